@@ -0,0 +1,531 @@
+#include <TestEzCsv.h>
+#include <ezlibs/ezCsv.hpp>
+#include <ezlibs/ezCTest.hpp>
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+// Desactivation des warnings de conversion
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244)  // Conversion from 'double' to 'float', possible loss of data
+#pragma warning(disable : 4305)  // Truncation from 'double' to 'float'
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+// all the rows of a csv text, as strings
+static std::vector<std::vector<std::string>> s_ReadRows(const std::string& vText, char vDelimiter = ',') {
+    std::vector<std::vector<std::string>> res;
+    ez::CsvReader reader;
+    reader.openBuffer(vText.data(), vText.size(), vDelimiter);
+    reader.forEachRow([&res](const ez::CsvRow& vRow) {
+        std::vector<std::string> row;
+        for (const auto& cell : vRow) {
+            row.push_back(cell.str());
+        }
+        res.push_back(row);
+        return true;
+    });
+    return res;
+}
+
+bool TestEzCsv_Reader_Basis() {
+    const auto rows = s_ReadRows("a,b,c\n1,,3\r\n4,5,\n");
+    CTEST_ASSERT(rows.size() == 3U);
+    CTEST_ASSERT(rows[0] == std::vector<std::string>({"a", "b", "c"}));
+    CTEST_ASSERT(rows[1] == std::vector<std::string>({"1", "", "3"}));
+    CTEST_ASSERT(rows[2] == std::vector<std::string>({"4", "5", ""}));
+    // no final new line, empty lines are skipped, other delimiter
+    const auto rows2 = s_ReadRows("x;y\n\n\r\nz;w", ';');
+    CTEST_ASSERT(rows2.size() == 2U);
+    CTEST_ASSERT(rows2[1] == std::vector<std::string>({"z", "w"}));
+    CTEST_ASSERT(s_ReadRows("").empty());
+    return true;
+}
+
+bool TestEzCsv_Reader_Quotes() {
+    const auto rows = s_ReadRows("\"a,b\",\"say \"\"hi\"\"\",\"multi\nline\"\n\"\",\"x\"tail,\"\"\"\"\n\"unclosed,end");
+    CTEST_ASSERT(rows.size() == 3U);
+    CTEST_ASSERT(rows[0] == std::vector<std::string>({"a,b", "say \"hi\"", "multi\nline"}));
+    CTEST_ASSERT(rows[1] == std::vector<std::string>({"", "xtail", "\""}));
+    CTEST_ASSERT(rows[2] == std::vector<std::string>({"unclosed,end"}));
+    // quoted cells without "" are views on the buffer, the others are copied
+    const std::string text = "\"plain\",\"a\"\"b\",\"c\"\"d\"";
+    ez::CsvReader reader;
+    reader.openBuffer(text.data(), text.size());
+    bool ok = false;
+    reader.forEachRow([&](const ez::CsvRow& vRow) {
+        ok = vRow.size() == 3U &&                                   //
+            vRow[0].data == text.data() + 1 && vRow[0] == "plain" &&  //
+            vRow[1] == "a\"b" && vRow[2] == "c\"d";
+        return true;
+    });
+    CTEST_ASSERT(ok);
+    return true;
+}
+
+bool TestEzCsv_Reader_Stop() {
+    ez::CsvReader reader;
+    const std::string text = "1\n2\n3\n4\n";
+    reader.openBuffer(text.data(), text.size());
+    size_t last = 0U;
+    const size_t count = reader.forEachRow([&last](const ez::CsvRow& vRow) {
+        last = vRow.index();
+        return vRow[0] != "2";
+    });
+    CTEST_ASSERT(count == 2U);
+    CTEST_ASSERT(last == 1U);
+    return true;
+}
+
+bool TestEzCsv_Reader_File() {
+    const std::string file = "test_ezcsv_reader.csv";
+    {
+        std::ofstream ofs(file, std::ios::binary);
+        ofs << "name,value\n\"dupont, jean\",12\nmartin,\"1\"\"5\"\n";
+    }
+    ez::Csv csv(file, ',', true);
+    CTEST_ASSERT(csv.getHeader() == std::vector<std::string>({"name", "value"}));
+    CTEST_ASSERT(csv.rowCount() == 2U);
+    CTEST_ASSERT(csv.at(0, 0) == "dupont, jean");
+    CTEST_ASSERT(csv.at(1, "value") == "1\"5");
+    {
+        ez::CsvReader reader(file);
+        CTEST_ASSERT(reader.size() > 0U);
+        CTEST_ASSERT(reader.forEachRow([](const ez::CsvRow&) { return true; }) == 3U);
+    }
+    std::remove(file.c_str());
+    // empty and missing files
+    {
+        std::ofstream ofs(file, std::ios::binary);
+    }
+    {
+        ez::CsvReader reader(file);
+        CTEST_ASSERT(reader.forEachRow([](const ez::CsvRow&) { return true; }) == 0U);
+    }
+    std::remove(file.c_str());
+    bool thrown = false;
+    try {
+        ez::CsvReader reader("not_existing_file.csv");
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    return true;
+}
+
+bool TestEzCsv_Columns_Types() {
+    const std::string text =
+        "id,price,name,note,mixed\n"
+        "1,2.5,apple,,10\n"
+        "-2,3,pear,x,20\n"
+        "3,,apple,\"y, z\",abc\n";
+    ez::CsvColumns csv;
+    csv.readFromBuffer(text.data(), text.size(), ',', true);
+    CTEST_ASSERT(csv.rowCount() == 3U);
+    CTEST_ASSERT(csv.colCount() == 5U);
+    CTEST_ASSERT(csv.getColumnName(1) == "price");
+    CTEST_ASSERT(csv.getColumnType(0) == ez::CsvColumns::ColumnType::INT64);
+    CTEST_ASSERT(csv.getColumnType(1) == ez::CsvColumns::ColumnType::DOUBLE);
+    CTEST_ASSERT(csv.getColumnType(2) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(csv.getColumnType(3) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(csv.getColumnType(4) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(csv.getInt64Column(0) == std::vector<int64_t>({1, -2, 3}));
+    CTEST_ASSERT(csv.getDouble(0, 1) == 2.5);
+    CTEST_ASSERT(csv.getDouble(1, 0) == -2.0);
+    CTEST_ASSERT(std::isnan(csv.getDouble(2, 1)));  // empty cell
+    CTEST_ASSERT(csv.getString(2, 3) == "y, z");
+    CTEST_ASSERT(csv.getStringDictionary(2).size() == 2U);  // apple, pear
+    CTEST_ASSERT(csv.getStringCodes(2)[0] == csv.getStringCodes(2)[2]);
+    CTEST_ASSERT(csv.at(1, "id") == "-2");
+    CTEST_ASSERT(csv.at(0, 1) == "2.5");
+    CTEST_ASSERT(csv.at(2, 4) == "abc");
+    // declared types
+    csv.readFromBuffer(text.data(), text.size(), ',', true, {ez::CsvColumns::ColumnType::DOUBLE, ez::CsvColumns::ColumnType::STRING});
+    CTEST_ASSERT(csv.getColumnType(0) == ez::CsvColumns::ColumnType::DOUBLE);
+    CTEST_ASSERT(csv.getColumnType(1) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(csv.getString(1, 1) == "3");
+    CTEST_ASSERT(csv.getColumnType(2) == ez::CsvColumns::ColumnType::STRING);
+    return true;
+}
+
+bool TestEzCsv_Columns_Errors() {
+    const std::string text = "a,b\n1,x\n2,y\n";
+    ez::CsvColumns csv;
+    bool thrown = false;
+    try {
+        csv.readFromBuffer(text.data(), text.size(), ',', true, {ez::CsvColumns::ColumnType::AUTO, ez::CsvColumns::ColumnType::INT64});
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    csv.readFromBuffer(text.data(), text.size(), ',', true);
+    thrown = false;
+    try {
+        csv.getDoubleColumn(1);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    thrown = false;
+    try {
+        csv.at(5, 0);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    // no header: first row is data, columns have no name
+    csv.readFromBuffer(text.data(), text.size());
+    CTEST_ASSERT(csv.rowCount() == 3U);
+    CTEST_ASSERT(csv.getColumnType(0) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(csv.getColumnName(0).empty());
+    csv.readFromBuffer("", 0U, ',', true);
+    CTEST_ASSERT(csv.rowCount() == 0U);
+    CTEST_ASSERT(csv.colCount() == 0U);
+    return true;
+}
+
+// several chunks give the same columns as one, quoted new lines included,
+// and a column is promoted when a late value does not fit the deduced type
+bool TestEzCsv_Columns_Parallel() {
+    std::ostringstream oss;
+    oss << "id,value,label\n";
+    const size_t rows = 200000U;
+    for (size_t i = 0; i < rows; ++i) {
+        oss << i << "," << (i == rows - 10U ? std::string("1.5") : std::to_string(i * 3U)) << ",";
+        if (i % 7U == 0U) {
+            oss << "\"multi\nline " << (i % 13U) << "\"";
+        } else {
+            oss << "label_" << (i % 100U);
+        }
+        oss << "\n";
+    }
+    const std::string text = oss.str();
+    CTEST_ASSERT(text.size() > 4U * (1U << 20));
+    ez::CsvColumns one;
+    one.readFromBuffer(text.data(), text.size(), ',', true, {}, 1U);
+    ez::CsvColumns many;
+    many.readFromBuffer(text.data(), text.size(), ',', true, {}, 4U);
+    CTEST_ASSERT(one.rowCount() == rows);
+    CTEST_ASSERT(many.rowCount() == rows);
+    CTEST_ASSERT(many.getColumnType(1) == ez::CsvColumns::ColumnType::DOUBLE);
+    CTEST_ASSERT(one.getInt64Column(0) == many.getInt64Column(0));
+    CTEST_ASSERT(one.getDoubleColumn(1) == many.getDoubleColumn(1));
+    CTEST_ASSERT(many.getDouble(rows - 10U, 1) == 1.5);
+    CTEST_ASSERT(many.getDouble(rows - 1U, 1) == (rows - 1U) * 3.0);
+    for (size_t i = 0; i < rows; i += 997U) {
+        CTEST_ASSERT(one.getString(i, 2) == many.getString(i, 2));
+        CTEST_ASSERT(many.getInt64(i, 0) == static_cast<int64_t>(i));
+    }
+    CTEST_ASSERT(many.getString(7U, 2) == "multi\nline 7");
+    CTEST_ASSERT(many.getStringDictionary(2).size() == one.getStringDictionary(2).size());
+    // after the sampled rows, a column promoted twice (1.5 then x), the other columns keep their first parsing
+    std::ostringstream promotions;
+    promotions << "id,value,label\n";
+    for (size_t i = 0; i < 3000U; ++i) {
+        promotions << i << "," << (i == 2000U ? std::string("1.5") : i == 2500U ? std::string("x") : std::to_string(i)) << ",\"l,\n" << i << "\"\n";
+    }
+    const std::string promotionsText = promotions.str();
+    ez::CsvColumns promoted;
+    promoted.readFromBuffer(promotionsText.data(), promotionsText.size(), ',', true, {}, 1U);
+    CTEST_ASSERT(promoted.rowCount() == 3000U);
+    CTEST_ASSERT(promoted.getColumnType(0) == ez::CsvColumns::ColumnType::INT64);
+    CTEST_ASSERT(promoted.getColumnType(1) == ez::CsvColumns::ColumnType::STRING);
+    CTEST_ASSERT(promoted.getString(2000U, 1) == "1.5");
+    CTEST_ASSERT(promoted.getString(2500U, 1) == "x");
+    CTEST_ASSERT(promoted.getString(2999U, 1) == "2999");
+    CTEST_ASSERT(promoted.getInt64(2999U, 0) == 2999);
+    CTEST_ASSERT(promoted.getString(2999U, 2) == "l,\n2999");
+    return true;
+}
+
+static std::string s_LoadFile(const std::string& vFile) {
+    std::ifstream ifs(vFile, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+bool TestEzCsv_Writer_Basis() {
+    const std::string file = "test_ezcsv_writer.csv";
+    {
+        ez::CsvWriter writer(file);
+        writer.writeRow("name", "count", "ratio");
+        writer.writeRow("plain", 42, 0.5);
+        writer.writeRow(std::string("a,b"), -7LL, 1e300);
+        writer.addCell("say \"hi\"").addCell(18446744073709551615ULL).addCell(-0.1).endRow();
+        writer.appendRow({"multi\nline", "", "x"});
+        CTEST_ASSERT(writer.rowCount() == 5U);
+    }
+    CTEST_ASSERT(s_LoadFile(file) ==
+                 "name,count,ratio\n"
+                 "plain,42,0.5\n"
+                 "\"a,b\",-7,1e+300\n"
+                 "\"say \"\"hi\"\"\",18446744073709551615,-0.1\n"
+                 "\"multi\nline\",,x\n");
+    // read back
+    ez::Csv csv(file, ',', true);
+    CTEST_ASSERT(csv.rowCount() == 4U);
+    CTEST_ASSERT(csv.at(1, 0) == "a,b");
+    CTEST_ASSERT(csv.at(2, 0) == "say \"hi\"");
+    CTEST_ASSERT(csv.at(3, 0) == "multi\nline");
+    // Csv::writeToFile quotes when needed too
+    csv.writeToFile(file, ';');
+    CTEST_ASSERT(s_LoadFile(file) ==
+                 "name;count;ratio\n"
+                 "plain;42;0.5\n"
+                 "a,b;-7;1e+300\n"
+                 "\"say \"\"hi\"\"\";18446744073709551615;-0.1\n"
+                 "\"multi\nline\";;x\n");
+    std::remove(file.c_str());
+    return true;
+}
+
+bool TestEzCsv_Writer_Numbers() {
+    char buffer[32];
+    const int64_t ints[] = {0, 1, -1, 1234567890123LL, INT64_MAX, INT64_MIN};
+    for (const auto v : ints) {
+        CTEST_ASSERT(std::string(buffer, ez::CsvWriter::formatInt64(v, buffer)) == std::to_string(v));
+    }
+    const double doubles[] = {0.0, 1.0, -2.0, 0.1, 0.37, 1.0 / 3.0, 123456.789, 1e-300, 1e300, -4.2e15, 5e14, 2.5, 1e15};
+    for (const auto v : doubles) {
+        const std::string text(buffer, ez::CsvWriter::formatDouble(v, buffer));
+        CTEST_ASSERT(std::strtod(text.c_str(), nullptr) == v);
+    }
+    CTEST_ASSERT(std::string(buffer, ez::CsvWriter::formatDouble(3.0, buffer)) == "3");
+    CTEST_ASSERT(std::string(buffer, ez::CsvWriter::formatDouble(0.1, buffer)) == "0.1");
+    CTEST_ASSERT(std::string(buffer, ez::CsvWriter::formatDouble(-0.0, buffer)) == "-0");
+    return true;
+}
+
+bool TestEzCsv_Writer_Append() {
+    const std::string file = "test_ezcsv_append.csv";
+    {
+        ez::CsvWriter writer(file);
+        writer.writeRow("id", "value");
+        writer.writeRow(1, 10);
+    }
+    {
+        ez::CsvWriter writer(file, ',', true);
+        writer.setFlushInterval(2U);
+        writer.writeRow(2, 20);
+        writer.writeRow(3, 30);
+        // flushed after the 2nd row, visible before the writer is closed
+        CTEST_ASSERT(s_LoadFile(file) == "id,value\n1,10\n2,20\n3,30\n");
+        writer.addCell(4);  // unfinished row, ended by close
+    }
+    CTEST_ASSERT(s_LoadFile(file) == "id,value\n1,10\n2,20\n3,30\n4\n");
+    std::remove(file.c_str());
+    bool thrown = false;
+    try {
+        ez::CsvWriter writer("not_existing_dir/file.csv");
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    return true;
+}
+
+// read throughput of a ~100 MB file
+bool TestEzCsv_Perfos_Read() {
+    const std::string file = "test_ezcsv_perfos.csv";
+    {
+        std::ofstream ofs(file, std::ios::binary);
+        ofs << "id,x,y,name,comment\n";
+        for (size_t i = 0; i < 1500000U; ++i) {
+            ofs << i << "," << (i * 0.37) << "," << (i % 977) * 1.5 << ",item_" << (i % 1000) << ",\"some text, with a comma\"\n";
+        }
+    }
+    std::ostringstream report;
+    report << "## ezCsv read" << std::endl << std::endl;
+    report << "| reader | MB/s |" << std::endl;
+    report << "|--------|------|" << std::endl;
+    size_t bytes = 0U;
+    size_t cells = 0U;
+    auto start = std::chrono::steady_clock::now();
+    {
+        ez::CsvReader reader(file);
+        bytes = reader.size();
+        reader.forEachRow([&cells](const ez::CsvRow& vRow) {
+            cells += vRow.size();
+            return true;
+        });
+    }
+    auto mbs = [&bytes](const std::chrono::steady_clock::time_point& vStart) {
+        return bytes / (1024.0 * 1024.0) / std::chrono::duration<double>(std::chrono::steady_clock::now() - vStart).count();
+    };
+    report << "| CsvReader::forEachRow | " << mbs(start) << " |" << std::endl;
+    CTEST_ASSERT(cells == 1500001U * 5U);
+    start = std::chrono::steady_clock::now();
+    {
+        ez::Csv csv(file, ',', true);
+        CTEST_ASSERT(csv.rowCount() == 1500000U);
+    }
+    report << "| Csv::readFromFile | " << mbs(start) << " |" << std::endl;
+    // the former std::getline + std::stringstream reader
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::vector<std::string>> data;
+        std::ifstream ifs(file);
+        std::string line;
+        while (std::getline(ifs, line)) {
+            std::vector<std::string> row;
+            std::stringstream lineStream(line);
+            std::string cell;
+            while (std::getline(lineStream, cell, ',')) {
+                row.push_back(cell);
+            }
+            data.push_back(row);
+        }
+    }
+    report << "| getline + stringstream | " << mbs(start) << " |" << std::endl;
+    std::remove(file.c_str());
+    std::cout << report.str();
+#ifdef RESULTS_PATH
+    std::ofstream resultsFile(RESULTS_PATH "csv_benchmark_results.md");
+    resultsFile << report.str();
+#endif
+    return true;
+}
+
+// columnar parse of a ~100 MB file vs the string table converted afterwards
+bool TestEzCsv_Perfos_Columns() {
+    const std::string file = "test_ezcsv_perfos_columns.csv";
+    const size_t rows = 2000000U;
+    {
+        std::ofstream ofs(file, std::ios::binary);
+        ofs << "id,x,y,category\n";
+        for (size_t i = 0; i < rows; ++i) {
+            ofs << i << "," << (i * 0.37) << "," << (i % 977) * 1.5 << ",cat_" << (i % 50) << "\n";
+        }
+    }
+    std::ostringstream report;
+    report << "## ezCsv columns" << std::endl << std::endl;
+    report << "| reader | ms |" << std::endl;
+    report << "|--------|----|" << std::endl;
+    auto ms = [](const std::chrono::steady_clock::time_point& vStart) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - vStart).count();
+    };
+    auto start = std::chrono::steady_clock::now();
+    {
+        ez::Csv csv(file, ',', true);
+        std::vector<int64_t> ids(csv.rowCount());
+        std::vector<double> xs(csv.rowCount());
+        for (size_t r = 0; r < csv.rowCount(); ++r) {
+            ids[r] = std::stoll(csv.at(r, 0));
+            xs[r] = std::stod(csv.at(r, 1));
+        }
+    }
+    report << "| Csv + std::stod | " << ms(start) << " |" << std::endl;
+    const size_t cores = std::max<size_t>(1U, std::thread::hardware_concurrency());
+    for (const size_t threads : {size_t(1U), cores}) {
+        start = std::chrono::steady_clock::now();
+        ez::CsvColumns csv(file, ',', true, {}, threads);
+        CTEST_ASSERT(csv.rowCount() == rows);
+        report << "| CsvColumns, " << threads << " threads | " << ms(start) << " |" << std::endl;
+    }
+    std::remove(file.c_str());
+    std::cout << report.str();
+#ifdef RESULTS_PATH
+    std::ofstream resultsFile(RESULTS_PATH "csv_columns_benchmark_results.md");
+    resultsFile << report.str();
+#endif
+    return true;
+}
+
+// write time of 10M rows vs a std::ofstream written cell by cell (the former Csv::writeToFile)
+bool TestEzCsv_Perfos_Write() {
+    const std::string file = "test_ezcsv_perfos_write.csv";
+    const size_t rows = 10000000U;
+    std::ostringstream report;
+    report << "## ezCsv write (" << rows << " rows)" << std::endl << std::endl;
+    report << "| writer | ms | MB/s |" << std::endl;
+    report << "|--------|----|------|" << std::endl;
+    auto ms = [](const std::chrono::steady_clock::time_point& vStart) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - vStart).count();
+    };
+    const std::string names[4] = {"alpha", "beta", "gamma, delta", "epsilon"};
+    auto start = std::chrono::steady_clock::now();
+    {
+        ez::CsvWriter writer(file);
+        writer.writeRow("id", "x", "y", "name");
+        for (size_t i = 0; i < rows; ++i) {
+            writer.writeRow(i, i * 0.25, static_cast<int>(i % 977), names[i % 4]);
+        }
+    }
+    double elapsed = ms(start);
+    const double mb = s_LoadFile(file).size() / (1024.0 * 1024.0);
+    report << "| CsvWriter | " << elapsed << " | " << mb / (elapsed / 1000.0) << " |" << std::endl;
+    start = std::chrono::steady_clock::now();
+    {
+        std::ofstream ofs(file);
+        ofs << "id" << ',' << "x" << ',' << "y" << ',' << "name" << "\n";
+        for (size_t i = 0; i < rows; ++i) {
+            ofs << i << ',' << i * 0.25 << ',' << static_cast<int>(i % 977) << ',' << names[i % 4] << "\n";
+        }
+    }
+    elapsed = ms(start);
+    report << "| std::ofstream << | " << elapsed << " | " << mb / (elapsed / 1000.0) << " |" << std::endl;
+    std::remove(file.c_str());
+    std::cout << report.str();
+#ifdef RESULTS_PATH
+    std::ofstream resultsFile(RESULTS_PATH "csv_write_benchmark_results.md");
+    resultsFile << report.str();
+#endif
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#define IfTestExist(v)            \
+    if (vTest == std::string(#v)) \
+    return v()
+
+bool TestEzCsv(const std::string& vTest) {
+    IfTestExist(TestEzCsv_Reader_Basis);
+    else IfTestExist(TestEzCsv_Reader_Quotes);
+    else IfTestExist(TestEzCsv_Reader_Stop);
+    else IfTestExist(TestEzCsv_Reader_File);
+    else IfTestExist(TestEzCsv_Columns_Types);
+    else IfTestExist(TestEzCsv_Columns_Errors);
+    else IfTestExist(TestEzCsv_Columns_Parallel);
+    else IfTestExist(TestEzCsv_Writer_Basis);
+    else IfTestExist(TestEzCsv_Writer_Numbers);
+    else IfTestExist(TestEzCsv_Writer_Append);
+    else IfTestExist(TestEzCsv_Perfos_Read);
+    else IfTestExist(TestEzCsv_Perfos_Columns);
+    else IfTestExist(TestEzCsv_Perfos_Write);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool TestEzCsv(const std::string& vTest);
@@ -1,6 +1,9 @@
 #include <ezlibs/ezFile.hpp>
+#include <ezlibs/ezSha.hpp>
 #include <ezlibs/ezCTest.hpp>
 #include <string>
+#include <chrono>
+#include <iostream>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -368,6 +371,75 @@ bool TestEzFile_PathInfos_ExtensionInName() {
     return true;
 }
 
+bool TestEzFile_hashFiles() {
+    std::vector<std::string> files;
+    std::vector<std::vector<uint8_t>> contents;
+    for (size_t i = 0; i < 20U; ++i) {
+        std::vector<uint8_t> bin(i * i * 1000U + i);
+        for (size_t j = 0; j < bin.size(); ++j) {
+            bin[j] = static_cast<uint8_t>(j * 31U + i);
+        }
+        files.push_back("test_hash_" + std::to_string(i) + ".bin");
+        contents.push_back(bin);
+        CTEST_ASSERT(ez::file::saveBinToFile(bin, files.back()));
+    }
+    files.push_back("nonexistent_12345.bin");
+    contents.push_back({});
+
+    // same results in the same order, whatever the threads count and the chunk size
+    const auto ref = ez::file::hashFiles(files, 1U);
+    CTEST_ASSERT(ref.size() == files.size());
+    for (size_t i = 0; i < files.size() - 1U; ++i) {
+        CTEST_ASSERT(ref[i].filePathName == files[i]);
+        CTEST_ASSERT(ref[i].size == contents[i].size());
+        CTEST_ASSERT(ref[i].hash == ez::xxh128().add(contents[i].data(), contents[i].size()).finalize().getHex());
+    }
+    CTEST_ASSERT(ref.back().hash.empty());
+    CTEST_ASSERT(ref.back().size == 0U);
+    const auto multi = ez::file::hashFiles(files, 4U, 4096U);
+    for (size_t i = 0; i < files.size(); ++i) {
+        CTEST_ASSERT(multi[i].filePathName == ref[i].filePathName);
+        CTEST_ASSERT(multi[i].hash == ref[i].hash);
+        CTEST_ASSERT(multi[i].size == ref[i].size);
+    }
+
+    // any hasher with the streaming api
+    const auto sha = ez::file::hashFiles<ez::sha1>(files);
+    CTEST_ASSERT(sha[3].hash == ez::sha1().add(contents[3].data(), contents[3].size()).finalize().getHex());
+    CTEST_ASSERT(ez::file::hashFiles<ez::xxh64>(files)[5].hash == ez::xxh64().add(contents[5].data(), contents[5].size()).finalize().getHex());
+    CTEST_ASSERT(ez::file::hashFiles(std::vector<std::string>()).empty());
+
+    for (size_t i = 0; i < files.size() - 1U; ++i) {
+        CTEST_ASSERT(ez::file::destroyFile(files[i]));
+    }
+    return true;
+}
+
+// throughput of hashFiles on a tree of many files
+bool TestEzFile_hashFiles_Perfos() {
+    std::vector<std::string> files;
+    std::vector<uint8_t> bin(2U * 1024U * 1024U);
+    for (size_t i = 0; i < 64U; ++i) {
+        for (size_t j = 0; j < bin.size(); j += 64U) {
+            bin[j] = static_cast<uint8_t>(i + j);
+        }
+        files.push_back("test_hash_perfos_" + std::to_string(i) + ".bin");
+        CTEST_ASSERT(ez::file::saveBinToFile(bin, files.back()));
+    }
+    const double totalSize = static_cast<double>(files.size() * bin.size());
+    for (const size_t threadsCount : {1U, 0U}) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto hashes = ez::file::hashFiles(files, threadsCount);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CTEST_ASSERT(hashes.size() == files.size());
+        std::cout << "hashFiles " << (threadsCount ? "1 thread  " : "all threads") << " : " << totalSize / seconds / 1e9 << " GB/s" << std::endl;
+    }
+    for (const auto &file : files) {
+        CTEST_ASSERT(ez::file::destroyFile(file));
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -404,6 +476,8 @@ bool TestEzFile(const std::string& vTest) {
     else IfTestExist(TestEzFile_PathInfos_GetFPNE_WithPathName);
     else IfTestExist(TestEzFile_PathInfos_GetFPNE_WithNameExt);
     else IfTestExist(TestEzFile_PathInfos_ExtensionInName);
+    else IfTestExist(TestEzFile_hashFiles);
+    else IfTestExist(TestEzFile_hashFiles_Perfos);
     return false;
 }
 
@@ -1,5 +1,21 @@
 #include <ezlibs/ezVdbWriter.hpp>
+#include <ezlibs/ezZlib.hpp>
+#include <ezlibs/ezCTest.hpp>
 #include <string>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <bitset>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <iostream>
+#include <functional>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -47,6 +63,579 @@ bool TestEzVdbWriter_Writer() {
     return true;
 }
 
+// throughput of addVoxel and write, for a dense block, a sparse shell and scattered voxels
+bool TestEzVdbWriter_Perfos() {
+    auto measure = [](const std::string& vName, std::function<size_t(ez::file::vdb::VdbFloatGrid&)> vFill) {
+        ez::file::vdb::VdbFloatGrid grid("density");
+        auto start = std::chrono::steady_clock::now();
+        const size_t count = vFill(grid);
+        const double fillSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const std::string filePathName = RESULTS_PATH "/perfos_" + vName + ".vdb";
+        FILE* fp = std::fopen(filePathName.c_str(), "wb");
+        if (fp == nullptr) {
+            return false;
+        }
+        start = std::chrono::steady_clock::now();
+        grid.write(fp);
+        const double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const long fileSize = std::ftell(fp);
+        std::fclose(fp);
+        std::remove(filePathName.c_str());
+        std::cout << vName << " : " << count << " voxels, addVoxel " << (double)count / fillSeconds / 1e6 << " Mvoxels/s, write " << writeSeconds * 1000.0
+                  << " ms, " << fileSize / 1024 << " KB" << std::endl;
+        return true;
+    };
+    CTEST_ASSERT(measure("dense", [](ez::file::vdb::VdbFloatGrid& vGrid) {
+        const uint32_t size = 192U;
+        for (uint32_t x = 0; x < size; ++x) {
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t z = 0; z < size; ++z) {
+                    vGrid.addVoxel(x, y, z, 1.0f);
+                }
+            }
+        }
+        return (size_t)size * size * size;
+    }));
+    CTEST_ASSERT(measure("sparse", [](ez::file::vdb::VdbFloatGrid& vGrid) {
+        // shell of a sphere, like a level set
+        const int32_t radius = 300;
+        std::vector<std::array<uint32_t, 3>> coords;
+        for (int32_t x = -radius; x <= radius; ++x) {
+            for (int32_t y = -radius; y <= radius; ++y) {
+                const int32_t z2 = radius * radius - x * x - y * y;
+                if (z2 >= 0) {
+                    const int32_t z = (int32_t)std::sqrt((double)z2);
+                    coords.push_back({(uint32_t)(x + 2048), (uint32_t)(y + 2048), (uint32_t)(2048 - z)});
+                    coords.push_back({(uint32_t)(x + 2048), (uint32_t)(y + 2048), (uint32_t)(2048 + z)});
+                }
+            }
+        }
+        for (const auto& c : coords) {
+            vGrid.addVoxel(c[0], c[1], c[2], 1.0f);
+        }
+        return coords.size();
+    }));
+    CTEST_ASSERT(measure("scattered", [](ez::file::vdb::VdbFloatGrid& vGrid) {
+        const size_t count = 10000U;
+        uint32_t seed = 12345U;
+        for (size_t i = 0; i < count; ++i) {
+            seed = seed * 1664525U + 1013904223U;
+            const uint32_t x = seed >> 20;
+            seed = seed * 1664525U + 1013904223U;
+            const uint32_t y = seed >> 20;
+            seed = seed * 1664525U + 1013904223U;
+            vGrid.addVoxel(x, y, seed >> 20, 1.0f);
+        }
+        return count;
+    }));
+    return true;
+}
+
+static std::string s_LoadFile(const std::string& vFilePathName) {
+    std::ifstream file(vFilePathName, std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+static void s_FillRows(ez::file::vdb::VdbFloatGrid& vDensity, ez::file::vdb::VdbVec3sGrid& vColor, uint32_t vStart, uint32_t vStep) {
+    const uint32_t size = 100U;
+    for (uint32_t x = vStart; x < size; x += vStep) {
+        for (uint32_t y = 0; y < size; ++y) {
+            const uint32_t z = (x * 7U + y * 3U) % 40U;
+            vDensity.addVoxel(x, y, z, (float)(x + y));
+            vColor.addVoxel(x, y, z + 1U, (float)x, (float)y, (float)z);
+        }
+    }
+}
+
+// the threads fill interleaved rows, so they share the leafs. the file must be the same as a filling by one thread
+bool TestEzVdbWriter_Parallel() {
+    const std::string refFilePathName = RESULTS_PATH "/parallel_ref.vdb";
+    {
+        ez::file::vdb::Writer vdb;
+        s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, 1U);
+        vdb.save(refFilePathName);
+    }
+    const auto ref = s_LoadFile(refFilePathName);
+    CTEST_ASSERT(!ref.empty());
+    for (const uint32_t threadsCount : {1U, 2U, 4U, 7U}) {
+        const std::string filePathName = RESULTS_PATH "/parallel_" + std::to_string(threadsCount) + ".vdb";
+        ez::file::vdb::Writer vdb;
+        // a part by the main layer, to merge with
+        s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, threadsCount + 1U);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&vdb, t, threadsCount]() {
+                auto& density = vdb.getPartialLayer<ez::file::vdb::VdbFloatGrid>(0, "density");
+                auto& color = vdb.getPartialLayer<ez::file::vdb::VdbVec3sGrid>(1, "color");
+                s_FillRows(density, color, t + 1U, threadsCount + 1U);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        vdb.save(filePathName);
+        CTEST_ASSERT(s_LoadFile(filePathName) == ref);
+    }
+    // the trees of different grid types are not merged
+    ez::file::vdb::VdbFloatGrid density("density");
+    ez::file::vdb::VdbVec3sGrid color("color");
+    s_FillRows(density, color, 0U, 1U);
+    CTEST_ASSERT(!density.merge(color));
+    CTEST_ASSERT(!color.merge(density));
+    CTEST_ASSERT(!density.merge(density));
+    return true;
+}
+
+// scaling of the filling by many threads, each thread fill a slab of a dense block
+bool TestEzVdbWriter_Parallel_Perfos() {
+    const uint32_t size = 256U;
+    const uint32_t depth = 128U;
+    std::cout << "hardware threads : " << std::thread::hardware_concurrency() << std::endl;
+    for (const uint32_t threadsCount : {1U, 2U, 4U, 8U, 16U}) {
+        ez::file::vdb::Writer vdb;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&vdb, t, threadsCount, size, depth]() {
+                auto& density = vdb.getPartialLayer<ez::file::vdb::VdbFloatGrid>(0, "density");
+                for (uint32_t z = t * depth / threadsCount; z < (t + 1U) * depth / threadsCount; ++z) {
+                    for (uint32_t y = 0; y < size; ++y) {
+                        for (uint32_t x = 0; x < size; ++x) {
+                            density.addVoxel(x, y, z, 1.0f);
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double fillSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        vdb.mergePartialLayers();
+        const double mergeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        // the same with one layer shared behind a mutex
+        ez::file::vdb::Writer vdbShared;
+        auto& sharedDensity = vdbShared.getFloatLayer(0, "density");
+        std::mutex sharedMutex;
+        start = std::chrono::steady_clock::now();
+        threads.clear();
+        for (uint32_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&sharedDensity, &sharedMutex, t, threadsCount, size, depth]() {
+                for (uint32_t z = t * depth / threadsCount; z < (t + 1U) * depth / threadsCount; ++z) {
+                    for (uint32_t y = 0; y < size; ++y) {
+                        for (uint32_t x = 0; x < size; ++x) {
+                            std::lock_guard<std::mutex> lock(sharedMutex);
+                            sharedDensity.addVoxel(x, y, z, 1.0f);
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double sharedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << threadsCount << " threads : fill " << (double)size * size * depth / fillSeconds / 1e6 << " Mvoxels/s, merge " << mergeSeconds * 1000.0
+                  << " ms, shared with mutex " << (double)size * size * depth / sharedSeconds / 1e6 << " Mvoxels/s" << std::endl;
+    }
+    return true;
+}
+
+// minimal reader of the float grids written by ez::file::vdb, for check the compressions.
+// return the active voxels of the first grid, by key x << 24 | y << 12 | z
+class FloatGridReader {
+private:
+    const std::string& m_Datas;
+    size_t m_Pos = 0U;
+    uint32_t m_Compression = 0U;
+
+public:
+    bool ok = true;
+    std::map<uint64_t, float> voxels;
+
+public:
+    explicit FloatGridReader(const std::string& vDatas) : m_Datas(vDatas) {
+    }
+
+    bool read() {
+        skip(8U + 4U * 3U + 1U + 36U + 4U);  // header, versions, uuid, file metadata
+        ok &= (get<uint32_t>() == 1U);      // grids count
+        skipName();                         // grid name
+        ok &= (getName() == "Tree_float_5_4_3");
+        skip(4U + 8U * 3U);  // instance parent, grid, block and end pos
+        m_Compression = get<uint32_t>();
+        const uint32_t metasCount = get<uint32_t>();
+        for (uint32_t i = 0; i < metasCount; ++i) {
+            skipName();  // name
+            skipName();  // type
+            skipName();  // value
+        }
+        skipName();                     // transform
+        skip(8U * 3U * 6U);             // transform values
+        skip(4U + 4U + 4U);             // buffers count, background, tiles count
+        ok &= (get<uint32_t>() == 1U);  // root childs count
+        skip(12U);                      // origin
+        // topology
+        std::vector<uint64_t> mask5(512);
+        getArray(mask5.data(), 512U);
+        skip(512U * 8U);  // value mask
+        readValues(32768U, 0U);
+        std::vector<std::pair<uint32_t, uint32_t>> leafs;  // bit index 4, bit index 3
+        for (uint32_t bit4 = 0; bit4 < 32768U && ok; ++bit4) {
+            if (mask5[bit4 >> 6] & (1ULL << (bit4 & 63U))) {
+                std::vector<uint64_t> mask4(64);
+                getArray(mask4.data(), 64U);
+                skip(64U * 8U);  // value mask
+                readValues(4096U, 0U);
+                for (uint32_t bit3 = 0; bit3 < 4096U; ++bit3) {
+                    if (mask4[bit3 >> 6] & (1ULL << (bit3 & 63U))) {
+                        leafs.emplace_back(bit4, bit3);
+                        skip(64U);  // leaf mask
+                    }
+                }
+            }
+        }
+        // buffers of the leafs
+        for (const auto& leaf : leafs) {
+            std::vector<uint64_t> mask0(8);
+            getArray(mask0.data(), 8U);
+            size_t activeCount = 0U;
+            for (const auto word : mask0) {
+                activeCount += std::bitset<64>(word).count();
+            }
+            const auto values = readValues(512U, activeCount);
+            if (!ok) {
+                break;
+            }
+            const bool onlyActives = (values.size() != 512U);
+            for (uint32_t bit0 = 0, idx = 0; bit0 < 512U; ++bit0) {
+                if (mask0[bit0 >> 6] & (1ULL << (bit0 & 63U))) {
+                    const uint64_t x = (leaf.first >> 10) * 128U + (leaf.second >> 8) * 8U + (bit0 >> 6);
+                    const uint64_t y = ((leaf.first >> 5) & 31U) * 128U + ((leaf.second >> 4) & 15U) * 8U + ((bit0 >> 3) & 7U);
+                    const uint64_t z = (leaf.first & 31U) * 128U + (leaf.second & 15U) * 8U + (bit0 & 7U);
+                    voxels[(x << 24) | (y << 12) | z] = values[onlyActives ? idx++ : bit0];
+                }
+            }
+        }
+        return ok && m_Pos == m_Datas.size();
+    }
+
+private:
+    void skip(size_t vBytes) {
+        m_Pos += vBytes;
+        ok &= (m_Pos <= m_Datas.size());
+    }
+    template <typename T>
+    void getArray(T* vDatas, size_t vCount) {
+        if (m_Pos + sizeof(T) * vCount <= m_Datas.size()) {
+            memcpy(vDatas, m_Datas.data() + m_Pos, sizeof(T) * vCount);
+        }
+        skip(sizeof(T) * vCount);
+    }
+    template <typename T>
+    T get() {
+        T ret{};
+        getArray(&ret, 1U);
+        return ret;
+    }
+    std::string getName() {
+        const uint32_t len = get<uint32_t>();
+        std::string ret;
+        if (ok && m_Pos + len <= m_Datas.size()) {
+            ret = m_Datas.substr(m_Pos, len);
+        }
+        skip(len);
+        return ret;
+    }
+    void skipName() {
+        skip(get<uint32_t>());
+    }
+    // the values of a node, like io::readCompressedValues of openvdb
+    std::vector<float> readValues(size_t vCount, size_t vActiveCount) {
+        const uint8_t metadata = get<uint8_t>();
+        ok &= (metadata == 0U || metadata == 6U);
+        const size_t count = ((m_Compression & ez::file::vdb::COMPRESS_ACTIVE_MASK) && metadata != 6U) ? vActiveCount : vCount;
+        std::vector<float> ret(count);
+        if (m_Compression & ez::file::vdb::COMPRESS_ZIP) {
+            const int64_t zipSize = get<int64_t>();
+            if (zipSize <= 0) {
+                ok &= ((size_t)-zipSize == count * sizeof(float));
+                getArray(ret.data(), count);
+            } else {
+                std::vector<uint8_t> out;
+                ok &= (m_Pos + (size_t)zipSize <= m_Datas.size());
+                ok &= ok && ez::zlib::uncompress(m_Datas.data() + m_Pos, (size_t)zipSize, out);
+                ok &= (out.size() == count * sizeof(float));
+                if (ok) {
+                    memcpy(ret.data(), out.data(), out.size());
+                }
+                skip((size_t)zipSize);
+            }
+        } else {
+            getArray(ret.data(), count);
+        }
+        return ret;
+    }
+};
+
+// all the compressions give the same voxels, and the active mask and zip reduce the file size
+bool TestEzVdbWriter_Compression() {
+    std::map<uint64_t, float> expected;
+    auto fill = [&expected](ez::file::vdb::VdbFloatGrid& vGrid) {
+        expected.clear();
+        for (uint32_t x = 0; x < 100U; x += 3U) {
+            for (uint32_t y = 0; y < 100U; ++y) {
+                const uint32_t z = 200U + (x * 7U + y * 3U) % 40U;
+                const float value = (float)((x + y) % 13U) * 0.5f;
+                vGrid.addVoxel(x, y, z, value);
+                expected[((uint64_t)x << 24) | ((uint64_t)y << 12) | z] = value;
+            }
+        }
+    };
+    std::vector<size_t> sizes;
+    for (const uint32_t compression : {(uint32_t)ez::file::vdb::COMPRESS_NONE,
+                                       (uint32_t)ez::file::vdb::COMPRESS_ACTIVE_MASK,
+                                       (uint32_t)ez::file::vdb::COMPRESS_ZIP,
+                                       (uint32_t)(ez::file::vdb::COMPRESS_ZIP | ez::file::vdb::COMPRESS_ACTIVE_MASK)}) {
+        const std::string filePathName = RESULTS_PATH "/compression_" + std::to_string(compression) + ".vdb";
+        ez::file::vdb::Writer vdb;
+        vdb.setCompression(compression);
+        fill(vdb.getFloatLayer(0, "density"));
+        CTEST_ASSERT(vdb.getFloatLayer(0, "density").getCompression() == compression);
+        vdb.save(filePathName);
+        const auto datas = s_LoadFile(filePathName);
+        CTEST_ASSERT(datas.find(ez::file::vdb::compression_to_string(compression)) != std::string::npos);
+        FloatGridReader reader(datas);
+        CTEST_ASSERT(reader.read());
+        CTEST_ASSERT(reader.voxels == expected);
+        sizes.push_back(datas.size());
+    }
+    CTEST_ASSERT(ez::file::vdb::compression_to_string(ez::file::vdb::COMPRESS_ZIP | ez::file::vdb::COMPRESS_ACTIVE_MASK) == "zip + active values");
+    CTEST_ASSERT(sizes[1] < sizes[0]);
+    CTEST_ASSERT(sizes[2] < sizes[0]);
+    CTEST_ASSERT(sizes[3] < sizes[2]);
+    return true;
+}
+
+// file size and write throughput of the compressions, for a dense block and a sparse shell
+bool TestEzVdbWriter_Compression_Perfos() {
+    auto measure = [](const std::string& vName, std::function<size_t(ez::file::vdb::VdbFloatGrid&)> vFill) {
+        ez::file::vdb::VdbFloatGrid grid("density");
+        const size_t count = vFill(grid);
+        const std::vector<std::pair<std::string, std::pair<uint32_t, int32_t>>> modes = {
+            {"none            ", {ez::file::vdb::COMPRESS_NONE, 0}},
+            {"active mask     ", {ez::file::vdb::COMPRESS_ACTIVE_MASK, 0}},
+            {"zip 1           ", {ez::file::vdb::COMPRESS_ZIP, 1}},
+            {"zip 6           ", {ez::file::vdb::COMPRESS_ZIP, 6}},
+            {"zip 1 + mask    ", {ez::file::vdb::COMPRESS_ZIP | ez::file::vdb::COMPRESS_ACTIVE_MASK, 1}},
+            {"zip 6 + mask    ", {ez::file::vdb::COMPRESS_ZIP | ez::file::vdb::COMPRESS_ACTIVE_MASK, 6}},
+        };
+        std::cout << vName << " : " << count << " voxels" << std::endl;
+        for (const auto& mode : modes) {
+            grid.setCompression(mode.second.first, mode.second.second);
+            const std::string filePathName = RESULTS_PATH "/compression_perfos.vdb";
+            FILE* fp = std::fopen(filePathName.c_str(), "wb");
+            if (fp == nullptr) {
+                return false;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            grid.write(fp);
+            const double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const long fileSize = std::ftell(fp);
+            std::fclose(fp);
+            std::remove(filePathName.c_str());
+            std::cout << "  " << mode.first << " : " << fileSize / 1024 << " KB, write " << writeSeconds * 1000.0 << " ms, "
+                      << (double)count / writeSeconds / 1e6 << " Mvoxels/s" << std::endl;
+        }
+        return true;
+    };
+    CTEST_ASSERT(measure("dense", [](ez::file::vdb::VdbFloatGrid& vGrid) {
+        const uint32_t size = 128U;
+        for (uint32_t x = 0; x < size; ++x) {
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t z = 0; z < size; ++z) {
+                    vGrid.addVoxel(x, y, z, (float)std::sin(x * 0.05) * (float)std::cos(y * 0.07) + (float)z / size);
+                }
+            }
+        }
+        return (size_t)size * size * size;
+    }));
+    CTEST_ASSERT(measure("sparse", [](ez::file::vdb::VdbFloatGrid& vGrid) {
+        // shell of a sphere, like a level set
+        const int32_t radius = 200;
+        size_t count = 0U;
+        for (int32_t x = -radius; x <= radius; ++x) {
+            for (int32_t y = -radius; y <= radius; ++y) {
+                const int32_t z2 = radius * radius - x * x - y * y;
+                if (z2 >= 0) {
+                    const int32_t z = (int32_t)std::sqrt((double)z2);
+                    vGrid.addVoxel(x + 2048, y + 2048, 2048 - z, (float)(x + y) * 0.01f);
+                    vGrid.addVoxel(x + 2048, y + 2048, 2048 + z, (float)(x - y) * 0.01f);
+                    count += 2U;
+                }
+            }
+        }
+        return count;
+    }));
+    return true;
+}
+
+static std::string s_GetFramePathName(const std::string& vBase, uint32_t vFrame) {
+    std::stringstream str;
+    str << RESULTS_PATH << "/" << vBase << "_" << std::setfill('0') << std::setw(4) << vFrame << ".vdb";
+    return str.str();
+}
+
+// the streamed files are the ones of save, and a keyframe is written as soon as finished
+bool TestEzVdbWriter_Streaming() {
+    const uint32_t framesCount = 5U;
+    for (uint32_t f = 1; f <= framesCount; ++f) {  // files of a previous run
+        std::remove(s_GetFramePathName("streaming_sync", f).c_str());
+        std::remove(s_GetFramePathName("streaming_async", f).c_str());
+    }
+    {
+        ez::file::vdb::Writer vdb;
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            vdb.setKeyFrame(f);
+            s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), f % 2U, 1U + f % 3U);
+        }
+        vdb.save(RESULTS_PATH "/streaming_ref.vdb");
+    }
+    {
+        ez::file::vdb::Writer vdb;
+        CTEST_ASSERT(vdb.startStreaming(RESULTS_PATH "/streaming_sync.vdb"));
+        CTEST_ASSERT(!vdb.startStreaming(RESULTS_PATH "/streaming_sync.vdb"));
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            vdb.setKeyFrame(f);
+            CTEST_ASSERT(vdb.getStreamedFramesCount() == f);
+            s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), f % 2U, 1U + f % 3U);
+            CTEST_ASSERT(!std::ifstream(s_GetFramePathName("streaming_sync", f + 1U)).good());
+            vdb.finishKeyFrame();
+            CTEST_ASSERT(std::ifstream(s_GetFramePathName("streaming_sync", f + 1U)).good());
+        }
+        vdb.stopStreaming();
+        CTEST_ASSERT(!vdb.isStreaming());
+        CTEST_ASSERT(vdb.getStreamedFramesCount() == framesCount);
+    }
+    {
+        // the keyframes are finished by setKeyFrame and filled by a thread with partial layers
+        ez::file::vdb::Writer vdb;
+        CTEST_ASSERT(vdb.startStreaming(RESULTS_PATH "/streaming_async.vdb", true));
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            vdb.setKeyFrame(f);
+            std::thread filler([&vdb, f]() {
+                auto& density = vdb.getPartialLayer<ez::file::vdb::VdbFloatGrid>(0, "density");
+                auto& color = vdb.getPartialLayer<ez::file::vdb::VdbVec3sGrid>(1, "color");
+                s_FillRows(density, color, f % 2U, 1U + f % 3U);
+            });
+            filler.join();
+        }
+        vdb.stopStreaming();
+        CTEST_ASSERT(vdb.getStreamedFramesCount() == framesCount);
+    }
+    for (uint32_t f = 1; f <= framesCount; ++f) {
+        const auto ref = s_LoadFile(s_GetFramePathName("streaming_ref", f));
+        CTEST_ASSERT(!ref.empty());
+        CTEST_ASSERT(s_LoadFile(s_GetFramePathName("streaming_sync", f)) == ref);
+        CTEST_ASSERT(s_LoadFile(s_GetFramePathName("streaming_async", f)) == ref);
+    }
+    return true;
+}
+
+// the finish of a keyframe doesnt merge the partial layers of the others, their threads can go on
+bool TestEzVdbWriter_Streaming_OtherKeyFrame() {
+    std::remove(RESULTS_PATH "/streaming_other_0001.vdb");  // file of a previous run
+    {
+        ez::file::vdb::Writer vdb;
+        s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, 1U);
+        vdb.save(RESULTS_PATH "/streaming_other_ref.vdb");
+    }
+    const auto ref = s_LoadFile(RESULTS_PATH "/streaming_other_ref.vdb");
+    CTEST_ASSERT(!ref.empty());
+    ez::file::vdb::Writer vdb;
+    vdb.setKeyFrame(0);
+    s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, 2U);
+    auto& density = vdb.getPartialLayer<ez::file::vdb::VdbFloatGrid>(0, "density");
+    auto& color = vdb.getPartialLayer<ez::file::vdb::VdbVec3sGrid>(1, "color");
+    vdb.setKeyFrame(1);
+    CTEST_ASSERT(vdb.startStreaming(RESULTS_PATH "/streaming_other.vdb"));
+    s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, 1U);
+    vdb.finishKeyFrame();
+    CTEST_ASSERT(s_LoadFile(RESULTS_PATH "/streaming_other_0001.vdb") == ref);
+    s_FillRows(density, color, 1U, 2U);  // the partial layers of the keyframe 0 are still alive
+    vdb.stopStreaming();
+    vdb.save(RESULTS_PATH "/streaming_other_kf0.vdb");  // only the keyframe 0 is left
+    CTEST_ASSERT(s_LoadFile(RESULTS_PATH "/streaming_other_kf0.vdb") == ref);
+    return true;
+}
+
+// a failed write is reported by getLastError, also when done by the background writer
+bool TestEzVdbWriter_Streaming_Errors() {
+    for (const bool async : {false, true}) {
+        ez::file::vdb::Writer vdb;
+        CTEST_ASSERT(vdb.startStreaming(RESULTS_PATH "/not_a_dir/streaming.vdb", async));
+        vdb.setKeyFrame(0);
+        s_FillRows(vdb.getFloatLayer(0, "density"), vdb.getVec3sLayer(1, "color"), 0U, 1U);
+        vdb.finishKeyFrame();
+        vdb.stopStreaming();
+        CTEST_ASSERT(vdb.getLastError() != 0);
+    }
+    return true;
+}
+
+// time of an animation saved at the end, or streamed with the writes in the filling thread or in a background thread
+bool TestEzVdbWriter_Streaming_Perfos() {
+    const uint32_t framesCount = 8U;
+    const uint32_t size = 96U;
+    auto fillFrame = [size](ez::file::vdb::Writer& vVdb, uint32_t vFrame) {
+        vVdb.setKeyFrame(vFrame);
+        auto& density = vVdb.getFloatLayer(0, "density");
+        for (uint32_t x = 0; x < size; ++x) {
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t z = 0; z < size; ++z) {
+                    density.addVoxel(x + vFrame, y, z, (float)(x + y + z + vFrame));
+                }
+            }
+        }
+    };
+    auto measure = [&](const std::string& vName, std::function<void()> vRun) {
+        const auto start = std::chrono::steady_clock::now();
+        vRun();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << vName << " : " << framesCount << " frames of " << size * size * size << " voxels in " << seconds * 1000.0 << " ms" << std::endl;
+        for (uint32_t f = 1; f <= framesCount; ++f) {
+            std::remove(s_GetFramePathName("streaming_perfos", f).c_str());
+        }
+    };
+    measure("save at end     ", [&]() {
+        ez::file::vdb::Writer vdb;
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            fillFrame(vdb, f);
+        }
+        vdb.save(RESULTS_PATH "/streaming_perfos.vdb");
+    });
+    measure("streaming       ", [&]() {
+        ez::file::vdb::Writer vdb;
+        vdb.startStreaming(RESULTS_PATH "/streaming_perfos.vdb");
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            fillFrame(vdb, f);
+        }
+        vdb.stopStreaming();
+    });
+    measure("streaming async ", [&]() {
+        ez::file::vdb::Writer vdb;
+        vdb.startStreaming(RESULTS_PATH "/streaming_perfos.vdb", true);
+        for (uint32_t f = 0; f < framesCount; ++f) {
+            fillFrame(vdb, f);
+        }
+        vdb.stopStreaming();
+    });
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -57,6 +646,15 @@ bool TestEzVdbWriter_Writer() {
 
 bool TestEzVdbWriter(const std::string& vTest) {
     IfTestExist(TestEzVdbWriter_Writer);
+    else IfTestExist(TestEzVdbWriter_Perfos);
+    else IfTestExist(TestEzVdbWriter_Parallel);
+    else IfTestExist(TestEzVdbWriter_Parallel_Perfos);
+    else IfTestExist(TestEzVdbWriter_Compression);
+    else IfTestExist(TestEzVdbWriter_Compression_Perfos);
+    else IfTestExist(TestEzVdbWriter_Streaming);
+    else IfTestExist(TestEzVdbWriter_Streaming_OtherKeyFrame);
+    else IfTestExist(TestEzVdbWriter_Streaming_Errors);
+    else IfTestExist(TestEzVdbWriter_Streaming_Perfos);
     return false;
 }
 
@@ -1,5 +1,8 @@
 #include <ezlibs/ezVoxWriter.hpp>
+#include <ezlibs/ezCTest.hpp>
 #include <string>
+#include <chrono>
+#include <iostream>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -46,6 +49,48 @@ bool TestEzVoxWriter_Writer() {
     return true;
 }
 
+// cubes far from each other must not share a cube
+bool TestEzVoxWriter_DistantCubes() {
+    ez::file::vox::Writer vox(1, 1, 1);  // cube pos == voxel pos
+    const size_t far = (size_t)1 << 21;
+    vox.setKeyFrame(0);
+    vox.addVoxel(0, 0, 0, 1);
+    vox.addVoxel(far, 0, 0, 2);
+    vox.addVoxel(0, far, 0, 3);
+    vox.addVoxel(0, 0, far * 2, 4);
+    vox.save(RESULTS_PATH "/distant.vox");  // updates the voxels count
+    CTEST_ASSERT(vox.getVoxelsCount(0) == 4U);
+    return true;
+}
+
+// addVoxel throughput, on new voxels and on already added voxels
+bool TestEzVoxWriter_Perfos() {
+    const size_t SIZE = 252U;  // 2 cubes per axis
+    const size_t HEIGHT = 32U;
+    const int32_t FRAMES = 2;
+    ez::file::vox::Writer vox;
+    for (const char* pass : {"new voxels  ", "same voxels "}) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int32_t k = 0; k < FRAMES; ++k) {
+            vox.setKeyFrame(k);
+            for (size_t x = 0; x < SIZE; ++x) {
+                for (size_t y = 0; y < SIZE; ++y) {
+                    for (size_t z = 0; z < HEIGHT; ++z) {
+                        vox.addVoxel(x, y, z + k, (uint8_t)((x + y + z) % 255 + 1));
+                    }
+                }
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double count = (double)(SIZE * SIZE * HEIGHT * FRAMES);
+        std::cout << "addVoxel " << pass << ": " << count / seconds / 1e6 << " Mvoxels/s" << std::endl;
+    }
+    vox.save(RESULTS_PATH "/perfos.vox");  // updates the voxels count
+    CTEST_ASSERT(vox.getVoxelsCount(0) == SIZE * SIZE * HEIGHT);
+    CTEST_ASSERT(vox.getVoxelsCount(1) == SIZE * SIZE * HEIGHT);
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -56,6 +101,8 @@ bool TestEzVoxWriter_Writer() {
 
 bool TestEzVoxWriter(const std::string& vTest) {
     IfTestExist(TestEzVoxWriter_Writer);
+    else IfTestExist(TestEzVoxWriter_DistantCubes);
+    else IfTestExist(TestEzVoxWriter_Perfos);
     return false;
 }
 
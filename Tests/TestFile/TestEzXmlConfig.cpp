@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -261,6 +262,112 @@ bool TestEzXmlConfig_StopChildParsing() {
     return true;
 }
 
+// trace of the setFromXmlNodes calls
+class TracingConfig : public ez::xml::Config {
+public:
+    std::vector<std::string> trace;
+    std::string stopOn;
+
+    virtual ez::xml::Nodes getXmlNodes(const std::string& vUserDatas = "") final {
+        return ez::xml::Nodes();
+    }
+
+    virtual bool setFromXmlNodes(const ez::xml::Node& vNode, const ez::xml::Node& vParent, const std::string& vUserDatas) final {
+        std::string line = vParent.getName() + ">" + vNode.getName() + " " + vNode.getAttribute("name") + " " + vNode.getContent() + " " + vUserDatas;
+        trace.push_back(line);
+        return vNode.getName() != stopOn;
+    }
+};
+
+static const char* s_streamedDoc = u8R"(
+<config>
+	<!-- Comment 1 -->
+    <NumberOneLine>60</NumberOneLine>
+    <Tests>
+	    <!-- Comment 2 -->
+        <Test name="test1" number="50"/>
+        <Test name="test2" number="100"/>
+        <Test name="test4" number="200">
+            <SubTest name="subTest1" number="250"/>
+            <SubTest name="subTest2" number="300">sub content</SubTest>
+        </Test>
+    </Tests>
+    <Last>end</Last>
+</config>
+)";
+
+bool TestEzXmlConfig_Streamed_SameAsDom() {
+    TracingConfig domConfig;
+    if (!domConfig.LoadConfigString(s_streamedDoc, "datas")) {
+        return false;
+    }
+    // small chunks for cut the tokens
+    TracingConfig streamedConfig;
+    std::istringstream stream(s_streamedDoc);
+    if (!streamedConfig.parseConfigStream(stream, "datas", 16U)) {
+        return false;
+    }
+    if (streamedConfig.trace.size() != 12U) {
+        return false;
+    }
+    if (streamedConfig.trace != domConfig.trace) {
+        return false;
+    }
+    return true;
+}
+
+bool TestEzXmlConfig_Streamed_StopChildParsing() {
+    TracingConfig config;
+    config.stopOn = "Tests";
+    std::istringstream stream(s_streamedDoc);
+    if (!config.parseConfigStream(stream, "", 16U)) {
+        return false;
+    }
+    // root, config, Comment 1, NumberOneLine, Tests, Last
+    if (config.trace.size() != 6U) {
+        return false;
+    }
+    if (config.trace[5].find("config>Last") != 0) {
+        return false;
+    }
+    config.trace.clear();
+    config.stopOn = "config";
+    std::istringstream stream2(s_streamedDoc);
+    if (!config.parseConfigStream(stream2, "", 16U)) {
+        return false;
+    }
+    if (config.trace.size() != 2U) {  // root, config
+        return false;
+    }
+    return true;
+}
+
+bool TestEzXmlConfig_Streamed_File() {
+    TestConfig config;
+    config.testValue = 456;
+    config.testName = "StreamedFile";
+    std::string testFile = std::string(RESULTS_PATH) + "test_config_streamed.xml";
+    if (!config.SaveConfigFile(testFile, "", "config")) {
+        return false;
+    }
+    TestConfig loadedConfig;
+    if (!loadedConfig.LoadConfigFileStreamed(testFile, "", 32U)) {
+        return false;
+    }
+    if (loadedConfig.testValue != 456 || loadedConfig.testName != "StreamedFile") {
+        return false;
+    }
+    // no file is ok, a malformed one is not
+    if (!loadedConfig.LoadConfigFileStreamed("nonexistent_file_12345.xml", "")) {
+        return false;
+    }
+    std::istringstream malformed("<config><TestValue>1</config>");
+    if (loadedConfig.parseConfigStream(malformed, "")) {
+        return false;
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -277,6 +384,9 @@ bool TestEzXmlConfig(const std::string& vTest) {
     else IfTestExist(TestEzXmlConfig_UserDatas);
     else IfTestExist(TestEzXmlConfig_RecursiveParsing);
     else IfTestExist(TestEzXmlConfig_StopChildParsing);
+    else IfTestExist(TestEzXmlConfig_Streamed_SameAsDom);
+    else IfTestExist(TestEzXmlConfig_Streamed_StopChildParsing);
+    else IfTestExist(TestEzXmlConfig_Streamed_File);
     return false;
 }
 
@@ -1,5 +1,6 @@
 #include <ezlibs/ezCTest.hpp>
 #include <TestEzBmp.h>
+#include <TestEzCsv.h>
 #ifdef TESTING_WIP
 #include <TestEzGif.h>
 #include <TestEzPng.h>
@@ -27,6 +28,7 @@ bool TestFile(const std::string& vTest) {
     else IfTestCollectionExist(TestEzSvg);
     else IfTestCollectionExist(TestEzJson);
 #endif
+    else IfTestCollectionExist(TestEzCsv);
     else IfTestCollectionExist(TestEzBinBuf);
     else IfTestCollectionExist(TestEzVdbWriter);
     else IfTestCollectionExist(TestEzVoxWriter);
@@ -27,6 +27,8 @@ SOFTWARE.
 #include <TestEzExprBuiltins.h>
 #include <TestEzExprConstants.h>
 #include <TestEzExprExceptions.h>
+#include <TestEzExprCompiled.h>
+#include <TestEzExprOptimizations.h>
 #include <TestEzExprPerfos.h>
 
 ////////////////////////////////////////////////////////////////////////////
@@ -42,6 +44,8 @@ bool TestEzExpr(const std::string& vTest) {
     IfTestCollectionExist(TestEzExpr_Constants);
     IfTestCollectionExist(TestEzExpr_Builtins);
     IfTestCollectionExist(TestEzExpr_Exceptions);
+    IfTestCollectionExist(TestEzExpr_Compiled);
+    IfTestCollectionExist(TestEzExpr_Optimizations);
     IfTestCollectionExist(TestEzExpr_Perfos);
     // default
     return false;
@@ -0,0 +1,366 @@
+﻿/*
+MIT License
+
+Copyright (c) 2014-2024 Stephane Cuillerdier (aka aiekick)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <TestEzExprCompiled.h>
+#include <ezlibs/ezCTest.hpp>
+#include <ezlibs/ezExpr.hpp>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+//// COMPILED //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+// the compiled program must give the same results as the tree walker
+bool TestEzExpr_Compiled_SameResults() {
+    const char* exprs[] = {
+        "x * x",
+        "5 + x + 5",
+        "(x + 5) * 2",
+        "-x + 3 ^ 2",
+        "sqrt(pow(x, 1.5) + pow(x, 2.5))",
+        "(1/(x + 1) + 2/(x + 2) + 3/(x + 3))",
+        "clamp(sin(x) * 2, -0.5, 0.5) + mod(x, 3) + 3!",
+        "smoothstep(0, 10, x) * max(x, 2) - atan2(x, 1)",
+    };
+    for (const auto* expr : exprs) {
+        ez::Expr ev;
+        ev.parse(expr);
+        for (double x = 0.5; x < 10.0; x += 0.75) {
+            const double tree = ev.set("x", x).eval().getResult();
+            const double compiled = ev.set("x", x).evalCompiled().getResult();
+            CTEST_ASSERT(tree == compiled);
+        }
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_Program() {
+    ez::Expr ev;
+    ev.parse("x * x + y * x").compile();
+    CTEST_ASSERT(ev.isCompiled());
+    const auto& program = ev.getProgram();
+    CTEST_ASSERT(program.variables.size() == 2U);  // x and y have one slot each
+    CTEST_ASSERT(program.code.size() == 7U);
+    CTEST_ASSERT(program.stackSize == 3U);
+    return true;
+}
+
+bool TestEzExpr_Compiled_SetAfterCompile() {
+    ez::Expr ev;
+    ev.parse("x * x + y").compile();
+    CTEST_ASSERT(ev.set("x", 2.0).set("y", 1.0).evalCompiled().check(5.0));
+    CTEST_ASSERT(ev.set("x", 3.0).evalCompiled().check(10.0));
+    CTEST_ASSERT(ev.set("y", -1.0).evalCompiled().check(8.0));
+    return true;
+}
+
+bool TestEzExpr_Compiled_ParseInvalidates() {
+    ez::Expr ev;
+    CTEST_ASSERT(ev.parse("x + 1").set("x", 1.0).evalCompiled().check(2.0));
+    CTEST_ASSERT(ev.isCompiled());
+    ev.parse("x * 10");
+    CTEST_ASSERT(!ev.isCompiled());
+    CTEST_ASSERT(ev.evalCompiled().check(10.0));
+    return true;
+}
+
+bool TestEzExpr_Compiled_AddFunctionInvalidates() {
+    ez::Expr ev;
+    ev.addFunction("twice", [](double a) { return a * 2.0; });
+    CTEST_ASSERT(ev.parse("twice(x)").set("x", 2.0).evalCompiled().check(4.0));
+    ev.addFunction("twice", [](double a) { return a * 3.0; });
+    CTEST_ASSERT(!ev.isCompiled());
+    CTEST_ASSERT(ev.evalCompiled().check(6.0));
+    return true;
+}
+
+bool TestEzExpr_Compiled_VariableNotFound() {
+    ez::Expr ev;
+    try {
+        ev.parse("x + y").set("x", 1.0).evalCompiled();
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(std::string(e.what()) == std::string("Variable not found: y"));
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::VARIABLE_NOT_FOUND);
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_VariableErased() {
+    ez::Expr ev;
+    ev.parse("x + 1").set("x", 1.0).evalCompiled();
+    ev.getDefinedVarsRef().clear();
+    CTEST_TRY_CATCH(ev.evalCompiled());
+    CTEST_ASSERT(ev.set("x", 2.0).evalCompiled().check(3.0));
+    return true;
+}
+
+bool TestEzExpr_Compiled_DivisionByZero() {
+    ez::Expr ev;
+    try {
+        ev.parse("1 / x").set("x", 0.0).evalCompiled();
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::DIVISION_BY_ZERO);
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_EvaluationNaN() {
+    ez::Expr ev;
+    try {
+        ev.parse("sqrt(x)").set("x", -1.0).evalCompiled();
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::EVALUATION_NAN);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//// ARRAYS ////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+// evalArrays must give the same results as eval row by row
+bool TestEzExpr_Compiled_Arrays_SameResults() {
+    const char* exprs[] = {
+        "x * y + t",
+        "-x / (y + 1) ^ 2",
+        "sin(x) * cos(y) + sqrt(abs(x - y)) + fract(t)",
+        "clamp(x, -1, 1) + mix(x, y, 0.25) + step(y, x) + min(x, t) - max(y, t)",
+        "floor(x) + ceil(y) + mod(x, 3) + atan2(x, y) + smoothstep(0, 10, y)",
+        "(x + y) % 7 + 3!",
+    };
+    const size_t count = 1000U;  // not a multiple of the block size
+    std::vector<double> xs(count), ys(count), results(count);
+    for (size_t i = 0; i < count; ++i) {
+        xs[i] = static_cast<double>(i) * 0.013 - 5.0;
+        ys[i] = static_cast<double>(i) * 0.007 + 0.5;
+    }
+    for (const auto* expr : exprs) {
+        ez::Expr ev;
+        ev.parse(expr).set("t", 2.5).bindArray("x", xs.data()).bindArray("y", ys.data()).evalArrays(results.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            CTEST_ASSERT(ev.set("x", xs[i]).set("y", ys[i]).eval().getResult() == results[i]);
+        }
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_Arrays_Broadcast() {
+    ez::Expr ev;
+    const double xs[] = {1.0, 2.0, 3.0};
+    double results[3] = {};
+    ev.parse("x * k").set("k", 10.0).bindArray("x", xs).evalArrays(results, 3);
+    CTEST_ASSERT(results[0] == 10.0 && results[1] == 20.0 && results[2] == 30.0);
+    ev.clearArrays().set("x", 4.0).evalArrays(results, 3);  // x is a scalar again
+    CTEST_ASSERT(results[0] == 40.0 && results[1] == 40.0 && results[2] == 40.0);
+    return true;
+}
+
+bool TestEzExpr_Compiled_Arrays_DivisionByZero() {
+    ez::Expr ev;
+    const double xs[] = {1.0, 2.0, 0.0, 3.0};
+    double results[4] = {};
+    try {
+        ev.parse("1 / x").bindArray("x", xs).evalArrays(results, 4);
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::DIVISION_BY_ZERO);
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_Arrays_EvaluationInf() {
+    ez::Expr ev;
+    const double xs[] = {1.0, 2.0, 1000.0};
+    double results[3] = {};
+    try {
+        ev.parse("exp(x)").bindArray("x", xs).evalArrays(results, 3);
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::EVALUATION_INF);
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_Arrays_VariableNotFound() {
+    ez::Expr ev;
+    const double xs[] = {1.0, 2.0};
+    double results[2] = {};
+    try {
+        ev.parse("x + y").bindArray("x", xs).evalArrays(results, 2);
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::VARIABLE_NOT_FOUND);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//// CONTEXTS //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool TestEzExpr_Compiled_Context_SameResults() {
+    ez::Expr ev;
+    ev.parse("sin(x) * sin(x) + y / (1 + abs(x))");
+    ez::ExprContext ctx(ev.getSharedProgram());
+    const size_t ySlot = ctx.getSlot("y");
+    CTEST_ASSERT(ySlot < ctx.getProgram()->variables.size());
+    CTEST_ASSERT(ctx.getSlot("z") == ctx.getProgram()->variables.size());
+    for (double x = -3.0; x < 3.0; x += 0.25) {
+        ctx.set("x", x).setSlot(ySlot, x * 2.0);
+        CTEST_ASSERT(ctx.eval().getResult() == ev.set("x", x).set("y", x * 2.0).eval().getResult());
+    }
+    return true;
+}
+
+// the shared program stays valid when the Expr is parsed again or destroyed
+bool TestEzExpr_Compiled_Context_OutlivesExpr() {
+    std::shared_ptr<const ez::Program> program;
+    {
+        ez::Expr ev;
+        ev.addFunction("twice", [](double a) { return a * 2.0; });
+        program = ev.parse("twice(x) + 1").getSharedProgram();
+        ev.parse("x");
+    }
+    ez::ExprContext ctx(program);
+    CTEST_ASSERT(ctx.set("x", 2.0).eval().check(5.0));
+    return true;
+}
+
+bool TestEzExpr_Compiled_Context_VariableNotFound() {
+    ez::Expr ev;
+    ez::ExprContext ctx(ev.parse("x + y").getSharedProgram());
+    try {
+        ctx.set("x", 1.0).eval();
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(std::string(e.what()) == std::string("Variable not found: y"));
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::VARIABLE_NOT_FOUND);
+    }
+    return true;
+}
+
+bool TestEzExpr_Compiled_Context_Arrays() {
+    ez::Expr ev;
+    ez::ExprContext ctx(ev.parse("x * k + 1").getSharedProgram());
+    const double xs[] = {1.0, 2.0, 3.0};
+    double results[3] = {};
+    ctx.set("k", 10.0).bindArray("x", xs).evalArrays(results, 3);
+    CTEST_ASSERT(results[0] == 11.0 && results[1] == 21.0 && results[2] == 31.0);
+    return true;
+}
+
+// one parse, many threads, each with its own context
+bool TestEzExpr_Compiled_Context_Threads() {
+    ez::Expr ev;
+    auto program = ev.parse("sqrt(x * x + y * y) + sin(x) * sin(x)").getSharedProgram();
+    const size_t threadsCount = 4U;
+    const size_t count = 10000U;
+    std::vector<double> sums(threadsCount, 0.0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&program, &sums, t, count]() {
+            ez::ExprContext ctx(program);
+            for (size_t i = 0; i < count; ++i) {
+                sums[t] += ctx.set("x", static_cast<double>(i)).set("y", static_cast<double>(t)).eval().getResult();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < threadsCount; ++t) {
+        double expected = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            expected += ev.set("x", static_cast<double>(i)).set("y", static_cast<double>(t)).eval().getResult();
+        }
+        CTEST_ASSERT(sums[t] == expected);
+    }
+    return true;
+}
+
+// the copies of a context have their own values, so they can be given to many threads
+bool TestEzExpr_Compiled_Context_Copies() {
+    ez::Expr ev;
+    ez::ExprContext ctx(ev.parse("x * 10 + y").getSharedProgram());
+    ctx.set("x", 1.0).set("y", 0.5);
+    const size_t threadsCount = 4U;
+    std::vector<ez::ExprContext> contexts(threadsCount, ctx);
+    std::vector<double> results(threadsCount, 0.0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&contexts, &results, t]() {
+            for (size_t i = 0; i < 1000U; ++i) {
+                results[t] = contexts[t].set("x", static_cast<double>(t + 2U)).eval().getResult();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t t = 0; t < threadsCount; ++t) {
+        CTEST_ASSERT(results[t] == (t + 2U) * 10.0 + 0.5);
+    }
+    CTEST_ASSERT(ctx.eval().getResult() == 10.5);
+    ez::ExprContext assigned(ev.parse("x").getSharedProgram());
+    assigned = contexts[0];
+    contexts[0].set("x", 100.0);
+    CTEST_ASSERT(assigned.eval().getResult() == 20.5);
+    ez::ExprContext moved(std::move(assigned));
+    CTEST_ASSERT(moved.set("y", 1.0).eval().getResult() == 21.0);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//// ENTRY POINT ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool TestEzExpr_Compiled(const std::string& vTest) {
+    IfTestExist(TestEzExpr_Compiled_SameResults);
+    else IfTestExist(TestEzExpr_Compiled_Program);
+    else IfTestExist(TestEzExpr_Compiled_SetAfterCompile);
+    else IfTestExist(TestEzExpr_Compiled_ParseInvalidates);
+    else IfTestExist(TestEzExpr_Compiled_AddFunctionInvalidates);
+    else IfTestExist(TestEzExpr_Compiled_VariableNotFound);
+    else IfTestExist(TestEzExpr_Compiled_VariableErased);
+    else IfTestExist(TestEzExpr_Compiled_DivisionByZero);
+    else IfTestExist(TestEzExpr_Compiled_EvaluationNaN);
+    else IfTestExist(TestEzExpr_Compiled_Arrays_SameResults);
+    else IfTestExist(TestEzExpr_Compiled_Arrays_Broadcast);
+    else IfTestExist(TestEzExpr_Compiled_Arrays_DivisionByZero);
+    else IfTestExist(TestEzExpr_Compiled_Arrays_EvaluationInf);
+    else IfTestExist(TestEzExpr_Compiled_Arrays_VariableNotFound);
+    else IfTestExist(TestEzExpr_Compiled_Context_SameResults);
+    else IfTestExist(TestEzExpr_Compiled_Context_OutlivesExpr);
+    else IfTestExist(TestEzExpr_Compiled_Context_VariableNotFound);
+    else IfTestExist(TestEzExpr_Compiled_Context_Arrays);
+    else IfTestExist(TestEzExpr_Compiled_Context_Threads);
+    else IfTestExist(TestEzExpr_Compiled_Context_Copies);
+    // default
+    return false;
+}
@@ -0,0 +1,165 @@
+﻿/*
+MIT License
+
+Copyright (c) 2014-2024 Stephane Cuillerdier (aka aiekick)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include <TestEzExprOptimizations.h>
+#include <ezlibs/ezCTest.hpp>
+#include <ezlibs/ezExpr.hpp>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+//// OPTIMIZATIONS /////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool TestEzExpr_Optimizations_ConstantFolding() {
+    ez::Expr ev;
+    ev.parse("2 * pi / 360 * x");
+    CTEST_ASSERT(ev.getParsedNodesCount() == 7U);
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == 3U);  // 0.0174... * x
+    CTEST_ASSERT(ev.set("x", 180.0).eval().check(M_PI));
+    return true;
+}
+
+bool TestEzExpr_Optimizations_ConstantFolding_Functions() {
+    ez::Expr ev;
+    ev.parse("x + sqrt(16) * -2 + 3!");
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == 5U);  // (x + -8) + 6
+    CTEST_ASSERT(ev.set("x", 1.0).eval().check(-1.0));
+    return true;
+}
+
+bool TestEzExpr_Optimizations_SharedSubTrees() {
+    ez::Expr ev;
+    ev.parse("sin(t) * sin(t)");
+    CTEST_ASSERT(ev.getParsedNodesCount() == 5U);
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == 3U);  // t, sin, *
+    ev.compile();
+    CTEST_ASSERT(ev.getProgram().tempsCount == 1U);
+    CTEST_ASSERT(ev.getProgram().code.size() == 5U);  // t sin store load mul
+    const double s = std::sin(0.5);
+    CTEST_ASSERT(ev.set("t", 0.5).eval().getResult() == s * s);
+    CTEST_ASSERT(ev.evalCompiled().getResult() == s * s);
+    return true;
+}
+
+// a shared sub-tree is computed once per eval(), whatever its count of parents
+bool TestEzExpr_Optimizations_SharedSubTrees_Eval() {
+    ez::Expr ev;
+    ev.parse("sin(t) * sin(t) + sin(t) / 2");
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == 6U);  // t, sin, *, 2, /, +
+    const double s = std::sin(0.5);
+    CTEST_ASSERT(ev.set("t", 0.5).eval().getResult() == s * s + s / 2.0);
+    CTEST_ASSERT(ev.getEvaluatedNodesCount() == ev.getOptimizedNodesCount());
+    const double s2 = std::sin(1.5);
+    CTEST_ASSERT(ev.set("t", 1.5).eval().getResult() == s2 * s2 + s2 / 2.0);  // not the value of the previous eval()
+    CTEST_ASSERT(ev.getEvaluatedNodesCount() == ev.getOptimizedNodesCount());
+    ev.setOptimization(false).parse("sin(t) * sin(t)");
+    CTEST_ASSERT(ev.eval().getResult() == s2 * s2);
+    CTEST_ASSERT(ev.getEvaluatedNodesCount() == 5U);
+    return true;
+}
+
+bool TestEzExpr_Optimizations_Disabled() {
+    ez::Expr ev;
+    ev.setOptimization(false).parse("sin(t) * sin(t) + 2 * 3");
+    CTEST_ASSERT(ev.getParsedNodesCount() == 9U);
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == 9U);
+    CTEST_ASSERT(ev.set("t", 0.0).eval().check(6.0));
+    return true;
+}
+
+// user functions can have side effects, they are neither folded nor shared
+bool TestEzExpr_Optimizations_UserFunctionsKept() {
+    ez::Expr ev;
+    size_t calls = 0U;
+    ev.addFunction("count", [&calls](double a) {
+        ++calls;
+        return a;
+    });
+    ev.parse("count(x) + count(x) + count(2)");
+    CTEST_ASSERT(ev.getOptimizedNodesCount() == ev.getParsedNodesCount());
+    ev.set("x", 1.0).evalCompiled();
+    CTEST_ASSERT(calls == 3U);
+    return true;
+}
+
+// a constant sub-tree giving an error is not folded, the error is thrown by the evaluation
+bool TestEzExpr_Optimizations_FoldingKeepsErrors() {
+    ez::Expr ev;
+    ev.parse("x + 1 / 0");
+    try {
+        ev.set("x", 1.0).eval();
+        return false;  // Expected an exception
+    } catch (const ez::ExprException& e) {
+        CTEST_ASSERT(e.getCode() == ez::ErrorCode::DIVISION_BY_ZERO);
+    }
+    return true;
+}
+
+// the optimized tree, the compiled program and the batch evaluation must give the same results as the raw tree
+bool TestEzExpr_Optimizations_SameResults() {
+    const char* exprs[] = {
+        "2 * pi / 360 * x",
+        "sin(x) * sin(x) + cos(x) * cos(x)",
+        "(x + 1) * (x + 1) / ((x + 1) * 2 + 1)",
+        "clamp(x * 0.5, 0, 1) + clamp(x * 0.5, 0, 1) * 2 + abs(-3)",
+        "pow(x, 2) + pow(x, 2) + sqrt(pow(x, 2))",
+    };
+    std::vector<double> xs, results;
+    for (double x = 0.25; x < 8.0; x += 0.5) {
+        xs.push_back(x);
+    }
+    results.resize(xs.size());
+    for (const auto* expr : exprs) {
+        ez::Expr raw, opt;
+        raw.setOptimization(false).parse(expr);
+        opt.parse(expr);
+        CTEST_ASSERT(opt.getOptimizedNodesCount() < raw.getOptimizedNodesCount());
+        opt.bindArray("x", xs.data()).evalArrays(results.data(), xs.size());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            const double expected = raw.set("x", xs[i]).eval().getResult();
+            CTEST_ASSERT(opt.set("x", xs[i]).eval().getResult() == expected);
+            CTEST_ASSERT(opt.evalCompiled().getResult() == expected);
+            CTEST_ASSERT(results[i] == expected);
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//// ENTRY POINT ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+bool TestEzExpr_Optimizations(const std::string& vTest) {
+    IfTestExist(TestEzExpr_Optimizations_ConstantFolding);
+    else IfTestExist(TestEzExpr_Optimizations_ConstantFolding_Functions);
+    else IfTestExist(TestEzExpr_Optimizations_SharedSubTrees);
+    else IfTestExist(TestEzExpr_Optimizations_SharedSubTrees_Eval);
+    else IfTestExist(TestEzExpr_Optimizations_Disabled);
+    else IfTestExist(TestEzExpr_Optimizations_UserFunctionsKept);
+    else IfTestExist(TestEzExpr_Optimizations_FoldingKeepsErrors);
+    else IfTestExist(TestEzExpr_Optimizations_SameResults);
+    // default
+    return false;
+}
@@ -30,14 +30,17 @@ SOFTWARE.
 #include <cassert>
 #include <chrono>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 static bool Bench(const std::string& vEzExpr,
-                  const std::function<double(ez::Expr& vEv, double)>& vEzExprIteration,
+                  const std::function<ez::Expr&(ez::Expr& vEv, double)>& vEzExprBinding,
                   const std::function<double(double)>& vCppExpr,
                   int vIterations,
                   double slowdownThreshold,
                   double& vOutEzExprTotalTime,
                   double& vOutEzExprAvgTime,
+                  double& vOutEzExprCompiledTotalTime,
                   double& vOutCppTotalTime,
                   double& vOutCppAvgTime,
                   std::ostream* outputStreamPtr) {
@@ -47,6 +50,7 @@ static bool Bench(const std::string& vEzExpr,
         ev.parse(vEzExpr);
 
         double ezExprAccumulation = 0.0;
+        double ezExprCompiledAccumulation = 0.0;
         double cppExprAccumulation = 0.0;
         double tmp;
 
@@ -55,12 +59,24 @@ static bool Bench(const std::string& vEzExpr,
         for (int j = 0; j < vIterations; ++j) {
             for (int i = 0; i < vIterations; ++i) {
                 tmp = i;
-                ezExprAccumulation += vEzExprIteration(ev, tmp);
+                ezExprAccumulation += vEzExprBinding(ev, tmp).eval().getResult();
             }
         }
         auto end_ez = std::chrono::high_resolution_clock::now();
         vOutEzExprTotalTime = std::chrono::duration<double, std::milli>(end_ez - start_ez).count();
 
+        // EzExpr Compiled Eval
+        ev.compile();
+        auto start_ez_compiled = std::chrono::high_resolution_clock::now();
+        for (int j = 0; j < vIterations; ++j) {
+            for (int i = 0; i < vIterations; ++i) {
+                tmp = i;
+                ezExprCompiledAccumulation += vEzExprBinding(ev, tmp).evalCompiled().getResult();
+            }
+        }
+        auto end_ez_compiled = std::chrono::high_resolution_clock::now();
+        vOutEzExprCompiledTotalTime = std::chrono::duration<double, std::milli>(end_ez_compiled - start_ez_compiled).count();
+
         // Cpp Eval
         auto start_cpp = std::chrono::high_resolution_clock::now();
         for (int j = 0; j < vIterations; ++j) {
@@ -73,14 +89,17 @@ static bool Bench(const std::string& vEzExpr,
         vOutCppTotalTime = std::chrono::duration<double, std::milli>(end_cpp - start_cpp).count();
 
         double slowdown_total_percentage = ((vOutEzExprTotalTime / vOutCppTotalTime) - 1.0) * 100.0;
+        double compiled_speedup = vOutEzExprTotalTime / vOutEzExprCompiledTotalTime;
 
         if (outputStreamPtr != nullptr) {
             (*outputStreamPtr) <<                                            //
                 "| " << vEzExpr <<                                           //
                 " | " << std::floor(vOutEzExprTotalTime * 100.0) / 100.0 <<  //
+                " | " << std::floor(vOutEzExprCompiledTotalTime * 100.0) / 100.0 <<  //
                 " | " << std::floor(vOutCppTotalTime * 100.0) / 100.0 <<     //
                 " | " << slowdown_total_percentage <<                        //
-                "% |\n";
+                "% | x" << std::floor(compiled_speedup * 100.0) / 100.0 <<  //
+                " |\n";
         }
 
         // the test will always been true, the goal is to geenrete a report
@@ -96,6 +115,13 @@ static bool Bench(const std::string& vEzExpr,
             }
             return false;
         }
+        if (ezExprCompiledAccumulation != ezExprAccumulation) {
+            if (outputStreamPtr != nullptr) {  //
+                (*outputStreamPtr) << "| " <<  //
+                    vEzExpr << " | Compiled accumulation mismatch |" << std::endl;
+            }
+            return false;
+        }
 
         return true;
     } catch (const std::exception& e) {
@@ -109,209 +135,321 @@ static bool Bench(const std::string& vEzExpr,
 ////////////////////////////////////////////////////////////////////////////
 
 bool TestEzExpr_Perfos_x_squared(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "x * x",  //
-        [](ez::Expr& ev, double t) { return ev.set("x", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("x", t); },
         [](double t) { return t * t; },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_x_cubed(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "x * x * x",  //
-        [](ez::Expr& ev, double t) { return ev.set("x", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("x", t); },
         [](double t) { return t * t * t; },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_sin_x(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "sin(x)",  //
-        [](ez::Expr& ev, double t) { return ev.set("x", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("x", t); },
         [](double t) { return std::sin(t); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_sqrt_x(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "sqrt(x)",  //
-        [](ez::Expr& ev, double t) { return ev.set("x", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("x", t); },
         [](double t) { return std::sqrt(t); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_cos_x_sin_y(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "cos(x) * sin(y)",  //
-        [](ez::Expr& ev, double t) { return ev.set("x", t).set("y", t + 1.0).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("x", t).set("y", t + 1.0); },
         [](double t) { return std::cos(t) * std::sin(t + 1.0); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_a_plus_5(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "a + 5",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return t + 5.0; },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_5_plus_a_plus_5(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "5 + a + 5",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return 5.0 + t + 5.0; },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_abs_a_plus_5(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "abs(a + 5)",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return std::abs(t + 5.0); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_a_plus_5_times_2(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "(a + 5) * 2",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return (t + 5.0) * 2.0; },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_a_plus_5_times_2_alt(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "a + (5 * 2)",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return t + (5.0 * 2.0); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_sqrt_pow_a(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "sqrt(pow(a, 1.5) + pow(a, 2.5))",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return std::sqrt(std::pow(t, 1.5) + std::pow(t, 2.5)); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
 bool TestEzExpr_Perfos_complex_fraction(double slowdownThreshold, int iterations, std::ostream* outputStreamPtr) {
-    double ez_expr_total_time, ez_expr_avg_time;
+    double ez_expr_total_time, ez_expr_avg_time, ez_expr_compiled_total_time;
     double cpp_expr_total_time, cpp_expr_avg_time;
 
     return Bench(
         "(1/(a + 1) + 2/(a + 2) + 3/(a + 3))",  //
-        [](ez::Expr& ev, double t) { return ev.set("a", t).eval().getResult(); },
+        [](ez::Expr& ev, double t) -> ez::Expr& { return ev.set("a", t); },
         [](double t) { return (1.0 / (t + 1.0)) + (2.0 / (t + 2.0)) + (3.0 / (t + 3.0)); },
         iterations,
         slowdownThreshold,
         ez_expr_total_time,
         ez_expr_avg_time,
+        ez_expr_compiled_total_time,
         cpp_expr_total_time,
         cpp_expr_avg_time,
         outputStreamPtr);
 }
 
+// per row (set + eval) vs batched (bindArray + evalArrays) evaluation of 1M rows
+bool TestEzExpr_Perfos_Batch_1M(double /*slowdownThreshold*/, int /*iterations*/, std::ostream* outputStreamPtr) {
+    try {
+        const std::string expr = "sin(x) * y + t * 0.5 - sqrt(abs(x - y)) / (1 + x * x)";
+        const size_t count = 1000000U;
+        std::vector<double> xs(count), ys(count), rowResults(count), batchResults(count);
+        for (size_t i = 0; i < count; ++i) {
+            xs[i] = static_cast<double>(i % 1000) * 0.01;
+            ys[i] = static_cast<double>(i % 777) * 0.02;
+        }
+        ez::Expr ev;
+        ev.parse(expr).set("t", 3.0).compile();
+
+        // per row
+        auto start_row = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            rowResults[i] = ev.set("x", xs[i]).set("y", ys[i]).evalCompiled().getResult();
+        }
+        auto end_row = std::chrono::high_resolution_clock::now();
+        const double rowTime = std::chrono::duration<double, std::milli>(end_row - start_row).count();
+
+        // batched
+        auto start_batch = std::chrono::high_resolution_clock::now();
+        ev.bindArray("x", xs.data()).bindArray("y", ys.data()).evalArrays(batchResults.data(), count);
+        auto end_batch = std::chrono::high_resolution_clock::now();
+        const double batchTime = std::chrono::duration<double, std::milli>(end_batch - start_batch).count();
+
+        if (outputStreamPtr != nullptr) {
+            (*outputStreamPtr) <<                                                        //
+                "| " << expr <<                                                          //
+                " | " << count <<                                                        //
+                " | " << std::floor(rowTime * 100.0) / 100.0 <<                          //
+                " | " << std::floor(batchTime * 100.0) / 100.0 <<                        //
+                " | " << std::floor(count / (rowTime * 1000.0) * 100.0) / 100.0 <<       //
+                " | " << std::floor(count / (batchTime * 1000.0) * 100.0) / 100.0 <<     //
+                " | x" << std::floor(rowTime / batchTime * 100.0) / 100.0 << " |\n";
+        }
+
+        return (rowResults == batchResults);
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// throughput of one shared program evaluated by 1 to N threads, each one with its own ExprContext
+bool TestEzExpr_Perfos_MultiThreads(double /*slowdownThreshold*/, int iterations, std::ostream* outputStreamPtr) {
+    try {
+        const std::string expr = "sqrt(pow(a, 1.5) + pow(a, 2.5))";
+        ez::Expr ev;
+        const auto program = ev.parse(expr).getSharedProgram();
+        const size_t evalsPerThread = static_cast<size_t>(iterations) * static_cast<size_t>(iterations);
+        size_t maxThreads = std::thread::hardware_concurrency();
+        if (maxThreads == 0U) {
+            maxThreads = 4U;
+        }
+        double expected = 0.0;
+        for (size_t i = 0; i < evalsPerThread; ++i) {
+            expected += ev.set("a", static_cast<double>(i % 1000U)).evalCompiled().getResult();
+        }
+        bool res = true;
+        for (size_t threadsCount = 1U; threadsCount <= maxThreads; threadsCount *= 2U) {
+            std::vector<double> sums(threadsCount, 0.0);
+            std::vector<std::thread> threads;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < threadsCount; ++t) {
+                threads.emplace_back([&program, &sums, t, evalsPerThread]() {
+                    ez::ExprContext ctx(program);
+                    const size_t slot = ctx.getSlot("a");
+                    double sum = 0.0;
+                    for (size_t i = 0; i < evalsPerThread; ++i) {
+                        sum += ctx.setSlot(slot, static_cast<double>(i % 1000U)).eval().getResult();
+                    }
+                    sums[t] = sum;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            const double time = std::chrono::duration<double, std::milli>(end - start).count();
+            for (const auto sum : sums) {
+                res &= (sum == expected);
+            }
+            if (outputStreamPtr != nullptr) {
+                const double totalEvals = static_cast<double>(evalsPerThread * threadsCount);
+                (*outputStreamPtr) <<                                                    //
+                    "| " << expr <<                                                      //
+                    " | " << threadsCount <<                                             //
+                    " | " << std::floor(time * 100.0) / 100.0 <<                         //
+                    " | " << std::floor(totalEvals / (time * 1000.0) * 100.0) / 100.0 << " |\n";
+            }
+        }
+        return res;
+    } catch (const std::exception& e) {
+        std::cerr << "An error occurred: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool TestEzExpr_Perfos_All(double slowdownThreshold, int iterations) {
     bool res = true;
 
@@ -320,8 +458,8 @@ bool TestEzExpr_Perfos_All(double slowdownThreshold, int iterations) {
 
     if (resultsFile.is_open()) {
         // Imprimer l'en-tête du tableau
-        resultsFile << "| Expression | EzExpr Total Time (ms) | C++ Total Time (ms) | Slowdown (%) |\n";
-        resultsFile << "|------------|------------------|-----------------|----------------|--------------|---------------------|-------------------|\n";
+        resultsFile << "| Expression | EzExpr Total Time (ms) | EzExpr Compiled Total Time (ms) | C++ Total Time (ms) | Slowdown (%) | Compiled Speedup |\n";
+        resultsFile << "|------------|------------------------|---------------------------------|---------------------|--------------|------------------|\n";
 
         // Exécution des tests
         res &= TestEzExpr_Perfos_x_squared(slowdownThreshold, iterations, &resultsFile);
@@ -337,6 +475,14 @@ bool TestEzExpr_Perfos_All(double slowdownThreshold, int iterations) {
         res &= TestEzExpr_Perfos_sqrt_pow_a(slowdownThreshold, iterations, &resultsFile);
         res &= TestEzExpr_Perfos_complex_fraction(slowdownThreshold, iterations, &resultsFile);
 
+        resultsFile << "\n| Expression | Rows | Per Row Time (ms) | Batched Time (ms) | Per Row (MRows/s) | Batched (MRows/s) | Batched Speedup |\n";
+        resultsFile << "|------------|------|-------------------|-------------------|-------------------|-------------------|-----------------|\n";
+        res &= TestEzExpr_Perfos_Batch_1M(slowdownThreshold, iterations, &resultsFile);
+
+        resultsFile << "\n| Expression | Threads | Total Time (ms) | Throughput (MEvals/s) |\n";
+        resultsFile << "|------------|---------|-----------------|-----------------------|\n";
+        res &= TestEzExpr_Perfos_MultiThreads(slowdownThreshold, iterations, &resultsFile);
+
         resultsFile.close();  // Fermer le fichier après les tests
     } else {
         std::cerr << "Failed to open results file." << std::endl;
@@ -374,6 +520,8 @@ bool TestEzExpr_Perfos(const std::string& vTest) {
     else IfTestBenchExist(TestEzExpr_Perfos_a_plus_5_times_2_alt);
     else IfTestBenchExist(TestEzExpr_Perfos_sqrt_pow_a);
     else IfTestBenchExist(TestEzExpr_Perfos_complex_fraction);
+    else IfTestBenchExist(TestEzExpr_Perfos_Batch_1M);
+    else IfTestBenchExist(TestEzExpr_Perfos_MultiThreads);
     // default
     return false;
 }
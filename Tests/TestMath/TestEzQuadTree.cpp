@@ -0,0 +1,491 @@
+#include <TestEzQuadTree.h>
+#include <ezlibs/ezMath.hpp>
+#include <ezlibs/ezQuadTree.hpp>
+#include <ezlibs/ezCTest.hpp>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#pragma warning(disable : 4305)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+static std::vector<ez::vec2<T>> s_RandomPoints(const size_t vCount, const unsigned vSeed) {
+    std::mt19937 gen(vSeed);
+    std::uniform_real_distribution<double> dist(0.0, 1000.0);
+    std::vector<ez::vec2<T>> res;
+    res.reserve(vCount);
+    for (size_t i = 0; i < vCount; ++i) {
+        res.push_back(ez::vec2<T>(static_cast<T>(dist(gen)), static_cast<T>(dist(gen))));
+    }
+    return res;
+}
+
+template <typename T>
+static T s_DistSq(const ez::vec2<T>& a, const ez::vec2<T>& b) {
+    const T dx = a.x - b.x;
+    const T dy = a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+// distances of the k nearest points, by brute force
+template <typename T>
+static std::vector<T> s_BruteForceKnn(const std::vector<ez::vec2<T>>& vPoints, const ez::vec2<T>& vPt, const size_t vK) {
+    std::vector<T> dists;
+    dists.reserve(vPoints.size());
+    for (const auto& p : vPoints) {
+        dists.push_back(s_DistSq(p, vPt));
+    }
+    std::sort(dists.begin(), dists.end());
+    if (dists.size() > vK) {
+        dists.resize(vK);
+    }
+    return dists;
+}
+
+template <typename T>
+static std::vector<T> s_Dists(const std::vector<ez::vec2<T>>& vPoints, const ez::vec2<T>& vPt) {
+    std::vector<T> res;
+    for (const auto& p : vPoints) {
+        res.push_back(s_DistSq(p, vPt));
+    }
+    return res;
+}
+
+template <typename T>
+bool TestEzQuadTree_Knn_BruteForce() {
+    const auto points = s_RandomPoints<T>(5000U, 42U);
+    ez::QuadTree<T> tree(0, 1000, 0, 1000, 8);
+    for (const auto& p : points) {
+        CTEST_ASSERT(tree.insert(p));
+    }
+    const auto queries = s_RandomPoints<T>(50U, 7U);
+    for (const auto& q : queries) {
+        for (const size_t k : {1U, 5U, 32U}) {
+            const auto res = tree.getNNeighboors(q, k);
+            CTEST_ASSERT(res.size() == k);
+            CTEST_ASSERT(s_Dists(res, q) == s_BruteForceKnn(points, q, k));  // same distances, sorted
+        }
+    }
+    // a query outside the tree boundary
+    const ez::vec2<T> outside(-500, 1500);
+    CTEST_ASSERT(s_Dists(tree.getNNeighboors(outside, 10U), outside) == s_BruteForceKnn(points, outside, 10U));
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Knn_Limits() {
+    ez::QuadTree<T> tree(0, 100, 0, 100, 4);
+    CTEST_ASSERT(tree.getNNeighboors(ez::vec2<T>(50, 50), 3U).empty());
+    CTEST_ASSERT(tree.insert(ez::vec2<T>(10, 10)));
+    CTEST_ASSERT(tree.insert(ez::vec2<T>(20, 20)));
+    CTEST_ASSERT(tree.insert(ez::vec2<T>(90, 90)));
+    CTEST_ASSERT(!tree.insert(ez::vec2<T>(200, 90)));  // outside
+    CTEST_ASSERT(tree.getNNeighboors(ez::vec2<T>(50, 50), 0U).empty());
+    const auto all = tree.getNNeighboors(ez::vec2<T>(0, 0), 10U);
+    CTEST_ASSERT(all.size() == 3U);
+    CTEST_ASSERT(all[0] == ez::vec2<T>(10, 10));
+    CTEST_ASSERT(all[1] == ez::vec2<T>(20, 20));
+    CTEST_ASSERT(all[2] == ez::vec2<T>(90, 90));
+    CTEST_ASSERT(tree.remove(ez::vec2<T>(10, 10)));
+    const auto one = tree.getNNeighboors(ez::vec2<T>(0, 0), 1U);
+    CTEST_ASSERT(one.size() == 1U);
+    CTEST_ASSERT(one[0] == ez::vec2<T>(20, 20));
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Radius_BruteForce() {
+    const auto points = s_RandomPoints<T>(5000U, 3U);
+    ez::QuadTree<T> tree(0, 1000, 0, 1000, 8);
+    for (const auto& p : points) {
+        CTEST_ASSERT(tree.insert(p));
+    }
+    const auto queries = s_RandomPoints<T>(50U, 11U);
+    for (const auto& q : queries) {
+        for (const T radius : {static_cast<T>(0), static_cast<T>(10), static_cast<T>(75)}) {
+            std::vector<T> expected;
+            for (const auto& p : points) {
+                const T d = s_DistSq(p, q);
+                if (d <= radius * radius) {
+                    expected.push_back(d);
+                }
+            }
+            std::sort(expected.begin(), expected.end());
+            CTEST_ASSERT(s_Dists(tree.getPointsInRadius(q, radius), q) == expected);
+        }
+    }
+    CTEST_ASSERT(tree.getPointsInRadius(ez::vec2<T>(500, 500), static_cast<T>(-1)).empty());
+    CTEST_ASSERT(tree.getPointsInRadius(ez::vec2<T>(500, 500), static_cast<T>(2000)).size() == points.size());
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Bulk_BruteForce() {
+    auto points = s_RandomPoints<T>(5000U, 5U);
+    points.push_back(ez::vec2<T>(2000, 2000));  // outside, ignored
+    ez::QuadTree<T> tree(0, 1000, 0, 1000, points, 8);
+    points.pop_back();
+    CTEST_ASSERT(tree.size() == points.size());
+    const auto queries = s_RandomPoints<T>(50U, 13U);
+    for (const auto& q : queries) {
+        for (const size_t k : {1U, 5U, 32U}) {
+            CTEST_ASSERT(s_Dists(tree.getNNeighboors(q, k), q) == s_BruteForceKnn(points, q, k));
+        }
+        std::vector<T> expected;
+        for (const auto& p : points) {
+            const T d = s_DistSq(p, q);
+            if (d <= static_cast<T>(50 * 50)) {
+                expected.push_back(d);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        CTEST_ASSERT(s_Dists(tree.getPointsInRadius(q, static_cast<T>(50)), q) == expected);
+    }
+    CTEST_ASSERT(tree.getPointsInRadius(ez::vec2<T>(500, 500), static_cast<T>(2000)).size() == points.size());
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Bulk_Edit() {
+    auto points = s_RandomPoints<T>(2000U, 17U);
+    ez::QuadTree<T> tree(0, 1000, 0, 1000, points, 4);
+    // remove half of the points, move a quarter and insert new ones
+    for (size_t i = 0; i < 1000U; ++i) {
+        CTEST_ASSERT(tree.remove(points[i]));
+    }
+    CTEST_ASSERT(!tree.remove(points[0]));
+    points.erase(points.begin(), points.begin() + 1000);
+    const auto moved = s_RandomPoints<T>(500U, 19U);
+    for (size_t i = 0; i < moved.size(); ++i) {
+        CTEST_ASSERT(tree.move(points[i], moved[i]));
+        points[i] = moved[i];
+    }
+    for (const auto& p : s_RandomPoints<T>(3000U, 23U)) {
+        CTEST_ASSERT(tree.insert(p));
+        points.push_back(p);
+    }
+    CTEST_ASSERT(tree.size() == points.size());
+    const auto queries = s_RandomPoints<T>(30U, 29U);
+    for (const auto& q : queries) {
+        CTEST_ASSERT(s_Dists(tree.getNNeighboors(q, 20U), q) == s_BruteForceKnn(points, q, 20U));
+    }
+    // compaction keeps the same content
+    tree.rebuild();
+    CTEST_ASSERT(tree.size() == points.size());
+    for (const auto& q : queries) {
+        CTEST_ASSERT(s_Dists(tree.getNNeighboors(q, 20U), q) == s_BruteForceKnn(points, q, 20U));
+    }
+    tree.clear();
+    CTEST_ASSERT(tree.size() == 0U);
+    CTEST_ASSERT(tree.getNNeighboors(queries[0], 3U).empty());
+    return true;
+}
+
+// the ranges of points freed by the insert/remove/move are reused, so the points arena stays bounded
+template <typename T>
+bool TestEzQuadTree_Arena_Churn() {
+    ez::QuadTree<T> small(0, 100, 0, 100, 4);
+    const auto five = s_RandomPoints<T>(5U, 31U);
+    size_t arenaSize = 0U;
+    for (size_t round = 0; round < 10000U; ++round) {
+        for (const auto& p : five) {
+            CTEST_ASSERT(small.insert(ez::vec2<T>(p.x / 10, p.y / 10)));
+        }
+        for (const auto& p : five) {
+            CTEST_ASSERT(small.remove(ez::vec2<T>(p.x / 10, p.y / 10)));
+        }
+        if (round == 0U) {
+            arenaSize = small.arenaSize();
+        }
+    }
+    CTEST_ASSERT(small.size() == 0U);
+    CTEST_ASSERT(small.arenaSize() == arenaSize);
+    // random moves of built and inserted points
+    auto points = s_RandomPoints<T>(1000U, 37U);
+    ez::QuadTree<T> tree(0, 1000, 0, 1000, points, 4);
+    for (const auto& p : s_RandomPoints<T>(500U, 41U)) {
+        CTEST_ASSERT(tree.insert(p));
+        points.push_back(p);
+    }
+    std::mt19937 gen(43U);
+    std::uniform_real_distribution<double> dist(-20.0, 20.0);
+    size_t maxArenaSize = 0U;
+    for (size_t round = 0; round < 200U; ++round) {
+        for (auto& p : points) {
+            const ez::vec2<T> to(  //
+                static_cast<T>(ez::clamp<double>(p.x + dist(gen), 0.0, 1000.0)),
+                static_cast<T>(ez::clamp<double>(p.y + dist(gen), 0.0, 1000.0)));
+            CTEST_ASSERT(tree.move(p, to));
+            p = to;
+        }
+        if (round == 20U) {
+            maxArenaSize = tree.arenaSize() * 2U;
+        } else if (round > 20U) {
+            CTEST_ASSERT(tree.arenaSize() <= maxArenaSize);
+        }
+    }
+    CTEST_ASSERT(tree.size() == points.size());
+    for (const auto& q : s_RandomPoints<T>(30U, 47U)) {
+        CTEST_ASSERT(s_Dists(tree.getNNeighboors(q, 20U), q) == s_BruteForceKnn(points, q, 20U));
+    }
+    return true;
+}
+
+// many identical points must not subdivide forever
+template <typename T>
+bool TestEzQuadTree_Bulk_Duplicates() {
+    const std::vector<ez::vec2<T>> points(100U, ez::vec2<T>(10, 10));
+    ez::QuadTree<T> bulk(0, 100, 0, 100, points, 4);
+    CTEST_ASSERT(bulk.size() == 100U);
+    ez::QuadTree<T> tree(0, 100, 0, 100, 4);
+    for (const auto& p : points) {
+        CTEST_ASSERT(tree.insert(p));
+    }
+    CTEST_ASSERT(tree.getPointsInRadius(ez::vec2<T>(10, 10), static_cast<T>(0)).size() == 100U);
+    CTEST_ASSERT(bulk.getNNeighboors(ez::vec2<T>(0, 0), 200U).size() == 100U);
+    for (size_t i = 0; i < 100U; ++i) {
+        CTEST_ASSERT(tree.remove(points[i]));
+    }
+    CTEST_ASSERT(!tree.remove(points[0]));
+    CTEST_ASSERT(tree.size() == 0U);
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Payload_Basis() {
+    const auto points = s_RandomPoints<T>(3000U, 31U);
+    std::vector<uint32_t> ids(points.size());
+    for (uint32_t i = 0; i < ids.size(); ++i) {
+        ids[i] = i;
+    }
+    ez::QuadTree<T, uint32_t> bulk(0, 1000, 0, 1000, points, ids, 8);
+    ez::QuadTree<T, uint32_t> tree(0, 1000, 0, 1000, 8);
+    for (uint32_t i = 0; i < ids.size(); ++i) {
+        CTEST_ASSERT(tree.insert(points[i], ids[i]));
+    }
+    // each neighbor comes with its own id
+    const auto queries = s_RandomPoints<T>(30U, 37U);
+    bool idsOk = true;
+    for (const auto& q : queries) {
+        std::vector<T> dists;
+        auto check = [&](const ez::vec2<T>& vPoint, const uint32_t& vId) {
+            dists.push_back(s_DistSq(vPoint, q));
+            idsOk &= (points[vId] == vPoint);
+        };
+        tree.forEachNNeighboor(q, 10U, check);
+        CTEST_ASSERT(dists == s_BruteForceKnn(points, q, 10U));
+        dists.clear();
+        bulk.forEachNNeighboor(q, 10U, check);
+        CTEST_ASSERT(dists == s_BruteForceKnn(points, q, 10U));
+        size_t count = 0U;
+        bulk.forEachInRadius(q, static_cast<T>(40), [&](const ez::vec2<T>& vPoint, const uint32_t& vId) {
+            idsOk &= (points[vId] == vPoint);
+            ++count;
+        });
+        CTEST_ASSERT(count == tree.getPointsInRadius(q, static_cast<T>(40)).size());
+    }
+    CTEST_ASSERT(idsOk);
+    // same position, different payloads
+    const ez::vec2<T> pos(500, 500);
+    CTEST_ASSERT(tree.insert(pos, 100000U));
+    CTEST_ASSERT(tree.insert(pos, 100001U));
+    CTEST_ASSERT(!tree.remove(pos, 100002U));
+    CTEST_ASSERT(tree.remove(pos, 100001U));
+    const ez::vec2<T> newPos(1, 2);
+    CTEST_ASSERT(tree.move(pos, 100000U, newPos));
+    CTEST_ASSERT(!tree.move(pos, 100000U, newPos));
+    uint32_t found = 0U;
+    tree.forEachNNeighboor(newPos, 1U, [&found](const ez::vec2<T>&, const uint32_t& vId) { found = vId; });
+    CTEST_ASSERT(found == 100000U);
+    // move without payload keeps it, and so does rebuild
+    CTEST_ASSERT(tree.move(points[5], ez::vec2<T>(999, 999)));
+    tree.rebuild();
+    CTEST_ASSERT(tree.size() == points.size() + 1U);
+    tree.forEachNNeighboor(ez::vec2<T>(999, 999), 1U, [&found](const ez::vec2<T>&, const uint32_t& vId) { found = vId; });
+    CTEST_ASSERT(found == 5U);
+    tree.forEachNNeighboor(newPos, 1U, [&found](const ez::vec2<T>&, const uint32_t& vId) { found = vId; });
+    CTEST_ASSERT(found == 100000U);
+    return true;
+}
+
+template <typename T>
+bool TestEzQuadTree_Rect_BruteForce() {
+    const auto points = s_RandomPoints<T>(5000U, 41U);
+    std::vector<uint32_t> ids(points.size());
+    for (uint32_t i = 0; i < ids.size(); ++i) {
+        ids[i] = i;
+    }
+    ez::QuadTree<T, uint32_t> tree(0, 1000, 0, 1000, points, ids, 8);
+    ez::QuadTree<T> bare(0, 1000, 0, 1000, 8);
+    for (const auto& p : points) {
+        CTEST_ASSERT(bare.insert(p));
+    }
+    const auto corners = s_RandomPoints<T>(100U, 43U);
+    for (size_t c = 0; c + 1 < corners.size(); c += 2) {
+        ez::AABB<T> rect;
+        rect.Set(corners[c], corners[c + 1]);
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < points.size(); ++i) {
+            if (rect.ContainsPoint(points[i])) {
+                expected.push_back(i);
+            }
+        }
+        std::vector<uint32_t> found;
+        tree.forEachInRect(rect, [&found](const ez::vec2<T>&, const uint32_t& vId) { found.push_back(vId); });
+        std::sort(found.begin(), found.end());
+        CTEST_ASSERT(found == expected);
+        size_t count = 0U;
+        bare.forEachInRect(rect, [&count, &rect](const ez::vec2<T>& vPoint) {
+            count += rect.ContainsPoint(vPoint) ? 1U : 0U;
+        });
+        CTEST_ASSERT(count == expected.size());
+        CTEST_ASSERT(bare.getPointsInRect(rect).size() == expected.size());
+    }
+    // whole tree, and outside of it
+    CTEST_ASSERT(tree.getPointsInRect(ez::AABB<T>(ez::vec2<T>(-10, -10), ez::vec2<T>(2000, 2000))).size() == points.size());
+    CTEST_ASSERT(tree.getPointsInRect(ez::AABB<T>(ez::vec2<T>(1500, 1500), ez::vec2<T>(2000, 2000))).empty());
+    return true;
+}
+
+// kNN query time vs point count, compared to a full sort of the points (the former implementation)
+bool TestEzQuadTree_Perfos_Knn() {
+    std::ostringstream report;
+    report << "## ezQuadTree kNN (k = 16)" << std::endl << std::endl;
+    report << "| points | build ms | kNN us/query | radius us/query | full sort us/query |" << std::endl;
+    report << "|--------|----------|--------------|-----------------|--------------------|" << std::endl;
+    for (const size_t count : {10000U, 100000U, 1000000U, 10000000U}) {
+        const auto points = s_RandomPoints<double>(count, 1U);
+        const auto queries = s_RandomPoints<double>(200U, 2U);
+        auto start = std::chrono::steady_clock::now();
+        ez::QuadTree<double> tree(0, 1000, 0, 1000, 16);
+        for (const auto& p : points) {
+            tree.insert(p);
+        }
+        const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        size_t found = 0U;
+        start = std::chrono::steady_clock::now();
+        for (const auto& q : queries) {
+            found += tree.getNNeighboors(q, 16U).size();
+        }
+        const double knnUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries.size();
+        CTEST_ASSERT(found == queries.size() * 16U);
+        const double radius = std::sqrt(16.0 / count * 1000.0 * 1000.0 / 3.14159);  // ~16 points
+        start = std::chrono::steady_clock::now();
+        for (const auto& q : queries) {
+            found += tree.getPointsInRadius(q, radius).size();
+        }
+        const double radiusUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries.size();
+        std::string sortUs = "-";
+        if (count <= 100000U) {
+            std::vector<ez::vec2<double>> all;
+            start = std::chrono::steady_clock::now();
+            for (const auto& q : queries) {
+                all = points;
+                std::sort(all.begin(), all.end(), [&q](const ez::vec2<double>& a, const ez::vec2<double>& b) { return s_DistSq(a, q) < s_DistSq(b, q); });
+                all.resize(16U);
+            }
+            sortUs = std::to_string(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries.size());
+        }
+        report << "| " << count << " | " << buildMs << " | " << knnUs << " | " << radiusUs << " | " << sortUs << " |" << std::endl;
+    }
+    std::cout << report.str();
+#ifdef RESULTS_PATH
+    std::ofstream resultsFile(RESULTS_PATH "quadtree_benchmark_results.md");
+    resultsFile << report.str();
+#endif
+    return true;
+}
+
+// build time of a bulk built tree vs one point at a time, and kNN time on each
+bool TestEzQuadTree_Perfos_Build() {
+    std::ostringstream report;
+    report << "## ezQuadTree build (capacity = 16, k = 16)" << std::endl << std::endl;
+    report << "| points | insert build ms | bulk build ms | kNN us/query (inserted) | kNN us/query (bulk) |" << std::endl;
+    report << "|--------|-----------------|---------------|-------------------------|---------------------|" << std::endl;
+    for (const size_t count : {10000U, 100000U, 1000000U, 10000000U}) {
+        const auto points = s_RandomPoints<double>(count, 1U);
+        const auto queries = s_RandomPoints<double>(1000U, 2U);
+        auto start = std::chrono::steady_clock::now();
+        ez::QuadTree<double> inserted(0, 1000, 0, 1000, 16);
+        for (const auto& p : points) {
+            inserted.insert(p);
+        }
+        const double insertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        ez::QuadTree<double> bulk(0, 1000, 0, 1000, points, 16);
+        const double bulkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        CTEST_ASSERT(inserted.size() == bulk.size());
+        double knnUs[2] = {};
+        const ez::QuadTree<double>* trees[2] = {&inserted, &bulk};
+        for (size_t t = 0; t < 2U; ++t) {
+            size_t found = 0U;
+            start = std::chrono::steady_clock::now();
+            for (const auto& q : queries) {
+                found += trees[t]->getNNeighboors(q, 16U).size();
+            }
+            knnUs[t] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries.size();
+            CTEST_ASSERT(found == queries.size() * 16U);
+        }
+        report << "| " << count << " | " << insertMs << " | " << bulkMs << " | " << knnUs[0] << " | " << knnUs[1] << " |" << std::endl;
+    }
+    std::cout << report.str();
+#ifdef RESULTS_PATH
+    std::ofstream resultsFile(RESULTS_PATH "quadtree_build_benchmark_results.md");
+    resultsFile << report.str();
+#endif
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+#define IfTestExist(v)            \
+    if (vTest == std::string(#v)) \
+    return v()
+
+bool TestEzQuadTree(const std::string& vTest) {
+    IfTestExist(TestEzQuadTree_Knn_BruteForce<float>);
+    else IfTestExist(TestEzQuadTree_Knn_BruteForce<double>);
+    else IfTestExist(TestEzQuadTree_Knn_Limits<float>);
+    else IfTestExist(TestEzQuadTree_Knn_Limits<double>);
+    else IfTestExist(TestEzQuadTree_Radius_BruteForce<float>);
+    else IfTestExist(TestEzQuadTree_Radius_BruteForce<double>);
+    else IfTestExist(TestEzQuadTree_Bulk_BruteForce<float>);
+    else IfTestExist(TestEzQuadTree_Bulk_BruteForce<double>);
+    else IfTestExist(TestEzQuadTree_Bulk_Edit<float>);
+    else IfTestExist(TestEzQuadTree_Bulk_Edit<double>);
+    else IfTestExist(TestEzQuadTree_Bulk_Duplicates<float>);
+    else IfTestExist(TestEzQuadTree_Bulk_Duplicates<double>);
+    else IfTestExist(TestEzQuadTree_Arena_Churn<float>);
+    else IfTestExist(TestEzQuadTree_Arena_Churn<double>);
+    else IfTestExist(TestEzQuadTree_Payload_Basis<float>);
+    else IfTestExist(TestEzQuadTree_Payload_Basis<double>);
+    else IfTestExist(TestEzQuadTree_Rect_BruteForce<float>);
+    else IfTestExist(TestEzQuadTree_Rect_BruteForce<double>);
+    else IfTestExist(TestEzQuadTree_Perfos_Knn);
+    else IfTestExist(TestEzQuadTree_Perfos_Build);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool TestEzQuadTree(const std::string& vTest);
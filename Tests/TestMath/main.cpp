@@ -7,6 +7,7 @@
 #include <TestEzQuat.h>
 #include <TestEzAABB.h>
 #include <TestEzExpr.h>
+#include <TestEzQuadTree.h>
 
 #include <limits>
 #include <cmath>
@@ -25,6 +26,7 @@ bool TestMisc(const std::string& vTest) {
     IfTestCollectionExist(TestEzQuat);
     IfTestCollectionExist(TestEzAABB);
     IfTestCollectionExist(TestEzExpr);
+    IfTestCollectionExist(TestEzQuadTree);
     return false;
 }
 
@@ -0,0 +1,258 @@
+#include <ezlibs/ezHash.hpp>
+#include <ezlibs/ezCTest.hpp>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+// Desactivation des warnings de conversion
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244)  // Conversion from 'double' to 'float', possible loss of data
+#pragma warning(disable : 4305)  // Truncation from 'double' to 'float'
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+static std::vector<uint8_t> s_GetDatas(size_t vSize) {
+    std::vector<uint8_t> ret(vSize);
+    for (size_t i = 0; i < vSize; ++i) {
+        ret[i] = static_cast<uint8_t>((static_cast<uint64_t>(i) * 2654435761ULL) >> 13);
+    }
+    return ret;
+}
+
+struct HashVector {
+    size_t len;
+    uint64_t seed;
+    uint64_t xxh64;
+    uint64_t xxh128High;
+    uint64_t xxh128Low;
+};
+
+// given by the reference implementation, for each size ranges of the algos
+static const HashVector s_HashVectors[] = {
+    {0U, 0x0ULL, 0xef46db3751d8e999ULL, 0x99aa06d3014798d8ULL, 0x6001c324468d497fULL},
+    {1U, 0x0ULL, 0xe934a84adb052768ULL, 0xa6cd5e9392000f6aULL, 0xc44bdff4074eecdbULL},
+    {2U, 0x0ULL, 0x0cd811486f07af67ULL, 0x59264f999f5b7151ULL, 0x1ca5cfa6a6d57dc2ULL},
+    {3U, 0x0ULL, 0x28823e205e353f69ULL, 0x95c705060a313bf8ULL, 0xa1c4a8259b827291ULL},
+    {4U, 0x0ULL, 0x91b65bbe720c34cfULL, 0xafbf64f9281b8de2ULL, 0xfde8d93ae8794d8eULL},
+    {5U, 0x0ULL, 0x31fce8da85d2b801ULL, 0xa872e23fe3235763ULL, 0x2be2d19951c07993ULL},
+    {7U, 0x0ULL, 0xe2400cdea02ee3c5ULL, 0xc64dca5a80a280cbULL, 0x75c20f7ea6fdec78ULL},
+    {8U, 0x0ULL, 0x521fd2878ea69d17ULL, 0x2761698c33953c43ULL, 0x0234362aaf47b71aULL},
+    {9U, 0x0ULL, 0x192535de38f73596ULL, 0x0d39db6431d37a74ULL, 0x895c8a562da51412ULL},
+    {12U, 0x0ULL, 0x3fb737ea78f531bbULL, 0x2bc81486652df906ULL, 0xbf890582d2f3aa52ULL},
+    {15U, 0x0ULL, 0x4ee77ab371d06e31ULL, 0x25bce72548003f03ULL, 0xebab99da883ac189ULL},
+    {16U, 0x0ULL, 0xb1a375c6bd6ba7afULL, 0x29be75b0bbbb5284ULL, 0xaafffcec5df2cb27ULL},
+    {17U, 0x0ULL, 0xbbe746d4e95f47ccULL, 0xdb7e8f77961e47fdULL, 0x878751509ecfdb8bULL},
+    {31U, 0x0ULL, 0xb74baa9042b94deeULL, 0xc7d62971fdc7cbdeULL, 0xf165f912bffdeb23ULL},
+    {32U, 0x0ULL, 0x4e13111ced6f735dULL, 0x3e97336e6cbb6ee0ULL, 0xde94574d7a589440ULL},
+    {33U, 0x0ULL, 0xf7b9faf20b3bce63ULL, 0x3411cfe692c2e51eULL, 0xe2928442749dbe83ULL},
+    {63U, 0x0ULL, 0x35f935e6044a08adULL, 0x7799ae11f05a258aULL, 0xfb05e0b272e66ddfULL},
+    {64U, 0x0ULL, 0xcd91daec2c21766fULL, 0x4928933168865587ULL, 0x66fa129223be93a5ULL},
+    {65U, 0x0ULL, 0x7c795c59456ed577ULL, 0xb6dfa5aac5c63dc2ULL, 0xf5b4ade8de9a76a3ULL},
+    {96U, 0x0ULL, 0x00943940f9ef4f42ULL, 0xe83e939b9571947cULL, 0xb9de9a9696c420fcULL},
+    {97U, 0x0ULL, 0x8e5c56c72a19b963ULL, 0xdd6ad8d4fb1433a9ULL, 0x8ea932450271fde4ULL},
+    {127U, 0x0ULL, 0x181ccdafb569956cULL, 0x4e3b459b60f6cafaULL, 0x8dc4748447f5628bULL},
+    {128U, 0x0ULL, 0x0f9f33b4fe066f05ULL, 0xba44fd018231af4cULL, 0xbbe087d879edcc78ULL},
+    {129U, 0x0ULL, 0x7ba4d2a5203763c7ULL, 0x522c922743fd67f1ULL, 0xb8075934107218e5ULL},
+    {160U, 0x0ULL, 0x95af5fdc901cfe5aULL, 0xb5514c067fd62918ULL, 0x0e08f445e497507aULL},
+    {200U, 0x0ULL, 0xdc2d5a9de81b7d4cULL, 0xfc856e6538fc9e49ULL, 0x293b2bb62ee3d385ULL},
+    {239U, 0x0ULL, 0x832a938c3b13127bULL, 0xc1e42329e230196fULL, 0x964c0b96c0e4e615ULL},
+    {240U, 0x0ULL, 0x1fa3ded0daf320b7ULL, 0x4f49ccc8526aa7adULL, 0x407883ea5ef95b9aULL},
+    {241U, 0x0ULL, 0xa6401b72569001b5ULL, 0x50b62ee1ee6455a7ULL, 0xbc424a2c480dd281ULL},
+    {255U, 0x0ULL, 0xfed0a69e11176032ULL, 0x13c4fb2eb194824fULL, 0x155baa5891f7606fULL},
+    {256U, 0x0ULL, 0x3dfddfd156d0783bULL, 0x20d618055259b36cULL, 0x2d040b1ab40f0d78ULL},
+    {257U, 0x0ULL, 0x953c769d8249d780ULL, 0x06d2f2dce7891e45ULL, 0xd0515fbec69efb50ULL},
+    {300U, 0x0ULL, 0x09238f35b40d0b40ULL, 0x9c23dfbc2e994472ULL, 0x8aedfd28145098a4ULL},
+    {511U, 0x0ULL, 0x5b68b365a6ada75bULL, 0x738e1d88a23cff63ULL, 0xf3848293e35ddb39ULL},
+    {512U, 0x0ULL, 0xf41bf38cfc37ff54ULL, 0x17d1143c4bfb7ce0ULL, 0x17ec4809d1a9ad43ULL},
+    {1023U, 0x0ULL, 0xda55b6e13352bc48ULL, 0xd34ef4f411b9a93eULL, 0x3071307bafa2f8f4ULL},
+    {1024U, 0x0ULL, 0x36b9a9162057f968ULL, 0x53bd178b75ab292eULL, 0x1fd15e7d36f5e1bcULL},
+    {1025U, 0x0ULL, 0x54d532ec3bac8bebULL, 0xd1ad5f4a3cce4374ULL, 0xfe08e5a874d23fd2ULL},
+    {2047U, 0x0ULL, 0x0dd37b878114ac9eULL, 0x02ee993d673c5657ULL, 0x00e9914a63660650ULL},
+    {2048U, 0x0ULL, 0xfffc2d88824db985ULL, 0x2e141090da5502aaULL, 0x81ec4a6a9ee23d55ULL},
+    {4099U, 0x0ULL, 0x5542cac97dc1842eULL, 0x372dc0b3d3eb9f9eULL, 0x67f2d25f6ba6562eULL},
+    {16384U, 0x0ULL, 0x6224816ed13e7deaULL, 0x9b6bf9aa8795f12fULL, 0x7388b93f4bfa5aeeULL},
+    {100003U, 0x0ULL, 0x3b98e4b47391ed90ULL, 0x19bacb7bf95a97eaULL, 0x25ba638a3c66d20fULL},
+    {0U, 0x9e3779b97f4a7c15ULL, 0xc4349fc93c010000ULL, 0xd142977a2cca554bULL, 0x4ca5176998171787ULL},
+    {1U, 0x9e3779b97f4a7c15ULL, 0x126bb57a12364aa5ULL, 0xe366b8c99a31df50ULL, 0x062b185e4e01441aULL},
+    {2U, 0x9e3779b97f4a7c15ULL, 0xf6f6678d026ce93bULL, 0xd63543b0064fdff5ULL, 0xe0bd22ab7317af96ULL},
+    {3U, 0x9e3779b97f4a7c15ULL, 0x3c78e47f8d9d625fULL, 0x3c583043ae3ec80eULL, 0x2c0f411a2c50b127ULL},
+    {4U, 0x9e3779b97f4a7c15ULL, 0x4fb638bfcfa1c0ccULL, 0x3c53fd28a4bcda94ULL, 0x4a10995d638a994eULL},
+    {5U, 0x9e3779b97f4a7c15ULL, 0x53b039d71580e7d4ULL, 0xfe702997fbc7f0f5ULL, 0x831b5e0cad180873ULL},
+    {7U, 0x9e3779b97f4a7c15ULL, 0x037801de732c7eb3ULL, 0xd1ec5de817129a2dULL, 0x3e797dad82e1a712ULL},
+    {8U, 0x9e3779b97f4a7c15ULL, 0x87c89248cf142c8bULL, 0x9d0c98607e7f886eULL, 0xac8ad9e866a0b8c8ULL},
+    {9U, 0x9e3779b97f4a7c15ULL, 0x5c1e79f7f405f40cULL, 0xcc06703115906de9ULL, 0x9ceeec552c902473ULL},
+    {12U, 0x9e3779b97f4a7c15ULL, 0xc0a6c2b770e85451ULL, 0x959135edf0f69be7ULL, 0x95248dfc81969385ULL},
+    {15U, 0x9e3779b97f4a7c15ULL, 0x7346a4900c6215b8ULL, 0x550fcd6de87d3184ULL, 0x4a819cd58153301eULL},
+    {16U, 0x9e3779b97f4a7c15ULL, 0xb99387526a9a127eULL, 0x58c47d96b734dfa2ULL, 0x4184fcb27ec83364ULL},
+    {17U, 0x9e3779b97f4a7c15ULL, 0xfa64237e310484e4ULL, 0x046dc26326b17f23ULL, 0x3c579f4313655434ULL},
+    {31U, 0x9e3779b97f4a7c15ULL, 0x2c8fa6d44ca89e82ULL, 0x42e4ebf31cd1ba9cULL, 0x74dc985b50ace5a2ULL},
+    {32U, 0x9e3779b97f4a7c15ULL, 0x3a5e73ddfe641a94ULL, 0x4f53b32cd772eb7cULL, 0xc600d9d70a3153dfULL},
+    {33U, 0x9e3779b97f4a7c15ULL, 0xdccfc8b6e6f78f10ULL, 0x1d587e2c3cc5d577ULL, 0x09e490b154793257ULL},
+    {63U, 0x9e3779b97f4a7c15ULL, 0xb3fcaa593c0c5edfULL, 0x87a6c4b1ea7b8ed4ULL, 0x0f34c372481e6dd2ULL},
+    {64U, 0x9e3779b97f4a7c15ULL, 0xb43fbd19c995f89fULL, 0x86b32032544f10a8ULL, 0xa4245b47ed2a7e35ULL},
+    {65U, 0x9e3779b97f4a7c15ULL, 0x487e890c0759525aULL, 0x6bf53bc859caa04aULL, 0x3b8d85a879025e1dULL},
+    {96U, 0x9e3779b97f4a7c15ULL, 0x45b083cb1b01cae0ULL, 0xfdff14438d52ca20ULL, 0x5ca68551efa57780ULL},
+    {97U, 0x9e3779b97f4a7c15ULL, 0x4ecac3300b13d41eULL, 0x1c94ac7508069d60ULL, 0x634c5d24ca0f56faULL},
+    {127U, 0x9e3779b97f4a7c15ULL, 0xc0a6b758665c27b0ULL, 0x1e9595b17334feaaULL, 0x32383c2204fafd2fULL},
+    {128U, 0x9e3779b97f4a7c15ULL, 0x1ab71bffa2364eeeULL, 0xb3ce7d70100aecb2ULL, 0xe5d58a12ecbbc415ULL},
+    {129U, 0x9e3779b97f4a7c15ULL, 0x16ef28d3e8fbf11aULL, 0xffbad2a7b15c96a4ULL, 0xa161c7ab356d129aULL},
+    {160U, 0x9e3779b97f4a7c15ULL, 0xf0f7b50a08371e9aULL, 0x39b31cd6ac6ba109ULL, 0x9c751b9997374f58ULL},
+    {200U, 0x9e3779b97f4a7c15ULL, 0xf56d922243452f33ULL, 0xaef5fc8ee09d7ff5ULL, 0x5a3edf0619b0bbfaULL},
+    {239U, 0x9e3779b97f4a7c15ULL, 0x006c577b8f2c9b25ULL, 0xa39f7207feb2dc86ULL, 0x76772e2c08b6544fULL},
+    {240U, 0x9e3779b97f4a7c15ULL, 0x83be76824b9a7da3ULL, 0x3eea9e0467dc0187ULL, 0xb97819e2dceb8523ULL},
+    {241U, 0x9e3779b97f4a7c15ULL, 0x8697dd0f1dfe0c1cULL, 0x0f899b32ec0df0d9ULL, 0xdbcb360abf2ca85dULL},
+    {255U, 0x9e3779b97f4a7c15ULL, 0x671624ef73114b71ULL, 0xcc390fa56a92f68dULL, 0x6b281c5f1253f92bULL},
+    {256U, 0x9e3779b97f4a7c15ULL, 0x766ad8f2e6158db8ULL, 0x1e88035cabaa3fb1ULL, 0xc9ff3e475003261fULL},
+    {257U, 0x9e3779b97f4a7c15ULL, 0xe852677c800c6debULL, 0xe55733493dd4d068ULL, 0x987dfd4f1d950785ULL},
+    {300U, 0x9e3779b97f4a7c15ULL, 0x36b7d9b71f2022cdULL, 0xdfc563e17147adebULL, 0xfad1a5605aa99567ULL},
+    {511U, 0x9e3779b97f4a7c15ULL, 0x97b17df46cb9550dULL, 0xf63d846f022e228eULL, 0x0de15a19c685df22ULL},
+    {512U, 0x9e3779b97f4a7c15ULL, 0x5462d89f1dff31f6ULL, 0xa203fbd68e19f647ULL, 0x0bd264522bb7f27cULL},
+    {1023U, 0x9e3779b97f4a7c15ULL, 0x11c52c8ce820b1c8ULL, 0x7c3a063d76550e3fULL, 0x98a3eb21a6568011ULL},
+    {1024U, 0x9e3779b97f4a7c15ULL, 0x4591f7f46dbc53b6ULL, 0xcf4085274abbf647ULL, 0x249cd8f9ad0ea839ULL},
+    {1025U, 0x9e3779b97f4a7c15ULL, 0x431d322b0f7f06a5ULL, 0xd70f8dc91c37b48aULL, 0x455ead76fa138d0aULL},
+    {2047U, 0x9e3779b97f4a7c15ULL, 0x9a80409a6b302ba2ULL, 0xac7310ca298946d9ULL, 0x25d719934f094310ULL},
+    {2048U, 0x9e3779b97f4a7c15ULL, 0x17afe9adace56874ULL, 0xf4649ce72cc55b54ULL, 0xdf66bcf56366e0fbULL},
+    {4099U, 0x9e3779b97f4a7c15ULL, 0x908c1ca6ecbb9ef7ULL, 0x0bd6cec1c749c791ULL, 0x03af9c51d789f00eULL},
+    {16384U, 0x9e3779b97f4a7c15ULL, 0x4406fe18bf78a292ULL, 0xf3a922e0fb91e87fULL, 0x6c69089c796986cfULL},
+    {100003U, 0x9e3779b97f4a7c15ULL, 0xcb0c372ebb6f889cULL, 0xa2790be05a55aecdULL, 0x65679fa500f43e0eULL},
+};
+
+bool TestEzHash_Xxh64() {
+    CTEST_ASSERT(ez::xxh64("").finalize().getHex() == "ef46db3751d8e999");
+    CTEST_ASSERT(ez::xxh64("abc").finalize().getHex() == "44bc2cf5ad770999");
+    for (const auto &vec : s_HashVectors) {
+        const auto datas = s_GetDatas(vec.len);
+        CTEST_ASSERT(ez::xxh64::hash(datas.data(), datas.size(), vec.seed) == vec.xxh64);
+    }
+    return true;
+}
+
+bool TestEzHash_Xxh128() {
+    CTEST_ASSERT(ez::xxh128("").finalize().getHex() == "99aa06d3014798d86001c324468d497f");
+    CTEST_ASSERT(ez::xxh128("abc").finalize().getHex() == "06b05ab6733a618578af5f94892f3950");
+    for (const auto &vec : s_HashVectors) {
+        const auto datas = s_GetDatas(vec.len);
+        const auto oneShot = ez::xxh128::hash(datas.data(), datas.size(), vec.seed);
+        CTEST_ASSERT(oneShot.high == vec.xxh128High);
+        CTEST_ASSERT(oneShot.low == vec.xxh128Low);
+        CTEST_ASSERT(ez::xxh128(vec.seed).add(datas.data(), datas.size()).finalize().getValue() == oneShot);
+    }
+    return true;
+}
+
+// same hash whatever the cut of the datas
+template <typename T>
+static bool s_TestHashSplit() {
+    const auto datas = s_GetDatas(5000);
+    for (const size_t size : {0U, 3U, 16U, 31U, 32U, 33U, 240U, 241U, 255U, 256U, 257U, 511U, 512U, 513U, 1024U, 1025U, 5000U}) {
+        const auto expected = T(42U).add(datas.data(), size).finalize().getHex();
+        for (const size_t step : {1U, 7U, 64U, 100U, 256U, 300U}) {
+            T hasher(42U);
+            for (size_t offset = 0; offset < size; offset += step) {
+                hasher.add(datas.data() + offset, std::min(step, size - offset));
+            }
+            CTEST_ASSERT(hasher.finalize().getHex() == expected);
+        }
+        // the hash can be read in the middle of the stream
+        T hasher(42U);
+        hasher.add(datas.data(), size / 2U).finalize();
+        CTEST_ASSERT(hasher.add(datas.data() + size / 2U, size - size / 2U).finalize().getHex() == expected);
+        CTEST_ASSERT(hasher.reset(42U).add(datas.data(), size).finalize().getHex() == expected);
+    }
+    return true;
+}
+
+bool TestEzHash_Split() {
+    CTEST_ASSERT(s_TestHashSplit<ez::xxh64>());
+    CTEST_ASSERT(s_TestHashSplit<ez::xxh128>());
+    CTEST_ASSERT(ez::xxh64("TOTO").addValue(15).finalize().getHex() == ez::xxh64("TOTO15").finalize().getHex());
+    CTEST_ASSERT(ez::xxh128("TOTO").addValue(1.5).finalize().getHex() == ez::xxh128("TOTO1.5").finalize().getHex());
+    return true;
+}
+
+bool TestEzHash_HashFile() {
+    std::string datas;
+    for (size_t i = 0; i < 100000U; ++i) {
+        datas += std::to_string(i * 7U);
+    }
+    const std::string filePathName = std::string(RESULTS_PATH) + "hash_file.bin";
+    {
+        std::ofstream file(filePathName, std::ios::out | std::ios::binary);
+        file.write(datas.data(), static_cast<std::streamsize>(datas.size()));
+    }
+    CTEST_ASSERT(ez::xxh64::hashFile(filePathName) == ez::xxh64(datas).finalize().getHex());
+    CTEST_ASSERT(ez::xxh128::hashFile(filePathName, 1000U) == ez::xxh128(datas).finalize().getHex());
+    CTEST_ASSERT(ez::xxh128::hashFile("not_existing_file.bin").empty());
+    return true;
+}
+
+// throughput on big and small datas
+bool TestEzHash_Perfos() {
+    const auto datas = s_GetDatas(64U * 1024U * 1024U);
+    auto measure = [&datas](const std::string &vName, std::function<std::string()> vHash) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto hex = vHash();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << vName << " : " << (double)datas.size() / seconds / 1e9 << " GB/s (" << hex.substr(0, 8) << ")" << std::endl;
+    };
+    measure("xxh64          ", [&datas]() { return ez::xxh64().add(datas.data(), datas.size()).finalize().getHex(); });
+    measure("xxh128         ", [&datas]() { return ez::xxh128().add(datas.data(), datas.size()).finalize().getHex(); });
+    measure("xxh64  32 bytes", [&datas]() {
+        uint64_t ret = 0U;
+        for (size_t offset = 0; offset + 32U <= datas.size(); offset += 32U) {
+            ret += ez::xxh64::hash(datas.data() + offset, 32U);
+        }
+        return std::to_string(ret);
+    });
+    measure("xxh128 32 bytes", [&datas]() {
+        uint64_t ret = 0U;
+        for (size_t offset = 0; offset + 32U <= datas.size(); offset += 32U) {
+            ret += ez::xxh128::hash(datas.data() + offset, 32U).low;
+        }
+        return std::to_string(ret);
+    });
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#define IfTestExist(v)            \
+    if (vTest == std::string(#v)) \
+    return v()
+
+bool TestEzHash(const std::string& vTest) {
+    IfTestExist(TestEzHash_Xxh64);
+    else IfTestExist(TestEzHash_Xxh128);
+    else IfTestExist(TestEzHash_Split);
+    else IfTestExist(TestEzHash_HashFile);
+    else IfTestExist(TestEzHash_Perfos);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
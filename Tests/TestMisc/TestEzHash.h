@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool TestEzHash(const std::string& vTest);
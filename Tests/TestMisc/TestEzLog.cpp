@@ -3,6 +3,14 @@
 #include <ezlibs/ezCTest.hpp>
 
 #include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -102,6 +110,373 @@ bool TestEzLog_CloseAndReopen() {
     return true;
 }
 
+// discard the console output of the benchmarks
+class NullStreamBuf : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+bool TestEzLog_Async_AllRecordsWritten() {
+    ez::Log log;
+    std::atomic<size_t> count{0U};
+    log.setStandardLogMessageFunctor([&count](const int&, const std::string&) { ++count; });
+    CTEST_ASSERT(log.startAsync(16U, ez::Log::OverflowPolicy::BLOCK));
+    CTEST_ASSERT(log.isAsync());
+    CTEST_ASSERT(!log.startAsync());  // already started
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4U; ++t) {
+        threads.emplace_back([&log, t]() {
+            for (int i = 0; i < 500; ++i) {
+                log.logSimpleStringByType(ez::Log::LOGGING_MESSAGE_TYPE_INFOS, "thread %u message %i", (uint32_t)t, i);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    log.flushAsync();
+    CTEST_ASSERT(count.load() == 2000U);
+    log.stopAsync();
+    CTEST_ASSERT(!log.isAsync());
+    CTEST_ASSERT(log.getAsyncDroppedCount() == 0U);
+    log.logSimpleString("synchronous again");
+    CTEST_ASSERT(count.load() == 2001U);
+    log.setStandardLogMessageFunctor(nullptr);
+    return true;
+}
+
+bool TestEzLog_Async_KeepsTypeAndOrder() {
+    ez::Log log;
+    std::vector<int> types;
+    std::vector<std::string> msgs;
+    log.setStandardLogMessageFunctor([&](const int& vType, const std::string& vMsg) {
+        types.push_back(vType);
+        msgs.push_back(vMsg);
+    });
+    CTEST_ASSERT(log.startAsync(4U));
+    log.logSimpleStringByType(ez::Log::LOGGING_MESSAGE_TYPE_WARNING, "first");
+    log.logStringByTypeWithFunction(ez::Log::LOGGING_MESSAGE_TYPE_ERROR, "TestFunction", 42, "second %i", 2);
+    log.logSimpleString("third");
+    log.stopAsync();
+    CTEST_ASSERT(msgs.size() == 3U);
+    CTEST_ASSERT(types[0] == ez::Log::LOGGING_MESSAGE_TYPE_WARNING);
+    CTEST_ASSERT(types[1] == ez::Log::LOGGING_MESSAGE_TYPE_ERROR);
+    CTEST_ASSERT(types[2] == 0);
+    CTEST_ASSERT(msgs[0].find("first") != std::string::npos);
+    CTEST_ASSERT(msgs[1].find("[TestFunction:42] second 2") != std::string::npos);
+    CTEST_ASSERT(msgs[2].find("third") != std::string::npos);
+    log.setStandardLogMessageFunctor(nullptr);
+    return true;
+}
+
+// the functor holds the writer thread until released, so the queue fills up
+static bool s_TestAsyncOverflow(const ez::Log::OverflowPolicy vPolicy) {
+    ez::Log log;
+    std::atomic<bool> release{false};
+    std::atomic<bool> writerBusy{false};
+    std::vector<std::string> msgs;
+    log.setStandardLogMessageFunctor([&](const int&, const std::string& vMsg) {
+        writerBusy = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        msgs.push_back(vMsg);
+    });
+    CTEST_ASSERT(log.startAsync(8U, vPolicy));
+    log.logSimpleString("message %i", 0);
+    while (!writerBusy.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 1; i < 100; ++i) {
+        log.logSimpleString("message %i", i);
+    }
+    const size_t dropped = log.getAsyncDroppedCount();
+    CTEST_ASSERT(dropped == 100U - 1U - 8U);  // one in the writer, 8 in the queue
+    release = true;
+    log.stopAsync();
+    CTEST_ASSERT(msgs.size() + dropped == 100U);
+    CTEST_ASSERT(msgs[0].find("message 0") != std::string::npos);
+    if (vPolicy == ez::Log::OverflowPolicy::DROP) {
+        CTEST_ASSERT(msgs.back().find("message 8") != std::string::npos);  // the newest are lost
+    } else {
+        CTEST_ASSERT(msgs.back().find("message 99") != std::string::npos);  // the oldest are lost
+        CTEST_ASSERT(msgs[1].find("message 92") != std::string::npos);
+    }
+    log.setStandardLogMessageFunctor(nullptr);
+    return true;
+}
+
+bool TestEzLog_Async_Drop() {
+    return s_TestAsyncOverflow(ez::Log::OverflowPolicy::DROP);
+}
+
+bool TestEzLog_Async_DropOldest() {
+    return s_TestAsyncOverflow(ez::Log::OverflowPolicy::DROP_OLDEST);
+}
+
+// mean latency of a log call seen by the producers, synchronous vs async, with 1, 4 and 16 threads
+bool TestEzLog_Async_Perfos() {
+    const int countPerThread = 2000;
+    NullStreamBuf nullBuf;
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+    report << "| threads | sync ns/call | async ns/call | speedup |" << std::endl;
+    report << "|---------|--------------|---------------|---------|" << std::endl;
+    for (const size_t threadsCount : {1U, 4U, 16U}) {
+        double nsPerCall[2] = {0.0, 0.0};
+        for (size_t mode = 0; mode < 2U; ++mode) {
+            ez::Log log;
+            std::atomic<size_t> count{0U};
+            log.setStandardLogMessageFunctor([&count](const int&, const std::string&) { ++count; });
+            if (mode == 1U) {
+                CTEST_ASSERT(log.startAsync(8192U, ez::Log::OverflowPolicy::BLOCK));
+            }
+            auto* coutBuf = std::cout.rdbuf(&nullBuf);
+            std::atomic<int64_t> totalNs{0};
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < threadsCount; ++t) {
+                threads.emplace_back([&log, &totalNs, t]() {
+                    const auto start = std::chrono::steady_clock::now();
+                    for (int i = 0; i < countPerThread; ++i) {
+                        log.logStringByTypeWithFunction(ez::Log::LOGGING_MESSAGE_TYPE_INFOS, "Perfos", 42, "thread %u value %i", (uint32_t)t, i);
+                    }
+                    const auto end = std::chrono::steady_clock::now();
+                    totalNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                });
+            }
+            for (auto& th : threads) {
+                th.join();
+            }
+            log.stopAsync();
+            std::cout.rdbuf(coutBuf);
+            CTEST_ASSERT(count.load() == threadsCount * countPerThread);
+            nsPerCall[mode] = (double)totalNs.load() / (double)(threadsCount * countPerThread);
+            log.setStandardLogMessageFunctor(nullptr);
+        }
+        report << "| " << threadsCount << " | " << nsPerCall[0] << " | " << nsPerCall[1] << " | " << nsPerCall[0] / nsPerCall[1] << "x |" << std::endl;
+    }
+    std::cout << report.str();
+    return true;
+}
+
+bool TestEzLog_History_Capacity() {
+    ez::Log log;
+    auto* coutBuf = std::cout.rdbuf(nullptr);
+    log.setHistoryCapacity(3U);
+    CTEST_ASSERT(log.getHistoryCapacity() == 3U);
+    for (int i = 0; i < 5; ++i) {
+        log.logSimpleString("message %i", i);
+    }
+    CTEST_ASSERT(log.getMessagesCount() == 3U);
+    auto msgs = log.getMessages();
+    CTEST_ASSERT(msgs.size() == 3U);
+    CTEST_ASSERT(msgs[0].find("message 2") != std::string::npos);
+    CTEST_ASSERT(msgs[2].find("message 4") != std::string::npos);
+    CTEST_ASSERT(log.getMessage(1U).find("message 3") != std::string::npos);
+    CTEST_ASSERT(log.getMessage(3U).empty());
+    // shrinking keeps the newest messages
+    log.setHistoryCapacity(2U);
+    msgs = log.getMessages();
+    CTEST_ASSERT(msgs.size() == 2U);
+    CTEST_ASSERT(msgs[0].find("message 3") != std::string::npos);
+    CTEST_ASSERT(msgs[1].find("message 4") != std::string::npos);
+    log.clearMessages();
+    CTEST_ASSERT(log.getMessagesCount() == 0U);
+    std::cout.rdbuf(coutBuf);
+    return true;
+}
+
+static size_t s_GetFileSize(const std::string& vFilePathName) {
+    std::ifstream file(vFilePathName, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return 0U;
+    }
+    return (size_t)file.tellg();
+}
+
+static bool s_FileExists(const std::string& vFilePathName) {
+    return std::ifstream(vFilePathName).is_open();
+}
+
+bool TestEzLog_File_RotationBySize() {
+    const std::string path = "TestEzLog_RotationBySize.log";
+    for (size_t i = 0; i < 4U; ++i) {
+        std::remove((i ? path + "." + std::to_string(i) : path).c_str());
+    }
+    auto* coutBuf = std::cout.rdbuf(nullptr);
+    {
+        ez::Log log;
+        CTEST_ASSERT(log.openFile(path, 200U, 0, 2U));
+        for (int i = 0; i < 50; ++i) {
+            log.logSimpleString("rotated message %i", i);
+        }
+        log.close();
+    }
+    std::cout.rdbuf(coutBuf);
+    CTEST_ASSERT(s_FileExists(path));
+    CTEST_ASSERT(s_FileExists(path + ".1"));
+    CTEST_ASSERT(s_FileExists(path + ".2"));
+    CTEST_ASSERT(!s_FileExists(path + ".3"));
+    CTEST_ASSERT(s_GetFileSize(path) > 0U);
+    CTEST_ASSERT(s_GetFileSize(path + ".1") >= 200U);
+    CTEST_ASSERT(s_GetFileSize(path + ".1") < 250U);
+    // the last message is in the current file
+    std::ifstream file(path);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CTEST_ASSERT(content.find("rotated message 49") != std::string::npos);
+    return true;
+}
+
+bool TestEzLog_File_RotationByTime() {
+    const std::string path = "TestEzLog_RotationByTime.log";
+    std::remove(path.c_str());
+    std::remove((path + ".1").c_str());
+    auto* coutBuf = std::cout.rdbuf(nullptr);
+    {
+        ez::Log log;
+        CTEST_ASSERT(log.openFile(path, 0U, 20, 1U));
+        log.logSimpleString("first file");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        log.logSimpleString("second file");
+        log.flushFile();
+        std::cout.rdbuf(coutBuf);
+        std::ifstream file(path + ".1");
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CTEST_ASSERT(content.find("first file") != std::string::npos);
+        std::ifstream file2(path);
+        std::string content2((std::istreambuf_iterator<char>(file2)), std::istreambuf_iterator<char>());
+        CTEST_ASSERT(content2.find("second file") != std::string::npos);
+        CTEST_ASSERT(content2.find("first file") == std::string::npos);
+    }
+    return true;
+}
+
+bool TestEzLog_Binary_Decode() {
+    ez::Log log;
+    log.startBinary(4096U);
+    const std::string str = "std string";
+    char buffer[16] = "char buffer";
+    int value = 7;
+    log.logBinary("int %i, negative %d, unsigned %u, hex 0x%08x", 42, -5, 3000000000U, 255);
+    log.logBinary("int64 %lld, size %zu, short %hd", (long long)-123456789012LL, (size_t)17, (short)-3);
+    log.logBinary("float %.3f, double %g, exp %e", 1.5f, 0.25, 1000.0);
+    log.logBinaryByType(ez::Log::LOGGING_MESSAGE_TYPE_ERROR, "literal %s, string %s, buffer %s, char %c, percent 100%%", "lit", str, buffer, 'A');
+    log.logBinary("ptr %p", (void*)&value);
+    log.logBinary("padded [%5i] [%-4s] [%06.2f]", 3, "ab", 3.14159);
+    log.logBinary("no arguments");
+    log.logBinary("missing %i %i", 1);
+    const auto msgs = log.decodeBinary();
+    CTEST_ASSERT(msgs.size() == 8U);
+    CTEST_ASSERT(msgs[0].find("] int 42, negative -5, unsigned 3000000000, hex 0x000000ff") != std::string::npos);
+    CTEST_ASSERT(msgs[1].find("] int64 -123456789012, size 17, short -3") != std::string::npos);
+    CTEST_ASSERT(msgs[2].find("] float 1.500, double 0.25, exp 1.000000e+03") != std::string::npos);
+    CTEST_ASSERT(msgs[3].find("] literal lit, string std string, buffer char buffer, char A, percent 100%") != std::string::npos);
+    char ptrStr[64];
+    snprintf(ptrStr, 64, "ptr %p", (void*)&value);
+    CTEST_ASSERT(msgs[4].find(ptrStr) != std::string::npos);
+    CTEST_ASSERT(msgs[5].find("] padded [    3] [ab  ] [003.14]") != std::string::npos);
+    CTEST_ASSERT(msgs[6].find("] no arguments") != std::string::npos);
+    CTEST_ASSERT(msgs[7].find("] missing 1 <?>") != std::string::npos);
+    log.resetBinary();
+    CTEST_ASSERT(log.decodeBinary().empty());
+    return true;
+}
+
+bool TestEzLog_Binary_Overflow() {
+    ez::Log log;
+    log.logBinary("not started %i", 1);  // ignored
+    CTEST_ASSERT(log.decodeBinary().empty());
+    log.startBinary(100U);  // records of 24 + 1 + 9 bytes rounded to 40
+    for (int i = 0; i < 5; ++i) {
+        log.logBinary("value %i", i);
+    }
+    CTEST_ASSERT(log.getBinaryDroppedCount() == 3U);
+    const auto msgs = log.decodeBinary();
+    CTEST_ASSERT(msgs.size() == 2U);
+    CTEST_ASSERT(msgs[1].find("value 1") != std::string::npos);
+    return true;
+}
+
+bool TestEzLog_Binary_Threads() {
+    ez::Log log;
+    log.startBinary(1024U * 1024U);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4U; ++t) {
+        threads.emplace_back([&log, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                log.logBinary("thread %u value %i", (uint32_t)t, i);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    const auto msgs = log.decodeBinary();
+    CTEST_ASSERT(msgs.size() == 4000U);
+    CTEST_ASSERT(log.getBinaryDroppedCount() == 0U);
+    size_t count = 0U;
+    for (const auto& msg : msgs) {
+        if (msg.find("thread 2 value 999") != std::string::npos) {
+            ++count;
+        }
+    }
+    CTEST_ASSERT(count == 1U);
+    return true;
+}
+
+bool TestEzLog_Binary_File() {
+    const std::string path = "TestEzLog_Binary.ezlb";
+    std::vector<std::string> expected;
+    {
+        ez::Log log;
+        log.startBinary(4096U);
+        log.logBinary("frame %i took %.2f ms", 10, 16.66);
+        log.logBinary("loaded %s", std::string("texture.png"));
+        log.logBinary("frame %i took %.2f ms", 11, 15.5);
+        expected = log.decodeBinary();
+        CTEST_ASSERT(log.saveBinaryFile(path));
+    }
+    std::vector<std::string> msgs;
+    CTEST_ASSERT(ez::Log::decodeBinaryFile(path, msgs));
+    CTEST_ASSERT(msgs == expected);
+    CTEST_ASSERT(msgs.size() == 3U);
+    CTEST_ASSERT(msgs[2].find("frame 11 took 15.50 ms") != std::string::npos);
+    CTEST_ASSERT(!ez::Log::decodeBinaryFile("TestEzLog_NotExisting.ezlb", msgs));
+    return true;
+}
+
+// cost of a binary log call vs a formatted one
+bool TestEzLog_Binary_Perfos() {
+    const int count = 100000;
+    NullStreamBuf nullBuf;
+    ez::Log log;
+    log.setHistoryCapacity(16U);
+    auto* coutBuf = std::cout.rdbuf(&nullBuf);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        log.logStringWithFunction("Perfos", 42, "frame %i took %.2f ms for %s", i, 16.66, "scene");
+    }
+    const double textNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / count;
+    std::cout.rdbuf(coutBuf);
+    log.startBinary(64U * count);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        log.logBinary("frame %i took %.2f ms for %s", i, 16.66, "scene");
+    }
+    const double binaryNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / count;
+    CTEST_ASSERT(log.getBinaryDroppedCount() == 0U);
+    start = std::chrono::steady_clock::now();
+    const auto msgs = log.decodeBinary();
+    const double decodeNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / count;
+    CTEST_ASSERT(msgs.size() == (size_t)count);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "| text ns/call | binary ns/call | speedup | decode ns/record |" << std::endl;
+    std::cout << "|--------------|----------------|---------|------------------|" << std::endl;
+    std::cout << "| " << textNs << " | " << binaryNs << " | " << textNs / binaryNs << "x | " << decodeNs << " |" << std::endl;
+    return true;
+}
+
 #ifdef _MSC_VER
 bool TestEzLog_GetLastErrorAsString() {
     std::string error = ez::Log::ref().getLastErrorAsString();
@@ -128,6 +503,19 @@ bool TestEzLog(const std::string& vTest) {
     else IfTestExist(TestEzLog_LogDebugMacros);
     else IfTestExist(TestEzLog_CustomLogFunctor);
     else IfTestExist(TestEzLog_CloseAndReopen);
+    else IfTestExist(TestEzLog_Async_AllRecordsWritten);
+    else IfTestExist(TestEzLog_Async_KeepsTypeAndOrder);
+    else IfTestExist(TestEzLog_Async_Drop);
+    else IfTestExist(TestEzLog_Async_DropOldest);
+    else IfTestExist(TestEzLog_Async_Perfos);
+    else IfTestExist(TestEzLog_History_Capacity);
+    else IfTestExist(TestEzLog_File_RotationBySize);
+    else IfTestExist(TestEzLog_File_RotationByTime);
+    else IfTestExist(TestEzLog_Binary_Decode);
+    else IfTestExist(TestEzLog_Binary_Overflow);
+    else IfTestExist(TestEzLog_Binary_Threads);
+    else IfTestExist(TestEzLog_Binary_File);
+    else IfTestExist(TestEzLog_Binary_Perfos);
 #ifdef _MSC_VER
     else IfTestExist(TestEzLog_GetLastErrorAsString);
 #endif
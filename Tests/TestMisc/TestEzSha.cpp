@@ -1,6 +1,12 @@
 #include <ezlibs/ezSha.hpp>
 #include <ezlibs/ezCTest.hpp>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -31,6 +37,104 @@ bool TestEzSha_0() {
     return true;
 }
 
+bool TestEzSha_1() {
+    // FIPS 180 test vectors
+    CTEST_ASSERT(ez::sha1("").finalize().getHex() == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    CTEST_ASSERT(ez::sha1("abc").finalize().getHex() == "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CTEST_ASSERT(ez::sha1("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq").finalize().getHex() == "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    CTEST_ASSERT(ez::sha1(std::string(1000000, 'a')).finalize().getHex() == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+    return true;
+}
+
+bool TestEzSha_256() {
+    // FIPS 180 test vectors
+    CTEST_ASSERT(ez::sha256("").finalize().getHex() == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CTEST_ASSERT(ez::sha256("abc").finalize().getHex() == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CTEST_ASSERT(ez::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq").finalize().getHex() == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CTEST_ASSERT(ez::sha256(std::string(1000000, 'a')).finalize().getHex() == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    CTEST_ASSERT(ez::sha256("TOTO").add("TATA").addValue(15).finalize().getHex() == ez::sha256("TOTOTATA15").finalize().getHex());
+    CTEST_ASSERT(ez::sha256().addValue('c').addValue(2.5).finalize().getHex() == ez::sha256("c2.5").finalize().getHex());
+    return true;
+}
+
+// same hash whatever the cut of the datas, and the kernel used
+template <typename T>
+static bool s_TestShaSplitAndKernels() {
+    std::vector<uint8_t> datas(10000);
+    uint32_t seed = 12345U;
+    for (auto &d : datas) {
+        seed = seed * 1664525U + 1013904223U;
+        d = static_cast<uint8_t>(seed >> 24);
+    }
+    for (const size_t size : {0U, 1U, 55U, 56U, 63U, 64U, 65U, 119U, 120U, 128U, 1000U, 10000U}) {
+        std::string expected;
+        for (const bool hardware : {false, true}) {
+            T::setHardwareAccelerationEnabled(hardware);
+            const auto whole = T().add(datas.data(), size).finalize().getHex();
+            if (expected.empty()) {
+                expected = whole;
+            }
+            CTEST_ASSERT(whole == expected);
+            for (const size_t step : {1U, 7U, 64U, 100U}) {
+                T hasher;
+                for (size_t offset = 0; offset < size; offset += step) {
+                    hasher.add(datas.data() + offset, std::min(step, size - offset));
+                }
+                CTEST_ASSERT(hasher.finalize().getHex() == expected);
+            }
+        }
+    }
+    T::setHardwareAccelerationEnabled(true);
+    return true;
+}
+
+bool TestEzSha_SplitAndKernels() {
+    CTEST_ASSERT(s_TestShaSplitAndKernels<ez::sha1>());
+    CTEST_ASSERT(s_TestShaSplitAndKernels<ez::sha256>());
+    return true;
+}
+
+bool TestEzSha_HashFile() {
+    std::string datas;
+    for (size_t i = 0; i < 100000U; ++i) {
+        datas += std::to_string(i * 7U);
+    }
+    const std::string filePathName = std::string(RESULTS_PATH) + "sha_hash_file.bin";
+    {
+        std::ofstream file(filePathName, std::ios::out | std::ios::binary);
+        file.write(datas.data(), static_cast<std::streamsize>(datas.size()));
+    }
+    CTEST_ASSERT(ez::sha1::hashFile(filePathName) == ez::sha1(datas).finalize().getHex());
+    CTEST_ASSERT(ez::sha256::hashFile(filePathName, 1000U) == ez::sha256(datas).finalize().getHex());
+    CTEST_ASSERT(ez::sha256::hashFile("not_existing_file.bin").empty());
+    return true;
+}
+
+// throughput of the portable and hardware kernels
+bool TestEzSha_Perfos() {
+    const std::vector<uint8_t> datas(32U * 1024U * 1024U, 0x5A);
+    auto measure = [&datas](const std::string &vName, std::function<std::string()> vHash) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto hex = vHash();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << vName << " : " << (double)datas.size() / seconds / 1e9 << " GB/s (" << hex.substr(0, 8) << ")" << std::endl;
+    };
+    for (const bool hardware : {false, true}) {
+        if (hardware && !ez::sha1::isHardwareAccelerationAvailable()) {
+            std::cout << "no hardware acceleration" << std::endl;
+            break;
+        }
+        ez::sha1::setHardwareAccelerationEnabled(hardware);
+        ez::sha256::setHardwareAccelerationEnabled(hardware);
+        const std::string kind = hardware ? " hardware" : " portable";
+        measure("sha1  " + kind, [&datas]() { return ez::sha1().add(datas.data(), datas.size()).finalize().getHex(); });
+        measure("sha256" + kind, [&datas]() { return ez::sha256().add(datas.data(), datas.size()).finalize().getHex(); });
+    }
+    ez::sha1::setHardwareAccelerationEnabled(true);
+    ez::sha256::setHardwareAccelerationEnabled(true);
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -41,6 +145,11 @@ bool TestEzSha_0() {
 
 bool TestEzSha(const std::string& vTest) {
     IfTestExist(TestEzSha_0);
+    else IfTestExist(TestEzSha_1);
+    else IfTestExist(TestEzSha_256);
+    else IfTestExist(TestEzSha_SplitAndKernels);
+    else IfTestExist(TestEzSha_HashFile);
+    else IfTestExist(TestEzSha_Perfos);
     return false;
 }
 
@@ -0,0 +1,406 @@
+#include <TestEzWorkerThread.h>
+#include <ezlibs/ezWorkerThread.hpp>
+#include <ezlibs/ezCTest.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+// Desactivation des warnings de conversion
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#pragma warning(disable : 4305)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+struct JobDatas {
+    size_t count = 0U;
+    double result = 0.0;
+};
+
+// some floating point work, not optimized away
+static double s_Work(const size_t vCount) {
+    double res = 0.0;
+    for (size_t i = 0; i < vCount; ++i) {
+        res += std::sqrt((double)i);
+    }
+    return res;
+}
+
+bool TestEzWorkerThread_Worker_Basis() {
+    ez::thread::Worker worker;
+    JobDatas datas;
+    datas.count = 1000U;
+    bool finished = false;
+    worker.start(
+        "Worker",
+        datas,
+        [](ez::thread::Worker::WorkerIO& vIO) {
+            auto& datas = vIO.get<JobDatas>();
+            vIO.setCurrentPhase("compute");
+            datas.result = s_Work(datas.count);
+            vIO.addProgress(1.0f);
+        },
+        [&finished](ez::thread::Worker::BaseIO& vIO) { finished = (vIO.get<JobDatas>().result > 0.0); });
+    while (worker.isWorking()) {
+        std::this_thread::yield();
+    }
+    worker.finishIfNeeded();
+    CTEST_ASSERT(finished);
+    CTEST_ASSERT(!worker.isRunning());
+    CTEST_ASSERT(worker.getProgress() == 1.0f);
+    return true;
+}
+
+bool TestEzWorkerThread_Pool_Submit() {
+    ez::thread::ThreadPool pool(4U);
+    CTEST_ASSERT(pool.getThreadsCount() == 4U);
+    std::vector<ez::thread::ThreadPool::TaskPtr> tasks;
+    std::atomic<size_t> finishedCount{0U};
+    for (size_t i = 0; i < 16U; ++i) {
+        JobDatas datas;
+        datas.count = 1000U + i;
+        tasks.push_back(pool.submit(
+            "Task",
+            datas,
+            [](ez::thread::Worker::WorkerIO& vIO) {
+                auto& datas = vIO.get<JobDatas>();
+                vIO.setCurrentPhase("compute");
+                datas.result = s_Work(datas.count);
+                vIO.addProgress(1.0f);
+            },
+            [&finishedCount](ez::thread::Worker::BaseIO&) { ++finishedCount; }));
+    }
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        auto& task = tasks[i];
+        task->wait();
+        CTEST_ASSERT(task->getState() == ez::thread::ThreadPool::Task::State::DONE);
+        CTEST_ASSERT(!task->isRunning());
+        CTEST_ASSERT(task->getProgress() == 1.0f);
+        CTEST_ASSERT(task->get<JobDatas>().result == s_Work(1000U + i));
+        CTEST_ASSERT(task->getWorker().getTaskTitle() == "Task");
+        CTEST_ASSERT(task->finishIfNeeded());
+        CTEST_ASSERT(!task->finishIfNeeded());  // once
+    }
+    CTEST_ASSERT(finishedCount == 16U);
+    return true;
+}
+
+bool TestEzWorkerThread_Pool_Cancel() {
+    ez::thread::ThreadPool pool(1U);
+    std::atomic<bool> started{false};
+    bool canceled = false;
+    bool finished = false;
+    auto task = pool.submit(
+        "Endless",
+        0,
+        [&started](ez::thread::Worker::WorkerIO& vIO) {
+            started = true;
+            while (vIO.isRunning()) {
+                std::this_thread::yield();
+            }
+        },
+        [&finished](ez::thread::Worker::BaseIO&) { finished = true; },
+        [&canceled](ez::thread::Worker::BaseIO&) { canceled = true; });
+    // pending behind the endless task, will never run
+    std::atomic<bool> pendingRan{false};
+    auto pending = pool.submit("Pending", 0, [&pendingRan](ez::thread::Worker::WorkerIO&) { pendingRan = true; });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    CTEST_ASSERT(task->getState() == ez::thread::ThreadPool::Task::State::RUNNING);
+    CTEST_ASSERT(pending->cancel());
+    CTEST_ASSERT(task->cancel());
+    CTEST_ASSERT(!task->cancel());
+    CTEST_ASSERT(task->isCanceled());
+    CTEST_ASSERT(canceled);
+    CTEST_ASSERT(!finished);
+    CTEST_ASSERT(!pendingRan);
+    return true;
+}
+
+bool TestEzWorkerThread_Pool_ParallelFor() {
+    ez::thread::ThreadPool pool(4U);
+    const size_t count = 10007U;
+    std::vector<std::atomic<int>> visits(count);
+    for (auto& v : visits) {
+        v = 0;
+    }
+    pool.parallelFor(0U, count, [&visits](const size_t vIdx) { ++visits[vIdx]; });
+    for (const auto& v : visits) {
+        CTEST_ASSERT(v == 1);
+    }
+    // explicit grain, and an offset range
+    std::atomic<size_t> sum{0U};
+    pool.parallelForRange(
+        100U,
+        200U,
+        [&sum](const size_t vFrom, const size_t vTo) {
+            for (size_t i = vFrom; i < vTo; ++i) {
+                sum += i;
+            }
+        },
+        7U);
+    CTEST_ASSERT(sum == 14950U);
+    pool.parallelFor(5U, 5U, [](const size_t) {});  // empty range
+    return true;
+}
+
+bool TestEzWorkerThread_Pool_NestedParallelFor() {
+    ez::thread::ThreadPool pool(2U);
+    std::atomic<size_t> count{0U};
+    std::vector<ez::thread::ThreadPool::TaskPtr> tasks;
+    for (size_t t = 0; t < 4U; ++t) {
+        tasks.push_back(pool.submit("Nested", 0, [&pool, &count](ez::thread::Worker::WorkerIO&) {
+            // runs on a thread of the pool, which helps instead of blocking
+            pool.parallelFor(0U, 1000U, [&count](const size_t) { ++count; });
+        }));
+    }
+    for (auto& task : tasks) {
+        task->wait();
+    }
+    CTEST_ASSERT(count == 4000U);
+    return true;
+}
+
+// a throwing chunk, even on the calling thread, must not return before the other chunks are done
+bool TestEzWorkerThread_Pool_ParallelFor_Exception() {
+    ez::thread::ThreadPool pool(4U);
+    std::atomic<size_t> count{0U};
+    bool thrown = false;
+    try {
+        pool.parallelForRange(
+            0U,
+            1000U,
+            [&count](const size_t vFrom, const size_t vTo) {
+                if (vFrom == 0U) {  // the chunk of the calling thread
+                    throw std::runtime_error("range");
+                }
+                count += vTo - vFrom;
+            },
+            10U);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    CTEST_ASSERT(count == 990U);
+    count = 0U;
+    thrown = false;
+    try {
+        pool.parallelFor(
+            0U,
+            1000U,
+            [&count](const size_t vIdx) {
+                ++count;
+                if (vIdx == 0U || vIdx == 505U) {
+                    throw std::runtime_error("index");
+                }
+            },
+            10U);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CTEST_ASSERT(thrown);
+    CTEST_ASSERT(count == 987U);  // the two throwing chunks stop after 1 and 6 indexs
+    // the pool is still usable
+    count = 0U;
+    pool.parallelFor(0U, 1000U, [&count](const size_t) { ++count; });
+    CTEST_ASSERT(count == 1000U);
+    return true;
+}
+
+// short jobs : a Worker (so a thread) per job vs the pool, and a serial loop vs parallelFor
+bool TestEzWorkerThread_Pool_Perfos() {
+    const size_t jobsCount = 256U;
+    const size_t workPerJob = 20000U;
+    double workerMs = 0.0;
+    double poolMs = 0.0;
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<ez::thread::Worker>> workers;
+        for (size_t i = 0; i < jobsCount; ++i) {
+            workers.emplace_back(new ez::thread::Worker());
+            JobDatas datas;
+            datas.count = workPerJob;
+            workers.back()->start("Job", datas, [](ez::thread::Worker::WorkerIO& vIO) {
+                auto& datas = vIO.get<JobDatas>();
+                datas.result = s_Work(datas.count);
+            });
+        }
+        for (auto& worker : workers) {
+            worker->stop();
+        }
+        workerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    ez::thread::ThreadPool pool;
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<ez::thread::ThreadPool::TaskPtr> tasks;
+        for (size_t i = 0; i < jobsCount; ++i) {
+            JobDatas datas;
+            datas.count = workPerJob;
+            tasks.push_back(pool.submit("Job", datas, [](ez::thread::Worker::WorkerIO& vIO) {
+                auto& datas = vIO.get<JobDatas>();
+                datas.result = s_Work(datas.count);
+            }));
+        }
+        for (auto& task : tasks) {
+            task->wait();
+        }
+        poolMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    const size_t count = 4000000U;
+    std::vector<double> values(count);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::sqrt((double)i);
+    }
+    const double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    pool.parallelFor(0U, count, [&values](const size_t vIdx) { values[vIdx] = std::sqrt((double)vIdx); });
+    const double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CTEST_ASSERT(values[count - 1U] == std::sqrt((double)(count - 1U)));
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "pool threads : " << pool.getThreadsCount() << std::endl;
+    std::cout << "| case | reference ms | pool ms | speedup |" << std::endl;
+    std::cout << "|------|--------------|---------|---------|" << std::endl;
+    std::cout << "| " << jobsCount << " jobs, Worker per job vs pool | " << workerMs << " | " << poolMs << " | " << workerMs / poolMs << "x |" << std::endl;
+    std::cout << "| " << count << " sqrt, serial vs parallelFor | " << serialMs << " | " << parallelMs << " | " << serialMs / parallelMs << "x |" << std::endl;
+    return true;
+}
+
+bool TestEzWorkerThread_Status_Basis() {
+    ez::thread::StatusChannel channel;
+    CTEST_ASSERT(channel.read().version == 0U);
+    CTEST_ASSERT(channel.read().phase[0] == '\0');
+    channel.setPhase("phase");
+    channel.setHeader("header");
+    channel.setMessage("message");
+    const auto& status = channel.read();
+    CTEST_ASSERT(status.version == 3U);
+    CTEST_ASSERT(std::string(status.phase) == "phase");
+    CTEST_ASSERT(std::string(status.header) == "header");
+    CTEST_ASSERT(std::string(status.message) == "message");
+    // the snapshot does not change until the next read
+    channel.set("p", "h", "m");
+    CTEST_ASSERT(std::string(status.phase) == "phase");
+    const auto& status2 = channel.read();
+    CTEST_ASSERT(std::string(status2.phase) == "p");
+    CTEST_ASSERT(std::string(status2.message) == "m");
+    CTEST_ASSERT(status2.version == 4U);
+    // no new publication, same snapshot
+    CTEST_ASSERT(&channel.read() == &status2);
+    // truncated
+    channel.setPhase(std::string(1000U, 'x'));
+    CTEST_ASSERT(std::string(channel.read().phase).size() == ez::thread::StatusChannel::Status::sPHASE_SIZE - 1U);
+    return true;
+}
+
+bool TestEzWorkerThread_Status_Worker() {
+    ez::thread::Worker worker;
+    std::atomic<bool> go{false};
+    worker.start("Status", 0, [&go](ez::thread::Worker::WorkerIO& vIO) {
+        vIO.setCurrentPhase("loading");
+        vIO.setCurrentStatus("parsing", "file", "a.txt");
+        go = true;
+    });
+    worker.stop();
+    CTEST_ASSERT(go);
+    const auto& status = worker.readStatus();
+    CTEST_ASSERT(std::string(status.phase) == "parsing");
+    CTEST_ASSERT(std::string(status.header) == "file");
+    CTEST_ASSERT(std::string(status.message) == "a.txt");
+    return true;
+}
+
+// a producer publishes millions of statuses while the reader checks each snapshot is complete
+bool TestEzWorkerThread_Status_Stress() {
+    const uint64_t count = 2000000U;
+    ez::thread::StatusChannel channel;
+    std::atomic<bool> done{false};
+    double producerNs = 0.0;
+    std::thread producer([&]() {
+        char phase[32], header[32], message[64];
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 1U; i <= count; ++i) {
+            snprintf(phase, 32, "%llu", (unsigned long long)i);
+            snprintf(header, 32, "%llu", (unsigned long long)i);
+            snprintf(message, 64, "message %llu", (unsigned long long)i);
+            channel.set(phase, header, message);
+        }
+        producerNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+        done = true;
+    });
+    uint64_t reads = 0U;
+    uint64_t lastVersion = 0U;
+    bool coherent = true;
+    const auto start = std::chrono::steady_clock::now();
+    while (!done || lastVersion < count) {
+        const auto& status = channel.read();
+        const uint64_t phase = strtoull(status.phase, nullptr, 10);
+        const uint64_t header = strtoull(status.header, nullptr, 10);
+        const uint64_t message = (status.version) ? strtoull(status.message + 8, nullptr, 10) : 0U;
+        coherent &= (status.version >= lastVersion);
+        coherent &= (phase == status.version && header == status.version && message == status.version);
+        lastVersion = status.version;
+        ++reads;
+    }
+    const double readerNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reads;
+    producer.join();
+    CTEST_ASSERT(coherent);
+    CTEST_ASSERT(lastVersion == count);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "updates : " << count << ", reads : " << reads << ", ns/update : " << producerNs << ", ns/read : " << readerNs << std::endl;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#define IfTestExist(v)            \
+    if (vTest == std::string(#v)) \
+    return v()
+
+bool TestEzWorkerThread(const std::string& vTest) {
+    IfTestExist(TestEzWorkerThread_Worker_Basis);
+    else IfTestExist(TestEzWorkerThread_Pool_Submit);
+    else IfTestExist(TestEzWorkerThread_Pool_Cancel);
+    else IfTestExist(TestEzWorkerThread_Pool_ParallelFor);
+    else IfTestExist(TestEzWorkerThread_Pool_ParallelFor_Exception);
+    else IfTestExist(TestEzWorkerThread_Pool_NestedParallelFor);
+    else IfTestExist(TestEzWorkerThread_Pool_Perfos);
+    else IfTestExist(TestEzWorkerThread_Status_Basis);
+    else IfTestExist(TestEzWorkerThread_Status_Worker);
+    else IfTestExist(TestEzWorkerThread_Status_Stress);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool TestEzWorkerThread(const std::string& vTest);
@@ -2,8 +2,11 @@
 #include <ezlibs/ezXml.hpp>
 #include <ezlibs/ezCTest.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <sstream>
 
 // Desactivation des warnings de conversion
 #ifdef _MSC_VER
@@ -279,6 +282,346 @@ bool TestEzXml_ReplaceAll() {
     return true;
 }
 
+bool TestEzXml_Document_ParsingOK() {
+    const auto &doc =
+            u8R"(
+ < config > 
+	<!-- Comment 1 -->
+    <NumberOneLine>60</NumberOneLine>
+    <Tests> 
+	    <!-- Comment 2 -->
+        <Test name="test1" number="50"/>
+        <Test name ="test2" number="100"/>
+        <Test name= "test3" number='150'/>
+        <Test name = "test4" number="200">
+            <SubTest name="subTest1" number="250"/>
+            <SubTest name="subTest2" number="300"/>
+            <bool>false</bool>
+            <bool>true</bool>
+        </Test>
+        <Test/>
+    </Tests>
+</config>
+)";
+    ez::xml::Document xml;
+    CTEST_ASSERT(xml.parseString(doc));
+    CTEST_ASSERT(xml.getRoot().getChildrenCount() == 1U);
+    const auto *config = xml.getRoot().getFirstChild();
+    CTEST_ASSERT(config->getName() == "config");
+    CTEST_ASSERT(config->getParent() == &xml.getRoot());
+    CTEST_ASSERT(config->getChildrenCount() == 3U);
+    const auto *comment = config->getFirstChild();
+    CTEST_ASSERT(comment->getType() == ez::xml::Node::Type::Comment);
+    CTEST_ASSERT(comment->getContent() == "<!-- Comment 1 -->");
+    CTEST_ASSERT(config->getChild("NumberOneLine")->getContent() == "60");
+    const auto *tests = config->getChild("Tests");
+    CTEST_ASSERT(tests != nullptr);
+    CTEST_ASSERT(tests->getChildrenCount() == 6U);
+    const auto *test = tests->getChild("Test");
+    CTEST_ASSERT(test->getAttribute("name") == "test1");
+    CTEST_ASSERT(test->getAttribute("number") == "50");
+    CTEST_ASSERT(!test->isAttributeExist("other"));
+    CTEST_ASSERT(test->getAttribute("other").empty());
+    CTEST_ASSERT(test->getNextSibling()->getAttribute("name") == "test2");
+    CTEST_ASSERT(test->getNextSibling()->getNextSibling()->getAttribute("number") == "150");
+    const auto *test4 = test->getNextSibling()->getNextSibling()->getNextSibling();
+    CTEST_ASSERT(test4->getChildrenCount() == 4U);
+    CTEST_ASSERT(test4->getChild("SubTest")->getAttribute("name") == "subTest1");
+    CTEST_ASSERT(test4->getChild("bool")->getContent() == "false");
+    CTEST_ASSERT(test4->getNextSibling()->getChildrenCount() == 0U);
+    CTEST_ASSERT(test4->getNextSibling()->getNextSibling() == nullptr);
+
+    // same tree than the classic parser
+    const auto node = xml.getRoot().toNode();
+    const auto &configNode = node.getChildren().at(0);
+    CTEST_ASSERT(configNode.getName() == "config");
+    CTEST_ASSERT(configNode.getChildren().size() == 3U);
+    CTEST_ASSERT(configNode.getChildren()[0].getContent() == "<!-- Comment 1 -->");
+    const auto &testsNode = configNode.getChildren()[2];
+    CTEST_ASSERT(testsNode.getChildren().size() == 6U);
+    CTEST_ASSERT(testsNode.getChildren()[1].getParentNodeName() == "Tests");
+    CTEST_ASSERT(testsNode.getChildren()[4].getAttribute("number") == "200");
+    CTEST_ASSERT(testsNode.getChildren()[4].getChildren()[3].getContent() == "true");
+    return true;
+}
+
+bool TestEzXml_Document_Entities() {
+    const auto &doc =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+            "<!DOCTYPE config>\r\n"
+            "<config path=\"a&lt;b&gt;&amp;&quot;c&quot;\" quote='it&apos;s'>\r\n"
+            "    <text>x &lt; y &amp;&amp; y &gt; z</text>\r\n"
+            "    <lines>l1\r\nl2\rl3</lines>\r\n"
+            "    <codes>&#65;&#x42;&#xe9;&#x20AC;</codes>\r\n"
+            "    <unknown>&nbsp;&amp</unknown>\r\n"
+            "    <cdata><![CDATA[<not> & parsed]]></cdata>\r\n"
+            "</config>\r\n";
+    ez::xml::Document xml;
+    CTEST_ASSERT(xml.parseString(doc));
+    const auto *config = xml.getRoot().getChild("config");
+    CTEST_ASSERT(config != nullptr);
+    CTEST_ASSERT(config->getAttribute("path") == "a<b>&\"c\"");
+    CTEST_ASSERT(config->getAttribute("quote") == "it's");
+    CTEST_ASSERT(config->getChild("text")->getContent() == "x < y && y > z");
+    CTEST_ASSERT(config->getChild("lines")->getContent() == "l1\nl2\nl3");
+    CTEST_ASSERT(config->getChild("codes")->getContent() == "AB\xC3\xA9\xE2\x82\xAC");
+    CTEST_ASSERT(config->getChild("unknown")->getContent() == "&nbsp;&amp");
+    CTEST_ASSERT(config->getChild("cdata")->getContent() == "<not> & parsed");
+    return true;
+}
+
+bool TestEzXml_Document_Errors() {
+    ez::xml::Document xml;
+    CTEST_ASSERT(!xml.parseString("<config>\n    <Test name=\"test1\" number=5/>\n</config>\n"));
+    CTEST_ASSERT(xml.getError().find("number") != std::string::npos);
+    CTEST_ASSERT(!xml.parseString("<config><Test name=\"test1/></config>"));
+    CTEST_ASSERT(!xml.parseString("<config><Test></config>"));
+    CTEST_ASSERT(xml.getError().find("</config>") != std::string::npos);
+    CTEST_ASSERT(!xml.parseString("<config>\n<config>\n"));
+    CTEST_ASSERT(xml.getError().find("unclosed") != std::string::npos);
+    CTEST_ASSERT(!xml.parseString("</config>"));
+    CTEST_ASSERT(!xml.parseString("<config><!-- comment </config>"));
+    CTEST_ASSERT(!xml.parseString("<config attr></config>"));
+    CTEST_ASSERT(!xml.parseString("<config"));
+    CTEST_ASSERT(!xml.parseFile("not_existing_file.xml"));
+    // the document is reusable after a failure
+    CTEST_ASSERT(xml.parseString("<config a='1'/>"));
+    CTEST_ASSERT(xml.getError().empty());
+    CTEST_ASSERT(xml.getRoot().getChildrenCount() == 1U);
+    CTEST_ASSERT(xml.getRoot().getFirstChild()->getAttribute("a") == "1");
+    return true;
+}
+
+bool TestEzXml_Document_InSitu() {
+    std::string buffer = "<config><value v=\"&lt;1&gt;\">a &amp; b</value></config>";
+    ez::xml::Document xml;
+    CTEST_ASSERT(xml.parseInSitu(&buffer[0], buffer.size()));
+    const auto *value = xml.getRoot().getChild("config")->getChild("value");
+    // the views point into the buffer, decoded in place
+    CTEST_ASSERT(value->getName().data() >= buffer.data());
+    CTEST_ASSERT(value->getName().data() < buffer.data() + buffer.size());
+    CTEST_ASSERT(value->getAttribute("v") == "<1>");
+    CTEST_ASSERT(value->getContent() == "a & b");
+    return true;
+}
+
+// events of the reader as text, for compare them
+static bool s_readEvents(std::istream &vStream, size_t vChunkSize, std::vector<std::string> &vEvents, std::string &vError) {
+    ez::xml::Reader reader;
+    reader.openStream(vStream, vChunkSize);
+    vEvents.clear();
+    while (reader.next()) {
+        switch (reader.getEventType()) {
+            case ez::xml::Reader::EventType::StartElement: vEvents.push_back("start " + reader.getName().str() + " " + std::to_string(reader.getDepth())); break;
+            case ez::xml::Reader::EventType::Attribute: vEvents.push_back("attr " + reader.getName().str() + "=" + reader.getValue().str()); break;
+            case ez::xml::Reader::EventType::Text: vEvents.push_back("text " + reader.getValue().str()); break;
+            case ez::xml::Reader::EventType::Comment: vEvents.push_back("comment " + reader.getValue().str()); break;
+            case ez::xml::Reader::EventType::EndElement: vEvents.push_back("end " + reader.getName().str() + " " + std::to_string(reader.getDepth())); break;
+            default: vEvents.push_back("unknown"); break;
+        }
+    }
+    vError = reader.getError();
+    return vError.empty();
+}
+
+bool TestEzXml_Reader_Events() {
+    const std::string doc =
+            "<?xml version=\"1.0\"?>\r\n"
+            "<!DOCTYPE config>\r\n"
+            "<config version='2'>\r\n"
+            "    <!-- a comment -->\r\n"
+            "    <Test name=\"test1\" expr=\"a > b\" quote='it&apos;s'/>\r\n"
+            "    <Test name = \"test2\">\r\n"
+            "        <value>x &lt; y\r\nz &#x20AC;</value>\r\n"
+            "        <cdata><![CDATA[<not> & parsed]]></cdata>\r\n"
+            "    </Test>\r\n"
+            "    <Empty></Empty>\r\n"
+            "</config>\r\n";
+    const std::vector<std::string> expected = {
+            "start config 1",
+            "attr version=2",
+            "comment <!-- a comment -->",
+            "start Test 2",
+            "attr name=test1",
+            "attr expr=a > b",
+            "attr quote=it's",
+            "end Test 1",
+            "start Test 2",
+            "attr name=test2",
+            "start value 3",
+            "text x < y\nz \xE2\x82\xAC",
+            "end value 2",
+            "start cdata 3",
+            "text <not> & parsed",
+            "end cdata 2",
+            "end Test 1",
+            "start Empty 2",
+            "end Empty 1",
+            "end config 0",
+    };
+    // the tokens cut by the chunks boundaries must give the same events
+    for (const size_t chunkSize : {16U, 17U, 23U, 64U, 65536U}) {
+        std::istringstream stream(doc);
+        std::vector<std::string> events;
+        std::string error;
+        CTEST_ASSERT(s_readEvents(stream, chunkSize, events, error));
+        CTEST_ASSERT(events == expected);
+    }
+    return true;
+}
+
+bool TestEzXml_Reader_Errors() {
+    const std::vector<std::pair<std::string, std::string>> docs = {
+            {"<config>\n    <Test name=\"test1\" number=5/>\n</config>\n", "number"},
+            {"<config><Test></config>", "</config>"},
+            {"<config>\n<config>\n", "unclosed"},
+            {"</config>", "</config>"},
+            {"<config><!-- comment </config>", "comment"},
+            {"<config attr></config>", "attribute"},
+            {"<config", "unterminated"},
+    };
+    for (const auto &doc : docs) {
+        std::istringstream stream(doc.first);
+        std::vector<std::string> events;
+        std::string error;
+        CTEST_ASSERT(!s_readEvents(stream, 16U, events, error));
+        CTEST_ASSERT(error.find(doc.second) != std::string::npos);
+    }
+    ez::xml::Reader reader;
+    CTEST_ASSERT(!reader.openFile("not_existing_file.xml"));
+    CTEST_ASSERT(!reader.next());
+    return true;
+}
+
+// classic parser vs in-situ document on a multi-megabyte config
+bool TestEzXml_Document_Perfos() {
+    std::string doc = "<config>\n";
+    size_t count = 0;
+    while (doc.size() < 4U * 1024U * 1024U) {
+        const auto idx = std::to_string(count++);
+        doc += "    <entry id=\"" + idx + "\" name=\"entry_" + idx + "\" value=\"3.14159\">\n";
+        doc += "        <!-- entry " + idx + " -->\n";
+        doc += "        <sub mode='fast'>text of " + idx + " &amp; more</sub>\n";
+        doc += "        <flag enabled=\"true\"/>\n";
+        doc += "    </entry>\n";
+    }
+    doc += "</config>\n";
+
+    auto start = std::chrono::steady_clock::now();
+    ez::Xml classic;
+    CTEST_ASSERT(classic.parseString(doc));
+    const auto classicMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CTEST_ASSERT(classic.getRoot().getChildren().at(0).getChildren().size() == count);
+
+    start = std::chrono::steady_clock::now();
+    ez::xml::Document document;
+    CTEST_ASSERT(document.parseString(doc));
+    const auto documentMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CTEST_ASSERT(document.getRoot().getFirstChild()->getChildrenCount() == count);
+
+    std::cout << "parsing of " << doc.size() / 1024U << " KB, " << count << " entries" << std::endl;
+    std::cout << "ez::Xml           : " << classicMs << " ms" << std::endl;
+    std::cout << "ez::xml::Document : " << documentMs << " ms (x" << classicMs / documentMs << ")" << std::endl;
+    return true;
+}
+
+static ez::xml::Node s_buildWriterTree() {
+    ez::xml::Node root("config");
+    root.addComment("a comment");
+    root.addChild("NumberOneLine").setContent(60);
+    auto &tests = root.addChild("Tests");
+    tests.addChild("Test").addAttribute("name", "test1").addAttribute("expr", "a < b && \"c\" > 'd'");
+    auto &test = tests.addChild("Test").addAttribute("name", "test2");
+    test.setContent("text <with> & \"entities\"");
+    test.addChild("Empty");
+    test.addChild("Raw").setContent<const char *>("already &amp; escaped & not");
+    return root;
+}
+
+bool TestEzXml_Writer_SameAsDump() {
+    const auto root = s_buildWriterTree();
+    CTEST_ASSERT(ez::xml::Writer::toString(root) == root.dump());
+    // a parsed document too
+    ez::Xml xml;
+    CTEST_ASSERT(xml.parseString(u8R"(
+<config a="1" b='x&amp;y'>
+    <!-- Comment -->
+    <v>60</v>
+    <t k="1">txt<c/></t>
+</config>
+)"));
+    CTEST_ASSERT(ez::xml::Writer::toString(xml.getRoot()) == xml.dump());
+    return true;
+}
+
+bool TestEzXml_Writer_Compact() {
+    const auto root = s_buildWriterTree();
+    const auto compact = ez::xml::Writer::toString(root, true);
+    CTEST_ASSERT(compact ==
+                 "<config><!-- a comment --><NumberOneLine>60</NumberOneLine><Tests>"
+                 "<Test expr=\"a &lt; b &amp;&amp; &quot;c&quot; &gt; &apos;d&apos;\" name=\"test1\"/>"
+                 "<Test name=\"test2\">text &lt;with&gt; &amp; &quot;entities&quot;<Empty/><Raw>already &amp; escaped &amp; not</Raw></Test>"
+                 "</Tests></config>");
+    // read back by the parsers
+    ez::xml::Document doc;
+    CTEST_ASSERT(doc.parseString(compact));
+    const auto *test = doc.getRoot().getChild("config")->getChild("Tests")->getChild("Test");
+    CTEST_ASSERT(test->getAttribute("expr") == "a < b && \"c\" > 'd'");
+    CTEST_ASSERT(test->getNextSibling()->getContent() == "text <with> & \"entities\"");
+    return true;
+}
+
+bool TestEzXml_Writer_Stream() {
+    const auto root = s_buildWriterTree();
+    std::ostringstream oss;
+    {
+        ez::xml::Writer writer(oss, false, 16U);  // flushed many times
+        writer.write(root);
+        CTEST_ASSERT(writer.str().empty());
+        writer.write(root);
+    }
+    CTEST_ASSERT(oss.str() == root.dump() + root.dump());
+    ez::xml::Writer writer;
+    writer.write(root);
+    CTEST_ASSERT(writer.str() == root.dump());
+    writer.clear();
+    CTEST_ASSERT(writer.str().empty());
+    return true;
+}
+
+// Node::dump vs Writer on a big tree
+bool TestEzXml_Writer_Perfos() {
+    ez::xml::Node root("config");
+    for (size_t i = 0; i < 20000U; ++i) {
+        auto &entry = root.addChild("entry").addAttribute("id", i).addAttribute("name", "entry_" + std::to_string(i));
+        entry.addComment("entry " + std::to_string(i));
+        entry.addChild("sub").addAttribute("mode", "fast").setContent("text of " + std::to_string(i) + " & more");
+        entry.addChild("flag").addAttribute("enabled", true);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const auto dumped = root.dump();
+    const auto dumpMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    ez::xml::Writer writer;
+    writer.write(root);
+    const auto writerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CTEST_ASSERT(writer.str() == dumped);
+
+    start = std::chrono::steady_clock::now();
+    ez::xml::Writer compactWriter(true);
+    compactWriter.write(root);
+    const auto compactMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    CTEST_ASSERT(compactWriter.str().size() < dumped.size());
+
+    std::cout << "writing of " << dumped.size() / 1024U << " KB" << std::endl;
+    std::cout << "Node::dump        : " << dumpMs << " ms" << std::endl;
+    std::cout << "Writer            : " << writerMs << " ms (x" << dumpMs / writerMs << ")" << std::endl;
+    std::cout << "Writer compact    : " << compactMs << " ms (x" << dumpMs / compactMs << ")" << std::endl;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////
@@ -299,6 +642,17 @@ bool TestEzXml(const std::string &vTest) {
     else IfTestExist(TestEzXml_AddChilds);
     else IfTestExist(TestEzXml_AttributeWithTemplateTypes);
     else IfTestExist(TestEzXml_ReplaceAll);
+    else IfTestExist(TestEzXml_Document_ParsingOK);
+    else IfTestExist(TestEzXml_Document_Entities);
+    else IfTestExist(TestEzXml_Document_Errors);
+    else IfTestExist(TestEzXml_Document_InSitu);
+    else IfTestExist(TestEzXml_Document_Perfos);
+    else IfTestExist(TestEzXml_Reader_Events);
+    else IfTestExist(TestEzXml_Reader_Errors);
+    else IfTestExist(TestEzXml_Writer_SameAsDump);
+    else IfTestExist(TestEzXml_Writer_Compact);
+    else IfTestExist(TestEzXml_Writer_Stream);
+    else IfTestExist(TestEzXml_Writer_Perfos);
     return false;
 }
 
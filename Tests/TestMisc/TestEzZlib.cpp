@@ -0,0 +1,190 @@
+#include <ezlibs/ezZlib.hpp>
+#include <ezlibs/ezCTest.hpp>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+// Desactivation des warnings de conversion
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244)  // Conversion from 'double' to 'float', possible loss of data
+#pragma warning(disable : 4305)  // Truncation from 'double' to 'float'
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wfloat-conversion"
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+// the kinds of datas met in files : text, noise, and sparse float values like vdb leafs
+static std::vector<std::vector<uint8_t>> s_GetDatas() {
+    std::vector<std::vector<uint8_t>> ret;
+    ret.push_back({});
+    ret.push_back({'a'});
+    std::string text;
+    for (size_t i = 0; i < 3000U; ++i) {
+        text += "voxel " + std::to_string(i % 37U) + " ";
+    }
+    ret.push_back(std::vector<uint8_t>(text.begin(), text.end()));
+    std::vector<uint8_t> noise(100000U);
+    uint32_t seed = 12345U;
+    for (auto& byte : noise) {
+        seed = seed * 1664525U + 1013904223U;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    ret.push_back(noise);
+    ret.push_back(std::vector<uint8_t>(70000U, 0U));
+    // few bytes of all values, often written in fixed huffman blocks
+    std::vector<uint8_t> sparse(3000U, 0U);
+    for (size_t i = 0; i < sparse.size(); i += 1U + (i * 7U) % 61U) {
+        sparse[i] = static_cast<uint8_t>(i * 13U);
+    }
+    ret.push_back(sparse);
+    std::vector<float> values(50000U, 0.0f);
+    for (size_t i = 0; i < values.size(); i += 3U) {
+        values[i] = static_cast<float>(i % 1000U) * 0.1f;
+    }
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(values.data());
+    ret.push_back(std::vector<uint8_t>(ptr, ptr + values.size() * sizeof(float)));
+    return ret;
+}
+
+bool TestEzZlib_Adler32() {
+    const std::string wikipedia = "Wikipedia";
+    CTEST_ASSERT(ez::zlib::adler32(wikipedia.data(), wikipedia.size()) == 0x11E60398U);
+    CTEST_ASSERT(ez::zlib::adler32(nullptr, 0U) == 1U);
+    std::vector<uint8_t> datas(256U * 300U);
+    for (size_t i = 0; i < datas.size(); ++i) {
+        datas[i] = static_cast<uint8_t>(i);
+    }
+    CTEST_ASSERT(ez::zlib::adler32(datas.data(), datas.size()) == 0x09F872BCU);
+    // by parts
+    const uint32_t part = ez::zlib::adler32(datas.data(), 10000U);
+    CTEST_ASSERT(ez::zlib::adler32(datas.data() + 10000U, datas.size() - 10000U, part) == 0x09F872BCU);
+    return true;
+}
+
+// streams of the zlib library (fixed and dynamic huffman blocks)
+bool TestEzZlib_Uncompress() {
+    const std::vector<uint8_t> fixed = {0x78, 0xda, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xc8, 0x40, 0x27, 0x01, 0x68, 0x03, 0x08, 0xb1};
+    std::vector<uint8_t> out;
+    CTEST_ASSERT(ez::zlib::uncompress(fixed.data(), fixed.size(), out));
+    CTEST_ASSERT(std::string(out.begin(), out.end()) == "hello hello hello hello");
+    const std::vector<uint8_t> dynamic = {
+        0x78, 0xda, 0x1d, 0x8c, 0xc9, 0x0d, 0x04, 0x41, 0x08, 0xc4, 0x12, 0xf2, 0xa3, 0xb9, 0x21, 0xff, 0xc4, 0xb6, 0x76, 0x24,
+        0x84, 0x38, 0xec, 0x7a, 0x18, 0xc9, 0x61, 0x8d, 0x17, 0xd1, 0xe4, 0xd1, 0xc9, 0x1a, 0x81, 0x27, 0x39, 0x8c, 0xe3, 0x84,
+        0xd1, 0xce, 0x89, 0x08, 0xe6, 0x61, 0x4e, 0x05, 0x27, 0x5a, 0xae, 0x02, 0x34, 0x27, 0xf5, 0x58, 0xba, 0xf0, 0x61, 0x97,
+        0x4a, 0xdc, 0x59, 0xa5, 0x29, 0xaa, 0x30, 0x63, 0x9b, 0x96, 0xb1, 0x84, 0x63, 0x22, 0xb9, 0x60, 0x8b, 0x39, 0x46, 0x3d,
+        0xbe, 0xfa, 0x56, 0x1d, 0xf5, 0xea, 0x3f, 0x24, 0x54, 0x82, 0x34, 0xc9, 0x3f, 0x1c, 0x12, 0x21, 0x3e};
+    std::string expected;
+    for (size_t i = 0; i < 60U; ++i) {
+        expected += std::to_string(i * i % 97U) + ",";
+    }
+    out.clear();
+    CTEST_ASSERT(ez::zlib::uncompress(dynamic.data(), dynamic.size(), out));
+    CTEST_ASSERT(std::string(out.begin(), out.end()) == expected);
+    return true;
+}
+
+bool TestEzZlib_RoundTrip() {
+    ez::zlib::Compressor compressor;
+    for (const auto& datas : s_GetDatas()) {
+        for (const int32_t level : {0, 1, 4, 6, 9}) {
+            std::vector<uint8_t> compressed;
+            compressor.compress(datas.data(), datas.size(), compressed, level);
+            CTEST_ASSERT(compressed == ez::zlib::compress(datas.data(), datas.size(), level));
+            std::vector<uint8_t> out;
+            CTEST_ASSERT(ez::zlib::uncompress(compressed.data(), compressed.size(), out));
+            CTEST_ASSERT(out == datas);
+        }
+    }
+    // the compression gain on the repetitive datas
+    const auto datas = s_GetDatas();
+    CTEST_ASSERT(ez::zlib::compress(datas[2].data(), datas[2].size()).size() < datas[2].size() / 20U);
+    CTEST_ASSERT(ez::zlib::compress(datas[4].data(), datas[4].size()).size() < 200U);
+    CTEST_ASSERT(ez::zlib::compress(datas[6].data(), datas[6].size()).size() < datas[6].size() / 2U);
+    // the noise is stored, with only the cost of the blocks headers
+    CTEST_ASSERT(ez::zlib::compress(datas[3].data(), datas[3].size()).size() < datas[3].size() + 100U);
+    return true;
+}
+
+bool TestEzZlib_Corrupted() {
+    const auto datas = s_GetDatas()[2];
+    const auto compressed = ez::zlib::compress(datas.data(), datas.size());
+    std::vector<uint8_t> out;
+    CTEST_ASSERT(!ez::zlib::uncompress(compressed.data(), compressed.size() / 2U, out));
+    auto badHeader = compressed;
+    badHeader[1] ^= 0x01U;
+    CTEST_ASSERT(!ez::zlib::uncompress(badHeader.data(), badHeader.size(), out));
+    auto badChecksum = compressed;
+    badChecksum.back() ^= 0x01U;
+    CTEST_ASSERT(!ez::zlib::uncompress(badChecksum.data(), badChecksum.size(), out));
+    auto badDatas = compressed;
+    badDatas[compressed.size() / 2U] ^= 0x10U;
+    out.clear();
+    CTEST_ASSERT(!ez::zlib::uncompress(badDatas.data(), badDatas.size(), out) || out != datas);
+    return true;
+}
+
+// throughput on sparse float values
+bool TestEzZlib_Perfos() {
+    std::vector<float> values(2U * 1024U * 1024U, 0.0f);
+    uint32_t seed = 1U;
+    for (auto& v : values) {
+        seed = seed * 1664525U + 1013904223U;
+        if ((seed >> 24) < 77U) {
+            v = static_cast<float>((seed >> 8) % 1000U) * 0.1f;
+        }
+    }
+    const size_t bytes = values.size() * sizeof(float);
+    ez::zlib::Compressor compressor;
+    for (const int32_t level : {1, 6}) {
+        std::vector<uint8_t> compressed;
+        auto start = std::chrono::steady_clock::now();
+        compressor.compress(values.data(), bytes, compressed, level);
+        const double compressSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::vector<uint8_t> out;
+        start = std::chrono::steady_clock::now();
+        CTEST_ASSERT(ez::zlib::uncompress(compressed.data(), compressed.size(), out));
+        const double uncompressSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "level " << level << " : ratio " << (double)compressed.size() / (double)bytes  //
+                  << ", compress " << (double)bytes / compressSeconds / 1e6 << " MB/s"  //
+                  << ", uncompress " << (double)bytes / uncompressSeconds / 1e6 << " MB/s" << std::endl;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#define IfTestExist(v)            \
+    if (vTest == std::string(#v)) \
+    return v()
+
+bool TestEzZlib(const std::string& vTest) {
+    IfTestExist(TestEzZlib_Adler32);
+    else IfTestExist(TestEzZlib_Uncompress);
+    else IfTestExist(TestEzZlib_RoundTrip);
+    else IfTestExist(TestEzZlib_Corrupted);
+    else IfTestExist(TestEzZlib_Perfos);
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#elif defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
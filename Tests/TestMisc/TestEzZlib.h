@@ -0,0 +1,5 @@
+#pragma once
+
+#include <string>
+
+bool TestEzZlib(const std::string& vTest);
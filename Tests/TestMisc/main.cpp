@@ -6,10 +6,13 @@
 #include <TestEzCnt.h>
 #include <TestEzFigFont.h>
 #include <TestEzSha.h>
+#include <TestEzHash.h>
+#include <TestEzZlib.h>
 #include <TestEzLog.h>
 #include <TestEzSqlite.h>
 #include <TestEzScreen.h>
 #include <TestEzTemplater.h>
+#include <TestEzWorkerThread.h>
 #ifdef TESTING_WIP
 #include <TestEzQrCode.h>
 #endif
@@ -27,10 +30,13 @@ bool TestMisc(const std::string& vTest) {
     else IfTestCollectionExist(TestEzCnt);
     else IfTestCollectionExist(TestEzFigFont);
     else IfTestCollectionExist(TestEzSha);
+    else IfTestCollectionExist(TestEzHash);
+    else IfTestCollectionExist(TestEzZlib);
     else IfTestCollectionExist(TestEzLog);
     else IfTestCollectionExist(TestEzSqlite);
     else IfTestCollectionExist(TestEzScreen);
     else IfTestCollectionExist(TestEzTemplater);
+    else IfTestCollectionExist(TestEzWorkerThread);
 #ifdef TESTING_WIP
     else IfTestCollectionExist(TestEzQrCode);
 #endif
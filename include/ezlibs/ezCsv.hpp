@@ -26,23 +26,742 @@ SOFTWARE.
 
 // ezCsv is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
 
+#include <cmath>
+#include <limits>
 #include <string>
+#include <thread>
 #include <vector>
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <unordered_map>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
 
+#include "ezOS.hpp"
+
+#ifdef WINDOWS_OS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace ez {
 
+/**
+ * @brief Vue (sans copie) sur une cellule Csv : pointeur dans le buffer lu et taille.
+ *
+ * Valide uniquement pendant l'appel du callback qui la reçoit.
+ */
+struct CsvCell {
+    const char* data{nullptr};  ///< Début du texte de la cellule (non terminé par '\0')
+    size_t size{0};             ///< Taille du texte de la cellule
+
+    /**
+     * @brief Copie la cellule dans une std::string.
+     */
+    std::string str() const {
+        return std::string(data, size);
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+
+    bool operator==(const std::string& other) const {
+        return other.size() == size && (size == 0 || std::memcmp(data, other.data(), size) == 0);
+    }
+
+    bool operator!=(const std::string& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief Ligne Csv passée aux callbacks de CsvReader : un tableau de CsvCell.
+ */
+class CsvRow {
+private:
+    const CsvCell* cells_{nullptr};  ///< Cellules de la ligne
+    size_t count_{0};                ///< Nombre de cellules
+    size_t index_{0};                ///< Index de la ligne dans le fichier (lignes vides ignorées)
+
+public:
+    CsvRow() = default;
+    CsvRow(const CsvCell* cells, size_t count, size_t index) : cells_(cells), count_(count), index_(index) {}
+
+    size_t size() const {
+        return count_;
+    }
+
+    size_t index() const {
+        return index_;
+    }
+
+    const CsvCell& operator[](size_t col) const {
+        return cells_[col];
+    }
+
+    const CsvCell* begin() const {
+        return cells_;
+    }
+
+    const CsvCell* end() const {
+        return cells_ + count_;
+    }
+};
+
+/**
+ * @class CsvReader
+ * @brief Lecture en flux d'un Csv, sans jamais construire toute la table en mémoire.
+ *
+ * - Le fichier est mappé en mémoire (mmap / MapViewOfFile), il n'est pas copié.
+ * - Chaque ligne est passée à un callback sous forme de vues (CsvCell) sur le buffer mappé.
+ * - Les guillemets suivent la RFC-4180 : délimiteurs et retours à la ligne permis entre guillemets,
+ *   "" pour un guillemet. Seules les cellules contenant des "" sont recopiées (dans un buffer réutilisé).
+ * - Fins de ligne \n, \r\n ou \r. Les lignes vides sont ignorées.
+ *
+ * Exemple :
+ *   ez::CsvReader reader("data.csv");
+ *   reader.forEachRow([](const ez::CsvRow& row) { ...; return true; });
+ */
+class CsvReader {
+private:
+    const char* data_{nullptr};     ///< Début du buffer lu (mappé ou fourni)
+    size_t size_{0};                ///< Taille du buffer lu
+    char delimiter_{','};           ///< Caractère de délimitation
+    std::vector<CsvCell> cells_;    ///< Cellules de la ligne courante (réutilisées)
+    std::vector<char> unquoted_;    ///< Cellules dont les "" ont été dédoublés (réutilisé)
+#ifdef WINDOWS_OS
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+
+public:
+    CsvReader() = default;
+
+    /**
+     * @brief Ouvre (mappe) un fichier Csv.
+     * @param filename Nom du fichier Csv à lire.
+     * @param delimiter Caractère de délimitation (`,` par défaut).
+     */
+    explicit CsvReader(const std::string& filename, char delimiter = ',') {
+        open(filename, delimiter);
+    }
+
+    ~CsvReader() {
+        close();
+    }
+
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    /**
+     * @brief Mappe un fichier Csv en mémoire.
+     * @param filename Nom du fichier Csv à lire.
+     * @param delimiter Caractère de délimitation (`,` par défaut).
+     * @throws std::runtime_error si le fichier ne peut pas être ouvert ou mappé.
+     */
+    void open(const std::string& filename, char delimiter = ',') {
+        close();
+        delimiter_ = delimiter;
+#ifdef WINDOWS_OS
+        file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Impossible d'ouvrir le fichier: " + filename);
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize)) {
+            close();
+            throw std::runtime_error("Impossible de lire la taille du fichier: " + filename);
+        }
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ != nullptr) {
+                data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (data_ == nullptr) {
+                close();
+                throw std::runtime_error("Impossible de mapper le fichier: " + filename);
+            }
+        }
+#else
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("Impossible d'ouvrir le fichier: " + filename);
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            close();
+            throw std::runtime_error("Impossible de lire la taille du fichier: " + filename);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (ptr == MAP_FAILED) {
+                size_ = 0;
+                close();
+                throw std::runtime_error("Impossible de mapper le fichier: " + filename);
+            }
+            data_ = static_cast<const char*>(ptr);
+            madvise(ptr, size_, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    /**
+     * @brief Lit un Csv déjà en mémoire. Le buffer n'est pas copié et doit survivre au reader.
+     * @param data Début du texte Csv.
+     * @param size Taille du texte Csv.
+     * @param delimiter Caractère de délimitation (`,` par défaut).
+     */
+    void openBuffer(const char* data, size_t size, char delimiter = ',') {
+        close();
+        data_ = data;
+        size_ = size;
+        delimiter_ = delimiter;
+    }
+
+    /**
+     * @brief Libère le mapping du fichier (sans effet sur un buffer fourni par openBuffer).
+     */
+    void close() {
+#ifdef WINDOWS_OS
+        if (mapping_ != nullptr) {
+            if (data_ != nullptr) {
+                UnmapViewOfFile(data_);
+            }
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+        }
+        if (file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (fd_ >= 0) {
+            if (data_ != nullptr) {
+                munmap(const_cast<char*>(data_), size_);
+            }
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Début du Csv lu (mappé ou fourni par openBuffer).
+     */
+    const char* data() const {
+        return data_;
+    }
+
+    /**
+     * @brief Taille en octets du Csv lu.
+     */
+    size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Parcourt toutes les lignes du Csv.
+     * @param callback Appelé pour chaque ligne avec un `const CsvRow&` ; retourne false pour arrêter la lecture.
+     *        Les cellules ne sont valides que pendant l'appel.
+     * @return Le nombre de lignes lues.
+     */
+    template <typename TCallback>
+    size_t forEachRow(TCallback&& callback) {
+        return parseRange(data_, data_ + size_, delimiter_, 0, cells_, unquoted_, callback);
+    }
+
+    /**
+     * @brief Parse les lignes de [begin, end). Les buffers cells et unquoted sont réutilisés d'un appel à l'autre.
+     * @param firstRowIndex Index donné à la première ligne.
+     * @return Le nombre de lignes lues.
+     */
+    template <typename TCallback>
+    static size_t parseRange(const char* begin,
+                             const char* end,
+                             char delimiter,
+                             size_t firstRowIndex,
+                             std::vector<CsvCell>& cells,
+                             std::vector<char>& unquoted,
+                             TCallback& callback) {
+        // cellules recopiées dans unquoted : (index de cellule, offset), résolues en fin de ligne
+        // car unquoted peut être réalloué pendant la ligne
+        std::vector<std::pair<size_t, size_t>> copied;
+        size_t rowIndex = firstRowIndex;
+        const char* p = begin;
+        while (p < end) {
+            // lignes vides
+            if (*p == '\n' || *p == '\r') {
+                ++p;
+                continue;
+            }
+            cells.clear();
+            unquoted.clear();
+            copied.clear();
+            while (true) {
+                CsvCell cell;
+                if (p < end && *p == '"') {
+                    parseQuotedCell(p, end, delimiter, cells.size(), cell, unquoted, copied);
+                } else {
+                    const char* start = p;
+                    while (p < end && *p != delimiter && *p != '\n' && *p != '\r') {
+                        ++p;
+                    }
+                    cell.data = start;
+                    cell.size = static_cast<size_t>(p - start);
+                }
+                cells.push_back(cell);
+                if (p < end && *p == delimiter) {
+                    ++p;
+                    continue;
+                }
+                // fin de ligne : \n, \r\n ou \r
+                if (p < end && *p == '\r') {
+                    ++p;
+                }
+                if (p < end && *p == '\n') {
+                    ++p;
+                }
+                break;
+            }
+            for (const auto& c : copied) {
+                cells[c.first].data = unquoted.data() + c.second;
+            }
+            if (!callback(CsvRow(cells.data(), cells.size(), rowIndex++))) {
+                break;
+            }
+        }
+        return rowIndex - firstRowIndex;
+    }
+
+private:
+    /**
+     * @brief Parse une cellule entre guillemets, p pointe sur le guillemet ouvrant.
+     *        Sans "" la cellule reste une vue sur le buffer, sinon elle est recopiée dans unquoted.
+     *        Du texte après le guillemet fermant (Csv mal formé) est gardé tel quel.
+     */
+    static void parseQuotedCell(const char*& p,
+                                const char* end,
+                                char delimiter,
+                                size_t cellIndex,
+                                CsvCell& cell,
+                                std::vector<char>& unquoted,
+                                std::vector<std::pair<size_t, size_t>>& copied) {
+        ++p;
+        const char* start = p;
+        bool isCopied = false;
+        size_t offset = 0;
+        const char* viewEnd = end;
+        while (p < end) {
+            const char* q = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+            if (q == nullptr) {
+                // guillemet non fermé : jusqu'à la fin du buffer
+                if (isCopied) {
+                    unquoted.insert(unquoted.end(), p, end);
+                }
+                p = end;
+                break;
+            }
+            if (q + 1 < end && q[1] == '"') {
+                // "" : un guillemet dans la cellule
+                if (!isCopied) {
+                    isCopied = true;
+                    offset = unquoted.size();
+                }
+                unquoted.insert(unquoted.end(), p, q + 1);
+                p = q + 2;
+                continue;
+            }
+            if (isCopied) {
+                unquoted.insert(unquoted.end(), p, q);
+            }
+            viewEnd = q;
+            p = q + 1;
+            break;
+        }
+        // texte après le guillemet fermant
+        const char* junk = p;
+        while (p < end && *p != delimiter && *p != '\n' && *p != '\r') {
+            ++p;
+        }
+        if (p != junk) {
+            if (!isCopied) {
+                isCopied = true;
+                offset = unquoted.size();
+                unquoted.insert(unquoted.end(), start, viewEnd);
+            }
+            unquoted.insert(unquoted.end(), junk, p);
+        }
+        if (isCopied) {
+            cell.data = nullptr;
+            cell.size = unquoted.size() - offset;
+            copied.emplace_back(cellIndex, offset);
+        } else {
+            cell.data = start;
+            cell.size = static_cast<size_t>(viewEnd - start);
+        }
+    }
+};
+
+/**
+ * @class CsvWriter
+ * @brief Écriture en flux d'un Csv, ligne par ligne, via un buffer.
+ *
+ * - Les cellules sont formatées dans un buffer écrit par gros blocs (pas d'iostream).
+ * - Les nombres sont formatés sans iostream, les double au plus court relu à l'identique.
+ * - Une cellule n'est mise entre guillemets que si elle contient le délimiteur, un guillemet ou un retour à la ligne.
+ * - En mode append, les lignes sont ajoutées à un fichier existant sans le relire.
+ *
+ * Exemple :
+ *   ez::CsvWriter writer("out.csv");
+ *   writer.writeRow("id", "value");
+ *   writer.writeRow(1, 2.5);
+ *   writer.addCell("x").addCell(42).endRow();
+ */
+class CsvWriter {
+private:
+    std::FILE* file_{nullptr};  ///< Fichier ouvert
+    std::vector<char> buffer_;  ///< Texte pas encore écrit
+    size_t bufferSize_{0};      ///< Taille au-delà de laquelle le buffer est écrit
+    size_t flushInterval_{0};   ///< Flush du fichier toutes les N lignes (0 : jamais)
+    size_t rowCount_{0};        ///< Nombre de lignes écrites
+    bool rowStarted_{false};    ///< Une cellule a déjà été ajoutée à la ligne courante
+    char delimiter_{','};       ///< Caractère de délimitation
+
+public:
+    CsvWriter() = default;
+
+    /**
+     * @brief Ouvre un fichier Csv en écriture (voir open).
+     */
+    explicit CsvWriter(const std::string& filename, char delimiter = ',', bool append = false, size_t bufferSize = 1 << 20) {
+        open(filename, delimiter, append, bufferSize);
+    }
+
+    ~CsvWriter() {
+        close();
+    }
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    /**
+     * @brief Ouvre un fichier Csv en écriture.
+     * @param filename Nom du fichier de sortie.
+     * @param delimiter Caractère de délimitation (`,` par défaut).
+     * @param append Ajoute les lignes à la fin du fichier au lieu de le remplacer.
+     * @param bufferSize Taille du buffer d'écriture.
+     * @throws std::runtime_error si le fichier ne peut pas être ouvert.
+     */
+    void open(const std::string& filename, char delimiter = ',', bool append = false, size_t bufferSize = 1 << 20) {
+        close();
+        file_ = std::fopen(filename.c_str(), append ? "ab" : "wb");
+        if (file_ == nullptr) {
+            throw std::runtime_error("Impossible d'ouvrir le fichier en écriture: " + filename);
+        }
+        delimiter_ = delimiter;
+        bufferSize_ = std::max<size_t>(bufferSize, 256);
+        buffer_.reserve(bufferSize_ + 256);
+        rowCount_ = 0;
+        rowStarted_ = false;
+    }
+
+    /**
+     * @brief Termine la ligne en cours, écrit le buffer et ferme le fichier.
+     */
+    void close() {
+        if (file_ == nullptr) {
+            return;
+        }
+        if (rowStarted_) {
+            endRow();
+        }
+        flush();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    bool isOpen() const {
+        return file_ != nullptr;
+    }
+
+    /**
+     * @brief Flush du fichier toutes les rowsCount lignes (0 : seulement quand le buffer est plein et à la fermeture).
+     */
+    void setFlushInterval(size_t rowsCount) {
+        flushInterval_ = rowsCount;
+    }
+
+    /**
+     * @brief Nombre de lignes écrites depuis l'ouverture.
+     */
+    size_t rowCount() const {
+        return rowCount_;
+    }
+
+    /**
+     * @brief Écrit le buffer dans le fichier et flush le fichier.
+     */
+    void flush() {
+        writeBuffer();
+        if (file_ != nullptr) {
+            std::fflush(file_);
+        }
+    }
+
+    // --- Écriture cellule par cellule ---
+
+    CsvWriter& addCell(const char* text, size_t size) {
+        startCell();
+        bool needQuotes = false;
+        for (size_t i = 0; i < size && !needQuotes; ++i) {
+            const char c = text[i];
+            needQuotes = (c == delimiter_ || c == '"' || c == '\n' || c == '\r');
+        }
+        if (!needQuotes) {
+            append(text, size);
+            return *this;
+        }
+        buffer_.push_back('"');
+        for (size_t i = 0; i < size; ++i) {
+            if (text[i] == '"') {
+                buffer_.push_back('"');
+            }
+            buffer_.push_back(text[i]);
+        }
+        buffer_.push_back('"');
+        return *this;
+    }
+
+    CsvWriter& addCell(const std::string& text) {
+        return addCell(text.data(), text.size());
+    }
+
+    CsvWriter& addCell(const char* text) {
+        return addCell(text, std::strlen(text));
+    }
+
+    CsvWriter& addCell(const CsvCell& cell) {
+        return addCell(cell.data, cell.size);
+    }
+
+    CsvWriter& addCell(long long value) {
+        startCell();
+        char buffer[24];
+        const size_t size = formatInt64(static_cast<int64_t>(value), buffer);
+        append(buffer, size);
+        return *this;
+    }
+
+    CsvWriter& addCell(int value) {
+        return addCell(static_cast<long long>(value));
+    }
+
+    CsvWriter& addCell(long value) {
+        return addCell(static_cast<long long>(value));
+    }
+
+    CsvWriter& addCell(unsigned value) {
+        return addCell(static_cast<unsigned long long>(value));
+    }
+
+    CsvWriter& addCell(unsigned long value) {
+        return addCell(static_cast<unsigned long long>(value));
+    }
+
+    CsvWriter& addCell(unsigned long long value) {
+        startCell();
+        char buffer[24];
+        const size_t size = formatUInt64(static_cast<uint64_t>(value), buffer);
+        append(buffer, size);
+        return *this;
+    }
+
+    CsvWriter& addCell(double value) {
+        startCell();
+        char buffer[32];
+        const size_t size = formatDouble(value, buffer);
+        append(buffer, size);
+        return *this;
+    }
+
+    CsvWriter& addCell(float value) {
+        return addCell(static_cast<double>(value));
+    }
+
+    /**
+     * @brief Termine la ligne courante.
+     */
+    void endRow() {
+        buffer_.push_back('\n');
+        rowStarted_ = false;
+        ++rowCount_;
+        if (flushInterval_ != 0 && rowCount_ % flushInterval_ == 0) {
+            flush();
+        } else if (buffer_.size() >= bufferSize_) {
+            writeBuffer();
+        }
+    }
+
+    // --- Écriture ligne par ligne ---
+
+    /**
+     * @brief Ajoute une ligne complète.
+     */
+    void appendRow(const std::vector<std::string>& row) {
+        for (const auto& cell : row) {
+            addCell(cell);
+        }
+        endRow();
+    }
+
+    /**
+     * @brief Ajoute une ligne complète, une cellule par argument (texte ou nombre).
+     */
+    template <typename... TArgs>
+    void writeRow(const TArgs&... args) {
+        // initialisation d'un tableau pour évaluer les addCell dans l'ordre
+        const int dummy[] = {0, (addCell(args), 0)...};
+        (void)dummy;
+        endRow();
+    }
+
+    // --- Formatage des nombres ---
+
+    /**
+     * @brief Écrit value en décimal dans buffer (24 octets mini).
+     * @return Le nombre de caractères écrits.
+     */
+    static size_t formatUInt64(uint64_t value, char* buffer) {
+        char digits[20];
+        size_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10U);
+            value /= 10U;
+        } while (value != 0U);
+        for (size_t i = 0; i < count; ++i) {
+            buffer[i] = digits[count - 1 - i];
+        }
+        return count;
+    }
+
+    static size_t formatInt64(int64_t value, char* buffer) {
+        if (value < 0) {
+            buffer[0] = '-';
+            return 1 + formatUInt64(0U - static_cast<uint64_t>(value), buffer + 1);
+        }
+        return formatUInt64(static_cast<uint64_t>(value), buffer);
+    }
+
+    /**
+     * @brief Écrit value dans buffer (32 octets mini), au plus court relu à l'identique.
+     * @return Le nombre de caractères écrits.
+     */
+    static size_t formatDouble(double value, char* buffer) {
+        // entier exact : pas besoin de printf
+        if (value == std::floor(value) && std::fabs(value) < 1e15) {
+            if (value == 0.0 && std::signbit(value)) {
+                buffer[0] = '-';
+                buffer[1] = '0';
+                return 2;
+            }
+            return formatInt64(static_cast<int64_t>(value), buffer);
+        }
+        // peu de décimales : value == n / 10^k exactement, écrit sans printf
+        if (std::fabs(value) < 1e9) {
+            double scale = 1.0;
+            for (int k = 1; k <= 6; ++k) {
+                scale *= 10.0;
+                const double scaled = std::round(value * scale);
+                if (scaled / scale == value) {
+                    return formatFixed(static_cast<int64_t>(scaled), k, buffer);
+                }
+            }
+        }
+        int size = std::snprintf(buffer, 32, "%.15g", value);
+        if (std::strtod(buffer, nullptr) != value && !std::isnan(value)) {
+            size = std::snprintf(buffer, 32, "%.17g", value);
+        }
+        return static_cast<size_t>(size);
+    }
+
+private:
+    /**
+     * @brief Écrit n / 10^decimals dans buffer, avec decimals chiffres après la virgule (sans les zéros de fin).
+     */
+    static size_t formatFixed(int64_t n, int decimals, char* buffer) {
+        size_t size = 0;
+        if (n < 0) {
+            buffer[size++] = '-';
+            n = -n;
+        }
+        char digits[24];
+        size_t count = formatUInt64(static_cast<uint64_t>(n), digits);
+        // zéros de tête pour avoir au moins decimals + 1 chiffres
+        const size_t minCount = static_cast<size_t>(decimals) + 1;
+        const size_t pad = (count < minCount) ? (minCount - count) : 0;
+        const size_t intCount = count + pad - static_cast<size_t>(decimals);
+        for (size_t i = 0; i < count + pad; ++i) {
+            if (i == intCount) {
+                buffer[size++] = '.';
+            }
+            buffer[size++] = (i < pad) ? '0' : digits[i - pad];
+        }
+        // zéros de fin
+        while (buffer[size - 1] == '0') {
+            --size;
+        }
+        if (buffer[size - 1] == '.') {
+            --size;
+        }
+        return size;
+    }
+
+    void append(const char* data, size_t size) {
+        const size_t offset = buffer_.size();
+        buffer_.resize(offset + size);
+        std::memcpy(buffer_.data() + offset, data, size);
+    }
+
+    void startCell() {
+        if (rowStarted_) {
+            buffer_.push_back(delimiter_);
+        }
+        rowStarted_ = true;
+    }
+
+    void writeBuffer() {
+        if (file_ != nullptr && !buffer_.empty()) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+        }
+        buffer_.clear();
+    }
+};
+
 /**
  * @class Csv
  * @brief Classe permettant de lire, manipuler et écrire des fichiers Csv.
  * 
  * Inspirée des bibliothèques Python pour la manipulation de données tabulaires.
- * - Lecture d’un Csv : readFromFile(...)
- * - Écriture d’un Csv : writeToFile(...)
+ * - Lecture d’un Csv : readFromFile(...) (pour lire en flux sans tout charger, voir CsvReader)
+ * - Écriture d’un Csv : writeToFile(...) (pour écrire en flux ou ajouter des lignes à un fichier, voir CsvWriter)
  * - Gestion du header (facultatif) : hasHeader_, header_, etc.
  * - Accès aux données : data_[ligne][colonne]
  * - Méthodes utilitaires : rowCount(), colCount(), head(), tail(), etc.
@@ -82,36 +801,23 @@ public:
         data_.clear();
         header_.clear();
 
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Impossible d'ouvrir le fichier: " + filename);
-        }
-
-        std::string line;
-        bool isFirstLine = true;
-
-        while (std::getline(file, line)) {
+        CsvReader reader(filename, delimiter);
+        reader.forEachRow([this](const CsvRow& csvRow) {
             std::vector<std::string> row;
-            std::stringstream lineStream(line);
-            std::string cell;
-
-            while (std::getline(lineStream, cell, delimiter)) {
-                row.push_back(cell);
+            row.reserve(csvRow.size());
+            for (const auto& cell : csvRow) {
+                row.push_back(cell.str());
             }
 
             // Si c'est la première ligne et qu'on considère qu'il y a un header,
             // on le stocke séparément puis on passe à la suite.
-            if (isFirstLine && hasHeader_) {
-                header_ = row;
-                isFirstLine = false;
-                continue;
+            if (csvRow.index() == 0 && hasHeader_) {
+                header_ = std::move(row);
+            } else {
+                data_.push_back(std::move(row));
             }
-
-            data_.push_back(row);
-            isFirstLine = false;
-        }
-
-        file.close();
+            return true;
+        });
     }
 
     /**
@@ -120,34 +826,17 @@ public:
      * @param delimiter Caractère de délimitation (`,` par défaut).
      */
     void writeToFile(const std::string& filename, char delimiter = ',') const {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Impossible d'ouvrir le fichier en écriture: " + filename);
-        }
+        CsvWriter writer(filename, delimiter);
 
         // Écriture du header si nécessaire
         if (hasHeader_ && !header_.empty()) {
-            for (size_t i = 0; i < header_.size(); ++i) {
-                file << header_[i];
-                if (i < header_.size() - 1) {
-                    file << delimiter;
-                }
-            }
-            file << "\n";
+            writer.appendRow(header_);
         }
 
         // Écriture des lignes de données
-        for (size_t i = 0; i < data_.size(); ++i) {
-            for (size_t j = 0; j < data_[i].size(); ++j) {
-                file << data_[i][j];
-                if (j < data_[i].size() - 1) {
-                    file << delimiter;
-                }
-            }
-            file << "\n";
+        for (const auto& row : data_) {
+            writer.appendRow(row);
         }
-
-        file.close();
     }
 
     // --- Méthodes d'accès et d'information ---
@@ -491,6 +1180,529 @@ public:
     }
 };
 
+/**
+ * @class CsvColumns
+ * @brief Csv stocké par colonnes typées : chaque colonne est un tableau contigu
+ *        d'int64, de double ou de codes vers un dictionnaire de chaînes.
+ *
+ * - Les types sont déclarés ou déduits des premières lignes (ColumnType::AUTO).
+ *   Une colonne déduite est promue (INT64 -> DOUBLE -> STRING) si une valeur ne colle pas.
+ * - Le fichier est découpé en morceaux aux limites de lignes, parsés en parallèle.
+ * - Accès typés (getInt64, getDouble, getString, colonnes entières) et at(row, col) en texte.
+ *
+ * Exemple :
+ *   ez::CsvColumns csv("data.csv", ',', true);
+ *   const auto& prices = csv.getDoubleColumn(csv.getColumnIndex("price"));
+ */
+class CsvColumns {
+public:
+    enum class ColumnType { AUTO = 0, INT64, DOUBLE, STRING };
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type{ColumnType::STRING};
+        std::vector<int64_t> ints;            ///< Valeurs si INT64
+        std::vector<double> doubles;          ///< Valeurs si DOUBLE
+        std::vector<uint32_t> codes;          ///< Index dans dictionary si STRING
+        std::vector<std::string> dictionary;  ///< Chaînes distinctes si STRING
+    };
+
+    // colonne d'un morceau parsé par un thread
+    struct ChunkColumn {
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<uint32_t> codes;
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, uint32_t> dictionaryIndex;
+        ColumnType promoteTo{ColumnType::AUTO};  ///< Type requis par une valeur qui ne colle pas
+    };
+
+    struct Chunk {
+        const char* begin{nullptr};
+        const char* end{nullptr};
+        size_t rowCount{0};
+        std::vector<ChunkColumn> columns;
+        std::string error;
+    };
+
+    bool hasHeader_{false};        ///< Indique si le Csv possède un header ou non
+    std::vector<Column> columns_;  ///< Colonnes typées
+    size_t rowCount_{0};           ///< Nombre de lignes (hors header)
+
+public:
+    CsvColumns() = default;
+
+    /**
+     * @brief Construit le Csv colonne en lisant un fichier (voir readFromFile).
+     */
+    CsvColumns(const std::string& filename,
+               char delimiter = ',',
+               bool hasHeader = false,
+               const std::vector<ColumnType>& types = {},
+               size_t threadsCount = 0) {
+        readFromFile(filename, delimiter, hasHeader, types, threadsCount);
+    }
+
+    /**
+     * @brief Lit un fichier Csv dans des colonnes typées.
+     * @param filename Nom du fichier Csv à lire.
+     * @param delimiter Caractère de délimitation (`,` par défaut).
+     * @param hasHeader Indique si la première ligne est un header (false par défaut).
+     * @param types Type de chaque colonne, AUTO (ou absent) pour le déduire.
+     * @param threadsCount Nombre de threads de parsing (0 pour le nombre de coeurs).
+     * @throws std::runtime_error si le fichier ne peut pas être lu ou si une valeur ne colle pas au type déclaré.
+     */
+    void readFromFile(const std::string& filename,
+                      char delimiter = ',',
+                      bool hasHeader = false,
+                      const std::vector<ColumnType>& types = {},
+                      size_t threadsCount = 0) {
+        CsvReader reader(filename, delimiter);
+        parse(reader.data(), reader.data() + reader.size(), delimiter, hasHeader, types, threadsCount);
+    }
+
+    /**
+     * @brief Comme readFromFile, pour un Csv déjà en mémoire.
+     */
+    void readFromBuffer(const char* data,
+                        size_t size,
+                        char delimiter = ',',
+                        bool hasHeader = false,
+                        const std::vector<ColumnType>& types = {},
+                        size_t threadsCount = 0) {
+        parse(data, data + size, delimiter, hasHeader, types, threadsCount);
+    }
+
+    // --- Méthodes d'accès et d'information ---
+
+    size_t rowCount() const {
+        return rowCount_;
+    }
+
+    size_t colCount() const {
+        return columns_.size();
+    }
+
+    bool hasHeader() const {
+        return hasHeader_;
+    }
+
+    /**
+     * @brief Nom de la colonne col (vide sans header).
+     */
+    const std::string& getColumnName(size_t col) const {
+        return checkedColumn(col).name;
+    }
+
+    /**
+     * @brief Renvoie l’index d’une colonne à partir de son nom dans le header.
+     * @throws std::runtime_error si la colonne n’est pas trouvée ou si le Csv n’a pas de header.
+     */
+    size_t getColumnIndex(const std::string& columnName) const {
+        if (!hasHeader_) {
+            throw std::runtime_error("Le Csv n'a pas de header.");
+        }
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            if (columns_[i].name == columnName) {
+                return i;
+            }
+        }
+        throw std::runtime_error("Colonne non trouvée: " + columnName);
+    }
+
+    ColumnType getColumnType(size_t col) const {
+        return checkedColumn(col).type;
+    }
+
+    /**
+     * @brief Valeurs d'une colonne INT64.
+     * @throws std::runtime_error si la colonne n'est pas INT64.
+     */
+    const std::vector<int64_t>& getInt64Column(size_t col) const {
+        return checkedColumn(col, ColumnType::INT64).ints;
+    }
+
+    /**
+     * @brief Valeurs d'une colonne DOUBLE.
+     * @throws std::runtime_error si la colonne n'est pas DOUBLE.
+     */
+    const std::vector<double>& getDoubleColumn(size_t col) const {
+        return checkedColumn(col, ColumnType::DOUBLE).doubles;
+    }
+
+    /**
+     * @brief Codes d'une colonne STRING (index dans getStringDictionary).
+     * @throws std::runtime_error si la colonne n'est pas STRING.
+     */
+    const std::vector<uint32_t>& getStringCodes(size_t col) const {
+        return checkedColumn(col, ColumnType::STRING).codes;
+    }
+
+    /**
+     * @brief Chaînes distinctes d'une colonne STRING.
+     * @throws std::runtime_error si la colonne n'est pas STRING.
+     */
+    const std::vector<std::string>& getStringDictionary(size_t col) const {
+        return checkedColumn(col, ColumnType::STRING).dictionary;
+    }
+
+    int64_t getInt64(size_t row, size_t col) const {
+        return getInt64Column(col).at(row);
+    }
+
+    /**
+     * @brief Valeur d'une cellule DOUBLE (ou INT64, convertie).
+     */
+    double getDouble(size_t row, size_t col) const {
+        const Column& column = checkedColumn(col);
+        if (column.type == ColumnType::INT64) {
+            return static_cast<double>(column.ints.at(row));
+        }
+        return getDoubleColumn(col).at(row);
+    }
+
+    const std::string& getString(size_t row, size_t col) const {
+        const Column& column = checkedColumn(col, ColumnType::STRING);
+        return column.dictionary[column.codes.at(row)];
+    }
+
+    /**
+     * @brief Accède à une cellule en texte, quel que soit le type de la colonne.
+     * @throws std::out_of_range si (row, col) est hors limite.
+     */
+    std::string at(size_t row, size_t col) const {
+        if (row >= rowCount() || col >= colCount()) {
+            throw std::out_of_range("Index hors limite dans CsvColumns::at()");
+        }
+        const Column& column = columns_[col];
+        switch (column.type) {
+            case ColumnType::INT64: return std::to_string(column.ints[row]);
+            case ColumnType::DOUBLE: {
+                char buffer[32];
+                return std::string(buffer, CsvWriter::formatDouble(column.doubles[row], buffer));
+            }
+            default: return column.dictionary[column.codes[row]];
+        }
+    }
+
+    std::string at(size_t row, const std::string& columnName) const {
+        return at(row, getColumnIndex(columnName));
+    }
+
+private:
+    // Nombre de lignes utilisées pour déduire les types AUTO
+    static const size_t sTypeSampleRows = 1000;
+    // En dessous de cette taille, un seul thread
+    static const size_t sMinChunkSize = 1 << 20;
+
+    const Column& checkedColumn(size_t col) const {
+        if (col >= columns_.size()) {
+            throw std::out_of_range("Index de colonne hors limite dans CsvColumns");
+        }
+        return columns_[col];
+    }
+
+    const Column& checkedColumn(size_t col, ColumnType type) const {
+        const Column& column = checkedColumn(col);
+        if (column.type != type) {
+            throw std::runtime_error("La colonne " + std::to_string(col) + " n'a pas le type demandé.");
+        }
+        return column;
+    }
+
+    static bool parseInt64(const CsvCell& cell, int64_t& out) {
+        const char* p = cell.data;
+        const char* end = cell.data + cell.size;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = (*p == '-');
+            ++p;
+        }
+        if (p == end) {
+            return false;
+        }
+        uint64_t value = 0;
+        const uint64_t limit = negative ? (static_cast<uint64_t>(INT64_MAX) + 1U) : static_cast<uint64_t>(INT64_MAX);
+        for (; p < end; ++p) {
+            const unsigned digit = static_cast<unsigned>(*p - '0');
+            if (digit > 9U || value > (limit - digit) / 10U) {
+                return false;
+            }
+            value = value * 10U + digit;
+        }
+        out = negative ? static_cast<int64_t>(0U - value) : static_cast<int64_t>(value);
+        return true;
+    }
+
+    static bool parseDouble(const CsvCell& cell, double& out) {
+        char buffer[64];
+        if (cell.size == 0 || cell.size >= sizeof(buffer) || std::isspace(static_cast<unsigned char>(cell.data[0]))) {
+            return false;
+        }
+        std::memcpy(buffer, cell.data, cell.size);
+        buffer[cell.size] = '\0';
+        char* end = nullptr;
+        out = std::strtod(buffer, &end);
+        return end == buffer + cell.size;
+    }
+
+    /**
+     * @brief Début de la première ligne après pos (après un retour à la ligne hors guillemets).
+     *        rowStart est un début de ligne avant pos, par exemple la limite précédente, ainsi
+     *        les limites successives sont trouvées en une seule passe.
+     *        Sans guillemets dans le Csv (hasQuotes à false), la recherche part directement de pos.
+     */
+    static const char* nextRowStart(const char* rowStart, const char* pos, const char* end, bool hasQuotes) {
+        // avec guillemets, leur parité depuis rowStart (hors guillemets) indique si p est dans une cellule entre guillemets
+        bool inQuotes = false;
+        const char* p = pos;
+        if (hasQuotes) {
+            for (p = rowStart; p < pos;) {
+                const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(pos - p)));
+                if (quote == nullptr) {
+                    p = pos;
+                } else {
+                    inQuotes = !inQuotes;
+                    p = quote + 1;
+                }
+            }
+        }
+        for (; p < end; ++p) {
+            if (*p == '"') {
+                inQuotes = !inQuotes;
+            } else if (!inQuotes && (*p == '\n' || *p == '\r')) {
+                if (*p == '\r' && p + 1 < end && p[1] == '\n') {
+                    ++p;
+                }
+                return p + 1;
+            }
+        }
+        return end;
+    }
+
+    /**
+     * @brief Parse les lignes d'un morceau dans des colonnes typées, seulement les colonnes c où toParse[c] est vrai
+     *        (les autres gardent leurs valeurs du parsing précédent).
+     *        Une valeur qui ne colle pas à un type déduit demande une promotion de la colonne,
+     *        à un type déclaré c'est une erreur.
+     */
+    static void parseChunk(Chunk& chunk,
+                           char delimiter,
+                           const std::vector<ColumnType>& types,
+                           const std::vector<bool>& declared,
+                           const std::vector<uint8_t>& toParse) {
+        const size_t colCount = types.size();
+        chunk.columns.resize(colCount);
+        for (size_t c = 0; c < colCount; ++c) {
+            if (toParse[c]) {
+                chunk.columns[c] = ChunkColumn();
+            }
+        }
+        chunk.rowCount = 0;
+        std::vector<CsvCell> cells;
+        std::vector<char> unquoted;
+        std::string key;
+        const CsvCell emptyCell;
+        auto onRow = [&](const CsvRow& row) {
+            for (size_t c = 0; c < colCount; ++c) {
+                const CsvCell& cell = (c < row.size()) ? row[c] : emptyCell;
+                ChunkColumn& column = chunk.columns[c];
+                if (!toParse[c] || column.promoteTo != ColumnType::AUTO) {
+                    continue;  // déjà parsée, ou sera reparsée
+                }
+                switch (types[c]) {
+                    case ColumnType::INT64: {
+                        int64_t v = 0;
+                        if (cell.empty() || parseInt64(cell, v)) {
+                            column.ints.push_back(v);
+                        } else {
+                            double d = 0.0;
+                            column.promoteTo = parseDouble(cell, d) ? ColumnType::DOUBLE : ColumnType::STRING;
+                        }
+                    } break;
+                    case ColumnType::DOUBLE: {
+                        double v = std::numeric_limits<double>::quiet_NaN();
+                        if (cell.empty() || parseDouble(cell, v)) {
+                            column.doubles.push_back(v);
+                        } else {
+                            column.promoteTo = ColumnType::STRING;
+                        }
+                    } break;
+                    default: {
+                        key.assign(cell.data, cell.size);
+                        auto it = column.dictionaryIndex.find(key);
+                        if (it == column.dictionaryIndex.end()) {
+                            it = column.dictionaryIndex.emplace(key, static_cast<uint32_t>(column.dictionary.size())).first;
+                            column.dictionary.push_back(key);
+                        }
+                        column.codes.push_back(it->second);
+                    } break;
+                }
+                if (column.promoteTo != ColumnType::AUTO && declared[c]) {
+                    chunk.error = "Valeur '" + cell.str() + "' invalide pour le type de la colonne " + std::to_string(c);
+                    return false;
+                }
+            }
+            ++chunk.rowCount;
+            return true;
+        };
+        CsvReader::parseRange(chunk.begin, chunk.end, delimiter, 0, cells, unquoted, onRow);
+    }
+
+    void parse(const char* begin,
+               const char* end,
+               char delimiter,
+               bool hasHeader,
+               const std::vector<ColumnType>& declaredTypes,
+               size_t threadsCount) {
+        hasHeader_ = hasHeader;
+        columns_.clear();
+        rowCount_ = 0;
+
+        // lignes vides du début
+        while (begin < end && (*begin == '\n' || *begin == '\r')) {
+            ++begin;
+        }
+        if (begin == end) {
+            return;
+        }
+        const bool hasQuotes = std::memchr(begin, '"', static_cast<size_t>(end - begin)) != nullptr;
+
+        // header (ou première ligne) : nombre et noms des colonnes
+        std::vector<CsvCell> cells;
+        std::vector<char> unquoted;
+        auto onFirstRow = [this, hasHeader](const CsvRow& row) {
+            columns_.resize(row.size());
+            if (hasHeader) {
+                for (size_t c = 0; c < row.size(); ++c) {
+                    columns_[c].name = row[c].str();
+                }
+            }
+            return false;
+        };
+        CsvReader::parseRange(begin, end, delimiter, 0, cells, unquoted, onFirstRow);
+        const char* dataBegin = hasHeader ? nextRowStart(begin, begin, end, hasQuotes) : begin;
+        const size_t colCount = columns_.size();
+
+        // types : déclarés, sinon déduits des premières lignes
+        std::vector<ColumnType> types(colCount, ColumnType::AUTO);
+        std::vector<bool> declared(colCount, false);
+        for (size_t c = 0; c < colCount && c < declaredTypes.size(); ++c) {
+            types[c] = declaredTypes[c];
+            declared[c] = (types[c] != ColumnType::AUTO);
+        }
+        std::vector<uint8_t> canInt(colCount, 1), canDouble(colCount, 1), hasValue(colCount, 0);
+        size_t sampled = 0;
+        auto onSampleRow = [&](const CsvRow& row) {
+            for (size_t c = 0; c < colCount && c < row.size(); ++c) {
+                if (row[c].empty()) {
+                    continue;
+                }
+                int64_t i = 0;
+                double d = 0.0;
+                hasValue[c] = 1;
+                canInt[c] &= parseInt64(row[c], i) ? 1 : 0;
+                canDouble[c] &= (canInt[c] || parseDouble(row[c], d)) ? 1 : 0;
+            }
+            return ++sampled < sTypeSampleRows;
+        };
+        CsvReader::parseRange(dataBegin, end, delimiter, 0, cells, unquoted, onSampleRow);
+        for (size_t c = 0; c < colCount; ++c) {
+            if (types[c] == ColumnType::AUTO) {
+                types[c] = !hasValue[c] ? ColumnType::STRING : canInt[c] ? ColumnType::INT64 : canDouble[c] ? ColumnType::DOUBLE : ColumnType::STRING;
+            }
+        }
+
+        // découpage en morceaux aux limites de lignes
+        if (threadsCount == 0) {
+            threadsCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        const size_t dataSize = static_cast<size_t>(end - dataBegin);
+        const size_t chunksCount = std::max<size_t>(1, std::min(threadsCount, dataSize / sMinChunkSize));
+        std::vector<Chunk> chunks(chunksCount);
+        const char* chunkBegin = dataBegin;
+        for (size_t i = 0; i < chunksCount; ++i) {
+            chunks[i].begin = chunkBegin;
+            chunks[i].end = (i + 1 == chunksCount) ? end : nextRowStart(chunkBegin, std::max(chunkBegin, dataBegin + dataSize * (i + 1) / chunksCount), end, hasQuotes);
+            chunkBegin = chunks[i].end;
+        }
+
+        // parsing parallèle, repris pour les seules colonnes déduites qui doivent être promues
+        std::vector<uint8_t> toParse(colCount, 1);
+        while (true) {
+            if (chunks.size() == 1) {
+                parseChunk(chunks[0], delimiter, types, declared, toParse);
+            } else {
+                std::vector<std::thread> threads;
+                threads.reserve(chunks.size());
+                for (auto& chunk : chunks) {
+                    threads.emplace_back([&chunk, delimiter, &types, &declared, &toParse]() { parseChunk(chunk, delimiter, types, declared, toParse); });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            }
+            bool promoted = false;
+            toParse.assign(colCount, 0);
+            for (const auto& chunk : chunks) {
+                if (!chunk.error.empty()) {
+                    columns_.clear();
+                    throw std::runtime_error(chunk.error);
+                }
+                for (size_t c = 0; c < colCount; ++c) {
+                    if (chunk.columns[c].promoteTo > types[c]) {
+                        types[c] = chunk.columns[c].promoteTo;
+                        toParse[c] = 1;
+                        promoted = true;
+                    }
+                }
+            }
+            if (!promoted) {
+                break;
+            }
+        }
+
+        // concaténation des morceaux, dans l'ordre
+        for (const auto& chunk : chunks) {
+            rowCount_ += chunk.rowCount;
+        }
+        for (size_t c = 0; c < colCount; ++c) {
+            Column& column = columns_[c];
+            column.type = types[c];
+            if (column.type == ColumnType::INT64) {
+                column.ints.reserve(rowCount_);
+            } else if (column.type == ColumnType::DOUBLE) {
+                column.doubles.reserve(rowCount_);
+            } else {
+                column.codes.reserve(rowCount_);
+            }
+            std::unordered_map<std::string, uint32_t> dictionaryIndex;
+            std::vector<uint32_t> remap;
+            for (auto& chunk : chunks) {
+                ChunkColumn& part = chunk.columns[c];
+                column.ints.insert(column.ints.end(), part.ints.begin(), part.ints.end());
+                column.doubles.insert(column.doubles.end(), part.doubles.begin(), part.doubles.end());
+                if (column.type != ColumnType::STRING) {
+                    continue;
+                }
+                remap.resize(part.dictionary.size());
+                for (size_t i = 0; i < part.dictionary.size(); ++i) {
+                    auto it = dictionaryIndex.find(part.dictionary[i]);
+                    if (it == dictionaryIndex.end()) {
+                        it = dictionaryIndex.emplace(part.dictionary[i], static_cast<uint32_t>(column.dictionary.size())).first;
+                        column.dictionary.push_back(std::move(part.dictionary[i]));
+                    }
+                    remap[i] = it->second;
+                }
+                for (const auto code : part.codes) {
+                    column.codes.push_back(remap[code]);
+                }
+            }
+        }
+    }
+};
+
 } // namespace ez
 
 /*
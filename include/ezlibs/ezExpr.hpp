@@ -37,11 +37,13 @@ SOFTWARE.
 #include <limits>
 #include <memory>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <sstream>
 #include <iostream>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 
 #ifndef DONT_DEFINE_DEFAULT_BUILTINS
 #define DEFINE_DEFAULT_BUILTINS
@@ -51,6 +53,11 @@ SOFTWARE.
 #define USE_PERFO_MEASURING
 #endif  // DONT_USE_PERFO_MEASURING
 
+// count of rows evaluated together by Expr::evalArrays
+#ifndef EZ_EXPR_BLOCK_SIZE
+#define EZ_EXPR_BLOCK_SIZE 256
+#endif  // EZ_EXPR_BLOCK_SIZE
+
 namespace ez {
 
 // Class that encapsulates a string
@@ -114,7 +121,7 @@ public:
     }
 
     // Copy assignment operator
-    char operator[](const size_t idx) {
+    char operator[](const size_t idx) const {
         return m_Data[idx];  // no verification
     }
 
@@ -248,14 +255,53 @@ static inline String operator+(const char* lhs, const String& rhs) {
 typedef ::std::function<double(double)> UnaryFunctor;
 typedef ::std::function<double(double, double)> BinaryFunctor;
 typedef ::std::function<double(double, double, double)> TernaryFunctor;
+typedef double (*UnaryFunctionPtr)(double);
+typedef double (*BinaryFunctionPtr)(double, double);
+typedef double (*TernaryFunctionPtr)(double, double, double);
 typedef ::std::unordered_map<String, double> VarContainer;
 typedef ::std::unordered_map<String, double> ConstantContainer;
 
+// Definition of possible instructions of a compiled program
+// NEG to MIX are builtins inlined by the compiler
+enum class OpCode {
+    NUMBER = 0,
+    VARIABLE,
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    POW,
+    MOD,
+    FACTORIAL,
+    UNARY,
+    BINARY,
+    TERNARY,
+    STORE,
+    LOAD,
+    NEG,
+    ABS,
+    FLOOR,
+    CEIL,
+    FRACT,
+    SQRT,
+    MIN,
+    MAX,
+    STEP,
+    CLAMP,
+    MIX,
+    Count
+};
+
 // Structure representing a function with its number of arguments and behavior
 struct Function {
     UnaryFunctor unaryFunctor = nullptr;
     BinaryFunctor binaryFunctor = nullptr;
     TernaryFunctor ternaryFunctor = nullptr;
+    // plain pointers of the builtins, called without the std::function indirection
+    UnaryFunctionPtr unaryPtr = nullptr;
+    BinaryFunctionPtr binaryPtr = nullptr;
+    TernaryFunctionPtr ternaryPtr = nullptr;
+    OpCode inlineOp = OpCode::Count;  // instruction replacing the call, Count if none
     size_t argCount = 0U;
 };
 
@@ -299,6 +345,24 @@ struct Node {
     ::std::array<::std::shared_ptr<Node>, 3> childs{};  // Array of pointers to child nodes
     ::std::array<double, 3> tmp{};  // for avoid allocation during evaluation
     size_t childCount = 0;
+    size_t evalId = 0U;  // id of the last eval() having computed the node, so a shared node is computed once per eval()
+    double evalValue = 0.0;  // value computed by the eval() of id evalId
+};
+
+// Structure representing one instruction of a compiled program
+struct Instruction {
+    OpCode op = OpCode::NUMBER;
+    size_t index = 0U;  // variable slot or function index
+    double value = 0.0;  // literal value
+};
+
+// Flat postfix program produced from the syntax tree, evaluated on a value stack
+struct Program {
+    ::std::vector<Instruction> code;
+    ::std::vector<Function> functions;  // functions called by the program (copied, so the program is self-contained)
+    ::std::vector<String> variables;  // variable name of each slot
+    size_t stackSize = 0U;  // max stack depth needed by the program
+    size_t tempsCount = 0U;  // count of temporaries keeping the shared sub-trees results, stored after the stack
 };
 
 // Class to manage exceptions specific to expression evaluation
@@ -318,7 +382,10 @@ private:
 };
 
 // Main class for evaluating mathematical expressions
+// not thread safe, see ExprContext for evaluating a compiled program from many threads
 class Expr {
+    friend class ExprContext;
+
 private:
     String m_Expr;  // Expression to evaluate
     Node m_RootExpr;  // Root of the syntax tree
@@ -326,8 +393,19 @@ private:
     VarContainer m_DefinedVariables;  // Container for variables defined after parsing
     ConstantContainer m_Constant;  // Container for constants
     FunctionContainer m_Functions;  // Container for functions
+    Program m_Program;  // Compiled program
+    ::std::shared_ptr<const Program> m_SharedProgram;  // Immutable copy of the compiled program, shared with the ExprContext's
+    ::std::vector<const double*> m_ProgramVars;  // Value of each program slot, resolved lazily in m_DefinedVariables
+    ::std::vector<double> m_ProgramStack;  // Value stack used by the compiled program
+    ::std::unordered_map<String, const double*> m_BoundArrays;  // Arrays of values bound to variables for evalArrays
+    ::std::vector<double> m_BlockStack;  // Stack of blocks used by evalArrays
     double m_EvalResult = 0.0;  // Evaluation result
     bool m_Verbose = false;  // Verbose mode
+    bool m_Optimize = true;  // Constant folding and sharing of identical sub-trees after parsing
+    size_t m_ParsedNodesCount = 0U;  // Count of nodes of the parsed syntax tree
+    size_t m_OptimizedNodesCount = 0U;  // Count of nodes after optimization
+    size_t m_EvalId = 0U;  // Id of the current eval(), 0 before the first one
+    size_t m_EvaluatedNodesCount = 0U;  // Count of nodes computed by the last eval()
     ::std::stringstream m_printExpr;  // Stream to print the expression and result
     ::std::chrono::duration<double, ::std::milli> m_Elapsed;  // Evaluation time
     ::std::chrono::steady_clock::time_point m_StartTime;
@@ -346,72 +424,73 @@ public:
         addConstant("e", M_E);  // e
 
         // Initialization of common unary functions
-        addFunction("-", [](double a) { return -a; });
+        m_addBuiltin("-", [](double a) { return -a; }, OpCode::NEG);
 
-        addFunction("abs", [](double a) { return ::std::abs(a); });
-        addFunction("floor", [](double a) { return ::std::floor(a); });
-        addFunction("ceil", [](double a) { return ::std::ceil(a); });
-        addFunction("round", [](double a) { return ::std::round(a); });
+        m_addBuiltin("abs", [](double a) { return ::std::abs(a); }, OpCode::ABS);
+        m_addBuiltin("floor", [](double a) { return ::std::floor(a); }, OpCode::FLOOR);
+        m_addBuiltin("ceil", [](double a) { return ::std::ceil(a); }, OpCode::CEIL);
+        m_addBuiltin("round", [](double a) { return ::std::round(a); });
 
-        addFunction("fract", [](double a) { return a - ::std::floor(a); });
-        addFunction("sign", [this](double a) { return m_Sign(a); });
+        m_addBuiltin("fract", [](double a) { return a - ::std::floor(a); }, OpCode::FRACT);
+        m_addBuiltin("sign", [](double a) { return m_Sign(a); });
 
-        addFunction("sin", [](double a) { return ::std::sin(a); });
-        addFunction("cos", [](double a) { return ::std::cos(a); });
-        addFunction("tan", [](double a) { return ::std::tan(a); });
+        m_addBuiltin("sin", [](double a) { return ::std::sin(a); });
+        m_addBuiltin("cos", [](double a) { return ::std::cos(a); });
+        m_addBuiltin("tan", [](double a) { return ::std::tan(a); });
 
-        addFunction("asin", [](double a) { return ::std::asin(a); });
-        addFunction("acos", [](double a) { return ::std::acos(a); });
-        addFunction("atan", [](double a) { return ::std::atan(a); });
+        m_addBuiltin("asin", [](double a) { return ::std::asin(a); });
+        m_addBuiltin("acos", [](double a) { return ::std::acos(a); });
+        m_addBuiltin("atan", [](double a) { return ::std::atan(a); });
 
-        addFunction("sinh", [](double a) { return ::std::sinh(a); });
-        addFunction("cosh", [](double a) { return ::std::cosh(a); });
-        addFunction("tanh", [](double a) { return ::std::tanh(a); });
+        m_addBuiltin("sinh", [](double a) { return ::std::sinh(a); });
+        m_addBuiltin("cosh", [](double a) { return ::std::cosh(a); });
+        m_addBuiltin("tanh", [](double a) { return ::std::tanh(a); });
 
-        addFunction("asinh", [](double a) { return ::std::asinh(a); });
-        addFunction("acosh", [](double a) { return ::std::acosh(a); });
-        addFunction("atanh", [](double a) { return ::std::atanh(a); });
+        m_addBuiltin("asinh", [](double a) { return ::std::asinh(a); });
+        m_addBuiltin("acosh", [](double a) { return ::std::acosh(a); });
+        m_addBuiltin("atanh", [](double a) { return ::std::atanh(a); });
 
-        addFunction("ln", [](double a) { return ::std::log(a); });
-        addFunction("log", [](double a) { return ::std::log(a); });
-        addFunction("log1p", [](double a) { return ::std::log1p(a); });
-        addFunction("logb", [](double a) { return ::std::logb(a); });
-        addFunction("log2", [](double a) { return ::std::log2(a); });
-        addFunction("log10", [](double a) { return ::std::log10(a); });
+        m_addBuiltin("ln", [](double a) { return ::std::log(a); });
+        m_addBuiltin("log", [](double a) { return ::std::log(a); });
+        m_addBuiltin("log1p", [](double a) { return ::std::log1p(a); });
+        m_addBuiltin("logb", [](double a) { return ::std::logb(a); });
+        m_addBuiltin("log2", [](double a) { return ::std::log2(a); });
+        m_addBuiltin("log10", [](double a) { return ::std::log10(a); });
 
-        addFunction("sqrt", [](double a) { return ::std::sqrt(a); });
-        addFunction("exp", [](double a) { return ::std::exp(a); });
+        m_addBuiltin("sqrt", [](double a) { return ::std::sqrt(a); }, OpCode::SQRT);
+        m_addBuiltin("exp", [](double a) { return ::std::exp(a); });
 
-        addFunction("fact", [this](double a) { return m_Factorial(a); });
+        m_addBuiltin("fact", [](double a) { return m_Factorial(a); });
 
-        addFunction("saturate", [this](double a) { return m_Clamp(a, 0.0, 1.0); });
+        m_addBuiltin("saturate", [](double a) { return m_Clamp(a, 0.0, 1.0); });
 
         // Initialization of common binary functions
-        addFunction("mod", [](double a, double b) { return ::std::fmod(a, b); });
-        addFunction("pow", [](double a, double b) {
+        m_addBuiltin("mod", [](double a, double b) { return ::std::fmod(a, b); });
+        m_addBuiltin("pow", [](double a, double b) {
             if (a < 0.0) {
                 throw ExprException(ErrorCode::EVALUATION_NAN, "Pow base value is negative");
             }
             return ::std::pow(a, b);
         });
-        addFunction("atan2", [](double a, double b) { return ::std::atan2(a, b); });
-        addFunction("min", [this](double a, double b) { return m_Min(a, b); });
-        addFunction("max", [this](double a, double b) { return m_Max(a, b); });
-        addFunction("step", [this](double a, double b) { return m_Step(a, b); });
-        addFunction("hypot", [](double a, double b) { return ::std::hypot(a, b); });
-        addFunction("smoothabs", [this](double a, double b) { return m_SmoothAbs(a, b); });
+        m_addBuiltin("atan2", [](double a, double b) { return ::std::atan2(a, b); });
+        m_addBuiltin("min", [](double a, double b) { return m_Min(a, b); }, OpCode::MIN);
+        m_addBuiltin("max", [](double a, double b) { return m_Max(a, b); }, OpCode::MAX);
+        m_addBuiltin("step", [](double a, double b) { return m_Step(a, b); }, OpCode::STEP);
+        m_addBuiltin("hypot", [](double a, double b) { return ::std::hypot(a, b); });
+        m_addBuiltin("smoothabs", [](double a, double b) { return m_SmoothAbs(a, b); });
 
         // Initialization of common ternary functions
-        addFunction("clamp", [this](double a, double b, double c) { return m_Clamp(a, b, c); });
-        addFunction("lerp", [this](double a, double b, double c) { return m_Mix(a, b, c); });
-        addFunction("mix", [this](double a, double b, double c) { return m_Mix(a, b, c); });
-        addFunction("smoothstep", [this](double a, double b, double c) { return m_SmoothStep(a, b, c); });
+        m_addBuiltin("clamp", [](double a, double b, double c) { return m_Clamp(a, b, c); }, OpCode::CLAMP);
+        m_addBuiltin("lerp", [](double a, double b, double c) { return m_Mix(a, b, c); }, OpCode::MIX);
+        m_addBuiltin("mix", [](double a, double b, double c) { return m_Mix(a, b, c); }, OpCode::MIX);
+        m_addBuiltin("smoothstep", [](double a, double b, double c) { return m_SmoothStep(a, b, c); });
     }
 
     // Method to parse an expression
     Expr& parse(const String& vExpr) {
         m_Expr = vExpr;  // Store the expression
         m_ParsedVariables.clear();  // clearing discoverd vairable during parsing
+        m_clearProgram();  // the previous compiled program is obsolete
         auto tokens = m_tokenize(m_Expr);  // Tokenize the expression
         size_t pos = 0;
         m_RootExpr = m_parseExpression(tokens, pos, 0);  // Parse the expression to create the syntax tree
@@ -426,6 +505,18 @@ public:
             throw ExprException(ErrorCode::PARSE_ERROR, "Unexpected token found after complete parsing.");
         }
 
+        m_ParsedNodesCount = m_countNodes(m_RootExpr);
+        if (m_Optimize) {
+            m_foldConstants(m_RootExpr);
+            ::std::unordered_map<::std::string, ::std::pair<size_t, ::std::shared_ptr<Node>>> uniques;
+            m_shareSubTrees(m_RootExpr, nullptr, uniques);
+        }
+        m_OptimizedNodesCount = m_countNodes(m_RootExpr);
+        if (m_Verbose) {
+            m_log("Nodes: " + String::fromDouble(static_cast<double>(m_ParsedNodesCount)) + " -> " +
+                  String::fromDouble(static_cast<double>(m_OptimizedNodesCount)) + "\n");
+        }
+
         return *this;
     }
 
@@ -441,11 +532,98 @@ public:
     }
 
     // Method to evaluate the expression
+    // the shared sub-trees are computed once, then their value is reused by their other parents
     Expr& eval() {
+        ++m_EvalId;
+        m_EvaluatedNodesCount = 0U;
         m_evalNode(m_RootExpr, m_EvalResult);  // Evaluate the root of the syntax tree
         return *this;
     }
 
+    // Method to compile the syntax tree into a flat program
+    // variables and functions are resolved once, so evalCompiled() does no lookup per node
+    Expr& compile() {
+        m_clearProgram();
+        CompileDatas datas;
+        m_countParents(m_RootExpr, datas.parents);
+        m_compileNode(m_RootExpr, datas);
+        m_ProgramVars.resize(m_Program.variables.size(), nullptr);
+        m_ProgramStack.resize(m_Program.stackSize + m_Program.tempsCount);
+        if (m_Verbose) {
+            m_log("Program: " + String::fromDouble(static_cast<double>(m_Program.code.size())) + " instructions, stack of " +
+                  String::fromDouble(static_cast<double>(m_Program.stackSize)) + "\n");
+        }
+        return *this;
+    }
+
+    // Method to evaluate the compiled program (compiled on first call)
+    Expr& evalCompiled() {
+        if (m_Program.code.empty()) {
+            compile();
+        }
+        for (size_t idx = 0; idx < m_ProgramVars.size(); ++idx) {
+            m_resolveProgramVar(idx);
+        }
+        m_EvalResult = m_runProgram(m_Program, m_ProgramVars.data(), m_ProgramStack.data());
+        return *this;
+    }
+
+    // Method to bind a variable to an array of values, used by evalArrays()
+    // the array must stay valid until evalArrays() is called
+    Expr& bindArray(const String& vName, const double* vValues) {
+        m_BoundArrays[vName] = vValues;
+        return *this;
+    }
+
+    // Method to remove the arrays bound with bindArray()
+    Expr& clearArrays() {
+        m_BoundArrays.clear();
+        return *this;
+    }
+
+    // Method to evaluate the compiled program on vCount rows, writing one result per row in vOutResults
+    // a variable bound with bindArray() takes the value of the row, the others keep the value defined with set()
+    // the program is run instruction by instruction over blocks of EZ_EXPR_BLOCK_SIZE rows, so the inner loops can be vectorized
+    Expr& evalArrays(double* vOutResults, const size_t vCount) {
+        if (m_Program.code.empty()) {
+            compile();
+        }
+        ::std::vector<const double*> arrays(m_Program.variables.size(), nullptr);
+        for (size_t idx = 0; idx < arrays.size(); ++idx) {
+            auto it = m_BoundArrays.find(m_Program.variables[idx]);
+            if (it != m_BoundArrays.end()) {
+                arrays[idx] = it->second;
+            } else {
+                m_resolveProgramVar(idx);
+            }
+        }
+        m_BlockStack.resize((m_Program.stackSize + m_Program.tempsCount) * EZ_EXPR_BLOCK_SIZE);
+        for (size_t start = 0; start < vCount; start += EZ_EXPR_BLOCK_SIZE) {
+            const size_t count = (vCount - start < EZ_EXPR_BLOCK_SIZE) ? vCount - start : EZ_EXPR_BLOCK_SIZE;
+            m_runProgramBlock(m_Program, m_ProgramVars.data(), arrays.data(), start, count, m_BlockStack.data());
+            ::std::memcpy(vOutResults + start, m_BlockStack.data(), count * sizeof(double));
+        }
+        return *this;
+    }
+
+    // test if the expression is compiled
+    bool isCompiled() const { return !m_Program.code.empty(); }
+
+    // Returns the compiled program
+    const Program& getProgram() const { return m_Program; }
+
+    // Returns an immutable copy of the compiled program (compiled if needed), to be evaluated by ExprContext's
+    // the copy is self-contained, it stays valid after a new parse or the destruction of this Expr
+    ::std::shared_ptr<const Program> getSharedProgram() {
+        if (m_Program.code.empty()) {
+            compile();
+        }
+        if (m_SharedProgram == nullptr) {
+            m_SharedProgram = ::std::make_shared<const Program>(m_Program);
+        }
+        return m_SharedProgram;
+    }
+
     Expr& startTime() {
         m_StartTime = ::std::chrono::steady_clock::now();  // Start time
         return *this;
@@ -474,6 +652,7 @@ public:
         fun.unaryFunctor = functor;
         fun.argCount = 1;
         m_Functions[vName] = fun;
+        m_clearProgram();  // the compiled program holds a copy of the functions
         return *this;
     }
 
@@ -483,6 +662,7 @@ public:
         fun.binaryFunctor = functor;
         fun.argCount = 2;
         m_Functions[vName] = fun;
+        m_clearProgram();  // the compiled program holds a copy of the functions
         return *this;
     }
 
@@ -492,6 +672,7 @@ public:
         fun.ternaryFunctor = functor;
         fun.argCount = 3;
         m_Functions[vName] = fun;
+        m_clearProgram();  // the compiled program holds a copy of the functions
         return *this;
     }
 
@@ -501,6 +682,21 @@ public:
         return *this;
     }
 
+    // Method to enable or disable the optimization of the syntax tree, applied by the next parse()
+    Expr& setOptimization(bool vOptimize) {
+        m_Optimize = vOptimize;
+        return *this;
+    }
+
+    // Returns the count of nodes of the parsed syntax tree, before optimization
+    size_t getParsedNodesCount() const { return m_ParsedNodesCount; }
+
+    // Returns the count of nodes evaluated, after optimization
+    size_t getOptimizedNodesCount() const { return m_OptimizedNodesCount; }
+
+    // Returns the count of nodes computed by the last eval()
+    size_t getEvaluatedNodesCount() const { return m_EvaluatedNodesCount; }
+
     // Returns the evaluation result
     double getResult() { return m_EvalResult; }
 
@@ -508,6 +704,7 @@ public:
     Expr& print() {
         m_printExpr = {};
         m_printExpr << "Expr \"" << m_Expr << "\"";
+        m_printExpr << " [nodes " << m_ParsedNodesCount << " -> " << m_OptimizedNodesCount << "]";
         for (const auto& it : m_DefinedVariables) {
             m_printExpr << ", " << it.first << " = " << it.second;
         }
@@ -535,9 +732,21 @@ public:
     const VarContainer& getDefinedVars() { return m_DefinedVariables; }
 
     // Returns defined variables as a modifiable reference
-    VarContainer& getDefinedVarsRef() { return m_DefinedVariables; }
+    VarContainer& getDefinedVarsRef() {
+        m_ProgramVars.assign(m_ProgramVars.size(), nullptr);  // the caller can erase variables
+        return m_DefinedVariables;
+    }
 
 protected:
+    // Temporary datas of compile()
+    struct CompileDatas {
+        ::std::unordered_map<String, size_t> slots;  // slot of each variable
+        ::std::unordered_map<String, size_t> functions;  // index of each function in the program
+        ::std::unordered_map<const Node*, size_t> parents;  // count of parents of each node
+        ::std::unordered_map<const Node*, size_t> temps;  // temporary of the shared nodes already emitted
+        size_t depth = 0U;  // current stack depth
+    };
+
     // Tokenize the expression
     ::std::vector<Token> m_tokenize(const String& expr) {
         ::std::vector<Token> tokens;
@@ -590,6 +799,11 @@ protected:
 
     // Evaluate a node in the syntax tree
     void m_evalNode(Node& node, double& vOutResult) {
+        if (node.childCount > 0 && m_EvalId != 0U && node.evalId == m_EvalId) {
+            vOutResult = node.evalValue;  // shared node already computed by this eval()
+            return;
+        }
+        ++m_EvaluatedNodesCount;
         switch (node.type) {
             case NodeType::NUMBER: {
                 vOutResult = node.value;
@@ -662,12 +876,612 @@ protected:
         } else if (::std::isinf(vOutResult)) {
             throw ExprException(ErrorCode::EVALUATION_INF, "Result is Inf");
         }
+        node.evalId = m_EvalId;
+        node.evalValue = vOutResult;
 
         if (m_Verbose) {
             m_log("Evaluating Node: " + String::fromDouble(vOutResult) + "\n");
         }
     }
 
+    // Count the distinct nodes of the syntax tree
+    size_t m_countNodes(const Node& vNode) {
+        ::std::unordered_set<const Node*> visited;
+        m_collectNodes(vNode, visited);
+        return visited.size();
+    }
+
+    void m_collectNodes(const Node& vNode, ::std::unordered_set<const Node*>& vVisited) {
+        if (vVisited.insert(&vNode).second) {
+            for (size_t idx = 0; idx < vNode.childCount; ++idx) {
+                m_collectNodes(*vNode.childs[idx], vVisited);
+            }
+        }
+    }
+
+    // test if a node always gives the same result for the same childs values
+    // user functions can have side effects, only the builtins are considered as pure
+    bool m_isPureNode(const Node& vNode) {
+        if (vNode.type == NodeType::FUNCTION) {
+            auto it = m_Functions.find(vNode.name);
+            if (it == m_Functions.end()) {
+                return (vNode.name[0] == '!');  // factorial
+            }
+            return (it->second.unaryPtr != nullptr || it->second.binaryPtr != nullptr || it->second.ternaryPtr != nullptr);
+        }
+        return true;
+    }
+
+    // Replace the sub-trees made only of numbers and constants by NUMBER nodes
+    void m_foldConstants(Node& vNode) {
+        bool onlyNumbers = true;
+        for (size_t idx = 0; idx < vNode.childCount; ++idx) {
+            m_foldConstants(*vNode.childs[idx]);
+            onlyNumbers &= (vNode.childs[idx]->type == NodeType::NUMBER);
+        }
+        if (vNode.childCount > 0 && onlyNumbers && m_isPureNode(vNode)) {
+            double value = 0.0;
+            try {
+                m_evalNode(vNode, value);
+            } catch (const ExprException&) {
+                return;  // not folded, so the error is thrown by the evaluation
+            }
+            Node folded;
+            folded.type = NodeType::NUMBER;
+            folded.value = value;
+            vNode = folded;
+        }
+    }
+
+    // Make the identical pure sub-trees share the same node, returns the id of the node
+    // vNodePtr is the pointer of the node in its parent, nullptr for the root
+    size_t m_shareSubTrees(Node& vNode,
+                           ::std::shared_ptr<Node>* vNodePtr,
+                           ::std::unordered_map<::std::string, ::std::pair<size_t, ::std::shared_ptr<Node>>>& vUniques) {
+        ::std::string key;
+        key += static_cast<char>('0' + static_cast<int>(vNode.type));
+        key += vNode.name.to_string();
+        if (vNode.type == NodeType::NUMBER) {
+            uint64_t bits = 0U;
+            ::std::memcpy(&bits, &vNode.value, sizeof(bits));
+            key += ::std::to_string(bits);
+        }
+        for (size_t idx = 0; idx < vNode.childCount; ++idx) {
+            key += '|';
+            key += ::std::to_string(m_shareSubTrees(*vNode.childs[idx], &vNode.childs[idx], vUniques));
+        }
+        if (!m_isPureNode(vNode)) {
+            key += '#';
+            key += ::std::to_string(reinterpret_cast<uintptr_t>(&vNode));  // never matched
+        }
+        auto it = vUniques.find(key);
+        if (it != vUniques.end()) {
+            if (vNodePtr != nullptr && vNode.childCount > 0 && it->second.second != nullptr) {
+                *vNodePtr = it->second.second;  // the leafs are not worth sharing
+            }
+            return it->second.first;
+        }
+        const size_t id = vUniques.size();
+        vUniques.emplace(key, ::std::make_pair(id, vNodePtr != nullptr ? *vNodePtr : nullptr));
+        return id;
+    }
+
+    // Reset the compiled program
+    void m_clearProgram() {
+        m_Program = {};
+        m_SharedProgram = nullptr;
+        m_ProgramVars.clear();
+    }
+
+    // Resolve the value of a program slot in the defined variables
+    void m_resolveProgramVar(const size_t vSlot) {
+        if (m_ProgramVars[vSlot] == nullptr) {
+            auto it = m_DefinedVariables.find(m_Program.variables[vSlot]);
+            if (it == m_DefinedVariables.end()) {
+                throw ExprException(ErrorCode::VARIABLE_NOT_FOUND, "Variable not found: " + m_Program.variables[vSlot]);
+            }
+            m_ProgramVars[vSlot] = &it->second;  // unordered_map never moves its elements
+        }
+    }
+
+    // Add a builtin function, vInlineOp is the instruction replacing its call in a compiled program
+    void m_addBuiltin(const String& vName, const UnaryFunctionPtr vPtr, const OpCode vInlineOp = OpCode::Count) {
+        Function fun;
+        fun.unaryFunctor = vPtr;
+        fun.unaryPtr = vPtr;
+        fun.inlineOp = vInlineOp;
+        fun.argCount = 1;
+        m_Functions[vName] = fun;
+        m_clearProgram();
+    }
+
+    void m_addBuiltin(const String& vName, const BinaryFunctionPtr vPtr, const OpCode vInlineOp = OpCode::Count) {
+        Function fun;
+        fun.binaryFunctor = vPtr;
+        fun.binaryPtr = vPtr;
+        fun.inlineOp = vInlineOp;
+        fun.argCount = 2;
+        m_Functions[vName] = fun;
+        m_clearProgram();
+    }
+
+    void m_addBuiltin(const String& vName, const TernaryFunctionPtr vPtr, const OpCode vInlineOp = OpCode::Count) {
+        Function fun;
+        fun.ternaryFunctor = vPtr;
+        fun.ternaryPtr = vPtr;
+        fun.inlineOp = vInlineOp;
+        fun.argCount = 3;
+        m_Functions[vName] = fun;
+        m_clearProgram();
+    }
+
+    // Count the parents of each node of the syntax tree, more than one for the shared sub-trees
+    void m_countParents(const Node& vNode, ::std::unordered_map<const Node*, size_t>& vParents) {
+        for (size_t idx = 0; idx < vNode.childCount; ++idx) {
+            if (++vParents[vNode.childs[idx].get()] == 1U) {
+                m_countParents(*vNode.childs[idx], vParents);
+            }
+        }
+    }
+
+    // Push an instruction and update the max stack depth
+    // vPopCount is the count of values consumed by the instruction, which pushes one value
+    void m_emit(const Instruction& vIns, const size_t vPopCount, CompileDatas& vDatas) {
+        m_Program.code.push_back(vIns);
+        vDatas.depth = vDatas.depth - vPopCount + 1U;
+        if (vDatas.depth > m_Program.stackSize) {
+            m_Program.stackSize = vDatas.depth;
+        }
+    }
+
+    // Emit the instructions of a node in postfix order
+    // a shared sub-tree is computed once, stored in a temporary, then loaded
+    void m_compileNode(const Node& node, CompileDatas& vDatas) {
+        auto tit = vDatas.temps.find(&node);
+        if (tit != vDatas.temps.end()) {
+            Instruction load;
+            load.op = OpCode::LOAD;
+            load.index = tit->second;
+            m_emit(load, 0U, vDatas);
+            return;
+        }
+        for (size_t idx = 0; idx < node.childCount; ++idx) {
+            m_compileNode(*node.childs[idx], vDatas);
+        }
+        Instruction ins;
+        switch (node.type) {
+            case NodeType::NUMBER: {
+                ins.op = OpCode::NUMBER;
+                ins.value = node.value;
+            } break;
+            case NodeType::VARIABLE: {
+                ins.op = OpCode::VARIABLE;
+                auto it = vDatas.slots.find(node.name);
+                if (it == vDatas.slots.end()) {
+                    it = vDatas.slots.emplace(node.name, m_Program.variables.size()).first;
+                    m_Program.variables.push_back(node.name);
+                }
+                ins.index = it->second;
+            } break;
+            case NodeType::OPERATOR: {
+                switch (node.name[0]) {
+                    case '+': ins.op = OpCode::ADD; break;
+                    case '-': ins.op = OpCode::SUB; break;
+                    case '*': ins.op = OpCode::MUL; break;
+                    case '/': ins.op = OpCode::DIV; break;
+                    case '^': ins.op = OpCode::POW; break;
+                    case '%': ins.op = OpCode::MOD; break;
+                    default: throw ExprException(ErrorCode::OPERATOR_NOT_FOUND, "Operator not found: " + node.name);
+                }
+            } break;
+            case NodeType::FUNCTION: {
+                auto it = m_Functions.find(node.name);
+                if (it == m_Functions.end()) {
+                    // Special case handling for the "!" operator (factorial)
+                    if (node.name[0] == '!') {
+                        ins.op = OpCode::FACTORIAL;
+                    } else {
+                        throw ExprException(ErrorCode::FUNCTION_NOT_FOUND, "Function not found: " + node.name);
+                    }
+                } else if (it->second.inlineOp != OpCode::Count) {
+                    ins.op = it->second.inlineOp;  // builtin computed in place, without call
+                } else {
+                    if (it->second.argCount == 1) {
+                        ins.op = OpCode::UNARY;
+                    } else if (it->second.argCount == 2) {
+                        ins.op = OpCode::BINARY;
+                    } else {
+                        ins.op = OpCode::TERNARY;
+                    }
+                    auto fit = vDatas.functions.find(node.name);
+                    if (fit == vDatas.functions.end()) {
+                        fit = vDatas.functions.emplace(node.name, m_Program.functions.size()).first;
+                        m_Program.functions.push_back(it->second);
+                    }
+                    ins.index = fit->second;
+                }
+            } break;
+            default: throw ExprException(ErrorCode::UNKNOWN_NODE_TYPE, "Unknown node type");
+        }
+        m_emit(ins, node.childCount, vDatas);
+        auto pit = vDatas.parents.find(&node);
+        if (pit != vDatas.parents.end() && pit->second > 1U) {
+            Instruction store;
+            store.op = OpCode::STORE;
+            store.index = m_Program.tempsCount++;
+            vDatas.temps[&node] = store.index;
+            m_emit(store, 1U, vDatas);  // the value stays on the stack
+        }
+    }
+
+    // Run a compiled program
+    // vVars contains the value of each variable slot, vStack must hold vProgram.stackSize + vProgram.tempsCount values
+    static double m_runProgram(const Program& vProgram, const double* const* vVars, double* vStack) {
+        double* sp = vStack;  // next free stack entry
+        for (const auto& ins : vProgram.code) {
+            switch (ins.op) {
+                case OpCode::NUMBER: {
+                    *sp++ = ins.value;
+                } break;
+                case OpCode::VARIABLE: {
+                    *sp++ = *vVars[ins.index];
+                } break;
+                case OpCode::ADD: {
+                    --sp;
+                    sp[-1] = sp[-1] + sp[0];
+                } break;
+                case OpCode::SUB: {
+                    --sp;
+                    sp[-1] = sp[-1] - sp[0];
+                } break;
+                case OpCode::MUL: {
+                    --sp;
+                    sp[-1] = sp[-1] * sp[0];
+                } break;
+                case OpCode::DIV: {
+                    --sp;
+                    if (sp[0] == 0.0) {
+                        throw ExprException(ErrorCode::DIVISION_BY_ZERO, "Division by zero");
+                    }
+                    sp[-1] = sp[-1] / sp[0];
+                } break;
+                case OpCode::POW: {
+                    --sp;
+                    if (sp[-1] < 0.0) {
+                        throw ExprException(ErrorCode::EVALUATION_NAN, "Pow base value is negative");
+                    }
+                    sp[-1] = ::std::pow(sp[-1], sp[0]);
+                } break;
+                case OpCode::MOD: {
+                    --sp;
+                    if (sp[0] == 0.0) {
+                        throw ExprException(ErrorCode::DIVISION_BY_ZERO, "Division by zero");
+                    }
+                    sp[-1] = ::std::fmod(sp[-1], sp[0]);
+                } break;
+                case OpCode::FACTORIAL: {
+                    sp[-1] = m_Factorial(sp[-1]);
+                } break;
+                case OpCode::UNARY: {
+                    const auto& fun = vProgram.functions[ins.index];
+                    sp[-1] = fun.unaryPtr ? fun.unaryPtr(sp[-1]) : fun.unaryFunctor(sp[-1]);
+                } break;
+                case OpCode::BINARY: {
+                    --sp;
+                    const auto& fun = vProgram.functions[ins.index];
+                    sp[-1] = fun.binaryPtr ? fun.binaryPtr(sp[-1], sp[0]) : fun.binaryFunctor(sp[-1], sp[0]);
+                } break;
+                case OpCode::TERNARY: {
+                    sp -= 2;
+                    const auto& fun = vProgram.functions[ins.index];
+                    sp[-1] = fun.ternaryPtr ? fun.ternaryPtr(sp[-1], sp[0], sp[1]) : fun.ternaryFunctor(sp[-1], sp[0], sp[1]);
+                } break;
+                case OpCode::STORE: {
+                    vStack[vProgram.stackSize + ins.index] = sp[-1];
+                } break;
+                case OpCode::LOAD: {
+                    *sp++ = vStack[vProgram.stackSize + ins.index];
+                } break;
+                case OpCode::NEG: {
+                    sp[-1] = -sp[-1];
+                } break;
+                case OpCode::ABS: {
+                    sp[-1] = ::std::abs(sp[-1]);
+                } break;
+                case OpCode::FLOOR: {
+                    sp[-1] = ::std::floor(sp[-1]);
+                } break;
+                case OpCode::CEIL: {
+                    sp[-1] = ::std::ceil(sp[-1]);
+                } break;
+                case OpCode::FRACT: {
+                    sp[-1] = sp[-1] - ::std::floor(sp[-1]);
+                } break;
+                case OpCode::SQRT: {
+                    sp[-1] = ::std::sqrt(sp[-1]);
+                } break;
+                case OpCode::MIN: {
+                    --sp;
+                    sp[-1] = m_Min(sp[-1], sp[0]);
+                } break;
+                case OpCode::MAX: {
+                    --sp;
+                    sp[-1] = m_Max(sp[-1], sp[0]);
+                } break;
+                case OpCode::STEP: {
+                    --sp;
+                    sp[-1] = m_Step(sp[-1], sp[0]);
+                } break;
+                case OpCode::CLAMP: {
+                    sp -= 2;
+                    sp[-1] = m_Clamp(sp[-1], sp[0], sp[1]);
+                } break;
+                case OpCode::MIX: {
+                    sp -= 2;
+                    sp[-1] = m_Mix(sp[-1], sp[0], sp[1]);
+                } break;
+                default: throw ExprException(ErrorCode::UNKNOWN_NODE_TYPE, "Unknown instruction");
+            }
+            // same checks as the tree walker, on each intermediate result
+            if (::std::isnan(sp[-1])) {
+                throw ExprException(ErrorCode::EVALUATION_NAN, "Result is NaN");
+            } else if (::std::isinf(sp[-1])) {
+                throw ExprException(ErrorCode::EVALUATION_INF, "Result is Inf");
+            }
+        }
+        return vStack[0];
+    }
+
+    // Run a compiled program over a block of vCount rows (vCount <= EZ_EXPR_BLOCK_SIZE), the results are left in the first block of vStack
+    // a slot takes its values in vArrays[slot] from row vStart if not null, else *vVars[slot] for each row
+    // vStack must hold vProgram.stackSize + vProgram.tempsCount blocks of EZ_EXPR_BLOCK_SIZE values
+    static void m_runProgramBlock(const Program& vProgram,
+                                  const double* const* vVars,
+                                  const double* const* vArrays,
+                                  const size_t vStart,
+                                  const size_t vCount,
+                                  double* vStack) {
+        const size_t n = vCount;
+        double* top = vStack;  // next free block
+        double* temps = vStack + vProgram.stackSize * EZ_EXPR_BLOCK_SIZE;  // blocks of the temporaries
+        for (const auto& ins : vProgram.code) {
+            double* a = nullptr;  // first operand, receives the result
+            const double* b = nullptr;  // second operand
+            const double* c = nullptr;  // third operand
+            switch (ins.op) {
+                case OpCode::NUMBER:
+                case OpCode::VARIABLE:
+                case OpCode::LOAD: {
+                    a = top;
+                    top += EZ_EXPR_BLOCK_SIZE;
+                } break;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::POW:
+                case OpCode::MOD:
+                case OpCode::BINARY:
+                case OpCode::MIN:
+                case OpCode::MAX:
+                case OpCode::STEP: {
+                    top -= EZ_EXPR_BLOCK_SIZE;
+                    a = top - EZ_EXPR_BLOCK_SIZE;
+                    b = top;
+                } break;
+                case OpCode::TERNARY:
+                case OpCode::CLAMP:
+                case OpCode::MIX: {
+                    top -= 2 * EZ_EXPR_BLOCK_SIZE;
+                    a = top - EZ_EXPR_BLOCK_SIZE;
+                    b = top;
+                    c = top + EZ_EXPR_BLOCK_SIZE;
+                } break;
+                default: {
+                    a = top - EZ_EXPR_BLOCK_SIZE;
+                } break;
+            }
+            switch (ins.op) {
+                case OpCode::NUMBER: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ins.value;
+                    }
+                } break;
+                case OpCode::VARIABLE: {
+                    if (vArrays[ins.index] != nullptr) {
+                        ::std::memcpy(a, vArrays[ins.index] + vStart, n * sizeof(double));
+                    } else {
+                        const double value = *vVars[ins.index];
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = value;
+                        }
+                    }
+                } break;
+                case OpCode::ADD: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = a[i] + b[i];
+                    }
+                } break;
+                case OpCode::SUB: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = a[i] - b[i];
+                    }
+                } break;
+                case OpCode::MUL: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = a[i] * b[i];
+                    }
+                } break;
+                case OpCode::DIV: {
+                    if (m_hasZero(b, n)) {
+                        throw ExprException(ErrorCode::DIVISION_BY_ZERO, "Division by zero");
+                    }
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = a[i] / b[i];
+                    }
+                } break;
+                case OpCode::POW: {
+                    if (m_hasNegative(a, n)) {
+                        throw ExprException(ErrorCode::EVALUATION_NAN, "Pow base value is negative");
+                    }
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::pow(a[i], b[i]);
+                    }
+                } break;
+                case OpCode::MOD: {
+                    if (m_hasZero(b, n)) {
+                        throw ExprException(ErrorCode::DIVISION_BY_ZERO, "Division by zero");
+                    }
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::fmod(a[i], b[i]);
+                    }
+                } break;
+                case OpCode::FACTORIAL: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Factorial(a[i]);
+                    }
+                } break;
+                case OpCode::UNARY: {
+                    const auto& fun = vProgram.functions[ins.index];
+                    if (fun.unaryPtr) {
+                        const UnaryFunctionPtr ptr = fun.unaryPtr;
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = ptr(a[i]);
+                        }
+                    } else {
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = fun.unaryFunctor(a[i]);
+                        }
+                    }
+                } break;
+                case OpCode::BINARY: {
+                    const auto& fun = vProgram.functions[ins.index];
+                    if (fun.binaryPtr) {
+                        const BinaryFunctionPtr ptr = fun.binaryPtr;
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = ptr(a[i], b[i]);
+                        }
+                    } else {
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = fun.binaryFunctor(a[i], b[i]);
+                        }
+                    }
+                } break;
+                case OpCode::TERNARY: {
+                    const auto& fun = vProgram.functions[ins.index];
+                    if (fun.ternaryPtr) {
+                        const TernaryFunctionPtr ptr = fun.ternaryPtr;
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = ptr(a[i], b[i], c[i]);
+                        }
+                    } else {
+                        for (size_t i = 0; i < n; ++i) {
+                            a[i] = fun.ternaryFunctor(a[i], b[i], c[i]);
+                        }
+                    }
+                } break;
+                case OpCode::STORE: {
+                    ::std::memcpy(temps + ins.index * EZ_EXPR_BLOCK_SIZE, a, n * sizeof(double));
+                } break;
+                case OpCode::LOAD: {
+                    ::std::memcpy(a, temps + ins.index * EZ_EXPR_BLOCK_SIZE, n * sizeof(double));
+                } break;
+                case OpCode::NEG: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = -a[i];
+                    }
+                } break;
+                case OpCode::ABS: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::abs(a[i]);
+                    }
+                } break;
+                case OpCode::FLOOR: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::floor(a[i]);
+                    }
+                } break;
+                case OpCode::CEIL: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::ceil(a[i]);
+                    }
+                } break;
+                case OpCode::FRACT: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = a[i] - ::std::floor(a[i]);
+                    }
+                } break;
+                case OpCode::SQRT: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = ::std::sqrt(a[i]);
+                    }
+                } break;
+                case OpCode::MIN: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Min(a[i], b[i]);
+                    }
+                } break;
+                case OpCode::MAX: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Max(a[i], b[i]);
+                    }
+                } break;
+                case OpCode::STEP: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Step(a[i], b[i]);
+                    }
+                } break;
+                case OpCode::CLAMP: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Clamp(a[i], b[i], c[i]);
+                    }
+                } break;
+                case OpCode::MIX: {
+                    for (size_t i = 0; i < n; ++i) {
+                        a[i] = m_Mix(a[i], b[i], c[i]);
+                    }
+                } break;
+                default: throw ExprException(ErrorCode::UNKNOWN_NODE_TYPE, "Unknown instruction");
+            }
+            m_checkBlock(a, n);
+        }
+    }
+
+    // Test if a block contains a zero, without branch so the loop can be vectorized
+    static bool m_hasZero(const double* vBlock, const size_t vCount) {
+        int found = 0;
+        for (size_t i = 0; i < vCount; ++i) {
+            found |= (vBlock[i] == 0.0);
+        }
+        return found != 0;
+    }
+
+    // Test if a block contains a negative value, without branch so the loop can be vectorized
+    static bool m_hasNegative(const double* vBlock, const size_t vCount) {
+        int found = 0;
+        for (size_t i = 0; i < vCount; ++i) {
+            found |= (vBlock[i] < 0.0);
+        }
+        return found != 0;
+    }
+
+    // Same checks as the tree walker, on each intermediate block
+    static void m_checkBlock(const double* vBlock, const size_t vCount) {
+        int notFinite = 0;
+        for (size_t i = 0; i < vCount; ++i) {
+            notFinite |= ((vBlock[i] - vBlock[i]) != 0.0);  // x - x is NaN for NaN and Inf
+        }
+        if (notFinite != 0) {
+            for (size_t i = 0; i < vCount; ++i) {
+                if (::std::isnan(vBlock[i])) {
+                    throw ExprException(ErrorCode::EVALUATION_NAN, "Result is NaN");
+                } else if (::std::isinf(vBlock[i])) {
+                    throw ExprException(ErrorCode::EVALUATION_INF, "Result is Inf");
+                }
+            }
+        }
+    }
+
     // Parse an expression to create a syntax tree
     Node m_parseExpression(::std::vector<Token>& tokens, size_t& pos, int precedence) {
         if (pos >= tokens.size()) {
@@ -821,7 +1635,7 @@ protected:
     /////////////////////////////////////////
 
     // Calculate a factorial
-    double m_Factorial(double vValue) {
+    static double m_Factorial(double vValue) {
         if (vValue < 0 || ::std::floor(vValue) != vValue) {
             throw ExprException(ErrorCode::PARSE_ERROR, "Factorial is not defined for negative or non-integer values.");
         }
@@ -834,7 +1648,7 @@ protected:
     }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/min.xhtml
-    double m_Min(double vX, double vY) {
+    static double m_Min(double vX, double vY) {
         if (vX < vY) {
             return vX;
         }
@@ -842,7 +1656,7 @@ protected:
     }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/max.xhtml
-    double m_Max(double vX, double vY) {
+    static double m_Max(double vX, double vY) {
         if (vX > vY) {
             return vX;
         }
@@ -850,27 +1664,27 @@ protected:
     }
 
     // https://www.shadertoy.com/???? : sqrt(v*v+k) with k >= 0
-    double m_SmoothAbs(double vV, double vK) { return ::std::sqrt(vV * vV + ::std::abs(vK)); }
+    static double m_SmoothAbs(double vV, double vK) { return ::std::sqrt(vV * vV + ::std::abs(vK)); }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/clamp.xhtml
     // Clamp (glsl), Saturate (hlsl)
-    double m_Clamp(double vX, double vMinVal, double vMaxVal) { return m_Min(m_Max(vX, vMinVal), vMaxVal); }
+    static double m_Clamp(double vX, double vMinVal, double vMaxVal) { return m_Min(m_Max(vX, vMinVal), vMaxVal); }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/smoothstep.xhtml
-    double m_SmoothStep(double vEdge0, double vEdge1, double vX) {
+    static double m_SmoothStep(double vEdge0, double vEdge1, double vX) {
         double t = m_Clamp((vX - vEdge0) / (vEdge1 - vEdge0), 0.0, 1.0);
         return t * t * (3.0 - 2.0 * t);
     }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/mix.xhtml
     // Mix (glsl), lerp (hlsl)
-    double m_Mix(double vX, double vY, double vA) { return vX * (1.0 - vA) + vY * vA; }
+    static double m_Mix(double vX, double vY, double vA) { return vX * (1.0 - vA) + vY * vA; }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/step.xhtml
-    double m_Step(double vEdge, double vX) { return vX < vEdge ? 0.0 : 1.0; }
+    static double m_Step(double vEdge, double vX) { return vX < vEdge ? 0.0 : 1.0; }
 
     // https://registry.khronos.org/OpenGL-Refpages/gl4/html/sign.xhtml
-    double m_Sign(double vX) {
+    static double m_Sign(double vX) {
         if (vX < 0.0) {
             return -1.0;
         } else if (vX > 0.0) {
@@ -880,4 +1694,144 @@ protected:
     }
 };
 
+// Lightweight evaluation state of a compiled program : variables values, stacks and result
+// the program is immutable and can be shared, so many threads can evaluate the same expression,
+// each one with its own context, without parsing the expression again
+class ExprContext {
+private:
+    ::std::shared_ptr<const Program> m_Program;  // Shared compiled program
+    ::std::vector<double> m_Values;  // Value of each variable slot
+    ::std::vector<const double*> m_ValuePtrs;  // Pointer on each value of m_Values
+    ::std::vector<bool> m_Defined;  // Tell if each variable slot was set
+    ::std::vector<const double*> m_Arrays;  // Arrays of values bound to variables for evalArrays
+    ::std::vector<double> m_Stack;  // Value stack used by the program
+    ::std::vector<double> m_BlockStack;  // Stack of blocks used by evalArrays
+    double m_EvalResult = 0.0;  // Evaluation result
+
+public:
+    explicit ExprContext(const ::std::shared_ptr<const Program>& vProgram) : m_Program(vProgram) {
+        if (m_Program == nullptr) {
+            throw ExprException(ErrorCode::PARSE_ERROR, "No program to evaluate");
+        }
+        const size_t count = m_Program->variables.size();
+        m_Values.resize(count, 0.0);
+        m_Defined.resize(count, false);
+        m_Arrays.resize(count, nullptr);
+        m_bindValuePtrs();
+        m_Stack.resize(m_Program->stackSize + m_Program->tempsCount);
+    }
+
+    // a copy points on its own values, so the copies can be given to many threads
+    ExprContext(const ExprContext& vOther)
+        : m_Program(vOther.m_Program),
+          m_Values(vOther.m_Values),
+          m_Defined(vOther.m_Defined),
+          m_Arrays(vOther.m_Arrays),
+          m_Stack(vOther.m_Stack),
+          m_BlockStack(vOther.m_BlockStack),
+          m_EvalResult(vOther.m_EvalResult) {
+        m_bindValuePtrs();
+    }
+
+    ExprContext& operator=(const ExprContext& vOther) {
+        if (this != &vOther) {
+            m_Program = vOther.m_Program;
+            m_Values = vOther.m_Values;
+            m_Defined = vOther.m_Defined;
+            m_Arrays = vOther.m_Arrays;
+            m_Stack = vOther.m_Stack;
+            m_BlockStack = vOther.m_BlockStack;
+            m_EvalResult = vOther.m_EvalResult;
+            m_bindValuePtrs();
+        }
+        return *this;
+    }
+
+    // a move keeps the buffer of m_Values, so m_ValuePtrs stays valid
+    ExprContext(ExprContext&&) = default;
+    ExprContext& operator=(ExprContext&&) = default;
+
+    // Returns the slot of a variable, or the count of slots if the variable is not used by the program
+    size_t getSlot(const String& vName) const {
+        size_t idx = 0;
+        while (idx < m_Program->variables.size() && m_Program->variables[idx] != vName) {
+            ++idx;
+        }
+        return idx;
+    }
+
+    // Method to set the value of a variable, ignored if the variable is not used by the program
+    ExprContext& set(const String& vName, const double vValue) { return setSlot(getSlot(vName), vValue); }
+
+    // Method to set the value of a variable slot, without name lookup
+    ExprContext& setSlot(const size_t vSlot, const double vValue) {
+        if (vSlot < m_Values.size()) {
+            m_Values[vSlot] = vValue;
+            m_Defined[vSlot] = true;
+        }
+        return *this;
+    }
+
+    // Method to evaluate the program
+    ExprContext& eval() {
+        m_checkDefined(false);
+        m_EvalResult = Expr::m_runProgram(*m_Program, m_ValuePtrs.data(), m_Stack.data());
+        return *this;
+    }
+
+    // Method to bind a variable to an array of values, used by evalArrays()
+    ExprContext& bindArray(const String& vName, const double* vValues) {
+        const size_t slot = getSlot(vName);
+        if (slot < m_Arrays.size()) {
+            m_Arrays[slot] = vValues;
+        }
+        return *this;
+    }
+
+    // Method to remove the arrays bound with bindArray()
+    ExprContext& clearArrays() {
+        m_Arrays.assign(m_Arrays.size(), nullptr);
+        return *this;
+    }
+
+    // Method to evaluate the program on vCount rows, see Expr::evalArrays
+    ExprContext& evalArrays(double* vOutResults, const size_t vCount) {
+        m_checkDefined(true);
+        m_BlockStack.resize((m_Program->stackSize + m_Program->tempsCount) * EZ_EXPR_BLOCK_SIZE);
+        for (size_t start = 0; start < vCount; start += EZ_EXPR_BLOCK_SIZE) {
+            const size_t count = (vCount - start < EZ_EXPR_BLOCK_SIZE) ? vCount - start : EZ_EXPR_BLOCK_SIZE;
+            Expr::m_runProgramBlock(*m_Program, m_ValuePtrs.data(), m_Arrays.data(), start, count, m_BlockStack.data());
+            ::std::memcpy(vOutResults + start, m_BlockStack.data(), count * sizeof(double));
+        }
+        return *this;
+    }
+
+    // Returns the evaluation result
+    double getResult() const { return m_EvalResult; }
+
+    // Checks if the evaluation result is close to a given value
+    bool check(const double vValue) const { return (::std::abs(m_EvalResult - vValue) < 0.001); }
+
+    // Returns the shared program
+    const ::std::shared_ptr<const Program>& getProgram() const { return m_Program; }
+
+private:
+    // Points each slot of m_ValuePtrs on its value in m_Values
+    void m_bindValuePtrs() {
+        m_ValuePtrs.resize(m_Values.size(), nullptr);
+        for (size_t idx = 0; idx < m_Values.size(); ++idx) {
+            m_ValuePtrs[idx] = &m_Values[idx];
+        }
+    }
+
+    // Throws if a variable slot was not set (and not bound to an array if vWithArrays)
+    void m_checkDefined(const bool vWithArrays) const {
+        for (size_t idx = 0; idx < m_Defined.size(); ++idx) {
+            if (!m_Defined[idx] && !(vWithArrays && m_Arrays[idx] != nullptr)) {
+                throw ExprException(ErrorCode::VARIABLE_NOT_FOUND, "Variable not found: " + m_Program->variables[idx]);
+            }
+        }
+    }
+};
+
 }  // namespace ez
@@ -36,11 +36,13 @@ SOFTWARE.
 #include <vector>
 #include <thread>
 #include <atomic>
+#include <cstdio>
 #include <memory>
 #include <sstream>
 #include <fstream>
 #include <cstdint>
 #include <iterator>
+#include <algorithm>
 #include <iostream>
 #include <functional>
 #include <unordered_map>
@@ -49,6 +51,7 @@ SOFTWARE.
 #include "ezApp.hpp"
 #include "ezStr.hpp"
 #include "ezLog.hpp"
+#include "ezHash.hpp"
 #include <sys/stat.h>
 
 #ifdef WINDOWS_OS
@@ -491,6 +494,74 @@ inline std::vector<std::string> getDrives() {
     return res;
 }
 
+// hash of a file content, given by hashFiles
+struct FileHash {
+    std::string filePathName;
+    std::string hash;  // hex of the hash, empty if the file cant be read
+    uint64_t size{};   // count of bytes hashed
+};
+
+// hash the content of the files, on many threads, each file is read sequentially by big chunks.
+// THasher can be ez::xxh128 (default), ez::xxh64, or ez::sha1 / ez::sha256 when a crypto hash is needed.
+// the results are in the same order as vFilePathNames. vThreadsCount at 0 mean the hardware concurrency
+template <typename THasher = xxh128>
+inline std::vector<FileHash> hashFiles(const std::vector<std::string> &vFilePathNames, size_t vThreadsCount = 0U, size_t vChunkSize = 1024U * 1024U) {
+    std::vector<FileHash> ret(vFilePathNames.size());
+    if (vThreadsCount == 0U) {
+        vThreadsCount = std::max<size_t>(1U, std::thread::hardware_concurrency());
+    }
+    vThreadsCount = std::min(vThreadsCount, vFilePathNames.size());
+    const size_t chunkSize = std::max<size_t>(vChunkSize, 1U);
+    std::atomic<size_t> nextFile{0U};
+    auto worker = [&]() {
+        std::vector<uint8_t> chunk(chunkSize);
+        size_t idx = 0U;
+        while ((idx = nextFile.fetch_add(1U)) < vFilePathNames.size()) {
+            auto &res = ret[idx];
+            res.filePathName = vFilePathNames[idx];
+#ifdef _MSC_VER
+            FILE *fp = nullptr;
+            if (fopen_s(&fp, res.filePathName.c_str(), "rb") != 0) {
+                fp = nullptr;
+            }
+#else
+            FILE *fp = std::fopen(res.filePathName.c_str(), "rb");
+#endif
+            if (fp == nullptr) {
+                continue;
+            }
+            // the chunks are already big, no need of the stdio buffer
+            std::setvbuf(fp, nullptr, _IONBF, 0);
+            THasher hasher;
+            size_t readCount = 0U;
+            while ((readCount = std::fread(chunk.data(), 1U, chunk.size(), fp)) > 0U) {
+                hasher.add(chunk.data(), readCount);
+                res.size += readCount;
+            }
+            const bool failed = (std::ferror(fp) != 0);
+            std::fclose(fp);
+            if (failed) {
+                res.size = 0U;
+            } else {
+                res.hash = hasher.finalize().getHex();
+            }
+        }
+    };
+    if (vThreadsCount <= 1U) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(vThreadsCount);
+        for (size_t i = 0; i < vThreadsCount; ++i) {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    return ret;
+}
+
 #ifndef EMSCRIPTEN_OS
 
 class Watcher {
@@ -0,0 +1,667 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2014-2024 Stephane Cuillerdier (aka aiekick)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// ezHash is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
+// fast non cryptographic hashes, for change detection, dedup or hash tables.
+// xxh64 is the XXH64 and xxh128 the XXH3 128 bits of https://github.com/Cyan4973/xxHash.git - BSD 2-Clause
+// the values are the same as the reference implementation
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+#include <type_traits>
+
+// the SSE2 path of xxh128 is used on x86 when available, EZ_HASH_NO_SIMD disable it
+#if !defined(EZ_HASH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define EZ_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace ez {
+
+// 128 bits hash value
+struct hash128 {
+    uint64_t low{};
+    uint64_t high{};
+    bool operator==(const hash128 &v) const { return low == v.low && high == v.high; }
+    bool operator!=(const hash128 &v) const { return !(*this == v); }
+};
+
+namespace detail {
+
+static constexpr uint32_t XXH_PRIME32_1{0x9E3779B1U};
+static constexpr uint32_t XXH_PRIME32_2{0x85EBCA77U};
+static constexpr uint32_t XXH_PRIME32_3{0xC2B2AE3DU};
+static constexpr uint64_t XXH_PRIME64_1{0x9E3779B185EBCA87ULL};
+static constexpr uint64_t XXH_PRIME64_2{0xC2B2AE3D27D4EB4FULL};
+static constexpr uint64_t XXH_PRIME64_3{0x165667B19E3779F9ULL};
+static constexpr uint64_t XXH_PRIME64_4{0x85EBCA77C2B2AE63ULL};
+static constexpr uint64_t XXH_PRIME64_5{0x27D4EB2F165667C5ULL};
+static constexpr uint64_t XXH_PRIME_MX1{0x165667919E3779F9ULL};
+static constexpr uint64_t XXH_PRIME_MX2{0x9FB21C651E98DF25ULL};
+
+inline uint32_t xxhSwap32(uint32_t x) {
+    return ((x << 24) & 0xff000000U) | ((x << 8) & 0x00ff0000U) | ((x >> 8) & 0x0000ff00U) | ((x >> 24) & 0x000000ffU);
+}
+
+inline uint64_t xxhSwap64(uint64_t x) {
+    return (static_cast<uint64_t>(xxhSwap32(static_cast<uint32_t>(x))) << 32) | xxhSwap32(static_cast<uint32_t>(x >> 32));
+}
+
+// the datas are read as little endian
+inline uint32_t xxhRead32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = xxhSwap32(v);
+#endif
+    return v;
+}
+
+inline uint64_t xxhRead64(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = xxhSwap64(v);
+#endif
+    return v;
+}
+
+inline void xxhWrite64(uint8_t *p, uint64_t v) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    v = xxhSwap64(v);
+#endif
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline uint32_t xxhRotl32(uint32_t x, uint32_t r) { return (x << r) | (x >> (32U - r)); }
+
+inline uint64_t xxhRotl64(uint64_t x, uint32_t r) { return (x << r) | (x >> (64U - r)); }
+
+// full 64x64 => 128 bits product
+inline hash128 xxhMul128(uint64_t a, uint64_t b) {
+    hash128 ret;
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 product = static_cast<uint128>(a) * b;
+    ret.low = static_cast<uint64_t>(product);
+    ret.high = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    ret.low = _umul128(a, b, &ret.high);
+#else
+    const uint64_t loLo = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    const uint64_t hiLo = (a >> 32) * (b & 0xFFFFFFFFULL);
+    const uint64_t loHi = (a & 0xFFFFFFFFULL) * (b >> 32);
+    const uint64_t hiHi = (a >> 32) * (b >> 32);
+    const uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFFULL) + loHi;
+    ret.high = (hiLo >> 32) + (cross >> 32) + hiHi;
+    ret.low = (cross << 32) | (loLo & 0xFFFFFFFFULL);
+#endif
+    return ret;
+}
+
+inline uint64_t xxhMulFold64(uint64_t a, uint64_t b) {
+    const hash128 product = xxhMul128(a, b);
+    return product.low ^ product.high;
+}
+
+inline uint64_t xxh64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t xxh3Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= XXH_PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+
+inline void xxhToHex(uint64_t vValue, const char *vAlphabet, std::string &vOut) {
+    for (int32_t j = 15; j >= 0; j--) {
+        vOut.push_back(vAlphabet[(vValue >> (j * 4)) & 0xf]);
+    }
+}
+
+// buffering and api shared by xxh64 and xxh128
+// TDerived give m_update(ptr, n), finalize() and getHex()
+template <typename TDerived>
+class fastHasher {
+private:
+    // integers, but not the chars written as chars by a stream
+    template <typename T>
+    struct isHashedAsNumber {
+        static bool constexpr value = std::is_integral<T>::value && !std::is_same<T, bool>::value &&  //
+            !std::is_same<T, char>::value && !std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value;
+    };
+
+public:
+    TDerived &add(const void *data, size_t n) {
+        if (data != nullptr && n > 0U) {
+            m_self().m_update(static_cast<const uint8_t *>(data), n);
+        }
+        return m_self();
+    }
+
+    TDerived &add(const std::string &vText) { return add(vText.data(), vText.size()); }
+
+    // integers are written like a stream do, without the stream
+    template <typename T>
+    typename std::enable_if<isHashedAsNumber<T>::value, TDerived &>::type addValue(const T &vValue) {
+        return add(std::to_string(vValue));
+    }
+
+    template <typename T>
+    typename std::enable_if<!isHashedAsNumber<T>::value, TDerived &>::type addValue(const T &vValue) {
+        std::stringstream ss;
+        ss << vValue;
+        return add(ss.str());
+    }
+
+    // hex of the hash of a file read by chunks, empty if the file cant be opened
+    static std::string hashFile(const std::string &vFilePathName, size_t vChunkSize = 1024 * 1024) {
+        std::string ret;
+#ifdef _MSC_VER
+        FILE *fp = nullptr;
+        if (fopen_s(&fp, vFilePathName.c_str(), "rb") != 0) {
+            fp = nullptr;
+        }
+#else
+        FILE *fp = std::fopen(vFilePathName.c_str(), "rb");
+#endif
+        if (fp != nullptr) {
+            TDerived hasher;
+            std::vector<uint8_t> chunk(vChunkSize > 0U ? vChunkSize : 1U);
+            size_t readCount = 0U;
+            while ((readCount = std::fread(chunk.data(), 1U, chunk.size(), fp)) > 0U) {
+                hasher.add(chunk.data(), readCount);
+            }
+            const bool failed = (std::ferror(fp) != 0);
+            std::fclose(fp);
+            if (!failed) {
+                ret = hasher.finalize().getHex();
+            }
+        }
+        return ret;
+    }
+
+private:
+    TDerived &m_self() { return static_cast<TDerived &>(*this); }
+};
+
+////////////////////////////////////////////////////////////////////////////
+//// XXH3 //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
+
+static constexpr size_t XXH3_SECRET_SIZE{192U};
+static constexpr size_t XXH3_STRIPE_LEN{64U};
+static constexpr size_t XXH3_SECRET_CONSUME_RATE{8U};
+static constexpr size_t XXH3_STRIPES_PER_BLOCK{(XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE};
+static constexpr size_t XXH3_MIDSIZE_MAX{240U};
+
+inline const uint8_t *xxh3DefaultSecret() {
+    static const uint8_t secret[XXH3_SECRET_SIZE] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,  //
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,  //
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,  //
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,  //
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,  //
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,  //
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,  //
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,  //
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,  //
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,  //
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,  //
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,  //
+    };
+    return secret;
+}
+
+// accumulate vCount stripes of 64 bytes, the secret move of 8 bytes by stripe
+inline void xxh3Accumulate(uint64_t *vAcc, const uint8_t *vInput, const uint8_t *vSecret, size_t vCount) {
+#ifdef EZ_HASH_SSE2
+    __m128i acc[4];
+    for (size_t i = 0; i < 4U; ++i) {
+        acc[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(vAcc) + i);
+    }
+    for (size_t n = 0; n < vCount; ++n) {
+        const __m128i *input = reinterpret_cast<const __m128i *>(vInput + n * XXH3_STRIPE_LEN);
+        const __m128i *secret = reinterpret_cast<const __m128i *>(vSecret + n * XXH3_SECRET_CONSUME_RATE);
+        for (size_t i = 0; i < 4U; ++i) {
+            const __m128i dataVec = _mm_loadu_si128(input + i);
+            const __m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128(secret + i));
+            const __m128i dataKeyHi = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+            const __m128i product = _mm_mul_epu32(dataKey, dataKeyHi);
+            const __m128i dataSwap = _mm_shuffle_epi32(dataVec, _MM_SHUFFLE(1, 0, 3, 2));
+            acc[i] = _mm_add_epi64(product, _mm_add_epi64(acc[i], dataSwap));
+        }
+    }
+    for (size_t i = 0; i < 4U; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(vAcc) + i, acc[i]);
+    }
+#else
+    for (size_t n = 0; n < vCount; ++n) {
+        const uint8_t *input = vInput + n * XXH3_STRIPE_LEN;
+        const uint8_t *secret = vSecret + n * XXH3_SECRET_CONSUME_RATE;
+        for (size_t i = 0; i < 8U; ++i) {
+            const uint64_t dataVal = xxhRead64(input + 8U * i);
+            const uint64_t dataKey = dataVal ^ xxhRead64(secret + 8U * i);
+            vAcc[i ^ 1U] += dataVal;
+            vAcc[i] += (dataKey & 0xFFFFFFFFULL) * (dataKey >> 32);
+        }
+    }
+#endif
+}
+
+inline void xxh3Scramble(uint64_t *vAcc, const uint8_t *vSecret) {
+#ifdef EZ_HASH_SSE2
+    const __m128i prime32 = _mm_set1_epi32(static_cast<int>(XXH_PRIME32_1));
+    for (size_t i = 0; i < 4U; ++i) {
+        __m128i *accPtr = reinterpret_cast<__m128i *>(vAcc) + i;
+        const __m128i accVec = _mm_loadu_si128(accPtr);
+        const __m128i dataVec = _mm_xor_si128(accVec, _mm_srli_epi64(accVec, 47));
+        const __m128i dataKey = _mm_xor_si128(dataVec, _mm_loadu_si128(reinterpret_cast<const __m128i *>(vSecret) + i));
+        const __m128i dataKeyHi = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i productLo = _mm_mul_epu32(dataKey, prime32);
+        const __m128i productHi = _mm_mul_epu32(dataKeyHi, prime32);
+        _mm_storeu_si128(accPtr, _mm_add_epi64(productLo, _mm_slli_epi64(productHi, 32)));
+    }
+#else
+    for (size_t i = 0; i < 8U; ++i) {
+        uint64_t acc = vAcc[i];
+        acc ^= acc >> 47;
+        acc ^= xxhRead64(vSecret + 8U * i);
+        acc *= XXH_PRIME32_1;
+        vAcc[i] = acc;
+    }
+#endif
+}
+
+// accumulate the stripes of a long input, a scramble is done at each end of block
+inline void xxh3ConsumeStripes(uint64_t *vAcc, size_t &vStripesSoFar, const uint8_t *vInput, size_t vCount, const uint8_t *vSecret) {
+    if (XXH3_STRIPES_PER_BLOCK - vStripesSoFar <= vCount) {
+        const size_t stripesToEnd = XXH3_STRIPES_PER_BLOCK - vStripesSoFar;
+        xxh3Accumulate(vAcc, vInput, vSecret + vStripesSoFar * XXH3_SECRET_CONSUME_RATE, stripesToEnd);
+        xxh3Scramble(vAcc, vSecret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+        xxh3Accumulate(vAcc, vInput + stripesToEnd * XXH3_STRIPE_LEN, vSecret, vCount - stripesToEnd);
+        vStripesSoFar = vCount - stripesToEnd;
+    } else {
+        xxh3Accumulate(vAcc, vInput, vSecret + vStripesSoFar * XXH3_SECRET_CONSUME_RATE, vCount);
+        vStripesSoFar += vCount;
+    }
+}
+
+inline uint64_t xxh3MergeAccs(const uint64_t *vAcc, const uint8_t *vSecret, uint64_t vStart) {
+    uint64_t ret = vStart;
+    for (size_t i = 0; i < 4U; ++i) {
+        ret += xxhMulFold64(vAcc[2U * i] ^ xxhRead64(vSecret + 16U * i), vAcc[2U * i + 1U] ^ xxhRead64(vSecret + 16U * i + 8U));
+    }
+    return xxh3Avalanche(ret);
+}
+
+inline uint64_t xxh3Mix16(const uint8_t *vInput, const uint8_t *vSecret, uint64_t vSeed) {
+    return xxhMulFold64(xxhRead64(vInput) ^ (xxhRead64(vSecret) + vSeed), xxhRead64(vInput + 8U) ^ (xxhRead64(vSecret + 8U) - vSeed));
+}
+
+inline void xxh3Mix32(hash128 &vAcc, const uint8_t *vInput1, const uint8_t *vInput2, const uint8_t *vSecret, uint64_t vSeed) {
+    vAcc.low += xxh3Mix16(vInput1, vSecret, vSeed);
+    vAcc.low ^= xxhRead64(vInput2) + xxhRead64(vInput2 + 8U);
+    vAcc.high += xxh3Mix16(vInput2, vSecret + 16U, vSeed);
+    vAcc.high ^= xxhRead64(vInput1) + xxhRead64(vInput1 + 8U);
+}
+
+// XXH3 128 bits of an input of max 240 bytes, with the default secret
+inline hash128 xxh3Hash128Short(const uint8_t *vInput, size_t vLen, uint64_t vSeed) {
+    const uint8_t *secret = xxh3DefaultSecret();
+    hash128 ret;
+    if (vLen == 0U) {
+        ret.low = xxh64Avalanche(vSeed ^ xxhRead64(secret + 64U) ^ xxhRead64(secret + 72U));
+        ret.high = xxh64Avalanche(vSeed ^ xxhRead64(secret + 80U) ^ xxhRead64(secret + 88U));
+    } else if (vLen <= 3U) {
+        const uint32_t combinedl = (static_cast<uint32_t>(vInput[0]) << 16) | (static_cast<uint32_t>(vInput[vLen >> 1]) << 24) |  //
+            static_cast<uint32_t>(vInput[vLen - 1U]) | (static_cast<uint32_t>(vLen) << 8);
+        const uint32_t combinedh = xxhRotl32(xxhSwap32(combinedl), 13U);
+        const uint64_t bitflipl = (xxhRead32(secret) ^ xxhRead32(secret + 4U)) + vSeed;
+        const uint64_t bitfliph = (xxhRead32(secret + 8U) ^ xxhRead32(secret + 12U)) - vSeed;
+        ret.low = xxh64Avalanche(static_cast<uint64_t>(combinedl) ^ bitflipl);
+        ret.high = xxh64Avalanche(static_cast<uint64_t>(combinedh) ^ bitfliph);
+    } else if (vLen <= 8U) {
+        const uint64_t seed = vSeed ^ (static_cast<uint64_t>(xxhSwap32(static_cast<uint32_t>(vSeed))) << 32);
+        const uint64_t input64 = xxhRead32(vInput) + (static_cast<uint64_t>(xxhRead32(vInput + vLen - 4U)) << 32);
+        const uint64_t bitflip = (xxhRead64(secret + 16U) ^ xxhRead64(secret + 24U)) + seed;
+        ret = xxhMul128(input64 ^ bitflip, XXH_PRIME64_1 + (static_cast<uint64_t>(vLen) << 2));
+        ret.high += ret.low << 1;
+        ret.low ^= ret.high >> 3;
+        ret.low ^= ret.low >> 35;
+        ret.low *= XXH_PRIME_MX2;
+        ret.low ^= ret.low >> 28;
+        ret.high = xxh3Avalanche(ret.high);
+    } else if (vLen <= 16U) {
+        const uint64_t bitflipl = (xxhRead64(secret + 32U) ^ xxhRead64(secret + 40U)) - vSeed;
+        const uint64_t bitfliph = (xxhRead64(secret + 48U) ^ xxhRead64(secret + 56U)) + vSeed;
+        const uint64_t inputLo = xxhRead64(vInput);
+        uint64_t inputHi = xxhRead64(vInput + vLen - 8U);
+        hash128 m128 = xxhMul128(inputLo ^ inputHi ^ bitflipl, XXH_PRIME64_1);
+        m128.low += static_cast<uint64_t>(vLen - 1U) << 54;
+        inputHi ^= bitfliph;
+        m128.high += inputHi + (inputHi & 0xFFFFFFFFULL) * (XXH_PRIME32_2 - 1U);
+        m128.low ^= xxhSwap64(m128.high);
+        ret = xxhMul128(m128.low, XXH_PRIME64_2);
+        ret.high += m128.high * XXH_PRIME64_2;
+        ret.low = xxh3Avalanche(ret.low);
+        ret.high = xxh3Avalanche(ret.high);
+    } else {
+        hash128 acc;
+        acc.low = static_cast<uint64_t>(vLen) * XXH_PRIME64_1;
+        if (vLen <= 128U) {
+            if (vLen > 32U) {
+                if (vLen > 64U) {
+                    if (vLen > 96U) {
+                        xxh3Mix32(acc, vInput + 48U, vInput + vLen - 64U, secret + 96U, vSeed);
+                    }
+                    xxh3Mix32(acc, vInput + 32U, vInput + vLen - 48U, secret + 64U, vSeed);
+                }
+                xxh3Mix32(acc, vInput + 16U, vInput + vLen - 32U, secret + 32U, vSeed);
+            }
+            xxh3Mix32(acc, vInput, vInput + vLen - 16U, secret, vSeed);
+        } else {
+            const size_t roundsCount = vLen / 32U;
+            for (size_t i = 0; i < 4U; ++i) {
+                xxh3Mix32(acc, vInput + 32U * i, vInput + 32U * i + 16U, secret + 32U * i, vSeed);
+            }
+            acc.low = xxh3Avalanche(acc.low);
+            acc.high = xxh3Avalanche(acc.high);
+            for (size_t i = 4U; i < roundsCount; ++i) {
+                xxh3Mix32(acc, vInput + 32U * i, vInput + 32U * i + 16U, secret + 3U + 32U * (i - 4U), vSeed);
+            }
+            // last bytes
+            xxh3Mix32(acc, vInput + vLen - 16U, vInput + vLen - 32U, secret + 136U - 17U - 16U, 0ULL - vSeed);
+        }
+        ret.low = xxh3Avalanche(acc.low + acc.high);
+        ret.high = 0ULL - xxh3Avalanche(acc.low * XXH_PRIME64_1 + acc.high * XXH_PRIME64_4 + (static_cast<uint64_t>(vLen) - vSeed) * XXH_PRIME64_2);
+    }
+    return ret;
+}
+
+}  // namespace detail
+
+// XXH64, 32 bytes stripes, good on 64 bits cpus without simd
+class xxh64 : public detail::fastHasher<xxh64> {
+    friend class detail::fastHasher<xxh64>;
+
+public:
+    static size_t constexpr HEX_SIZE{16};
+
+private:
+    std::array<uint64_t, 4> m_acc{};
+    std::array<uint8_t, 32> m_buf{};
+    uint32_t m_index{};
+    uint64_t m_totalLen{};
+    uint64_t m_seed{};
+    uint64_t m_digest{};
+
+public:
+    explicit xxh64(uint64_t vSeed = 0U) { reset(vSeed); }
+    explicit xxh64(const std::string &vText, uint64_t vSeed = 0U) : xxh64(vSeed) { add(vText); }
+
+    xxh64 &reset(uint64_t vSeed = 0U) {
+        m_seed = vSeed;
+        m_acc[0] = vSeed + detail::XXH_PRIME64_1 + detail::XXH_PRIME64_2;
+        m_acc[1] = vSeed + detail::XXH_PRIME64_2;
+        m_acc[2] = vSeed;
+        m_acc[3] = vSeed - detail::XXH_PRIME64_1;
+        m_index = 0U;
+        m_totalLen = 0U;
+        m_digest = 0U;
+        return *this;
+    }
+
+    // the datas can still be added after
+    xxh64 &finalize() {
+        using namespace detail;
+        uint64_t h = 0U;
+        if (m_totalLen >= 32U) {
+            h = xxhRotl64(m_acc[0], 1U) + xxhRotl64(m_acc[1], 7U) + xxhRotl64(m_acc[2], 12U) + xxhRotl64(m_acc[3], 18U);
+            for (size_t i = 0; i < 4U; ++i) {
+                h ^= m_round(0U, m_acc[i]);
+                h = h * XXH_PRIME64_1 + XXH_PRIME64_4;
+            }
+        } else {
+            h = m_seed + XXH_PRIME64_5;
+        }
+        h += m_totalLen;
+        const uint8_t *ptr = m_buf.data();
+        const uint8_t *end = ptr + m_index;
+        for (; ptr + 8 <= end; ptr += 8) {
+            h ^= m_round(0U, xxhRead64(ptr));
+            h = xxhRotl64(h, 27U) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        }
+        if (ptr + 4 <= end) {
+            h ^= static_cast<uint64_t>(xxhRead32(ptr)) * XXH_PRIME64_1;
+            h = xxhRotl64(h, 23U) * XXH_PRIME64_2 + XXH_PRIME64_3;
+            ptr += 4;
+        }
+        for (; ptr < end; ++ptr) {
+            h ^= (*ptr) * XXH_PRIME64_5;
+            h = xxhRotl64(h, 11U) * XXH_PRIME64_1;
+        }
+        m_digest = xxh64Avalanche(h);
+        return *this;
+    }
+
+    uint64_t getValue() const { return m_digest; }
+
+    const std::string getHex(const char *alphabet = "0123456789abcdef") const {
+        std::string ret;
+        ret.reserve(HEX_SIZE);
+        detail::xxhToHex(m_digest, alphabet, ret);
+        return ret;
+    }
+
+    static uint64_t hash(const void *data, size_t n, uint64_t vSeed = 0U) { return xxh64(vSeed).add(data, n).finalize().getValue(); }
+
+private:
+    static uint64_t m_round(uint64_t vAcc, uint64_t vInput) {
+        vAcc += vInput * detail::XXH_PRIME64_2;
+        return detail::xxhRotl64(vAcc, 31U) * detail::XXH_PRIME64_1;
+    }
+
+    void m_update(const uint8_t *ptr, size_t n) {
+        m_totalLen += n;
+
+        // fill up stripe if not full
+        if (m_index != 0U || n < sizeof(m_buf)) {
+            const size_t count = std::min<size_t>(n, sizeof(m_buf) - m_index);
+            std::memcpy(m_buf.data() + m_index, ptr, count);
+            m_index += static_cast<uint32_t>(count);
+            ptr += count;
+            n -= count;
+            if (m_index < sizeof(m_buf)) {
+                return;
+            }
+            m_consumeStripes(m_buf.data(), 1U);
+            m_index = 0U;
+        }
+
+        // process full stripes directly from the input
+        const size_t stripesCount = n / sizeof(m_buf);
+        m_consumeStripes(ptr, stripesCount);
+        ptr += stripesCount * sizeof(m_buf);
+        n -= stripesCount * sizeof(m_buf);
+
+        // keep the remaining part of stripe
+        std::memcpy(m_buf.data(), ptr, n);
+        m_index = static_cast<uint32_t>(n);
+    }
+
+    void m_consumeStripes(const uint8_t *ptr, size_t vCount) {
+        uint64_t v1 = m_acc[0];
+        uint64_t v2 = m_acc[1];
+        uint64_t v3 = m_acc[2];
+        uint64_t v4 = m_acc[3];
+        for (; vCount > 0U; --vCount, ptr += 32) {
+            v1 = m_round(v1, detail::xxhRead64(ptr));
+            v2 = m_round(v2, detail::xxhRead64(ptr + 8));
+            v3 = m_round(v3, detail::xxhRead64(ptr + 16));
+            v4 = m_round(v4, detail::xxhRead64(ptr + 24));
+        }
+        m_acc[0] = v1;
+        m_acc[1] = v2;
+        m_acc[2] = v3;
+        m_acc[3] = v4;
+    }
+};
+
+// XXH3 128 bits, 64 bytes stripes, vectorized with SSE2 when available.
+// the fastest on big datas and the safest for dedup (collisions)
+class xxh128 : public detail::fastHasher<xxh128> {
+    friend class detail::fastHasher<xxh128>;
+
+public:
+    static size_t constexpr HEX_SIZE{32};
+
+private:
+    static size_t constexpr BUFFER_SIZE{256U};
+    std::array<uint64_t, 8> m_acc{};
+    std::array<uint8_t, detail::XXH3_SECRET_SIZE> m_secret{};
+    std::array<uint8_t, BUFFER_SIZE> m_buf{};
+    size_t m_index{};
+    size_t m_stripesSoFar{};
+    uint64_t m_totalLen{};
+    uint64_t m_seed{};
+    hash128 m_digest{};
+
+public:
+    explicit xxh128(uint64_t vSeed = 0U) { reset(vSeed); }
+    explicit xxh128(const std::string &vText, uint64_t vSeed = 0U) : xxh128(vSeed) { add(vText); }
+
+    xxh128 &reset(uint64_t vSeed = 0U) {
+        using namespace detail;
+        m_seed = vSeed;
+        m_acc = {{XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3, XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1}};
+        // the seed is mixed in the secret used by the long inputs
+        const uint8_t *defaultSecret = xxh3DefaultSecret();
+        for (size_t i = 0; i < XXH3_SECRET_SIZE; i += 16U) {
+            xxhWrite64(m_secret.data() + i, xxhRead64(defaultSecret + i) + vSeed);
+            xxhWrite64(m_secret.data() + i + 8U, xxhRead64(defaultSecret + i + 8U) - vSeed);
+        }
+        m_index = 0U;
+        m_stripesSoFar = 0U;
+        m_totalLen = 0U;
+        m_digest = hash128();
+        return *this;
+    }
+
+    // the datas can still be added after
+    xxh128 &finalize() {
+        using namespace detail;
+        if (m_totalLen <= XXH3_MIDSIZE_MAX) {
+            // all the datas are still in the buffer
+            m_digest = xxh3Hash128Short(m_buf.data(), static_cast<size_t>(m_totalLen), m_seed);
+            return *this;
+        }
+        std::array<uint64_t, 8> acc = m_acc;
+        const uint8_t *lastStripe = nullptr;
+        uint8_t lastStripeBuf[XXH3_STRIPE_LEN];
+        if (m_index >= XXH3_STRIPE_LEN) {
+            size_t stripesSoFar = m_stripesSoFar;
+            xxh3ConsumeStripes(acc.data(), stripesSoFar, m_buf.data(), (m_index - 1U) / XXH3_STRIPE_LEN, m_secret.data());
+            lastStripe = m_buf.data() + m_index - XXH3_STRIPE_LEN;
+        } else {
+            // the last stripe overlap the previous buffer content
+            const size_t catchup = XXH3_STRIPE_LEN - m_index;
+            std::memcpy(lastStripeBuf, m_buf.data() + BUFFER_SIZE - catchup, catchup);
+            std::memcpy(lastStripeBuf + catchup, m_buf.data(), m_index);
+            lastStripe = lastStripeBuf;
+        }
+        xxh3Accumulate(acc.data(), lastStripe, m_secret.data() + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - 7U, 1U);
+        m_digest.low = xxh3MergeAccs(acc.data(), m_secret.data() + 11U, m_totalLen * XXH_PRIME64_1);
+        m_digest.high = xxh3MergeAccs(acc.data(), m_secret.data() + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - 11U, ~(m_totalLen * XXH_PRIME64_2));
+        return *this;
+    }
+
+    const hash128 &getValue() const { return m_digest; }
+
+    const std::string getHex(const char *alphabet = "0123456789abcdef") const {
+        std::string ret;
+        ret.reserve(HEX_SIZE);
+        detail::xxhToHex(m_digest.high, alphabet, ret);
+        detail::xxhToHex(m_digest.low, alphabet, ret);
+        return ret;
+    }
+
+    static hash128 hash(const void *data, size_t n, uint64_t vSeed = 0U) {
+        if (n <= detail::XXH3_MIDSIZE_MAX) {  // no state needed
+            return detail::xxh3Hash128Short(static_cast<const uint8_t *>(data), n, vSeed);
+        }
+        return xxh128(vSeed).add(data, n).finalize().getValue();
+    }
+
+private:
+    // the buffer is only consumed when more datas follow, so the last stripe is always in it
+    void m_update(const uint8_t *ptr, size_t n) {
+        using namespace detail;
+        const uint8_t *end = ptr + n;
+        m_totalLen += n;
+        if (m_index + n <= BUFFER_SIZE) {
+            std::memcpy(m_buf.data() + m_index, ptr, n);
+            m_index += n;
+            return;
+        }
+        if (m_index != 0U) {
+            const size_t count = BUFFER_SIZE - m_index;
+            std::memcpy(m_buf.data() + m_index, ptr, count);
+            ptr += count;
+            xxh3ConsumeStripes(m_acc.data(), m_stripesSoFar, m_buf.data(), BUFFER_SIZE / XXH3_STRIPE_LEN, m_secret.data());
+            m_index = 0U;
+        }
+        if (ptr + BUFFER_SIZE < end) {
+            do {
+                xxh3ConsumeStripes(m_acc.data(), m_stripesSoFar, ptr, BUFFER_SIZE / XXH3_STRIPE_LEN, m_secret.data());
+                ptr += BUFFER_SIZE;
+            } while (ptr + BUFFER_SIZE < end);
+            // keep the last consumed stripe for a final stripe overlapping it
+            std::memcpy(m_buf.data() + BUFFER_SIZE - XXH3_STRIPE_LEN, ptr - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN);
+        }
+        m_index = static_cast<size_t>(end - ptr);
+        std::memcpy(m_buf.data(), ptr, m_index);
+    }
+};
+
+}  // namespace ez
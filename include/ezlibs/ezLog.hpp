@@ -36,6 +36,16 @@ SOFTWARE.
 #define EZ_LOG_APP_NAME "App"
 #endif
 
+// max count of messages kept in the in-memory history
+#ifndef EZ_LOG_HISTORY_CAPACITY
+#define EZ_LOG_HISTORY_CAPACITY 4096U
+#endif
+
+// size of the write buffer of the log file
+#ifndef EZ_LOG_FILE_BUFFER_SIZE
+#define EZ_LOG_FILE_BUFFER_SIZE 65536U
+#endif
+
 #include "ezStr.hpp"
 #include "ezTime.hpp"
 
@@ -59,16 +69,25 @@ SOFTWARE.
 
 #include <cstdarg> /* va_list, va_start, va_arg, va_end */
 
+#include <cstdio>  // std::rename, std::remove
 #include <iostream>  // std::cout
 
 #include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
+#include <chrono>
 #include <cassert>
 #include <fstream>
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <condition_variable>
 
 typedef long long int64;
 
@@ -167,10 +186,93 @@ public:
     typedef int MessageType;
     typedef std::function<void(const int& vType, const std::string& vMessage)> LogMessageFunctor;
     enum MessageTypeEnum { LOGGING_MESSAGE_TYPE_INFOS = 0, LOGGING_MESSAGE_TYPE_WARNING, LOGGING_MESSAGE_TYPE_ERROR };
+    // what a caller does when the async queue is full
+    enum class OverflowPolicy { BLOCK = 0, DROP, DROP_OLDEST };
 
 protected:
     std::mutex m_logger_Mutex;
 
+private:
+    // message formatted by the caller, written by the async writer thread
+    struct AsyncRecord {
+        MessageType type = 0;
+        bool hasType = false;
+        std::string msg;  // keeps its capacity, so a reused cell does not allocate
+    };
+
+    // bounded lock-free queue (D. Vyukov), many producers, many consumers
+    // the writer thread is the consumer, but producers also pop with OverflowPolicy::DROP_OLDEST
+    class AsyncQueue {
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{0U};
+            AsyncRecord record;
+        };
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask = 0U;
+        std::atomic<size_t> m_enqueuePos{0U};
+        char m_pad[64];  // keep the two positions on different cache lines
+        std::atomic<size_t> m_dequeuePos{0U};
+
+    public:
+        void init(const size_t vCapacity) {
+            size_t capacity = 2U;
+            while (capacity < vCapacity) {
+                capacity <<= 1U;
+            }
+            m_cells.reset(new Cell[capacity]);
+            m_mask = capacity - 1U;
+            for (size_t i = 0; i < capacity; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            m_enqueuePos.store(0U, std::memory_order_relaxed);
+            m_dequeuePos.store(0U, std::memory_order_relaxed);
+        }
+        size_t capacity() const { return m_mask + 1U; }
+        // vFiller fills the record of the reserved cell, return false if the queue is full
+        template <typename T>
+        bool tryPush(const T& vFiller) {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[pos & m_mask];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+                if (dif == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+                        vFiller(cell.record);
+                        cell.sequence.store(pos + 1U, std::memory_order_release);
+                        return true;
+                    }
+                } else if (dif < 0) {
+                    return false;  // full
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        // vConsumer reads the record of the oldest cell, return false if the queue is empty
+        template <typename T>
+        bool tryPop(const T& vConsumer) {
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[pos & m_mask];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1U);
+                if (dif == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+                        vConsumer(cell.record);
+                        cell.sequence.store(pos + m_mask + 1U, std::memory_order_release);
+                        return true;
+                    }
+                } else if (dif < 0) {
+                    return false;  // empty
+                } else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
 private:
     static size_t constexpr sMAX_BUFFER_SIZE = 1024U * 3U;
     std::ofstream m_debugLogFile;
@@ -178,8 +280,47 @@ private:
     bool m_reseted = false;
     LogMessageFunctor m_standardLogFunction;
     LogMessageFunctor m_openGLLogFunction;
+    // history ring : once full, the oldest message at m_messagesStart is overwritten
     std::vector<std::string> m_messages;  // file, function, line, msg
+    size_t m_messagesStart = 0U;
+    size_t m_historyCapacity = EZ_LOG_HISTORY_CAPACITY;
+    // file sink
+    std::vector<char> m_fileBuffer;
+    std::string m_filePathName;
+    size_t m_fileSize = 0U;  // bytes written in the current file
+    uint64_t m_fileOpenTick = 0U;  // same type as time::getTicks()
+    size_t m_fileMaxSize = 0U;  // 0 : no size rotation
+    int64 m_fileMaxAgeMs = 0;  // 0 : no time rotation
+    size_t m_fileMaxBackups = 0U;
     bool m_consoleVerbose = false;
+    // async mode
+    static size_t constexpr sASYNC_BATCH_SIZE = 256U;
+    AsyncQueue m_asyncQueue;
+    std::vector<AsyncRecord> m_asyncBatch;  // records popped by the writer thread
+    OverflowPolicy m_asyncPolicy = OverflowPolicy::BLOCK;
+    std::thread m_asyncThread;
+    std::atomic<bool> m_async{false};  // callers push in the queue
+    std::atomic<bool> m_asyncRunning{false};  // the writer thread runs
+    std::atomic<bool> m_asyncWaiting{false};  // the writer thread sleeps
+    std::atomic<size_t> m_asyncProducers{0U};  // callers currently pushing
+    std::atomic<size_t> m_asyncPushed{0U};  // records pushed or being pushed
+    std::atomic<size_t> m_asyncConsumed{0U};  // records written or dropped by DROP_OLDEST
+    std::atomic<size_t> m_asyncDropped{0U};  // records lost by DROP or DROP_OLDEST
+    std::mutex m_asyncWakeMutex;
+    std::condition_variable m_asyncWake;
+    // binary mode : records are [u32 size][i32 type][i64 ticks][u64 format ptr][u8 args count][args], aligned on 8 bytes
+    // the size is stored last, a zero size means the record is not committed yet
+    enum BinaryArgType : uint8_t { BINARY_ARG_INT = 0, BINARY_ARG_UINT, BINARY_ARG_DOUBLE, BINARY_ARG_POINTER, BINARY_ARG_STRING };
+    struct BinaryIntTag {};
+    struct BinaryUintTag {};
+    struct BinaryDoubleTag {};
+    struct BinaryPointerTag {};
+    static size_t constexpr sBINARY_HEADER_SIZE = 24U;
+    static int32_t constexpr sBINARY_NO_TYPE = -1;
+    std::unique_ptr<uint8_t[]> m_binaryBuffer;
+    size_t m_binaryCapacity = 0U;
+    std::atomic<size_t> m_binaryCursor{0U};
+    std::atomic<size_t> m_binaryDropped{0U};
 
 public:
     Log() {
@@ -191,68 +332,54 @@ public:
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
+        stopAsync();
         close();
     }
     void logSimpleString(const char* fmt, ...) {
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(nullptr, nullptr, nullptr, fmt, args);
+        m_LogStringVa(nullptr, nullptr, nullptr, fmt, args);
         va_end(args);
-        lck.unlock();
     }
     void logSimpleStringByType(const MessageType& vType, const char* fmt, ...) {
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(&vType, nullptr, nullptr, fmt, args);
+        m_LogStringVa(&vType, nullptr, nullptr, fmt, args);
         va_end(args);
-        lck.unlock();
     }
     void logStringWithFunction(const std::string& vFunction, const int& vLine, const char* fmt, ...) {
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(nullptr, &vFunction, &vLine, fmt, args);
+        m_LogStringVa(nullptr, &vFunction, &vLine, fmt, args);
         va_end(args);
-        lck.unlock();
     }
     void logStringByTypeWithFunction(const MessageType& vType, const std::string& vFunction, const int& vLine, const char* fmt, ...) {
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(&vType, &vFunction, &vLine, fmt, args);
+        m_LogStringVa(&vType, &vFunction, &vLine, fmt, args);
         va_end(args);
-        lck.unlock();
     }
     void logStringByTypeWithFunction_Debug(const MessageType& vType, const std::string& vFunction, const int& vLine, const char* fmt, ...) {
 #ifndef NDEBUG
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(&vType, &vFunction, &vLine, fmt, args);
+        m_LogStringVa(&vType, &vFunction, &vLine, fmt, args);
         va_end(args);
-        lck.unlock();
 #else
         (void)vType;
         (void)vFunction;
@@ -265,13 +392,10 @@ public:
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
         ZoneScoped;
 #endif
-        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
-        lck.lock();
         va_list args;
         va_start(args, fmt);
-        m_LogString(nullptr, &vFunction, &vLine, fmt, args);
+        m_LogStringVa(nullptr, &vFunction, &vLine, fmt, args);
         va_end(args);
-        lck.unlock();
 #else
         (void)vFunction;
         (void)vLine;
@@ -355,8 +479,7 @@ public:
 #endif
         std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
         lck.lock();
-        m_debugLogFile.close();
-        m_debugLogFile.clear();
+        m_closeFile();
         lck.unlock();
     }
 
@@ -390,12 +513,231 @@ public:
         return msg;
     }
 
+    // Start the async mode : callers only format their message and push it in a bounded lock-free queue,
+    // a writer thread pops the messages by batches and writes them to the console, the file and the functor
+    // vCapacity is rounded up to a power of two, vPolicy tells what a caller does when the queue is full
+    bool startAsync(const size_t vCapacity = 8192U, const OverflowPolicy vPolicy = OverflowPolicy::BLOCK) {
+        if (m_asyncThread.joinable()) {
+            return false;
+        }
+        m_asyncQueue.init(vCapacity);
+        m_asyncBatch.resize(sASYNC_BATCH_SIZE);
+        m_asyncPolicy = vPolicy;
+        m_asyncPushed = 0U;
+        m_asyncConsumed = 0U;
+        m_asyncDropped = 0U;
+        m_asyncRunning = true;
+        m_asyncThread = std::thread(&Log::m_asyncWriterLoop, this);
+        m_async = true;
+        return true;
+    }
+
+    // Stop the async mode, the pending messages are written before return
+    void stopAsync() {
+        if (!m_asyncThread.joinable()) {
+            return;
+        }
+        m_async = false;  // next calls are synchronous
+        while (m_asyncProducers.load() != 0U) {
+            std::this_thread::yield();
+        }
+        m_asyncRunning = false;
+        m_wakeAsyncWriter();
+        m_asyncThread.join();
+    }
+
+    // Wait until the messages pushed before this call are written
+    void flushAsync() {
+        const size_t pushed = m_asyncPushed.load();
+        while (m_asyncThread.joinable() && m_asyncConsumed.load() < pushed) {
+            m_wakeAsyncWriter();
+            std::this_thread::yield();
+        }
+    }
+
+    bool isAsync() const { return m_async.load(); }
+
+    // Start the binary mode : logBinary() only copies the format pointer and the raw arguments in a
+    // preallocated buffer of vCapacity bytes, the text is rendered later by decodeBinary() or decodeBinaryFile()
+    // the records which do not fit in the buffer are dropped
+    void startBinary(const size_t vCapacity = 1024U * 1024U) {
+        m_binaryCapacity = (vCapacity + 7U) & ~(size_t)7U;
+        m_binaryBuffer.reset(new uint8_t[m_binaryCapacity]);
+        memset(m_binaryBuffer.get(), 0, m_binaryCapacity);
+        m_binaryCursor = 0U;
+        m_binaryDropped = 0U;
+    }
+
+    // Forget the recorded messages, must not be called while logBinary() runs on another thread
+    void resetBinary() {
+        if (m_binaryBuffer) {
+            memset(m_binaryBuffer.get(), 0, (std::min)(m_binaryCursor.load(), m_binaryCapacity));
+        }
+        m_binaryCursor = 0U;
+        m_binaryDropped = 0U;
+    }
+
+    // count of messages which did not fit in the binary buffer
+    size_t getBinaryDroppedCount() const { return m_binaryDropped.load(); }
+
+    // vFmt is kept as a pointer, so it must be a string literal (or live until the decoding)
+    // the arguments can be integers, floats, pointers, C strings and std::string ('*' width is not supported)
+    template <typename... Args>
+    void logBinary(const char* vFmt, const Args&... vArgs) {
+        m_logBinary(sBINARY_NO_TYPE, vFmt, vArgs...);
+    }
+    template <typename... Args>
+    void logBinaryByType(const MessageType& vType, const char* vFmt, const Args&... vArgs) {
+        m_logBinary((int32_t)vType, vFmt, vArgs...);
+    }
+
+    // Render the committed binary records as the text messages of the log
+    std::vector<std::string> decodeBinary() const {
+        std::vector<std::string> res;
+        m_decodeBinary(m_binaryBuffer.get(), m_getBinaryUsedSize(), m_lastTick, [](uint64_t vPtr) { return std::string((const char*)(uintptr_t)vPtr); }, res);
+        return res;
+    }
+
+    // Save the binary records with their format strings, for a decoding by decodeBinaryFile() in another process
+    bool saveBinaryFile(const std::string& vFilePathName) const {
+        std::ofstream file(vFilePathName, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        const size_t usedSize = m_getBinaryUsedSize();
+        std::unordered_map<uint64_t, std::string> formats;
+        for (size_t pos = 0; pos < usedSize;) {
+            const uint8_t* rec = m_binaryBuffer.get() + pos;
+            uint64_t fmt = 0U;
+            memcpy(&fmt, rec + 16U, 8U);
+            if (formats.find(fmt) == formats.end()) {
+                formats[fmt] = (const char*)(uintptr_t)fmt;
+            }
+            pos += m_loadBinarySize(rec);
+        }
+        const uint32_t version = 1U;
+        const int64_t baseTick = m_lastTick;
+        const uint32_t formatsCount = (uint32_t)formats.size();
+        const uint64_t recordsSize = usedSize;
+        file.write("EZLB", 4);
+        file.write((const char*)&version, sizeof(version));
+        file.write((const char*)&baseTick, sizeof(baseTick));
+        file.write((const char*)&formatsCount, sizeof(formatsCount));
+        for (const auto& it : formats) {
+            const uint32_t len = (uint32_t)it.second.size();
+            file.write((const char*)&it.first, sizeof(it.first));
+            file.write((const char*)&len, sizeof(len));
+            file.write(it.second.data(), len);
+        }
+        file.write((const char*)&recordsSize, sizeof(recordsSize));
+        file.write((const char*)m_binaryBuffer.get(), (std::streamsize)usedSize);
+        return file.good();
+    }
+
+    // Render the records of a file saved by saveBinaryFile()
+    static bool decodeBinaryFile(const std::string& vFilePathName, std::vector<std::string>& vOutMessages) {
+        std::ifstream file(vFilePathName, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        char magic[4] = {};
+        uint32_t version = 0U;
+        int64_t baseTick = 0;
+        uint32_t formatsCount = 0U;
+        file.read(magic, 4);
+        file.read((char*)&version, sizeof(version));
+        file.read((char*)&baseTick, sizeof(baseTick));
+        file.read((char*)&formatsCount, sizeof(formatsCount));
+        if (!file.good() || memcmp(magic, "EZLB", 4) != 0 || version != 1U) {
+            return false;
+        }
+        std::unordered_map<uint64_t, std::string> formats;
+        for (uint32_t i = 0; i < formatsCount; ++i) {
+            uint64_t ptr = 0U;
+            uint32_t len = 0U;
+            file.read((char*)&ptr, sizeof(ptr));
+            file.read((char*)&len, sizeof(len));
+            std::string fmt(len, '\0');
+            file.read(&fmt[0], len);
+            formats[ptr] = fmt;
+        }
+        uint64_t recordsSize = 0U;
+        file.read((char*)&recordsSize, sizeof(recordsSize));
+        std::vector<uint8_t> records((size_t)recordsSize);
+        file.read((char*)records.data(), (std::streamsize)recordsSize);
+        if (!file.good()) {
+            return false;
+        }
+        m_decodeBinary(records.data(), records.size(), baseTick, [&formats](uint64_t vPtr) { return formats[vPtr]; }, vOutMessages);
+        return true;
+    }
+
+    // count of messages lost with OverflowPolicy::DROP or OverflowPolicy::DROP_OLDEST
+    size_t getAsyncDroppedCount() const { return m_asyncDropped.load(); }
+
     void setStandardLogMessageFunctor(const LogMessageFunctor& vMessageLogFunctor) { m_standardLogFunction = vMessageLogFunctor; }
     void setOpenglLogMessageFunctor(const LogMessageFunctor& vMessageLogFunctor) { m_openGLLogFunction = vMessageLogFunctor; }
 
     void setVerboseMode(bool vFlag) { m_consoleVerbose = vFlag; }
     bool isVerboseMode() { return m_consoleVerbose; }
 
+    // Max count of messages kept in the history, the oldest are dropped first. 0 means unbounded
+    void setHistoryCapacity(const size_t vCapacity) {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        auto msgs = m_getMessages();
+        if (vCapacity && msgs.size() > vCapacity) {
+            msgs.erase(msgs.begin(), msgs.begin() + (msgs.size() - vCapacity));
+        }
+        m_messages = std::move(msgs);
+        m_messagesStart = 0U;
+        m_historyCapacity = vCapacity;
+    }
+    size_t getHistoryCapacity() {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        return m_historyCapacity;
+    }
+    size_t getMessagesCount() {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        return m_messages.size();
+    }
+    // the messages of the history, from the oldest to the newest
+    std::vector<std::string> getMessages() {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        return m_getMessages();
+    }
+    // vIdx 0 is the oldest message of the history
+    std::string getMessage(const size_t vIdx) {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        if (vIdx < m_messages.size()) {
+            return m_messages[(m_messagesStart + vIdx) % m_messages.size()];
+        }
+        return {};
+    }
+    void clearMessages() {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        m_messages.clear();
+        m_messagesStart = 0U;
+    }
+
+    // Write the log in vFilePathName with a buffered stream, flushed on close, on rotation and on errors
+    // the file is rotated when it exceeds vMaxSize bytes or vMaxAgeMs milliseconds (0 disables each rule) :
+    // file.log is renamed file.log.1, file.log.1 is renamed file.log.2, ... and file.log.<vMaxBackups> is removed
+    bool openFile(const std::string& vFilePathName, const size_t vMaxSize = 0U, const int64 vMaxAgeMs = 0, const size_t vMaxBackups = 5U) {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        m_closeFile();
+        m_filePathName = vFilePathName;
+        m_fileMaxSize = vMaxSize;
+        m_fileMaxAgeMs = vMaxAgeMs;
+        m_fileMaxBackups = vMaxBackups;
+        return m_openFile();
+    }
+    void flushFile() {
+        std::lock_guard<std::mutex> lck(m_logger_Mutex);
+        if (m_debugLogFile.is_open()) {
+            m_debugLogFile.flush();
+        }
+    }
+
 private:
     void m_createFileOnDisk() {
         if (m_reseted) {
@@ -406,7 +748,8 @@ private:
 #endif
         std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
         lck.lock();
-        m_debugLogFile.open("debug.log", std::ios::out);
+        m_filePathName = "debug.log";
+        m_openFile();
         m_lastTick = time::getTicks();
         m_consoleVerbose = false;
         m_reseted = true;
@@ -414,60 +757,133 @@ private:
     }
 
 private:
-    void m_LogString(const MessageType* vType, const std::string* vFunction, const int* vLine, const char* vStr) {
+    // Format the message as [time][function:line] text, returns its length
+    size_t m_formatMessage(char* vBuffer, const std::string* vFunction, const int* vLine, const char* vStr) {
         const int64 ticks = time::getTicks();
         const double time = (ticks - m_lastTick) / 1000.0;
-
-        static char TempBufferBis[sMAX_BUFFER_SIZE + 1];
         int w = 0;
         if (vFunction && vLine) {
-            w = snprintf(TempBufferBis, sMAX_BUFFER_SIZE, "[%010.3fs][%s:%i] %s", time, vFunction->c_str(), *vLine, vStr);
+            w = snprintf(vBuffer, sMAX_BUFFER_SIZE, "[%010.3fs][%s:%i] %s", time, vFunction->c_str(), *vLine, vStr);
         } else {
-            w = snprintf(TempBufferBis, sMAX_BUFFER_SIZE, "[%010.3fs] %s", time, vStr);
+            w = snprintf(vBuffer, sMAX_BUFFER_SIZE, "[%010.3fs] %s", time, vStr);
         }
-        if (w) {
-            const std::string msg = std::string(TempBufferBis, (size_t)w);
+        if (w <= 0) {
+            return 0U;
+        }
+        return ((size_t)w < sMAX_BUFFER_SIZE) ? (size_t)w : sMAX_BUFFER_SIZE - 1U;  // truncated
+    }
 
-            m_messages.push_back(msg);
+    // Write a formatted message to the history, the console, the functor and the file
+    // vFlush is false for the async writer, which flushes once per batch
+    void m_writeMessage(const MessageType* vType, const std::string& vMsg, const bool vFlush) {
+        m_addToHistory(vMsg);
 
 #if defined(TRACY_ENABLE) && defined(LOG_TRACY_MESSAGES)
-            TracyMessageL(m_messages[m_messages.size() - 1U].c_str());
+        TracyMessageL(vMsg.c_str());
 #endif
 
 #ifdef __ANDROID__
-            if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_INFOS) {
-                __android_log_write(ANDROID_LOG_INFO, EZ_LOG_APP_NAME, msg.c_str());
-            } else if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_WARNING) {
-                __android_log_write(ANDROID_LOG_WARN, EZ_LOG_APP_NAME, msg.c_str());
-            } else if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_ERROR) {
-                __android_log_write(ANDROID_LOG_ERROR, EZ_LOG_APP_NAME, msg.c_str());
-            }
+        if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_INFOS) {
+            __android_log_write(ANDROID_LOG_INFO, EZ_LOG_APP_NAME, vMsg.c_str());
+        } else if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_WARNING) {
+            __android_log_write(ANDROID_LOG_WARN, EZ_LOG_APP_NAME, vMsg.c_str());
+        } else if (*vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_ERROR) {
+            __android_log_write(ANDROID_LOG_ERROR, EZ_LOG_APP_NAME, vMsg.c_str());
+        }
 #else
-            std::cout << msg << std::endl;
+        std::cout << vMsg << '\n';
+        if (vFlush) {
+            std::cout.flush();
+        }
 #endif
 
-            if (vStr && m_standardLogFunction) {
-                int type = 0;
+        if (m_standardLogFunction) {
+            int type = 0;
 
-                if (vType) {
-                    type = (int)(*vType);
-                }
+            if (vType) {
+                type = (int)(*vType);
+            }
 
-                auto arr = str::splitStringToVector(msg, '\n');
-                if (arr.size() == 1U) {
-                    m_standardLogFunction(type, msg);
-                } else {
-                    for (auto m : arr) {
-                        m_standardLogFunction(type, m);
-                    }
+            auto arr = str::splitStringToVector(vMsg, '\n');
+            if (arr.size() == 1U) {
+                m_standardLogFunction(type, vMsg);
+            } else {
+                for (auto m : arr) {
+                    m_standardLogFunction(type, m);
                 }
             }
+        }
 
-            if (!m_debugLogFile.bad()) {
-                m_debugLogFile << msg << std::endl;
+        if (m_debugLogFile.is_open() && !m_debugLogFile.bad()) {
+            m_rotateFileIfNeeded();
+            m_debugLogFile << vMsg << '\n';
+            m_fileSize += vMsg.size() + 1U;
+            // the errors are flushed at once, so the last messages before a crash are on disk
+            if (vFlush && vType && *vType == MessageTypeEnum::LOGGING_MESSAGE_TYPE_ERROR) {
+                m_debugLogFile.flush();
             }
         }
     }
+
+    void m_addToHistory(const std::string& vMsg) {
+        if (!m_historyCapacity || m_messages.size() < m_historyCapacity) {
+            m_messages.push_back(vMsg);
+        } else {
+            m_messages[m_messagesStart] = vMsg;  // reuse the string of the oldest message
+            m_messagesStart = (m_messagesStart + 1U) % m_messages.size();
+        }
+    }
+
+    std::vector<std::string> m_getMessages() const {
+        std::vector<std::string> res;
+        res.reserve(m_messages.size());
+        for (size_t i = 0; i < m_messages.size(); ++i) {
+            res.push_back(m_messages[(m_messagesStart + i) % m_messages.size()]);
+        }
+        return res;
+    }
+
+    bool m_openFile() {
+        if (m_fileBuffer.empty()) {
+            m_fileBuffer.resize(EZ_LOG_FILE_BUFFER_SIZE);
+        }
+        m_debugLogFile.rdbuf()->pubsetbuf(m_fileBuffer.data(), (std::streamsize)m_fileBuffer.size());  // must be set before open
+        m_debugLogFile.open(m_filePathName, std::ios::out);
+        m_fileSize = 0U;
+        m_fileOpenTick = time::getTicks();
+        return m_debugLogFile.is_open();
+    }
+
+    void m_closeFile() {
+        m_debugLogFile.close();
+        m_debugLogFile.clear();
+    }
+
+    void m_rotateFileIfNeeded() {
+        const bool sizeExceeded = (m_fileMaxSize && m_fileSize >= m_fileMaxSize);
+        const uint64_t ticks = time::getTicks();  // system clock, so can go back
+        const bool ageExceeded = (m_fileMaxAgeMs > 0 && m_fileSize && ticks >= m_fileOpenTick && (int64)(ticks - m_fileOpenTick) >= m_fileMaxAgeMs);
+        if (!sizeExceeded && !ageExceeded) {
+            return;
+        }
+        m_closeFile();
+        if (m_fileMaxBackups) {
+            std::remove((m_filePathName + "." + std::to_string(m_fileMaxBackups)).c_str());
+            for (size_t i = m_fileMaxBackups - 1U; i > 0U; --i) {
+                std::rename((m_filePathName + "." + std::to_string(i)).c_str(), (m_filePathName + "." + std::to_string(i + 1U)).c_str());
+            }
+            std::rename(m_filePathName.c_str(), (m_filePathName + ".1").c_str());
+        }
+        m_openFile();
+    }
+
+    void m_LogString(const MessageType* vType, const std::string* vFunction, const int* vLine, const char* vStr) {
+        static char TempBufferBis[sMAX_BUFFER_SIZE + 1];
+        const size_t len = m_formatMessage(TempBufferBis, vFunction, vLine, vStr);
+        if (len) {
+            m_writeMessage(vType, std::string(TempBufferBis, len), true);
+        }
+    }
     void m_LogString(const MessageType* vType, const std::string* vFunction, const int* vLine, const char* fmt, va_list vArgs) {
         static char TempBuffer[sMAX_BUFFER_SIZE + 1];
         int w = vsnprintf(TempBuffer, sMAX_BUFFER_SIZE, fmt, vArgs);
@@ -476,6 +892,331 @@ private:
         }
     }
 
+    // Entry of all the log calls : pushed in the async queue if the async mode is started, else written under lock
+    void m_LogStringVa(const MessageType* vType, const std::string* vFunction, const int* vLine, const char* fmt, va_list vArgs) {
+        if (m_async.load(std::memory_order_relaxed)) {
+            ++m_asyncProducers;
+            if (m_async.load()) {
+                m_pushAsync(vType, vFunction, vLine, fmt, vArgs);
+                --m_asyncProducers;
+                return;
+            }
+            --m_asyncProducers;
+        }
+        std::unique_lock<std::mutex> lck(ez::Log::m_logger_Mutex, std::defer_lock);
+        lck.lock();
+        m_LogString(vType, vFunction, vLine, fmt, vArgs);
+        lck.unlock();
+    }
+
+    // Format the message on the caller thread and push it in the async queue
+    void m_pushAsync(const MessageType* vType, const std::string* vFunction, const int* vLine, const char* fmt, va_list vArgs) {
+        static thread_local char TempBuffer[sMAX_BUFFER_SIZE + 1];
+        static thread_local char TempBufferBis[sMAX_BUFFER_SIZE + 1];
+        int w = vsnprintf(TempBuffer, sMAX_BUFFER_SIZE, fmt, vArgs);
+        if (!w) {
+            return;
+        }
+        const size_t len = m_formatMessage(TempBufferBis, vFunction, vLine, TempBuffer);
+        if (!len) {
+            return;
+        }
+        const char* msg = TempBufferBis;
+        auto filler = [vType, msg, len](AsyncRecord& vRecord) {
+            vRecord.hasType = (vType != nullptr);
+            vRecord.type = vType ? *vType : 0;
+            vRecord.msg.assign(msg, len);
+        };
+        // counted before its publication, so a flushAsync can not return before its write
+        ++m_asyncPushed;
+        while (!m_asyncQueue.tryPush(filler)) {
+            if (m_asyncPolicy == OverflowPolicy::DROP) {
+                --m_asyncPushed;
+                ++m_asyncDropped;
+                return;
+            } else if (m_asyncPolicy == OverflowPolicy::DROP_OLDEST) {
+                if (m_asyncQueue.tryPop([](AsyncRecord&) {})) {
+                    ++m_asyncDropped;
+                    ++m_asyncConsumed;
+                }
+            } else {  // BLOCK
+                m_wakeAsyncWriter();
+                std::this_thread::yield();
+            }
+        }
+        if (m_asyncWaiting.load(std::memory_order_relaxed)) {
+            m_wakeAsyncWriter();
+        }
+    }
+
+    void m_wakeAsyncWriter() {
+        std::lock_guard<std::mutex> lck(m_asyncWakeMutex);
+        m_asyncWake.notify_one();
+    }
+
+    // Writer thread : pops the records by batches, flushes the console and the file once per batch
+    void m_asyncWriterLoop() {
+        for (;;) {
+            // the records are swapped out of the queue, so the cells are released before the slow writes
+            size_t count = 0U;
+            while (count < sASYNC_BATCH_SIZE && m_asyncQueue.tryPop([this, count](AsyncRecord& vRecord) {
+                auto& rec = m_asyncBatch[count];
+                rec.type = vRecord.type;
+                rec.hasType = vRecord.hasType;
+                rec.msg.swap(vRecord.msg);
+            })) {
+                ++count;
+            }
+            if (count) {
+                std::lock_guard<std::mutex> lck(m_logger_Mutex);
+                for (size_t i = 0; i < count; ++i) {
+                    const auto& rec = m_asyncBatch[i];
+                    m_writeMessage(rec.hasType ? &rec.type : nullptr, rec.msg, false);
+                }
+                std::cout.flush();
+                if (!m_debugLogFile.bad()) {
+                    m_debugLogFile.flush();
+                }
+            }
+            m_asyncConsumed += count;
+            if (count == 0U) {
+                if (!m_asyncRunning.load()) {
+                    break;  // stopped and drained
+                }
+                std::unique_lock<std::mutex> lck(m_asyncWakeMutex);
+                m_asyncWaiting = true;
+                m_asyncWake.wait_for(lck, std::chrono::milliseconds(10));
+                m_asyncWaiting = false;
+            }
+        }
+    }
+
+    template <typename... Args>
+    void m_logBinary(const int32_t vType, const char* vFmt, const Args&... vArgs) {
+        if (!m_binaryBuffer) {
+            return;
+        }
+        static_assert(sizeof...(Args) < 256U, "too many arguments");
+        const size_t size = (sBINARY_HEADER_SIZE + 1U + m_binaryArgsSize(vArgs...) + 7U) & ~(size_t)7U;
+        const size_t pos = m_binaryCursor.fetch_add(size, std::memory_order_relaxed);
+        if (pos + size > m_binaryCapacity) {
+            ++m_binaryDropped;
+            return;
+        }
+        uint8_t* rec = m_binaryBuffer.get() + pos;
+        const int64_t ticks = (int64_t)time::getTicks();
+        const uint64_t fmt = (uint64_t)(uintptr_t)vFmt;
+        memcpy(rec + 4U, &vType, 4U);
+        memcpy(rec + 8U, &ticks, 8U);
+        memcpy(rec + 16U, &fmt, 8U);
+        rec[sBINARY_HEADER_SIZE] = (uint8_t)sizeof...(Args);
+        m_binaryWriteArgs(rec + sBINARY_HEADER_SIZE + 1U, vArgs...);
+        reinterpret_cast<std::atomic<uint32_t>*>(rec)->store((uint32_t)size, std::memory_order_release);  // commit
+    }
+
+    static uint32_t m_loadBinarySize(const uint8_t* vRecord) {
+        return reinterpret_cast<const std::atomic<uint32_t>*>(vRecord)->load(std::memory_order_acquire);
+    }
+
+    // size of the committed records, stops at the first record not committed yet
+    size_t m_getBinaryUsedSize() const {
+        if (!m_binaryBuffer) {
+            return 0U;
+        }
+        const size_t end = (std::min)(m_binaryCursor.load(), m_binaryCapacity);
+        size_t pos = 0U;
+        while (pos + sBINARY_HEADER_SIZE <= end) {
+            const uint32_t size = m_loadBinarySize(m_binaryBuffer.get() + pos);
+            if (!size) {
+                break;
+            }
+            pos += size;
+        }
+        return pos;
+    }
+
+    static size_t m_binaryArgsSize() { return 0U; }
+    template <typename T, typename... Args>
+    static size_t m_binaryArgsSize(const T& vArg, const Args&... vArgs) {
+        return m_binaryArgSize(vArg) + m_binaryArgsSize(vArgs...);
+    }
+    static size_t m_binaryStrLen(const char* vStr) { return vStr ? (std::min)(strlen(vStr), (size_t)0xFFFF) : 0U; }
+    static size_t m_binaryArgSize(const char* vStr) { return 3U + m_binaryStrLen(vStr); }
+    static size_t m_binaryArgSize(char* vStr) { return 3U + m_binaryStrLen(vStr); }
+    static size_t m_binaryArgSize(const std::string& vStr) { return 3U + (std::min)(vStr.size(), (size_t)0xFFFF); }
+    template <typename T>
+    static size_t m_binaryArgSize(const T&) {
+        return 9U;
+    }
+
+    static void m_binaryWriteArgs(uint8_t*) {}
+    template <typename T, typename... Args>
+    static void m_binaryWriteArgs(uint8_t* vPtr, const T& vArg, const Args&... vArgs) {
+        m_binaryWriteArgs(m_binaryWriteArg(vPtr, vArg), vArgs...);
+    }
+    static uint8_t* m_binaryWriteString(uint8_t* vPtr, const char* vStr, const size_t vLen) {
+        const uint16_t len = (uint16_t)vLen;
+        *vPtr++ = BINARY_ARG_STRING;
+        memcpy(vPtr, &len, 2U);
+        if (len) {
+            memcpy(vPtr + 2U, vStr, len);
+        }
+        return vPtr + 2U + len;
+    }
+    static uint8_t* m_binaryWriteArg(uint8_t* vPtr, const char* vStr) { return m_binaryWriteString(vPtr, vStr, m_binaryStrLen(vStr)); }
+    static uint8_t* m_binaryWriteArg(uint8_t* vPtr, char* vStr) { return m_binaryWriteString(vPtr, vStr, m_binaryStrLen(vStr)); }
+    static uint8_t* m_binaryWriteArg(uint8_t* vPtr, const std::string& vStr) { return m_binaryWriteString(vPtr, vStr.data(), (std::min)(vStr.size(), (size_t)0xFFFF)); }
+    template <typename T>
+    static uint8_t* m_binaryWriteArg(uint8_t* vPtr, const T& vArg) {
+        typedef typename std::conditional<std::is_signed<T>::value, BinaryIntTag, BinaryUintTag>::type IntegerTag;
+        typedef typename std::conditional<std::is_pointer<T>::value, BinaryPointerTag, IntegerTag>::type NotFloatTag;
+        return m_binaryWriteScalar(vPtr, vArg, typename std::conditional<std::is_floating_point<T>::value, BinaryDoubleTag, NotFloatTag>::type());
+    }
+    template <typename T>
+    static uint8_t* m_binaryWriteScalar(uint8_t* vPtr, const T& vArg, BinaryIntTag) {
+        const int64_t v = (int64_t)vArg;
+        *vPtr = BINARY_ARG_INT;
+        memcpy(vPtr + 1U, &v, 8U);
+        return vPtr + 9U;
+    }
+    template <typename T>
+    static uint8_t* m_binaryWriteScalar(uint8_t* vPtr, const T& vArg, BinaryUintTag) {
+        const uint64_t v = (uint64_t)vArg;
+        *vPtr = BINARY_ARG_UINT;
+        memcpy(vPtr + 1U, &v, 8U);
+        return vPtr + 9U;
+    }
+    template <typename T>
+    static uint8_t* m_binaryWriteScalar(uint8_t* vPtr, const T& vArg, BinaryDoubleTag) {
+        const double v = (double)vArg;
+        *vPtr = BINARY_ARG_DOUBLE;
+        memcpy(vPtr + 1U, &v, 8U);
+        return vPtr + 9U;
+    }
+    template <typename T>
+    static uint8_t* m_binaryWriteScalar(uint8_t* vPtr, const T& vArg, BinaryPointerTag) {
+        const uint64_t v = (uint64_t)(uintptr_t)vArg;
+        *vPtr = BINARY_ARG_POINTER;
+        memcpy(vPtr + 1U, &v, 8U);
+        return vPtr + 9U;
+    }
+
+    static void m_appendFormatted(std::string& vOut, const char* vSpec, ...) {
+        va_list args;
+        va_start(args, vSpec);
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        const int len = vsnprintf(nullptr, 0, vSpec, args);
+        if (len > 0) {
+            const size_t start = vOut.size();
+            vOut.resize(start + (size_t)len + 1U);
+            vsnprintf(&vOut[start], (size_t)len + 1U, vSpec, argsCopy);
+            vOut.resize(start + (size_t)len);
+        }
+        va_end(argsCopy);
+        va_end(args);
+    }
+
+    // Render one record : each printf conversion of the format takes the next stored argument,
+    // the length modifiers are replaced since the integers are stored on 64 bits
+    static std::string m_renderBinaryRecord(const std::string& vFmt, const uint8_t* vArgs) {
+        std::string res;
+        size_t argsCount = *vArgs++;
+        const char* c = vFmt.c_str();
+        while (*c) {
+            if (*c != '%') {
+                res += *c++;
+                continue;
+            }
+            ++c;
+            if (*c == '%') {
+                res += *c++;
+                continue;
+            }
+            std::string spec = "%";
+            while (*c && strchr("-+ #0123456789.", *c)) {
+                spec += *c++;
+            }
+            while (*c && strchr("hljztL", *c)) {
+                ++c;
+            }
+            const char conv = *c;
+            if (!conv) {
+                break;
+            }
+            ++c;
+            if (!argsCount) {
+                res += "<?>";  // missing argument
+                continue;
+            }
+            --argsCount;
+            const uint8_t type = *vArgs++;
+            int64_t i64 = 0;
+            uint64_t u64 = 0U;
+            double f64 = 0.0;
+            std::string str;
+            if (type == BINARY_ARG_STRING) {
+                uint16_t len = 0U;
+                memcpy(&len, vArgs, 2U);
+                str.assign((const char*)vArgs + 2U, len);
+                vArgs += 2U + len;
+            } else {
+                memcpy(&u64, vArgs, 8U);
+                vArgs += 8U;
+                memcpy(&i64, &u64, 8U);
+                if (type == BINARY_ARG_DOUBLE) {
+                    memcpy(&f64, &u64, 8U);
+                    i64 = (int64_t)f64;
+                    u64 = (uint64_t)i64;
+                } else {
+                    f64 = (type == BINARY_ARG_INT) ? (double)i64 : (double)u64;
+                }
+            }
+            spec += conv;
+            if (strchr("di", conv)) {
+                spec.insert(spec.size() - 1U, "ll");
+                m_appendFormatted(res, spec.c_str(), (long long)i64);
+            } else if (strchr("uxXo", conv)) {
+                spec.insert(spec.size() - 1U, "ll");
+                m_appendFormatted(res, spec.c_str(), (unsigned long long)u64);
+            } else if (conv == 'c') {
+                m_appendFormatted(res, spec.c_str(), (int)i64);
+            } else if (strchr("fFeEgGaA", conv)) {
+                m_appendFormatted(res, spec.c_str(), f64);
+            } else if (conv == 's') {
+                m_appendFormatted(res, spec.c_str(), str.c_str());
+            } else if (conv == 'p') {
+                m_appendFormatted(res, spec.c_str(), (void*)(uintptr_t)u64);
+            }
+        }
+        return res;
+    }
+
+    template <typename T>
+    static void m_decodeBinary(const uint8_t* vRecords, const size_t vSize, const int64 vBaseTick, const T& vFormatResolver, std::vector<std::string>& vOutMessages) {
+        if (!vRecords) {
+            return;
+        }
+        for (size_t pos = 0; pos + sBINARY_HEADER_SIZE <= vSize;) {
+            const uint8_t* rec = vRecords + pos;
+            uint32_t size = 0U;
+            memcpy(&size, rec, 4U);
+            if (size <= sBINARY_HEADER_SIZE || pos + size > vSize) {
+                break;
+            }
+            int64_t ticks = 0;
+            uint64_t fmt = 0U;
+            memcpy(&ticks, rec + 8U, 8U);
+            memcpy(&fmt, rec + 16U, 8U);
+            const std::string msg = m_renderBinaryRecord(vFormatResolver(fmt), rec + sBINARY_HEADER_SIZE);
+            const double time = (ticks - vBaseTick) / 1000.0;
+            std::string line;
+            m_appendFormatted(line, "[%010.3fs] %s", time, msg.c_str());
+            vOutMessages.push_back(line);
+            pos += size;
+        }
+    }
+
 public:
 // old behavior
 #ifdef LEGACY_SINGLETON
@@ -26,11 +26,16 @@ SOFTWARE.
 
 // ezQuadTree is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
 
+#include <map>
 #include <vector>
+#include <cstdint>
 #include <algorithm>
 #include <limits>
 #include <cmath>
 #include <queue>
+#include <utility>
+#include <functional>
+#include <type_traits>
 
 // On suppose ici que vous avez déjà une classe/matrice/méthode pour gérer un vec2<T> :
 // template <typename T>
@@ -48,18 +53,79 @@ SOFTWARE.
 namespace ez
 {
 
+    namespace detail
+    {
+        /**
+         * @brief Payload "vide" d'un QuadTree sans payload.
+         */
+        struct QuadTreeNoPayload
+        {
+        };
+
+        /**
+         * @brief Payloads stockés en parallèle des points (même index que le point).
+         */
+        template <typename P>
+        class QuadTreePayloads
+        {
+        public:
+            void clear() { m_values.clear(); }
+            void reserve(std::size_t vCount) { m_values.reserve(vCount); }
+            void resize(std::size_t vCount) { m_values.resize(vCount); }
+            void push_back(const P& vValue) { m_values.push_back(vValue); }
+            const P& get(std::size_t vIdx) const { return m_values[vIdx]; }
+            void set(std::size_t vIdx, const P& vValue) { m_values[vIdx] = vValue; }
+            void swap(std::size_t vA, std::size_t vB) { std::swap(m_values[vA], m_values[vB]); }
+            template <typename TPoint, typename TCallback>
+            void call(TCallback& vCallback, const TPoint& vPoint, std::size_t vIdx) const { vCallback(vPoint, m_values[vIdx]); }
+
+        private:
+            std::vector<P> m_values;
+        };
+
+        /**
+         * @brief Sans payload, rien n'est stocké et le callback ne reçoit que le point.
+         */
+        template <>
+        class QuadTreePayloads<QuadTreeNoPayload>
+        {
+        public:
+            void clear() {}
+            void reserve(std::size_t) {}
+            void resize(std::size_t) {}
+            void push_back(const QuadTreeNoPayload&) {}
+            QuadTreeNoPayload get(std::size_t) const { return QuadTreeNoPayload(); }
+            void set(std::size_t, const QuadTreeNoPayload&) {}
+            void swap(std::size_t, std::size_t) {}
+            template <typename TPoint, typename TCallback>
+            void call(TCallback& vCallback, const TPoint& vPoint, std::size_t) const { vCallback(vPoint); }
+        };
+    } // namespace detail
+
     /**
      * @brief QuadTree générique permettant d'insérer, de supprimer et de déplacer des points.
      *        Il propose également une méthode pour récupérer les voisins les plus proches d'un point.
      *
+     *        Les noeuds sont stockés dans un tableau contigu (les 4 enfants d'un noeud sont consécutifs)
+     *        et les points des feuilles dans des plages d'un tableau contigu de points, sans allocation par noeud.
+     *        La construction en bloc (build) range les points dans l'ordre de Morton (Z-order),
+     *        les points d'une même région sont donc voisins en mémoire.
+     *
+     *        Chaque point peut porter un payload (id, handle..), stocké dans un tableau parallèle
+     *        et rendu par les requêtes à callback (forEachInRect, forEachInRadius, forEachNNeighboor).
+     *        Sans payload (void), les callbacks reçoivent seulement le point.
+     *
      * @tparam T Type numérique sous-jacent (float, double, etc.)
+     * @tparam TPayload Type du payload de chaque point (void pour aucun)
      *
-     * @warning Nécessite l'existence de vec2<T> (déjà fourni selon l'énoncé).
+     * @warning Nécessite l'existence de vec2<T> et AABB<T> (ezMath.hpp).
      */
-    template <typename T>
+    template <typename T, typename TPayload = void>
     class QuadTree
     {
     public:
+        typedef typename std::conditional<std::is_void<TPayload>::value, detail::QuadTreeNoPayload, TPayload>::type PayloadType;
+
         /**
          * @brief Constructeur principal.
          * @param xMin   Borne minimale en X de la zone couverte par le QuadTree.
@@ -69,14 +135,120 @@ namespace ez
          * @param capacity Nombre maximum de points qu'un noeud peut contenir avant subdivision.
          */
         QuadTree(T xMin, T xMax, T yMin, T yMax, std::size_t capacity = 4)
-            : m_capacity(capacity)
+            : m_capacity(capacity ? capacity : 1)
         {
             m_boundary.xMin = xMin;
             m_boundary.xMax = xMax;
             m_boundary.yMin = yMin;
             m_boundary.yMax = yMax;
+            clear();
         }
 
+        /**
+         * @brief Constructeur avec construction en bloc (voir build).
+         */
+        QuadTree(T xMin, T xMax, T yMin, T yMax, const std::vector<vec2<T>>& points, std::size_t capacity = 4)
+            : QuadTree(xMin, xMax, yMin, yMax, capacity)
+        {
+            build(points);
+        }
+
+        /**
+         * @brief Constructeur avec construction en bloc de points et de leurs payloads (voir build).
+         */
+        template <typename P = TPayload, typename = typename std::enable_if<!std::is_void<P>::value>::type>
+        QuadTree(T xMin, T xMax, T yMin, T yMax, const std::vector<vec2<T>>& points, const std::vector<P>& payloads, std::size_t capacity = 4)
+            : QuadTree(xMin, xMax, yMin, yMax, capacity)
+        {
+            build(points, payloads);
+        }
+
+        /**
+         * @brief Vide le QuadTree.
+         */
+        void clear()
+        {
+            m_nodes.assign(1, Node());
+            m_freeNodes.clear();
+            m_freeRanges.clear();
+            m_points.clear();
+            m_payloads.clear();
+            m_count = 0;
+        }
+
+        /**
+         * @brief Remplace le contenu du QuadTree par points, en une seule passe.
+         *        Chaque noeud partitionne sa plage de points en 4 quadrants sur place, récursivement,
+         *        ce qui range les points dans l'ordre de Morton et alloue les noeuds d'un seul tenant.
+         *        Bien plus rapide que des insert successifs.
+         *        Les payloads éventuels sont construits par défaut.
+         * @param points Les points à insérer (ceux hors de la zone sont ignorés).
+         * @return Le nombre de points insérés.
+         */
+        std::size_t build(const std::vector<vec2<T>>& points)
+        {
+            clear();
+            m_points.reserve(points.size());
+            for (const auto& p : points)
+            {
+                if (m_boundary.contains(p))
+                    m_points.push_back(p);
+            }
+            m_payloads.resize(m_points.size());
+            return buildFromPoints();
+        }
+
+        /**
+         * @brief Comme build(points), avec le payload de chaque point (payloads[i] pour points[i]).
+         * @return Le nombre de points insérés (0 si les tailles diffèrent).
+         */
+        template <typename P = TPayload>
+        typename std::enable_if<!std::is_void<P>::value, std::size_t>::type build(const std::vector<vec2<T>>& points, const std::vector<P>& payloads)
+        {
+            clear();
+            if (points.size() != payloads.size())
+                return 0;
+            m_points.reserve(points.size());
+            m_payloads.reserve(points.size());
+            for (std::size_t i = 0; i < points.size(); ++i)
+            {
+                if (m_boundary.contains(points[i]))
+                {
+                    m_points.push_back(points[i]);
+                    m_payloads.push_back(payloads[i]);
+                }
+            }
+            return buildFromPoints();
+        }
+
+        /**
+         * @brief Reconstruit l'arbre avec ses propres points, pour compacter la mémoire
+         *        et retrouver l'ordre de Morton après de nombreux insert/remove.
+         */
+        void rebuild()
+        {
+            std::vector<vec2<T>> points;
+            detail::QuadTreePayloads<PayloadType> payloads;
+            points.reserve(m_count);
+            payloads.reserve(m_count);
+            collectAllPoints(0, points, payloads);
+            clear();
+            m_points.swap(points);
+            m_payloads = std::move(payloads);
+            buildFromPoints();
+        }
+
+        /**
+         * @brief Nombre de points contenus dans le QuadTree.
+         */
+        std::size_t size() const { return m_count; }
+
+        /**
+         * @brief Taille de la zone des plages de points (points, places libres des feuilles et plages libérées).
+         *        Les plages libérées sont réutilisées par les insert, cette taille reste donc bornée.
+         */
+        std::size_t arenaSize() const { return m_points.size(); }
+
         /**
          * @brief Insère un nouveau point dans le QuadTree.
          * @param pt Le point à insérer.
@@ -84,21 +256,45 @@ namespace ez
          */
         bool insert(const vec2<T>& pt)
         {
-            return insertImpl(m_root, pt, m_boundary);
+            return insert(pt, PayloadType());
+        }
+
+        /**
+         * @brief Insère un nouveau point et son payload dans le QuadTree.
+         * @param pt Le point à insérer.
+         * @param payload Le payload du point.
+         * @return true si l'insertion a réussi, false sinon (hors limite par ex.).
+         */
+        bool insert(const vec2<T>& pt, const PayloadType& payload)
+        {
+            if (!insertImpl(0, pt, payload, m_boundary, 0))
+                return false;
+            ++m_count;
+            return true;
         }
 
         /**
-         * @brief Supprime un point du QuadTree (si présent).
+         * @brief Supprime un point du QuadTree (si présent), quel que soit son payload.
          * @param pt Le point à supprimer.
          * @return true si le point a été trouvé et supprimé, false sinon.
          */
         bool remove(const vec2<T>& pt)
         {
-            return removeImpl(m_root, pt, m_boundary);
+            return removeEntry(pt, [](uint32_t) { return true; }, nullptr);
         }
 
         /**
-         * @brief Déplace un point existant vers une nouvelle position.
+         * @brief Supprime le point pt portant le payload donné (si présent).
+         * @return true si le point a été trouvé et supprimé, false sinon.
+         */
+        template <typename P = TPayload>
+        typename std::enable_if<!std::is_void<P>::value, bool>::type remove(const vec2<T>& pt, const P& payload)
+        {
+            return removeEntry(pt, [this, &payload](uint32_t vIdx) { return m_payloads.get(vIdx) == payload; }, nullptr);
+        }
+
+        /**
+         * @brief Déplace un point existant vers une nouvelle position, en gardant son payload.
          *        Cette fonction layerue une remove + insert si le point existe.
          * @param oldPt Ancienne position du point.
          * @param newPt Nouvelle position du point.
@@ -107,15 +303,28 @@ namespace ez
          */
         bool move(const vec2<T>& oldPt, const vec2<T>& newPt)
         {
-            if (!remove(oldPt))
+            PayloadType payload = PayloadType();
+            if (!removeEntry(oldPt, [](uint32_t) { return true; }, &payload))
+                return false;
+            return insert(newPt, payload);
+        }
+
+        /**
+         * @brief Déplace le point oldPt portant le payload donné vers newPt.
+         */
+        template <typename P = TPayload>
+        typename std::enable_if<!std::is_void<P>::value, bool>::type move(const vec2<T>& oldPt, const P& payload, const vec2<T>& newPt)
+        {
+            if (!remove(oldPt, payload))
                 return false;
-            return insert(newPt);
+            return insert(newPt, payload);
         }
 
         /**
          * @brief Récupère les vMaxNeighbors points les plus proches de pt.
-         *        Approche simple: on parcourt l'arbre et on stocke les distances au fur et à mesure.
-         *        Une approche plus élaborée pourrait faire un rayon d'exploration croissant, etc.
+         *        Recherche "best-first" : les noeuds sont visités par distance croissante de leur boundary,
+         *        et un noeud plus loin que le pire des vMaxNeighbors candidats courants est élagué avec tout son sous-arbre.
+         *        Les candidats sont gardés dans un tas max borné à vMaxNeighbors.
          *
          * @param pt Point de référence.
          * @param vMaxNeighbors Nombre maximal de voisins à récupérer.
@@ -123,28 +332,79 @@ namespace ez
          */
         std::vector<vec2<T>> getNNeighboors(const vec2<T>& pt, std::size_t vMaxNeighbors) const
         {
-            // On pourrait optimiser la recherche par région,
-            // mais voici une version simple qui parcourt l'ensemble des points.
-            std::vector<vec2<T>> allPoints;
-            collectAllPoints(m_root, allPoints);
+            std::vector<vec2<T>> res;
+            findNNeighboors(pt, vMaxNeighbors, [&res](const vec2<T>& vPoint, uint32_t) { res.push_back(vPoint); });
+            return res;
+        }
 
-            // On trie par distance
-            auto distanceSq = [&](const vec2<T>& p1, const vec2<T>& p2)
-            {
-                T dx = p1.x - p2.x;
-                T dy = p1.y - p2.y;
-                return dx * dx + dy * dy;
-            };
+        /**
+         * @brief Comme getNNeighboors, mais appelle vCallback(point[, payload]) pour chaque voisin,
+         *        par distance croissante.
+         */
+        template <typename TCallback>
+        void forEachNNeighboor(const vec2<T>& pt, std::size_t vMaxNeighbors, TCallback&& vCallback) const
+        {
+            findNNeighboors(pt, vMaxNeighbors, [this, &vCallback](const vec2<T>& vPoint, uint32_t vIdx) { m_payloads.call(vCallback, vPoint, vIdx); });
+        }
 
-            std::sort(allPoints.begin(), allPoints.end(), [&](const vec2<T>& a, const vec2<T>& b)
+        /**
+         * @brief Récupère les points à une distance inférieure ou égale à vRadius de pt.
+         *        Les noeuds dont la boundary est hors du rayon sont élagués avec tout leur sous-arbre.
+         *
+         * @param pt Point de référence.
+         * @param vRadius Rayon de recherche.
+         * @return Un vecteur des points trouvés, triés par distance croissante.
+         */
+        std::vector<vec2<T>> getPointsInRadius(const vec2<T>& pt, T vRadius) const
+        {
+            std::vector<Candidate> found;
+            if (vRadius >= static_cast<T>(0))
             {
-                return distanceSq(a, pt) < distanceSq(b, pt);
-            });
+                collectInRadius(0, m_boundary, pt, vRadius * vRadius, [this, &found, &pt](uint32_t vIdx) {
+                    found.push_back(Candidate{distanceSq(m_points[vIdx], pt), vIdx});
+                });
+            }
+
+            std::sort(found.begin(), found.end());
+
+            std::vector<vec2<T>> res;
+            res.reserve(found.size());
+            for (const auto& c : found)
+                res.push_back(m_points[c.index]);
+            return res;
+        }
+
+        /**
+         * @brief Appelle vCallback(point[, payload]) pour chaque point à une distance inférieure ou égale à vRadius de pt.
+         *        Sans tri ni allocation.
+         */
+        template <typename TCallback>
+        void forEachInRadius(const vec2<T>& pt, T vRadius, TCallback&& vCallback) const
+        {
+            if (vRadius < static_cast<T>(0))
+                return;
+            collectInRadius(0, m_boundary, pt, vRadius * vRadius, [this, &vCallback](uint32_t vIdx) { m_payloads.call(vCallback, m_points[vIdx], vIdx); });
+        }
 
-            if (allPoints.size() > vMaxNeighbors)
-                allPoints.resize(vMaxNeighbors);
+        /**
+         * @brief Appelle vCallback(point[, payload]) pour chaque point contenu dans vRect (bords inclus).
+         *        Les noeuds hors de vRect sont élagués, ceux entièrement dedans sont rendus sans test par point.
+         *        Sans allocation, pour le culling d'un viewport par ex.
+         */
+        template <typename TCallback>
+        void forEachInRect(const AABB<T>& vRect, TCallback&& vCallback) const
+        {
+            collectInRect(0, m_boundary, Boundary::fromAABB(vRect), [this, &vCallback](uint32_t vIdx) { m_payloads.call(vCallback, m_points[vIdx], vIdx); });
+        }
 
-            return allPoints;
+        /**
+         * @brief Récupère les points contenus dans vRect (bords inclus).
+         */
+        std::vector<vec2<T>> getPointsInRect(const AABB<T>& vRect) const
+        {
+            std::vector<vec2<T>> res;
+            collectInRect(0, m_boundary, Boundary::fromAABB(vRect), [this, &res](uint32_t vIdx) { res.push_back(m_points[vIdx]); });
+            return res;
         }
 
     private:
@@ -161,64 +421,261 @@ namespace ez
                 return (p.x >= xMin && p.x <= xMax &&
                         p.y >= yMin && p.y <= yMax);
             }
+
+            bool contains(const Boundary& b) const
+            {
+                return (b.xMin >= xMin && b.xMax <= xMax &&
+                        b.yMin >= yMin && b.yMax <= yMax);
+            }
+
+            bool intersects(const Boundary& b) const
+            {
+                return (b.xMin <= xMax && b.xMax >= xMin &&
+                        b.yMin <= yMax && b.yMax >= yMin);
+            }
+
+            static Boundary fromAABB(const AABB<T>& aabb)
+            {
+                Boundary b;
+                b.xMin = aabb.lowerBound.x;
+                b.xMax = aabb.upperBound.x;
+                b.yMin = aabb.lowerBound.y;
+                b.yMax = aabb.upperBound.y;
+                return b;
+            }
+
+            /**
+             * @brief Distance au carré entre p et le point le plus proche de la zone (0 si p est dedans).
+             */
+            T distanceSq(const vec2<T>& p) const
+            {
+                const T zero = static_cast<T>(0);
+                const T dx = (p.x < xMin) ? (xMin - p.x) : ((p.x > xMax) ? (p.x - xMax) : zero);
+                const T dy = (p.y < yMin) ? (yMin - p.y) : ((p.y > yMax) ? (p.y - yMax) : zero);
+                return dx * dx + dy * dy;
+            }
         };
 
         /**
          * @brief Structure interne représentant un noeud du QuadTree.
+         *        Une feuille référence la plage [pointsBegin, pointsBegin + pointsCount) de m_points,
+         *        de capacité pointsCapacity. Un noeud subdivisé n'a pas de points.
          */
         struct Node
         {
-            // Points stockés dans ce noeud (si pas subdivisé ou si capacité non dépassée).
-            std::vector<vec2<T>> points;
+            // Index du premier des 4 fils (consécutifs) dans m_nodes, -1 pour une feuille.
+            int32_t firstChild = -1;
+            uint32_t pointsBegin = 0;
+            uint32_t pointsCount = 0;
+            uint32_t pointsCapacity = 0;
+
+            bool isLeaf() const { return firstChild < 0; }
+        };
 
-            // Fils du noeud (quad subdivision). S'ils sont non-nuls, on est subdivisé.
-            Node* children[4] = {nullptr, nullptr, nullptr, nullptr};
+        /**
+         * @brief Point candidat d'une recherche (index dans m_points), ordonné par distance.
+         */
+        struct Candidate
+        {
+            T distSq;
+            uint32_t index;
+
+            bool operator<(const Candidate& other) const { return distSq < other.distSq; }
+        };
+
+        /**
+         * @brief Noeud en attente de visite dans la recherche des plus proches voisins.
+         */
+        struct NodeToVisit
+        {
+            T distSq;
+            uint32_t node;
+            Boundary boundary;
+
+            bool operator>(const NodeToVisit& other) const { return distSq > other.distSq; }
+        };
+
+        // Profondeur au-delà de laquelle une feuille pleine grandit au lieu de se subdiviser (points confondus).
+        static const uint32_t sMaxDepth = 24;
+
+    private:
+        /**
+         * @brief Construit l'arbre avec tous les points déjà rangés dans m_points (et m_payloads).
+         */
+        std::size_t buildFromPoints()
+        {
+            m_count = m_points.size();
+            m_nodes.reserve(1 + 2 * (m_count / m_capacity + 1));
+            buildImpl(0, m_boundary, 0, static_cast<uint32_t>(m_points.size()), 0);
+            return m_count;
+        }
 
-            ~Node()
+        /**
+         * @brief Range au début de [begin, end) les points vérifiant vPred, en déplaçant leurs payloads avec eux.
+         * @return L'index du premier point ne vérifiant pas vPred.
+         */
+        template <typename TPred>
+        uint32_t partition(uint32_t begin, uint32_t end, TPred vPred)
+        {
+            uint32_t first = begin;
+            for (uint32_t i = begin; i < end; ++i)
             {
-                // Nettoyage récursif
-                for (int i = 0; i < 4; ++i)
+                if (vPred(m_points[i]))
                 {
-                    delete children[i];
-                    children[i] = nullptr;
+                    if (i != first)
+                    {
+                        std::swap(m_points[i], m_points[first]);
+                        m_payloads.swap(i, first);
+                    }
+                    ++first;
                 }
             }
-        };
+            return first;
+        }
 
-    private:
         /**
-         * @brief Insère un point dans l'arbre à partir d'un noeud donné et d'une boundary connue.
+         * @brief Construit récursivement le sous-arbre du noeud nodeIdx avec les points [begin, end) de m_points.
          */
-        bool insertImpl(Node*& node, const vec2<T>& pt, const Boundary& boundary)
+        void buildImpl(uint32_t nodeIdx, const Boundary& boundary, uint32_t begin, uint32_t end, uint32_t depth)
         {
-            // Si le point n'est pas dans la boundary, on ne l'insère pas
-            if (!boundary.contains(pt))
-                return false;
+            const uint32_t count = end - begin;
+            if (count <= m_capacity || depth >= sMaxDepth)
+            {
+                Node& node = m_nodes[nodeIdx];
+                node.pointsBegin = begin;
+                node.pointsCount = count;
+                node.pointsCapacity = count;
+                return;
+            }
+
+            // partition sur place en 4 quadrants, avec la même règle que insert (premier fils contenant le point)
+            const T midX = (boundary.xMin + boundary.xMax) / 2;
+            const T midY = (boundary.yMin + boundary.yMax) / 2;
+            const uint32_t bottomEnd = partition(begin, end, [midY](const vec2<T>& p) { return p.y <= midY; });
+            const uint32_t bounds[5] = {
+                begin,
+                partition(begin, bottomEnd, [midX](const vec2<T>& p) { return p.x <= midX; }),
+                bottomEnd,
+                partition(bottomEnd, end, [midX](const vec2<T>& p) { return p.x <= midX; }),
+                end};
+
+            // 0 : bas-gauche, 1 : bas-droit, 2 : haut-gauche, 3 : haut-droit
+            const uint32_t firstChild = allocChildren();
+            m_nodes[nodeIdx].firstChild = static_cast<int32_t>(firstChild);
+            for (int i = 0; i < 4; ++i)
+            {
+                buildImpl(firstChild + static_cast<uint32_t>(i), computeChildBoundary(boundary, i), bounds[i], bounds[i + 1], depth + 1);
+            }
+        }
 
-            // Si le noeud n'existe pas encore, on le crée.
-            if (!node)
+        /**
+         * @brief Alloue 4 noeuds fils consécutifs (feuilles vides), en réutilisant un bloc libéré si possible.
+         */
+        uint32_t allocChildren()
+        {
+            uint32_t idx = 0;
+            if (!m_freeNodes.empty())
+            {
+                idx = m_freeNodes.back();
+                m_freeNodes.pop_back();
+                for (uint32_t i = 0; i < 4; ++i)
+                    m_nodes[idx + i] = Node();
+            }
+            else
             {
-                node = new Node();
+                idx = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.resize(m_nodes.size() + 4);
             }
+            return idx;
+        }
 
-            // Si on n'est pas subdivisé et qu'on peut stocker directement le point.
-            if (node->children[0] == nullptr && node->points.size() < m_capacity)
+        /**
+         * @brief Rend la plage d'une feuille à m_freeRanges, la feuille n'a plus de points.
+         */
+        void freeLeafRange(Node& node)
+        {
+            if (node.pointsCapacity > 0)
+                m_freeRanges.insert(std::make_pair(node.pointsCapacity, node.pointsBegin));
+            node.pointsBegin = 0;
+            node.pointsCount = 0;
+            node.pointsCapacity = 0;
+        }
+
+        /**
+         * @brief Donne à une feuille une nouvelle plage d'au moins newCapacity points,
+         *        la plus petite plage libérée qui convient, sinon une plage en fin de m_points.
+         *        L'ancienne plage est libérée.
+         */
+        void growLeaf(uint32_t nodeIdx, uint32_t newCapacity)
+        {
+            uint32_t newBegin = 0;
+            auto it = m_freeRanges.lower_bound(newCapacity);
+            if (it != m_freeRanges.end())
+            {
+                newCapacity = it->first;
+                newBegin = it->second;
+                m_freeRanges.erase(it);
+            }
+            else
+            {
+                newBegin = static_cast<uint32_t>(m_points.size());
+                m_points.resize(m_points.size() + newCapacity);
+                m_payloads.resize(m_points.size());
+            }
+            Node& node = m_nodes[nodeIdx];
+            const uint32_t count = node.pointsCount;
+            for (uint32_t i = 0; i < count; ++i)
             {
-                node->points.push_back(pt);
-                return true;
+                m_points[newBegin + i] = m_points[node.pointsBegin + i];
+                m_payloads.set(newBegin + i, m_payloads.get(node.pointsBegin + i));
             }
+            freeLeafRange(node);
+            node.pointsBegin = newBegin;
+            node.pointsCount = count;
+            node.pointsCapacity = newCapacity;
+        }
+
+        /**
+         * @brief Ajoute un point à une feuille, en agrandissant sa plage si besoin.
+         */
+        void pushToLeaf(uint32_t nodeIdx, const vec2<T>& pt, const PayloadType& payload, uint32_t minCapacity)
+        {
+            if (m_nodes[nodeIdx].pointsCount == m_nodes[nodeIdx].pointsCapacity)
+                growLeaf(nodeIdx, (std::max)(minCapacity, m_nodes[nodeIdx].pointsCapacity * 2));
+            Node& leaf = m_nodes[nodeIdx];
+            m_points[leaf.pointsBegin + leaf.pointsCount] = pt;
+            m_payloads.set(leaf.pointsBegin + leaf.pointsCount, payload);
+            ++leaf.pointsCount;
+        }
 
-            // Sinon, si on n'a pas encore subdivisé, on subdivise.
-            if (node->children[0] == nullptr)
+        /**
+         * @brief Insère un point dans l'arbre à partir d'un noeud donné et d'une boundary connue.
+         */
+        bool insertImpl(uint32_t nodeIdx, const vec2<T>& pt, const PayloadType& payload, const Boundary& boundary, uint32_t depth)
+        {
+            // Si le point n'est pas dans la boundary, on ne l'insère pas
+            if (!boundary.contains(pt))
+                return false;
+
+            if (m_nodes[nodeIdx].isLeaf())
             {
-                subdivide(node, boundary);
+                // On peut stocker directement le point.
+                if (m_nodes[nodeIdx].pointsCount < m_capacity || depth >= sMaxDepth)
+                {
+                    pushToLeaf(nodeIdx, pt, payload, static_cast<uint32_t>(m_capacity));
+                    return true;
+                }
+
+                // Sinon on subdivise.
+                subdivide(nodeIdx, boundary);
             }
 
             // Tente d'insérer dans l'un des 4 sous-noeuds.
+            const uint32_t firstChild = static_cast<uint32_t>(m_nodes[nodeIdx].firstChild);
             for (int i = 0; i < 4; ++i)
             {
                 Boundary childBoundary = computeChildBoundary(boundary, i);
-                if (insertImpl(node->children[i], pt, childBoundary))
+                if (insertImpl(firstChild + static_cast<uint32_t>(i), pt, payload, childBoundary, depth + 1))
                 {
                     return true;
                 }
@@ -229,75 +686,95 @@ namespace ez
         }
 
         /**
-         * @brief Supprime un point à partir d'un noeud donné si présent.
+         * @brief Supprime le premier point pt dont l'index vérifie vMatch, et copie son payload dans vOutPayload (si non nul).
          */
-        bool removeImpl(Node*& node, const vec2<T>& pt, const Boundary& boundary)
+        template <typename TMatch>
+        bool removeEntry(const vec2<T>& pt, const TMatch& vMatch, PayloadType* vOutPayload)
         {
-            if (!node)
+            if (!removeImpl(0, pt, m_boundary, vMatch, vOutPayload))
                 return false;
+            --m_count;
+            return true;
+        }
+
+        /**
+         * @brief Supprime un point à partir d'un noeud donné si présent.
+         */
+        template <typename TMatch>
+        bool removeImpl(uint32_t nodeIdx, const vec2<T>& pt, const Boundary& boundary, const TMatch& vMatch, PayloadType* vOutPayload)
+        {
             if (!boundary.contains(pt))
                 return false;
 
-            // Vérifie si le point est stocké dans ce noeud directement
-            auto& pts = node->points;
-            auto it = std::find(pts.begin(), pts.end(), pt);
-            if (it != pts.end())
+            Node& node = m_nodes[nodeIdx];
+            if (node.isLeaf())
             {
-                pts.erase(it);
-                // Optionnel: si plus de points et pas de subdivision, on peut cleaner le node.
-                cleanIfEmpty(node);
-                return true;
+                // Vérifie si le point est stocké dans cette feuille, le dernier point prend sa place
+                const uint32_t last = node.pointsBegin + node.pointsCount;
+                for (uint32_t i = node.pointsBegin; i < last; ++i)
+                {
+                    if (m_points[i] == pt && vMatch(i))
+                    {
+                        if (vOutPayload != nullptr)
+                            *vOutPayload = m_payloads.get(i);
+                        m_points[i] = m_points[last - 1];
+                        m_payloads.set(i, m_payloads.get(last - 1));
+                        --node.pointsCount;
+                        return true;
+                    }
+                }
+                return false;
             }
 
             // Sinon on va plus loin dans les enfants
-            bool removed = false;
+            const uint32_t firstChild = static_cast<uint32_t>(node.firstChild);
             for (int i = 0; i < 4; ++i)
             {
-                if (node->children[i])
+                Boundary childBoundary = computeChildBoundary(boundary, i);
+                if (removeImpl(firstChild + static_cast<uint32_t>(i), pt, childBoundary, vMatch, vOutPayload))
                 {
-                    Boundary childBoundary = computeChildBoundary(boundary, i);
-                    if (removeImpl(node->children[i], pt, childBoundary))
-                    {
-                        removed = true;
-                        break;
-                    }
+                    // On nettoie si besoin
+                    cleanIfEmpty(nodeIdx);
+                    return true;
                 }
             }
-
-            // On nettoie si besoin
-            if (removed)
-                cleanIfEmpty(node);
-
-            return removed;
+            return false;
         }
 
         /**
-         * @brief Subdivise un noeud en créant 4 sous-noeuds et en redistribuant les points.
+         * @brief Subdivise une feuille en créant 4 sous-noeuds et en redistribuant les points.
          */
-        void subdivide(Node* node, const Boundary& boundary)
+        void subdivide(uint32_t nodeIdx, const Boundary& boundary)
         {
-            // Crée les 4 children
-            for (int i = 0; i < 4; ++i)
-            {
-                node->children[i] = new Node();
-            }
+            const uint32_t firstChild = allocChildren();
+            Node& node = m_nodes[nodeIdx];
+            const uint32_t begin = node.pointsBegin;
+            const uint32_t count = node.pointsCount;
+            const uint32_t capacity = node.pointsCapacity;
+            node.firstChild = static_cast<int32_t>(firstChild);
+            node.pointsBegin = 0;
+            node.pointsCount = 0;
+            node.pointsCapacity = 0;
 
             // Redistribue les points existants dans le noeud vers ses enfants
-            std::vector<vec2<T>> oldPoints = node->points;
-            node->points.clear();
-
-            for (auto& pt : oldPoints)
+            for (uint32_t p = 0; p < count; ++p)
             {
+                const vec2<T> pt = m_points[begin + p];
+                const PayloadType payload = m_payloads.get(begin + p);
                 for (int i = 0; i < 4; ++i)
                 {
                     Boundary childB = computeChildBoundary(boundary, i);
                     if (childB.contains(pt))
                     {
-                        node->children[i]->points.push_back(pt);
+                        pushToLeaf(firstChild + static_cast<uint32_t>(i), pt, payload, static_cast<uint32_t>(m_capacity));
                         break;
                     }
                 }
             }
+
+            // L'ancienne plage n'est libérée qu'une fois ses points redistribués
+            if (capacity > 0)
+                m_freeRanges.insert(std::make_pair(capacity, begin));
         }
 
         /**
@@ -339,70 +816,203 @@ namespace ez
         }
 
         /**
-         * @brief Nettoie un noeud si celui-ci ne contient plus de points et que tous ses enfants sont vides.
-         *        Dans ce cas, on le supprime entièrement (pour limiter l'usage mémoire).
+         * @brief Vrai si le noeud est une feuille sans point.
          */
-        void cleanIfEmpty(Node*& node)
+        bool isEmpty(uint32_t nodeIdx) const
         {
-            if (!node)
+            const Node& node = m_nodes[nodeIdx];
+            return node.isLeaf() && node.pointsCount == 0;
+        }
+
+        /**
+         * @brief Si les 4 enfants d'un noeud sont des feuilles vides, le noeud redevient une feuille
+         *        et le bloc des enfants est recyclé (pour limiter l'usage mémoire).
+         */
+        void cleanIfEmpty(uint32_t nodeIdx)
+        {
+            Node& node = m_nodes[nodeIdx];
+            if (node.isLeaf())
                 return;
 
-            if (!node->points.empty())
+            const uint32_t firstChild = static_cast<uint32_t>(node.firstChild);
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                if (!isEmpty(firstChild + i))
+                    return;
+            }
+
+            // A ce stade, tous les enfants sont vides.
+            for (uint32_t i = 0; i < 4; ++i)
+                freeLeafRange(m_nodes[firstChild + i]);
+            m_freeNodes.push_back(firstChild);
+            m_nodes[nodeIdx].firstChild = -1;
+        }
+
+        static T distanceSq(const vec2<T>& p1, const vec2<T>& p2)
+        {
+            const T dx = p1.x - p2.x;
+            const T dy = p1.y - p2.y;
+            return dx * dx + dy * dy;
+        }
+
+        /**
+         * @brief Recherche "best-first" des vMaxNeighbors plus proches voisins (voir getNNeighboors),
+         *        vOutput(point, index) est appelé pour chacun par distance croissante.
+         */
+        template <typename TOutput>
+        void findNNeighboors(const vec2<T>& pt, std::size_t vMaxNeighbors, TOutput&& vOutput) const
+        {
+            if (m_count == 0 || vMaxNeighbors == 0)
                 return;
 
-            // Vérifie si tous les sous-arbres sont vides
-            for (int i = 0; i < 4; ++i)
+            // tas max des candidats : le pire candidat est en tête
+            std::priority_queue<Candidate> candidates;
+
+            // tas min des noeuds à visiter, par distance de leur boundary au point
+            std::priority_queue<NodeToVisit, std::vector<NodeToVisit>, std::greater<NodeToVisit>> nodes;
+            nodes.push(NodeToVisit{m_boundary.distanceSq(pt), 0, m_boundary});
+
+            while (!nodes.empty())
             {
-                if (node->children[i])
+                const NodeToVisit current = nodes.top();
+                nodes.pop();
+
+                // tous les noeuds restants sont plus loin que le pire candidat
+                if (candidates.size() == vMaxNeighbors && current.distSq > candidates.top().distSq)
+                    break;
+
+                const Node& node = m_nodes[current.node];
+                if (node.isLeaf())
                 {
-                    // Si un enfant existe et n'est pas vide, on ne clean pas
-                    if (!node->children[i]->points.empty())
-                        return;
-                    // On vérifie aussi récursivement
-                    bool childHasChildren = false;
-                    for (int j = 0; j < 4; ++j)
+                    const uint32_t last = node.pointsBegin + node.pointsCount;
+                    for (uint32_t i = node.pointsBegin; i < last; ++i)
                     {
-                        if (node->children[i]->children[j] != nullptr)
+                        const T d = distanceSq(m_points[i], pt);
+                        if (candidates.size() < vMaxNeighbors)
                         {
-                            childHasChildren = true;
-                            break;
+                            candidates.push(Candidate{d, i});
+                        }
+                        else if (d < candidates.top().distSq)
+                        {
+                            candidates.pop();
+                            candidates.push(Candidate{d, i});
                         }
                     }
-                    if (childHasChildren)
-                        return;
+                    continue;
+                }
+
+                for (int i = 0; i < 4; ++i)
+                {
+                    const uint32_t child = static_cast<uint32_t>(node.firstChild) + static_cast<uint32_t>(i);
+                    if (isEmpty(child))
+                        continue;
+                    const Boundary childBoundary = computeChildBoundary(current.boundary, i);
+                    const T d = childBoundary.distanceSq(pt);
+                    if (candidates.size() < vMaxNeighbors || d <= candidates.top().distSq)
+                        nodes.push(NodeToVisit{d, child, childBoundary});
+                }
+            }
+
+            // le tas donne les candidats du plus loin au plus proche
+            std::vector<uint32_t> sorted(candidates.size());
+            for (std::size_t i = sorted.size(); i > 0; --i)
+            {
+                sorted[i - 1] = candidates.top().index;
+                candidates.pop();
+            }
+            for (const auto idx : sorted)
+                vOutput(m_points[idx], idx);
+        }
+
+        /**
+         * @brief Appelle (récursivement) vOutput(index) pour les points d'un sous-arbre à une distance au carré inférieure ou égale à radiusSq.
+         */
+        template <typename TOutput>
+        void collectInRadius(uint32_t nodeIdx, const Boundary& boundary, const vec2<T>& pt, T radiusSq, TOutput&& vOutput) const
+        {
+            if (isEmpty(nodeIdx) || boundary.distanceSq(pt) > radiusSq)
+                return;
+            const Node& node = m_nodes[nodeIdx];
+            if (node.isLeaf())
+            {
+                const uint32_t last = node.pointsBegin + node.pointsCount;
+                for (uint32_t i = node.pointsBegin; i < last; ++i)
+                {
+                    if (distanceSq(m_points[i], pt) <= radiusSq)
+                        vOutput(i);
                 }
+                return;
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                collectInRadius(static_cast<uint32_t>(node.firstChild) + static_cast<uint32_t>(i), computeChildBoundary(boundary, i), pt, radiusSq, vOutput);
             }
+        }
 
-            // A ce stade, le noeud n'a plus de points et tous les enfants sont vides.
-            // On peut détruire ce noeud pour libérer la mémoire
-            delete node;
-            node = nullptr;
+        /**
+         * @brief Appelle (récursivement) vOutput(index) pour les points d'un sous-arbre contenus dans rect.
+         */
+        template <typename TOutput>
+        void collectInRect(uint32_t nodeIdx, const Boundary& boundary, const Boundary& rect, TOutput&& vOutput) const
+        {
+            if (isEmpty(nodeIdx) || !rect.intersects(boundary))
+                return;
+            const Node& node = m_nodes[nodeIdx];
+            if (node.isLeaf())
+            {
+                // noeud entièrement dans rect : pas de test par point
+                const bool inside = rect.contains(boundary);
+                const uint32_t last = node.pointsBegin + node.pointsCount;
+                for (uint32_t i = node.pointsBegin; i < last; ++i)
+                {
+                    if (inside || rect.contains(m_points[i]))
+                        vOutput(i);
+                }
+                return;
+            }
+            for (int i = 0; i < 4; ++i)
+            {
+                collectInRect(static_cast<uint32_t>(node.firstChild) + static_cast<uint32_t>(i), computeChildBoundary(boundary, i), rect, vOutput);
+            }
         }
 
         /**
-         * @brief Récupère tous les points (récursivement) d'un sous-arbre.
+         * @brief Récupère tous les points (récursivement) d'un sous-arbre, avec leurs payloads.
          */
-        void collectAllPoints(const Node* node, std::vector<vec2<T>>& outPoints) const
+        void collectAllPoints(uint32_t nodeIdx, std::vector<vec2<T>>& outPoints, detail::QuadTreePayloads<PayloadType>& outPayloads) const
         {
-            if (!node)
+            const Node& node = m_nodes[nodeIdx];
+            if (node.isLeaf())
+            {
+                // Ajout des points de la feuille
+                const uint32_t last = node.pointsBegin + node.pointsCount;
+                for (uint32_t i = node.pointsBegin; i < last; ++i)
+                {
+                    outPoints.push_back(m_points[i]);
+                    outPayloads.push_back(m_payloads.get(i));
+                }
                 return;
-            // Ajout des points du noeud
-            outPoints.insert(outPoints.end(), node->points.begin(), node->points.end());
+            }
             // Récursivement, va chercher dans les enfants
             for (int i = 0; i < 4; ++i)
             {
-                collectAllPoints(node->children[i], outPoints);
+                collectAllPoints(static_cast<uint32_t>(node.firstChild) + static_cast<uint32_t>(i), outPoints, outPayloads);
             }
         }
 
     private:
-        Node* m_root = nullptr;        ///< Racine du QuadTree
-        Boundary m_boundary;           ///< Zone englobante de la racine
-        std::size_t m_capacity = 4;    ///< Capacité de chaque noeud avant subdivision
+        std::vector<Node> m_nodes;                        ///< Noeuds, la racine est m_nodes[0]
+        std::vector<uint32_t> m_freeNodes;                ///< Blocs de 4 noeuds libérés, réutilisables
+        std::multimap<uint32_t, uint32_t> m_freeRanges;   ///< Plages de m_points libérées (capacité => début), réutilisables
+        std::vector<vec2<T>> m_points;                    ///< Plages de points des feuilles
+        detail::QuadTreePayloads<PayloadType> m_payloads; ///< Payloads des points (même index que m_points)
+        Boundary m_boundary;                              ///< Zone englobante de la racine
+        std::size_t m_capacity = 4;                       ///< Capacité de chaque noeud avant subdivision
+        std::size_t m_count = 0;                          ///< Nombre de points
     };
 
 } // namespace ez
 
 /*
 
-*/
\ No newline at end of file
+*/
@@ -26,238 +26,381 @@ SOFTWARE.
 
 // ezSha is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
 // and base on https://github.com/983/SHA1.git - Unlicense
+// the SHA-NI kernels follow the Intel reference code (public domain)
 
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
 #include <cstdint>
 #include <cstring>
 #include <sstream>
-#include <string>
-#include <array>
+#include <type_traits>
+
+// the SHA-NI kernels are selected at runtime when the cpu have them, EZ_SHA_NO_HARDWARE disable them
+#if !defined(EZ_SHA_NO_HARDWARE) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define EZ_SHA_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define EZ_SHA_NI_TARGET
+#else
+#include <cpuid.h>
+#define EZ_SHA_NI_TARGET __attribute__((target("sha,sse4.1")))
+#endif
+#endif
 
 namespace ez {
 
-class sha1 {
+namespace detail {
+
+// the cpu have the SHA extensions (and SSE4.1 used by the kernels)
+inline bool shaCpuHaveShaNi() {
+#ifdef EZ_SHA_X86
+    static const bool haveShaNi = []() {
+        uint32_t regs1[4] = {};
+        uint32_t regs7[4] = {};
+#ifdef _MSC_VER
+        int r[4];
+        __cpuid(r, 0);
+        if (r[0] < 7) {
+            return false;
+        }
+        __cpuid(r, 1);
+        regs1[2] = static_cast<uint32_t>(r[2]);
+        __cpuidex(r, 7, 0);
+        regs7[1] = static_cast<uint32_t>(r[1]);
+#else
+        if (__get_cpuid_max(0, nullptr) < 7) {
+            return false;
+        }
+        __get_cpuid(1, &regs1[0], &regs1[1], &regs1[2], &regs1[3]);
+        __get_cpuid_count(7, 0, &regs7[0], &regs7[1], &regs7[2], &regs7[3]);
+#endif
+        const bool ssse3 = (regs1[2] & (1U << 9)) != 0;
+        const bool sse41 = (regs1[2] & (1U << 19)) != 0;
+        const bool sha = (regs7[1] & (1U << 29)) != 0;
+        return ssse3 && sse41 && sha;
+    }();
+    return haveShaNi;
+#else
+    return false;
+#endif
+}
+
+// buffering, padding and api shared by sha1 and sha256.
+// TDerived give the block functions : m_processBlocksPortable and m_getHardwareProcessBlocks
+template <typename TDerived, size_t TStateWords>
+class shaHasher {
 public:
-    static size_t constexpr SHA1_HEX_SIZE{40};
+    typedef void (*ProcessBlocksFunc)(uint32_t *vState, const uint8_t *vBlocks, size_t vCount);
+    static size_t constexpr HEX_SIZE{TStateWords * 8U};
 
 private:
-    std::array<uint32_t, 5> m_state{};
+    // integers, but not the chars written as chars by a stream
+    template <typename T>
+    struct isHashedAsNumber {
+        static bool constexpr value = std::is_integral<T>::value && !std::is_same<T, bool>::value &&  //
+            !std::is_same<T, char>::value && !std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value;
+    };
+
+protected:
+    std::array<uint32_t, TStateWords> m_state{};
     std::array<uint8_t, 64> m_buf{};
     uint32_t m_index{};
     uint64_t m_countBits{};
 
 public:
-    sha1() : m_index(0), m_countBits(0) {
-        m_state[0] = 0x67452301;
-        m_state[1] = 0xEFCDAB89;
-        m_state[2] = 0x98BADCFE;
-        m_state[3] = 0x10325476;
-        m_state[4] = 0xC3D2E1F0;
-    }
-    explicit sha1(const std::string &vText) : sha1() { add(vText); }
-    explicit sha1(const char *vText) : sha1() { add(vText); }
-
-    /*
-    sha1 &add(char c) { return add(*(uint8_t *)&c); }
-    */
-
-    sha1 &add(const void *data, uint32_t n) {
-        if (!data) {
-            return *this;
+    TDerived &add(const void *data, size_t n) {
+        if (!data || !n) {
+            return m_self();
         }
-
-        const uint8_t *ptr = (const uint8_t *)data;
+        const uint8_t *ptr = static_cast<const uint8_t *>(data);
+        const ProcessBlocksFunc processBlocks = m_getProcessBlocks();
+        m_countBits += static_cast<uint64_t>(n) * 8U;
 
         // fill up block if not full
-        for (; n && m_index % sizeof(m_buf); n--) {
-            m_add(*ptr++);
+        if (m_index != 0U) {
+            const size_t count = std::min<size_t>(n, sizeof(m_buf) - m_index);
+            std::memcpy(m_buf.data() + m_index, ptr, count);
+            m_index += static_cast<uint32_t>(count);
+            ptr += count;
+            n -= count;
+            if (m_index < sizeof(m_buf)) {
+                return m_self();
+            }
+            processBlocks(m_state.data(), m_buf.data(), 1U);
+            m_index = 0U;
         }
 
-        // process full blocks
-        for (; n >= sizeof(m_buf); n -= sizeof(m_buf)) {
-            m_processBlock(ptr);
-            ptr += sizeof(m_buf);
-            m_countBits += sizeof(m_buf) * 8;
+        // process full blocks directly from the input
+        const size_t blocksCount = n / sizeof(m_buf);
+        if (blocksCount > 0U) {
+            processBlocks(m_state.data(), ptr, blocksCount);
+            ptr += blocksCount * sizeof(m_buf);
+            n -= blocksCount * sizeof(m_buf);
         }
 
-        // process remaining part of block
-        for (; n; n--) {
-            m_add(*ptr++);
-        }
+        // keep the remaining part of block
+        std::memcpy(m_buf.data(), ptr, n);
+        m_index = static_cast<uint32_t>(n);
+        return m_self();
+    }
 
-        return *this;
+    TDerived &add(const std::string &vText) {
+        return add(vText.data(), vText.size());
     }
 
-    sha1 &add(const std::string &vText) {
-        if (vText.empty()) {
-            return *this;
-        }
-        return add(vText.data(), static_cast<uint32_t>(vText.size()));
+    // integers are written like a stream do, without the stream
+    template <typename T>
+    typename std::enable_if<isHashedAsNumber<T>::value, TDerived &>::type addValue(const T &vValue) {
+        return add(std::to_string(vValue));
     }
 
     template <typename T>
-    sha1 &addValue(const T &vValue) {
+    typename std::enable_if<!isHashedAsNumber<T>::value, TDerived &>::type addValue(const T &vValue) {
         std::stringstream ss;
         ss << vValue;
         return add(ss.str());
     }
 
-    sha1 &finalize() {
+    TDerived &finalize() {
         // hashed text ends with 0x80, some padding 0x00 and the length in bits
-        m_addByteDontCountBits(0x80);
-        while (m_index % 64 != 56) {
-            m_addByteDontCountBits(0x00);
+        const ProcessBlocksFunc processBlocks = m_getProcessBlocks();
+        m_buf[m_index++] = 0x80;
+        if (m_index > 56U) {
+            std::memset(m_buf.data() + m_index, 0, sizeof(m_buf) - m_index);
+            processBlocks(m_state.data(), m_buf.data(), 1U);
+            m_index = 0U;
         }
+        std::memset(m_buf.data() + m_index, 0, 56U - m_index);
         for (int32_t j = 7; j >= 0; j--) {
-            m_addByteDontCountBits(static_cast<uint8_t>(m_countBits >> j * 8));
+            m_buf[63U - static_cast<uint32_t>(j)] = static_cast<uint8_t>(m_countBits >> j * 8);
         }
-
-        return *this;
+        processBlocks(m_state.data(), m_buf.data(), 1U);
+        m_index = 0U;
+        return m_self();
     }
 
     const std::string getHex(const char *alphabet = "0123456789abcdef") {
-        std::string ret(SHA1_HEX_SIZE, 0);
+        std::string ret(HEX_SIZE, 0);
         int k = 0;
-        for (int m_index = 0; m_index < 5; m_index++) {
+        for (size_t i = 0; i < TStateWords; i++) {
             for (int j = 7; j >= 0; j--) {
-                ret[k++] = alphabet[(m_state[m_index] >> j * 4) & 0xf];
+                ret[k++] = alphabet[(m_state[i] >> j * 4) & 0xf];
             }
         }
         return ret;
     }
 
-private:
-    sha1 &m_add(uint8_t x) {
-        m_addByteDontCountBits(x);
-        m_countBits += 8;
-        return *this;
-    }
-    void m_addByteDontCountBits(uint8_t x) {
-        m_buf[m_index++] = x;
-        if (m_index >= sizeof(m_buf)) {
-            m_index = 0;
-            m_processBlock(m_buf.data());
+    // hex of the hash of a file read by chunks, empty if the file cant be opened
+    static std::string hashFile(const std::string &vFilePathName, size_t vChunkSize = 1024 * 1024) {
+        std::string ret;
+#ifdef _MSC_VER
+        FILE *fp = nullptr;
+        if (fopen_s(&fp, vFilePathName.c_str(), "rb") != 0) {
+            fp = nullptr;
         }
+#else
+        FILE *fp = std::fopen(vFilePathName.c_str(), "rb");
+#endif
+        if (fp != nullptr) {
+            TDerived hasher;
+            std::vector<uint8_t> chunk(vChunkSize > 0U ? vChunkSize : 1U);
+            size_t readCount = 0U;
+            while ((readCount = std::fread(chunk.data(), 1U, chunk.size(), fp)) > 0U) {
+                hasher.add(chunk.data(), readCount);
+            }
+            const bool failed = (std::ferror(fp) != 0);
+            std::fclose(fp);
+            if (!failed) {
+                ret = hasher.finalize().getHex();
+            }
+        }
+        return ret;
+    }
+
+    // the hardware kernels are used when available, can be disabled (by ex for benchmarks)
+    static bool isHardwareAccelerationAvailable() {
+        return TDerived::m_getHardwareProcessBlocks() != nullptr;
+    }
+
+    static void setHardwareAccelerationEnabled(bool vEnabled) {
+        m_hardwareEnabled().store(vEnabled);
+    }
+
+    static bool isHardwareAccelerationEnabled() {
+        return isHardwareAccelerationAvailable() && m_hardwareEnabled().load();
     }
 
+protected:
     static uint32_t m_rol32(uint32_t x, uint32_t n) { return (x << n) | (x >> (32 - n)); }
 
+    static uint32_t m_ror32(uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); }
+
     static uint32_t m_makeWord(const uint8_t *p) { return ((uint32_t)p[0] << 3 * 8) | ((uint32_t)p[1] << 2 * 8) | ((uint32_t)p[2] << 1 * 8) | ((uint32_t)p[3] << 0 * 8); }
 
-    void m_processBlock(const uint8_t *ptr) {
-        const uint32_t c0 = 0x5a827999;
-        const uint32_t c1 = 0x6ed9eba1;
-        const uint32_t c2 = 0x8f1bbcdc;
-        const uint32_t c3 = 0xca62c1d6;
+private:
+    TDerived &m_self() { return static_cast<TDerived &>(*this); }
 
-        uint32_t a = m_state[0];
-        uint32_t b = m_state[1];
-        uint32_t c = m_state[2];
-        uint32_t d = m_state[3];
-        uint32_t e = m_state[4];
+    static std::atomic<bool> &m_hardwareEnabled() {
+        static std::atomic<bool> enabled{true};
+        return enabled;
+    }
 
-        uint32_t w[16];
+    static ProcessBlocksFunc m_getProcessBlocks() {
+        static const ProcessBlocksFunc hardware = TDerived::m_getHardwareProcessBlocks();
+        return (hardware != nullptr && m_hardwareEnabled().load()) ? hardware : &TDerived::m_processBlocksPortable;
+    }
+};
+
+}  // namespace detail
 
-        for (int m_index = 0; m_index < 16; m_index++) {
-            w[m_index] = m_makeWord(ptr + m_index * 4);
+class sha1 : public detail::shaHasher<sha1, 5> {
+    friend class detail::shaHasher<sha1, 5>;
+
+public:
+    static size_t constexpr SHA1_HEX_SIZE{40};
+
+public:
+    sha1() {
+        m_state[0] = 0x67452301;
+        m_state[1] = 0xEFCDAB89;
+        m_state[2] = 0x98BADCFE;
+        m_state[3] = 0x10325476;
+        m_state[4] = 0xC3D2E1F0;
+    }
+    explicit sha1(const std::string &vText) : sha1() { add(vText); }
+    explicit sha1(const char *vText) : sha1() { add(vText, std::strlen(vText)); }
+
+private:
+    static ProcessBlocksFunc m_getHardwareProcessBlocks() {
+#ifdef EZ_SHA_X86
+        if (detail::shaCpuHaveShaNi()) {
+            return &m_processBlocksShaNi;
         }
+#endif
+        return nullptr;
+    }
+
+    static void m_processBlocksPortable(uint32_t *vState, const uint8_t *vBlocks, size_t vCount) {
+        for (; vCount > 0U; --vCount, vBlocks += 64) {
+            const uint8_t *ptr = vBlocks;
+            const uint32_t c0 = 0x5a827999;
+            const uint32_t c1 = 0x6ed9eba1;
+            const uint32_t c2 = 0x8f1bbcdc;
+            const uint32_t c3 = 0xca62c1d6;
+
+            uint32_t a = vState[0];
+            uint32_t b = vState[1];
+            uint32_t c = vState[2];
+            uint32_t d = vState[3];
+            uint32_t e = vState[4];
+
+            uint32_t w[16];
+
+            for (int m_index = 0; m_index < 16; m_index++) {
+                w[m_index] = m_makeWord(ptr + m_index * 4);
+            }
 
 #define SHA1_LOAD(m_index) w[m_index & 15] = m_rol32(w[(m_index + 13) & 15] ^ w[(m_index + 8) & 15] ^ w[(m_index + 2) & 15] ^ w[m_index & 15], 1);
 #define SHA1_ROUND_0(v, u, x, y, z, m_index)                         \
-    z += ((u & (x ^ y)) ^ y) + w[m_index & 15] + c0 + m_rol32(v, 5); \
-    u = m_rol32(u, 30);
+        z += ((u & (x ^ y)) ^ y) + w[m_index & 15] + c0 + m_rol32(v, 5); \
+        u = m_rol32(u, 30);
 #define SHA1_ROUND_1(v, u, x, y, z, m_index)                                            \
-    SHA1_LOAD(m_index) z += ((u & (x ^ y)) ^ y) + w[m_index & 15] + c0 + m_rol32(v, 5); \
-    u = m_rol32(u, 30);
+        SHA1_LOAD(m_index) z += ((u & (x ^ y)) ^ y) + w[m_index & 15] + c0 + m_rol32(v, 5); \
+        u = m_rol32(u, 30);
 #define SHA1_ROUND_2(v, u, x, y, z, m_index)                                    \
-    SHA1_LOAD(m_index) z += (u ^ x ^ y) + w[m_index & 15] + c1 + m_rol32(v, 5); \
-    u = m_rol32(u, 30);
+        SHA1_LOAD(m_index) z += (u ^ x ^ y) + w[m_index & 15] + c1 + m_rol32(v, 5); \
+        u = m_rol32(u, 30);
 #define SHA1_ROUND_3(v, u, x, y, z, m_index)                                                  \
-    SHA1_LOAD(m_index) z += (((u | x) & y) | (u & x)) + w[m_index & 15] + c2 + m_rol32(v, 5); \
-    u = m_rol32(u, 30);
+        SHA1_LOAD(m_index) z += (((u | x) & y) | (u & x)) + w[m_index & 15] + c2 + m_rol32(v, 5); \
+        u = m_rol32(u, 30);
 #define SHA1_ROUND_4(v, u, x, y, z, m_index)                                    \
-    SHA1_LOAD(m_index) z += (u ^ x ^ y) + w[m_index & 15] + c3 + m_rol32(v, 5); \
-    u = m_rol32(u, 30);
-
-        SHA1_ROUND_0(a, b, c, d, e, 0);
-        SHA1_ROUND_0(e, a, b, c, d, 1);
-        SHA1_ROUND_0(d, e, a, b, c, 2);
-        SHA1_ROUND_0(c, d, e, a, b, 3);
-        SHA1_ROUND_0(b, c, d, e, a, 4);
-        SHA1_ROUND_0(a, b, c, d, e, 5);
-        SHA1_ROUND_0(e, a, b, c, d, 6);
-        SHA1_ROUND_0(d, e, a, b, c, 7);
-        SHA1_ROUND_0(c, d, e, a, b, 8);
-        SHA1_ROUND_0(b, c, d, e, a, 9);
-        SHA1_ROUND_0(a, b, c, d, e, 10);
-        SHA1_ROUND_0(e, a, b, c, d, 11);
-        SHA1_ROUND_0(d, e, a, b, c, 12);
-        SHA1_ROUND_0(c, d, e, a, b, 13);
-        SHA1_ROUND_0(b, c, d, e, a, 14);
-        SHA1_ROUND_0(a, b, c, d, e, 15);
-        SHA1_ROUND_1(e, a, b, c, d, 16);
-        SHA1_ROUND_1(d, e, a, b, c, 17);
-        SHA1_ROUND_1(c, d, e, a, b, 18);
-        SHA1_ROUND_1(b, c, d, e, a, 19);
-        SHA1_ROUND_2(a, b, c, d, e, 20);
-        SHA1_ROUND_2(e, a, b, c, d, 21);
-        SHA1_ROUND_2(d, e, a, b, c, 22);
-        SHA1_ROUND_2(c, d, e, a, b, 23);
-        SHA1_ROUND_2(b, c, d, e, a, 24);
-        SHA1_ROUND_2(a, b, c, d, e, 25);
-        SHA1_ROUND_2(e, a, b, c, d, 26);
-        SHA1_ROUND_2(d, e, a, b, c, 27);
-        SHA1_ROUND_2(c, d, e, a, b, 28);
-        SHA1_ROUND_2(b, c, d, e, a, 29);
-        SHA1_ROUND_2(a, b, c, d, e, 30);
-        SHA1_ROUND_2(e, a, b, c, d, 31);
-        SHA1_ROUND_2(d, e, a, b, c, 32);
-        SHA1_ROUND_2(c, d, e, a, b, 33);
-        SHA1_ROUND_2(b, c, d, e, a, 34);
-        SHA1_ROUND_2(a, b, c, d, e, 35);
-        SHA1_ROUND_2(e, a, b, c, d, 36);
-        SHA1_ROUND_2(d, e, a, b, c, 37);
-        SHA1_ROUND_2(c, d, e, a, b, 38);
-        SHA1_ROUND_2(b, c, d, e, a, 39);
-        SHA1_ROUND_3(a, b, c, d, e, 40);
-        SHA1_ROUND_3(e, a, b, c, d, 41);
-        SHA1_ROUND_3(d, e, a, b, c, 42);
-        SHA1_ROUND_3(c, d, e, a, b, 43);
-        SHA1_ROUND_3(b, c, d, e, a, 44);
-        SHA1_ROUND_3(a, b, c, d, e, 45);
-        SHA1_ROUND_3(e, a, b, c, d, 46);
-        SHA1_ROUND_3(d, e, a, b, c, 47);
-        SHA1_ROUND_3(c, d, e, a, b, 48);
-        SHA1_ROUND_3(b, c, d, e, a, 49);
-        SHA1_ROUND_3(a, b, c, d, e, 50);
-        SHA1_ROUND_3(e, a, b, c, d, 51);
-        SHA1_ROUND_3(d, e, a, b, c, 52);
-        SHA1_ROUND_3(c, d, e, a, b, 53);
-        SHA1_ROUND_3(b, c, d, e, a, 54);
-        SHA1_ROUND_3(a, b, c, d, e, 55);
-        SHA1_ROUND_3(e, a, b, c, d, 56);
-        SHA1_ROUND_3(d, e, a, b, c, 57);
-        SHA1_ROUND_3(c, d, e, a, b, 58);
-        SHA1_ROUND_3(b, c, d, e, a, 59);
-        SHA1_ROUND_4(a, b, c, d, e, 60);
-        SHA1_ROUND_4(e, a, b, c, d, 61);
-        SHA1_ROUND_4(d, e, a, b, c, 62);
-        SHA1_ROUND_4(c, d, e, a, b, 63);
-        SHA1_ROUND_4(b, c, d, e, a, 64);
-        SHA1_ROUND_4(a, b, c, d, e, 65);
-        SHA1_ROUND_4(e, a, b, c, d, 66);
-        SHA1_ROUND_4(d, e, a, b, c, 67);
-        SHA1_ROUND_4(c, d, e, a, b, 68);
-        SHA1_ROUND_4(b, c, d, e, a, 69);
-        SHA1_ROUND_4(a, b, c, d, e, 70);
-        SHA1_ROUND_4(e, a, b, c, d, 71);
-        SHA1_ROUND_4(d, e, a, b, c, 72);
-        SHA1_ROUND_4(c, d, e, a, b, 73);
-        SHA1_ROUND_4(b, c, d, e, a, 74);
-        SHA1_ROUND_4(a, b, c, d, e, 75);
-        SHA1_ROUND_4(e, a, b, c, d, 76);
-        SHA1_ROUND_4(d, e, a, b, c, 77);
-        SHA1_ROUND_4(c, d, e, a, b, 78);
-        SHA1_ROUND_4(b, c, d, e, a, 79);
+        SHA1_LOAD(m_index) z += (u ^ x ^ y) + w[m_index & 15] + c3 + m_rol32(v, 5); \
+        u = m_rol32(u, 30);
+
+            SHA1_ROUND_0(a, b, c, d, e, 0);
+            SHA1_ROUND_0(e, a, b, c, d, 1);
+            SHA1_ROUND_0(d, e, a, b, c, 2);
+            SHA1_ROUND_0(c, d, e, a, b, 3);
+            SHA1_ROUND_0(b, c, d, e, a, 4);
+            SHA1_ROUND_0(a, b, c, d, e, 5);
+            SHA1_ROUND_0(e, a, b, c, d, 6);
+            SHA1_ROUND_0(d, e, a, b, c, 7);
+            SHA1_ROUND_0(c, d, e, a, b, 8);
+            SHA1_ROUND_0(b, c, d, e, a, 9);
+            SHA1_ROUND_0(a, b, c, d, e, 10);
+            SHA1_ROUND_0(e, a, b, c, d, 11);
+            SHA1_ROUND_0(d, e, a, b, c, 12);
+            SHA1_ROUND_0(c, d, e, a, b, 13);
+            SHA1_ROUND_0(b, c, d, e, a, 14);
+            SHA1_ROUND_0(a, b, c, d, e, 15);
+            SHA1_ROUND_1(e, a, b, c, d, 16);
+            SHA1_ROUND_1(d, e, a, b, c, 17);
+            SHA1_ROUND_1(c, d, e, a, b, 18);
+            SHA1_ROUND_1(b, c, d, e, a, 19);
+            SHA1_ROUND_2(a, b, c, d, e, 20);
+            SHA1_ROUND_2(e, a, b, c, d, 21);
+            SHA1_ROUND_2(d, e, a, b, c, 22);
+            SHA1_ROUND_2(c, d, e, a, b, 23);
+            SHA1_ROUND_2(b, c, d, e, a, 24);
+            SHA1_ROUND_2(a, b, c, d, e, 25);
+            SHA1_ROUND_2(e, a, b, c, d, 26);
+            SHA1_ROUND_2(d, e, a, b, c, 27);
+            SHA1_ROUND_2(c, d, e, a, b, 28);
+            SHA1_ROUND_2(b, c, d, e, a, 29);
+            SHA1_ROUND_2(a, b, c, d, e, 30);
+            SHA1_ROUND_2(e, a, b, c, d, 31);
+            SHA1_ROUND_2(d, e, a, b, c, 32);
+            SHA1_ROUND_2(c, d, e, a, b, 33);
+            SHA1_ROUND_2(b, c, d, e, a, 34);
+            SHA1_ROUND_2(a, b, c, d, e, 35);
+            SHA1_ROUND_2(e, a, b, c, d, 36);
+            SHA1_ROUND_2(d, e, a, b, c, 37);
+            SHA1_ROUND_2(c, d, e, a, b, 38);
+            SHA1_ROUND_2(b, c, d, e, a, 39);
+            SHA1_ROUND_3(a, b, c, d, e, 40);
+            SHA1_ROUND_3(e, a, b, c, d, 41);
+            SHA1_ROUND_3(d, e, a, b, c, 42);
+            SHA1_ROUND_3(c, d, e, a, b, 43);
+            SHA1_ROUND_3(b, c, d, e, a, 44);
+            SHA1_ROUND_3(a, b, c, d, e, 45);
+            SHA1_ROUND_3(e, a, b, c, d, 46);
+            SHA1_ROUND_3(d, e, a, b, c, 47);
+            SHA1_ROUND_3(c, d, e, a, b, 48);
+            SHA1_ROUND_3(b, c, d, e, a, 49);
+            SHA1_ROUND_3(a, b, c, d, e, 50);
+            SHA1_ROUND_3(e, a, b, c, d, 51);
+            SHA1_ROUND_3(d, e, a, b, c, 52);
+            SHA1_ROUND_3(c, d, e, a, b, 53);
+            SHA1_ROUND_3(b, c, d, e, a, 54);
+            SHA1_ROUND_3(a, b, c, d, e, 55);
+            SHA1_ROUND_3(e, a, b, c, d, 56);
+            SHA1_ROUND_3(d, e, a, b, c, 57);
+            SHA1_ROUND_3(c, d, e, a, b, 58);
+            SHA1_ROUND_3(b, c, d, e, a, 59);
+            SHA1_ROUND_4(a, b, c, d, e, 60);
+            SHA1_ROUND_4(e, a, b, c, d, 61);
+            SHA1_ROUND_4(d, e, a, b, c, 62);
+            SHA1_ROUND_4(c, d, e, a, b, 63);
+            SHA1_ROUND_4(b, c, d, e, a, 64);
+            SHA1_ROUND_4(a, b, c, d, e, 65);
+            SHA1_ROUND_4(e, a, b, c, d, 66);
+            SHA1_ROUND_4(d, e, a, b, c, 67);
+            SHA1_ROUND_4(c, d, e, a, b, 68);
+            SHA1_ROUND_4(b, c, d, e, a, 69);
+            SHA1_ROUND_4(a, b, c, d, e, 70);
+            SHA1_ROUND_4(e, a, b, c, d, 71);
+            SHA1_ROUND_4(d, e, a, b, c, 72);
+            SHA1_ROUND_4(c, d, e, a, b, 73);
+            SHA1_ROUND_4(b, c, d, e, a, 74);
+            SHA1_ROUND_4(a, b, c, d, e, 75);
+            SHA1_ROUND_4(e, a, b, c, d, 76);
+            SHA1_ROUND_4(d, e, a, b, c, 77);
+            SHA1_ROUND_4(c, d, e, a, b, 78);
+            SHA1_ROUND_4(b, c, d, e, a, 79);
 
 #undef SHA1_LOAD
 #undef SHA1_ROUND_0
@@ -266,12 +409,375 @@ private:
 #undef SHA1_ROUND_3
 #undef SHA1_ROUND_4
 
-        m_state[0] += a;
-        m_state[1] += b;
-        m_state[2] += c;
-        m_state[3] += d;
-        m_state[4] += e;
+            vState[0] += a;
+            vState[1] += b;
+            vState[2] += c;
+            vState[3] += d;
+            vState[4] += e;
+        }
+    }
+
+#ifdef EZ_SHA_X86
+    EZ_SHA_NI_TARGET static void m_processBlocksShaNi(uint32_t *vState, const uint8_t *vBlocks, size_t vCount) {
+        const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vState)), 0x1B);
+        __m128i e0 = _mm_set_epi32(static_cast<int>(vState[4]), 0, 0, 0);
+        __m128i e1, msg0, msg1, msg2, msg3;
+        for (; vCount > 0U; --vCount, vBlocks += 64) {
+            const __m128i abcdSave = abcd;
+            const __m128i e0Save = e0;
+            // rounds 0-3
+            msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 0)), mask);
+            e0 = _mm_add_epi32(e0, msg0);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            // rounds 4-7
+            msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 16)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+            // rounds 8-11
+            msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 32)), mask);
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+            msg0 = _mm_xor_si128(msg0, msg2);
+            // rounds 12-15
+            msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 48)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+            msg1 = _mm_xor_si128(msg1, msg3);
+            // rounds 16-19
+            e0 = _mm_sha1nexte_epu32(e0, msg0);
+            e1 = abcd;
+            msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+            msg2 = _mm_xor_si128(msg2, msg0);
+            // rounds 20-23
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+            msg3 = _mm_xor_si128(msg3, msg1);
+            // rounds 24-27
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+            msg0 = _mm_xor_si128(msg0, msg2);
+            // rounds 28-31
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+            msg1 = _mm_xor_si128(msg1, msg3);
+            // rounds 32-35
+            e0 = _mm_sha1nexte_epu32(e0, msg0);
+            e1 = abcd;
+            msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+            msg2 = _mm_xor_si128(msg2, msg0);
+            // rounds 36-39
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+            msg3 = _mm_xor_si128(msg3, msg1);
+            // rounds 40-43
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+            msg0 = _mm_xor_si128(msg0, msg2);
+            // rounds 44-47
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+            msg1 = _mm_xor_si128(msg1, msg3);
+            // rounds 48-51
+            e0 = _mm_sha1nexte_epu32(e0, msg0);
+            e1 = abcd;
+            msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+            msg2 = _mm_xor_si128(msg2, msg0);
+            // rounds 52-55
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+            msg3 = _mm_xor_si128(msg3, msg1);
+            // rounds 56-59
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+            msg0 = _mm_xor_si128(msg0, msg2);
+            // rounds 60-63
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+            msg1 = _mm_xor_si128(msg1, msg3);
+            // rounds 64-67
+            e0 = _mm_sha1nexte_epu32(e0, msg0);
+            e1 = abcd;
+            msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+            msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+            msg2 = _mm_xor_si128(msg2, msg0);
+            // rounds 68-71
+            e1 = _mm_sha1nexte_epu32(e1, msg1);
+            e0 = abcd;
+            msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            msg3 = _mm_xor_si128(msg3, msg1);
+            // rounds 72-75
+            e0 = _mm_sha1nexte_epu32(e0, msg2);
+            e1 = abcd;
+            msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+            // rounds 76-79
+            e1 = _mm_sha1nexte_epu32(e1, msg3);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            e0 = _mm_sha1nexte_epu32(e0, e0Save);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(vState), _mm_shuffle_epi32(abcd, 0x1B));
+        vState[4] = static_cast<uint32_t>(_mm_extract_epi32(e0, 3));
+    }
+#endif
+};
+
+class sha256 : public detail::shaHasher<sha256, 8> {
+    friend class detail::shaHasher<sha256, 8>;
+
+public:
+    static size_t constexpr SHA256_HEX_SIZE{64};
+
+public:
+    sha256() {
+        m_state[0] = 0x6a09e667;
+        m_state[1] = 0xbb67ae85;
+        m_state[2] = 0x3c6ef372;
+        m_state[3] = 0xa54ff53a;
+        m_state[4] = 0x510e527f;
+        m_state[5] = 0x9b05688c;
+        m_state[6] = 0x1f83d9ab;
+        m_state[7] = 0x5be0cd19;
+    }
+    explicit sha256(const std::string &vText) : sha256() { add(vText); }
+    explicit sha256(const char *vText) : sha256() { add(vText, std::strlen(vText)); }
+
+private:
+    static const uint32_t *m_getRoundConstants() {
+        alignas(16) static const uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,  //
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,  //
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,  //
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,  //
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,  //
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,  //
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,  //
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+        return k;
+    }
+
+    static ProcessBlocksFunc m_getHardwareProcessBlocks() {
+#ifdef EZ_SHA_X86
+        if (detail::shaCpuHaveShaNi()) {
+            return &m_processBlocksShaNi;
+        }
+#endif
+        return nullptr;
+    }
+
+    static void m_processBlocksPortable(uint32_t *vState, const uint8_t *vBlocks, size_t vCount) {
+        const uint32_t *k = m_getRoundConstants();
+        uint32_t w[64];
+        for (; vCount > 0U; --vCount, vBlocks += 64) {
+            for (int i = 0; i < 16; i++) {
+                w[i] = m_makeWord(vBlocks + i * 4);
+            }
+            for (int i = 16; i < 64; i++) {
+                const uint32_t s0 = m_ror32(w[i - 15], 7) ^ m_ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const uint32_t s1 = m_ror32(w[i - 2], 17) ^ m_ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = vState[0];
+            uint32_t b = vState[1];
+            uint32_t c = vState[2];
+            uint32_t d = vState[3];
+            uint32_t e = vState[4];
+            uint32_t f = vState[5];
+            uint32_t g = vState[6];
+            uint32_t h = vState[7];
+            for (int i = 0; i < 64; i++) {
+                const uint32_t t1 = h + (m_ror32(e, 6) ^ m_ror32(e, 11) ^ m_ror32(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+                const uint32_t t2 = (m_ror32(a, 2) ^ m_ror32(a, 13) ^ m_ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            vState[0] += a;
+            vState[1] += b;
+            vState[2] += c;
+            vState[3] += d;
+            vState[4] += e;
+            vState[5] += f;
+            vState[6] += g;
+            vState[7] += h;
+        }
+    }
+
+#ifdef EZ_SHA_X86
+    EZ_SHA_NI_TARGET static void m_processBlocksShaNi(uint32_t *vState, const uint8_t *vBlocks, size_t vCount) {
+        const uint32_t *k = m_getRoundConstants();
+        const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vState)), 0xB1);  // CDAB
+        __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vState + 4)), 0x1B);  // EFGH
+        __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0);  // CDGH
+        __m128i msg, msg0, msg1, msg2, msg3;
+        for (; vCount > 0U; --vCount, vBlocks += 64) {
+            const __m128i abefSave = state0;
+            const __m128i cdghSave = state1;
+            // rounds 0-3
+            msg0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 0)), mask);
+            msg = _mm_add_epi32(msg0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 0)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            // rounds 4-7
+            msg1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 16)), mask);
+            msg = _mm_add_epi32(msg1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 4)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+            // rounds 8-11
+            msg2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 32)), mask);
+            msg = _mm_add_epi32(msg2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 8)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+            // rounds 12-15
+            msg3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vBlocks + 48)), mask);
+            msg = _mm_add_epi32(msg3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 12)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg3, msg2, 4);
+            msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, tmp), msg3);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+            // rounds 16-19
+            msg = _mm_add_epi32(msg0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 16)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg0, msg3, 4);
+            msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, tmp), msg0);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+            // rounds 20-23
+            msg = _mm_add_epi32(msg1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 20)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg1, msg0, 4);
+            msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, tmp), msg1);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+            // rounds 24-27
+            msg = _mm_add_epi32(msg2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 24)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg2, msg1, 4);
+            msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, tmp), msg2);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+            // rounds 28-31
+            msg = _mm_add_epi32(msg3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 28)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg3, msg2, 4);
+            msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, tmp), msg3);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+            // rounds 32-35
+            msg = _mm_add_epi32(msg0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 32)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg0, msg3, 4);
+            msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, tmp), msg0);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+            // rounds 36-39
+            msg = _mm_add_epi32(msg1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 36)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg1, msg0, 4);
+            msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, tmp), msg1);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+            // rounds 40-43
+            msg = _mm_add_epi32(msg2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 40)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg2, msg1, 4);
+            msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, tmp), msg2);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+            // rounds 44-47
+            msg = _mm_add_epi32(msg3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 44)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg3, msg2, 4);
+            msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, tmp), msg3);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+            // rounds 48-51
+            msg = _mm_add_epi32(msg0, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 48)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg0, msg3, 4);
+            msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, tmp), msg0);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+            // rounds 52-55
+            msg = _mm_add_epi32(msg1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 52)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg1, msg0, 4);
+            msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, tmp), msg1);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            // rounds 56-59
+            msg = _mm_add_epi32(msg2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 56)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(msg2, msg1, 4);
+            msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, tmp), msg2);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            // rounds 60-63
+            msg = _mm_add_epi32(msg3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(k + 60)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+        }
+        tmp = _mm_shuffle_epi32(state0, 0x1B);  // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);  // DCHG
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(vState), _mm_blend_epi16(tmp, state1, 0xF0));  // DCBA
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(vState + 4), _mm_alignr_epi8(state1, tmp, 8));  // ABEF
     }
+#endif
 };
 
 }  // namespace ez
@@ -33,14 +33,19 @@ SOFTWARE.
 #include <cstdint>
 #include <sstream>
 #include <cstring>
+#include <cerrno>
 #include <limits>
 #include <string>
 #include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <memory>
+#include <algorithm>
 #include <array>
-#include <map>
 
 #include "ezMath.hpp"
+#include "ezZlib.hpp"
 
 namespace ez {
 namespace file {
@@ -100,10 +105,34 @@ inline void write_meta_vec3i(FILE* fp, const std::string& name, const std::array
     write_vec3i(fp, data);
 }
 
+// compression flags of a grid, the values of openvdb
+enum Compression : uint32_t {
+    COMPRESS_NONE = 0x0,
+    COMPRESS_ZIP = 0x1,          // the values buffers are deflated
+    COMPRESS_ACTIVE_MASK = 0x2,  // only the active values are written, the inactive are the background
+};
+
+// the value of the "file_compression" metadata
+inline std::string compression_to_string(uint32_t flags) {
+    if (flags == COMPRESS_NONE) {
+        return "none";
+    }
+    std::string ret;
+    if (flags & COMPRESS_ZIP) {
+        ret += "zip";
+    }
+    if (flags & COMPRESS_ACTIVE_MASK) {
+        ret += ret.empty() ? "active values" : " + active values";
+    }
+    return ret;
+}
+
 class ATree {
 protected:
     dAABBCC m_Volume;
     std::string m_Name;
+    uint32_t m_Compression = COMPRESS_NONE;
+    int32_t m_ZipLevel = 6;
 
 protected:
     virtual bool addVoxel(uint32_t vX, uint32_t vY, uint32_t vZ, void* vDatas, size_t vByteSize, size_t vCount) = 0;
@@ -149,34 +178,110 @@ public:
     }
     virtual ~ATree() = default;
 
+    // vFlags is a combination of Compression, vZipLevel is the deflate level of COMPRESS_ZIP, from 1 (fast) to 9 (small)
+    void setCompression(uint32_t vFlags, int32_t vZipLevel = 6) {
+        m_Compression = vFlags;
+        m_ZipLevel = vZipLevel;
+    }
+    uint32_t getCompression() const {
+        return m_Compression;
+    }
+
     virtual void write(FILE* vFp) = 0;
+    virtual bool merge(ATree& vOther) = 0;
+    virtual void clear() = 0;
 };
 
 template <typename TType, size_t TCount>
 class VdbTree : public ATree {
 private:
+    static constexpr uint32_t EMPTY_LEAF_KEY = 0xFFFFFFFFU;
+
     struct Node3 {
         uint64_t mask[8] = {};
         std::array<TType, TCount> data[512] = {};  // data
     };
 
+    // the childs Node3 are in the leafs table
     struct Node4 {
         uint64_t mask[64] = {};
-        std::map<uint32_t, Node3> nodes;  // loc, node
     };
 
+    // the childs are directly indexed by their bit index, nullptr if not active
     struct Node5 {
         uint64_t mask[512] = {};
-        std::map<uint32_t, Node4> nodes;  // loc, node
+        std::unique_ptr<Node4> nodes[32768];
     };
 
+    // slot of the open addressing table of the leafs
+    struct LeafSlot {
+        uint32_t key = EMPTY_LEAF_KEY;
+        uint32_t index = 0U;
+    };
+
+    // metadata byte before the values of a node, the inactive values are the background in our trees
+    static constexpr uint8_t NO_MASK_OR_INACTIVE_VALS = 0U;
+    static constexpr uint8_t NO_MASK_AND_ALL_VALS = 6U;
+
+    // the values of a node, deflated like openvdb if COMPRESS_ZIP :
+    // the size of the zipped datas then the datas, or minus the size of the raw datas then the datas if the zip is not smaller
+    void writeValues(FILE* fp, const std::array<TType, TCount>* values, size_t count) {
+        const size_t bytes = sizeof(std::array<TType, TCount>) * count;
+        if (bytes == 0U) {
+            if (m_Compression & COMPRESS_ZIP) {
+                write_data<int64_t>(fp, 0);  // the zipped size of no datas
+            }
+            return;
+        }
+        if (m_Compression & COMPRESS_ZIP) {
+            m_ZipBuffer.clear();
+            m_ZipCompressor->compress(values, bytes, m_ZipBuffer, m_ZipLevel);
+            if (m_ZipBuffer.size() < bytes) {
+                write_data<int64_t>(fp, (int64_t)m_ZipBuffer.size());
+                write_data_arr<uint8_t>(fp, m_ZipBuffer.data(), m_ZipBuffer.size());
+                return;
+            }
+            write_data<int64_t>(fp, -(int64_t)bytes);
+        }
+        write_data_arr<std::array<TType, TCount>>(fp, values, count);
+    }
+
+    // the internal nodes have no active tiles, so no values with COMPRESS_ACTIVE_MASK
+    void writeEmptyTiles(FILE* fp, size_t count) {
+        if (m_Compression & COMPRESS_ACTIVE_MASK) {
+            write_data<uint8_t>(fp, NO_MASK_OR_INACTIVE_VALS);
+            writeValues(fp, nullptr, 0);
+        } else {
+            static const std::vector<std::array<TType, TCount>> tiles_empty(32768);  // we dont use a std::array for not increase the bin size
+            write_data<uint8_t>(fp, NO_MASK_AND_ALL_VALS);
+            writeValues(fp, tiles_empty.data(), count);
+        }
+    }
+
+    void writeNode3Values(FILE* fp, const Node3& node) {
+        const bool all_active = std::all_of(node.mask, node.mask + 8, [](uint64_t word) { return word == ~0ULL; });
+        if ((m_Compression & COMPRESS_ACTIVE_MASK) && !all_active) {
+            m_ActiveValues.clear();
+            size_t word_idx = 0;
+            for (auto word : node.mask) {
+                const auto& base_bit_0_idx = word_idx++ * 64;
+                for (; word != 0; word &= word - 1) {
+                    m_ActiveValues.push_back(node.data[base_bit_0_idx + (size_t)count_trailing_zeros(word)]);
+                }
+            }
+            write_data<uint8_t>(fp, NO_MASK_OR_INACTIVE_VALS);
+            writeValues(fp, m_ActiveValues.data(), m_ActiveValues.size());
+        } else {
+            write_data<uint8_t>(fp, NO_MASK_AND_ALL_VALS);
+            writeValues(fp, node.data, 512);
+        }
+    }
+
     void writeNode4EmptyHeader(FILE* fp, Node4* node) {
         write_data_arr<uint64_t>(fp, node->mask, 64);
         static std::vector<uint64_t> mask_arr_uint64_empty(64);  // we dont use a std::array for not increase the bin size
         write_data_arr<uint64_t>(fp, mask_arr_uint64_empty.data(), mask_arr_uint64_empty.size());
-        write_data<uint8_t>(fp, 6);
-        static std::vector<float> mask_arr_float_empty(4096);
-        write_data_arr<float>(fp, mask_arr_float_empty.data(), mask_arr_float_empty.size());
+        writeEmptyTiles(fp, 4096);
     }
 
     void writeNode5EmptyHeader(FILE* fp, Node5* node) {
@@ -184,31 +289,29 @@ private:
         write_data_arr<uint64_t>(fp, node->mask, 512);
         static std::vector<uint64_t> mask_arr_uint64_empty(512);  // we dont use a std::array for not increase the bin size
         write_data_arr<uint64_t>(fp, mask_arr_uint64_empty.data(), mask_arr_uint64_empty.size());
-        write_data<uint8_t>(fp, 6);
-        static std::vector<float> mask_arr_float_empty(32768);
-        write_data_arr<float>(fp, mask_arr_float_empty.data(), mask_arr_float_empty.size());
+        writeEmptyTiles(fp, 32768);
     }
 
     void writeTree(FILE* fp) {
         write_data<uint32_t>(fp, 1);
-        write_data<float>(fp, 0);
+        write_data<std::array<TType, TCount>>(fp, {});  // background
         write_data<uint32_t>(fp, 0);
         write_data<uint32_t>(fp, 1);
-        auto& nodes5Ref = m_Nodes;
+        auto& nodes5Ref = *m_Nodes;
         writeNode5EmptyHeader(fp, &nodes5Ref);
         size_t word5_idx = 0;
         for (auto word5 : nodes5Ref.mask) {
             const auto& base_bit_4_idx = ((uint32_t)word5_idx++) * 64;
             for (; word5 != 0; word5 &= word5 - 1) {
                 const auto& bit_4_index = base_bit_4_idx + (uint32_t)count_trailing_zeros(word5);
-                auto& nodes4Ref = nodes5Ref.nodes.at(bit_4_index);
+                auto& nodes4Ref = *nodes5Ref.nodes[bit_4_index];
                 writeNode4EmptyHeader(fp, &nodes4Ref);
                 size_t word4_idx = 0;
                 for (auto word4 : nodes4Ref.mask) {
                     const auto& base_bit_3_idx = ((uint32_t)word4_idx++) * 64;
                     for (; word4 != 0; word4 &= word4 - 1) {
                         const auto& bit_3_index = base_bit_3_idx + (uint32_t)count_trailing_zeros(word4);
-                        const auto& nodes3Ref = nodes4Ref.nodes.at(bit_3_index);
+                        const auto& nodes3Ref = *findNode3(getLeafKey(bit_4_index, bit_3_index));
                         write_data_arr<uint64_t>(fp, nodes3Ref.mask, 8);
                     }
                 }
@@ -219,16 +322,15 @@ private:
             const auto& base_bit_4_idx = ((uint32_t)word5_idx++) * 64;
             for (; word5 != 0; word5 &= word5 - 1) {
                 const auto& bit_4_index = base_bit_4_idx + (uint32_t)count_trailing_zeros(word5);
-                const auto& nodes4Ref = nodes5Ref.nodes.at(bit_4_index);
+                const auto& nodes4Ref = *nodes5Ref.nodes[bit_4_index];
                 size_t word4_idx = 0;
                 for (auto word4 : nodes4Ref.mask) {
                     const auto& base_bit_3_idx = ((uint32_t)word4_idx++) * 64;
                     for (; word4 != 0; word4 &= word4 - 1) {
                         const auto& bit_3_index = base_bit_3_idx + (uint32_t)count_trailing_zeros(word4);
-                        const auto& nodes3Ref = nodes4Ref.nodes.at(bit_3_index);
+                        const auto& nodes3Ref = *findNode3(getLeafKey(bit_4_index, bit_3_index));
                         write_data_arr<uint64_t>(fp, nodes3Ref.mask, 8);
-                        write_data<uint8_t>(fp, 6);
-                        write_data_arr<std::array<TType, TCount>>(fp, nodes3Ref.data, 512);
+                        writeNode3Values(fp, nodes3Ref);
                     }
                 }
             }
@@ -239,7 +341,7 @@ private:
         // Number of entries
         write_data<uint32_t>(fp, 5);
         write_meta_string(fp, "class", "unknown");
-        write_meta_string(fp, "file_compression", "none");
+        write_meta_string(fp, "file_compression", compression_to_string(m_Compression));
         write_meta_vec3i(fp, "file_bbox_max", {(int32_t)m_Volume.upperBound.x, (int32_t)m_Volume.upperBound.y, (int32_t)m_Volume.upperBound.z});
         write_meta_vec3i(fp, "file_bbox_min", {(int32_t)m_Volume.lowerBound.x, (int32_t)m_Volume.lowerBound.y, (int32_t)m_Volume.lowerBound.z});
         write_meta_string(fp, "name", m_Name);
@@ -282,23 +384,101 @@ private:
     }
 
 private:
-    Node5 m_Nodes;
+    std::unique_ptr<Node5> m_Nodes;
+    std::vector<std::unique_ptr<Node3>> m_Leafs;
+    std::vector<LeafSlot> m_LeafSlots;  // size is a power of two, half filled at max
+    // last accessed leaf, coherent insertions are often in the same leaf
+    Node3* m_LastNode3 = nullptr;
+    uint32_t m_LastNode3Key = EMPTY_LEAF_KEY;
+    // buffers of the compressions, only during the write
+    std::unique_ptr<ez::zlib::Compressor> m_ZipCompressor;
+    std::vector<uint8_t> m_ZipBuffer;
+    std::vector<std::array<TType, TCount>> m_ActiveValues;
+
+    // unique key of a leaf, the bits 12 to 26 are the bit index 4, the bits 0 to 11 the bit index 3
+    static uint32_t getLeafKey(uint32_t vBitIndex4, uint32_t vBitIndex3) {
+        return (vBitIndex4 << 12) | vBitIndex3;
+    }
+
+    static size_t getLeafSlot(uint32_t vKey, size_t vSlotsMask) {
+        return static_cast<size_t>((vKey * 0x9E3779B1U) >> 7) & vSlotsMask;
+    }
+
+    Node3* findNode3(uint32_t vKey) const {
+        if (!m_LeafSlots.empty()) {
+            const size_t slotsMask = m_LeafSlots.size() - 1U;
+            for (size_t i = getLeafSlot(vKey, slotsMask);; i = (i + 1U) & slotsMask) {
+                const auto& slot = m_LeafSlots[i];
+                if (slot.key == vKey) {
+                    return m_Leafs[slot.index].get();
+                }
+                if (slot.key == EMPTY_LEAF_KEY) {
+                    break;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void insertLeafSlot(uint32_t vKey, uint32_t vIndex) {
+        const size_t slotsMask = m_LeafSlots.size() - 1U;
+        size_t i = getLeafSlot(vKey, slotsMask);
+        while (m_LeafSlots[i].key != EMPTY_LEAF_KEY) {
+            i = (i + 1U) & slotsMask;
+        }
+        m_LeafSlots[i].key = vKey;
+        m_LeafSlots[i].index = vIndex;
+    }
+
+    // add a leaf not in the tree, its parents are created and activated if needed
+    Node3& insertNode3(uint32_t vKey, std::unique_ptr<Node3> vNode3) {
+        const uint32_t bit_index_4 = vKey >> 12;
+        const uint32_t bit_index_3 = vKey & 4095U;
+        auto& nodes4Ptr = m_Nodes->nodes[bit_index_4];
+        if (nodes4Ptr == nullptr) {
+            nodes4Ptr.reset(new Node4());
+            m_Nodes->mask[bit_index_4 >> 6] |= static_cast<uint64_t>(1) << (bit_index_4 & (64 - 1));  // active the voxel 4
+        }
+        nodes4Ptr->mask[bit_index_3 >> 6] |= static_cast<uint64_t>(1) << (bit_index_3 & (64 - 1));  // active the voxel 3
+        if ((m_Leafs.size() + 1U) * 2U > m_LeafSlots.size()) {
+            std::vector<LeafSlot> oldSlots(std::max<size_t>(m_LeafSlots.size() * 2U, 1024U));
+            oldSlots.swap(m_LeafSlots);
+            for (const auto& slot : oldSlots) {
+                if (slot.key != EMPTY_LEAF_KEY) {
+                    insertLeafSlot(slot.key, slot.index);
+                }
+            }
+        }
+        m_Leafs.push_back(std::move(vNode3));
+        insertLeafSlot(vKey, static_cast<uint32_t>(m_Leafs.size() - 1U));
+        return *m_Leafs.back();
+    }
+
+    // leaf of a voxel, created if needed
+    Node3& getNode3(uint32_t vX, uint32_t vY, uint32_t vZ) {
+        const uint32_t key = getLeafKey(getBitIndex4(vX, vY, vZ), getBitIndex3(vX, vY, vZ));
+        if (m_LastNode3Key == key) {
+            return *m_LastNode3;
+        }
+        Node3* nodes3Ptr = findNode3(key);
+        if (nodes3Ptr == nullptr) {
+            nodes3Ptr = &insertNode3(key, std::unique_ptr<Node3>(new Node3()));
+        }
+        m_LastNode3 = nodes3Ptr;
+        m_LastNode3Key = key;
+        return *m_LastNode3;
+    }
 
 public:
-    VdbTree(const std::string& vName) : ATree(vName) {
+    VdbTree(const std::string& vName) : ATree(vName), m_Nodes(new Node5()) {
     }
     virtual ~VdbTree() = default;
 
     bool addVoxel(uint32_t vX, uint32_t vY, uint32_t vZ, void* vDatas, size_t vByteSize, size_t vCount) override final {
         if (vDatas != nullptr && vByteSize == sizeof(TType) && vCount == TCount) {
             m_Volume.Combine(ez::dvec3((float)vX, (float)vY, (float)vZ));
-            const auto& bit_index_4 = getBitIndex4(vX, vY, vZ);
-            const auto& bit_index_3 = getBitIndex3(vX, vY, vZ);
             const auto& bit_index_0 = getBitIndex0(vX, vY, vZ);
-            auto& nodes4Ref = m_Nodes.nodes[bit_index_4];
-            auto& nodes3Ref = nodes4Ref.nodes[bit_index_3];
-            m_Nodes.mask[bit_index_4 >> 6] |= static_cast<uint64_t>(1) << (bit_index_4 & (64 - 1));    // active the voxel 4
-            nodes4Ref.mask[bit_index_3 >> 6] |= static_cast<uint64_t>(1) << (bit_index_3 & (64 - 1));  // active the voxel 3
+            auto& nodes3Ref = getNode3(vX, vY, vZ);
             nodes3Ref.mask[bit_index_0 >> 6] |= static_cast<uint64_t>(1) << (bit_index_0 & (64 - 1));  // active the voxel 0
             memcpy(&nodes3Ref.data[bit_index_0], vDatas, vByteSize * vCount);
             return true;
@@ -310,6 +490,50 @@ public:
         return addVoxel(vX, vY, vZ, const_cast<TType*>(vDatas.data()), sizeof(TType), TCount);
     }
 
+    // move the voxels of vOther in this tree, vOther is cleared.
+    // vOther must be of the same type, else false is returned. the leafs only in vOther are moved, not copied.
+    // for a voxel in both trees, the value of vOther is kept
+    bool merge(ATree& vOther) override {
+        auto* otherPtr = dynamic_cast<VdbTree*>(&vOther);  // once by merged tree, not by voxel
+        if (otherPtr == nullptr || otherPtr == this) {
+            return false;
+        }
+        auto& other = *otherPtr;
+        if (!other.m_Leafs.empty()) {
+            m_Volume.Combine(other.m_Volume);
+            for (const auto& slot : other.m_LeafSlots) {
+                if (slot.key == EMPTY_LEAF_KEY) {
+                    continue;
+                }
+                auto& otherNode3Ptr = other.m_Leafs[slot.index];
+                Node3* nodes3Ptr = findNode3(slot.key);
+                if (nodes3Ptr == nullptr) {
+                    insertNode3(slot.key, std::move(otherNode3Ptr));
+                    continue;
+                }
+                for (size_t word_idx = 0; word_idx < 8U; ++word_idx) {
+                    const uint64_t word = otherNode3Ptr->mask[word_idx];
+                    nodes3Ptr->mask[word_idx] |= word;
+                    for (uint64_t bits = word; bits != 0; bits &= bits - 1) {
+                        const size_t bit_index_0 = word_idx * 64U + (size_t)count_trailing_zeros(bits);
+                        nodes3Ptr->data[bit_index_0] = otherNode3Ptr->data[bit_index_0];
+                    }
+                }
+            }
+        }
+        other.clear();
+        return true;
+    }
+
+    void clear() override {
+        m_Volume = dAABBCC();
+        m_Nodes.reset(new Node5());
+        m_Leafs.clear();
+        m_LeafSlots.clear();
+        m_LastNode3 = nullptr;
+        m_LastNode3Key = EMPTY_LEAF_KEY;
+    }
+
     void write(FILE* fp) override {
         write_name(fp, m_Name);
         write_name(fp, getTypeName());
@@ -318,10 +542,16 @@ public:
         write_data<uint64_t>(fp, stream_pos + sizeof(uint64_t) * 3);  // grid pos
         write_data<uint64_t>(fp, 0);                                  // block pos
         write_data<uint64_t>(fp, 0);                                  // end pos
-        write_data<uint32_t>(fp, 0);                                  // compression
+        write_data<uint32_t>(fp, m_Compression);                      // compression
         writeMetadata(fp);
         writeTransform(fp);
+        if (m_Compression & COMPRESS_ZIP) {
+            m_ZipCompressor.reset(new ez::zlib::Compressor());
+        }
         writeTree(fp);
+        m_ZipCompressor.reset();
+        m_ZipBuffer = std::vector<uint8_t>();
+        m_ActiveValues = std::vector<std::array<TType, TCount>>();
     }
 };
 
@@ -404,32 +634,111 @@ class Writer {
 private:
     typedef std::unordered_map<LayerId, std::unique_ptr<ATree>> LayerContainer;
     std::unordered_map<KeyFrame, LayerContainer> m_Trees;
+    // partial trees of the layers, one by filling thread
+    typedef std::unordered_map<std::thread::id, std::unique_ptr<ATree>> PartialContainer;
+    std::unordered_map<KeyFrame, std::unordered_map<LayerId, PartialContainer>> m_PartialTrees;
+    std::mutex m_PartialTreesMutex;
     KeyFrame m_CurrentKeyFrame = 0U;
+    uint32_t m_Compression = COMPRESS_NONE;
+    int32_t m_ZipLevel = 6;
     FILE* m_file = nullptr;
     int32_t m_LastError = 0;
+    // streaming, the finished keyframes are written then freed
+    bool m_Streaming = false;
+    std::string m_StreamBasePathName;  // file path name without the extension
+    size_t m_StreamedFramesCount = 0U;
+    std::thread m_StreamThread;  // background writer, if async
+    std::mutex m_StreamMutex;
+    std::condition_variable m_StreamWake;
+    LayerContainer m_StreamPending;  // keyframe given to the background writer
+    std::string m_StreamPendingFilePathName;
+    bool m_StreamHasPending = false;
+    bool m_StreamRunning = false;
+    int32_t m_StreamError = 0;  // errno of a failed write of the background writer, not yet reported
 
 public:
+    ~Writer() {
+        stopStreaming();
+    }
+
     template <typename TTtree>
     TTtree& getLayer(uint32_t vLayerId, const std::string& vLayerName) {
         auto& key = m_Trees[m_CurrentKeyFrame];
         if (key.find(vLayerId) == key.end()) {
             key[vLayerId] = std::unique_ptr<TTtree>(new TTtree(vLayerName));
+            key[vLayerId]->setCompression(m_Compression, m_ZipLevel);
         }
         return static_cast<TTtree&>(*(key.at(vLayerId).get()));
     }
 
+    // thread safe. give to the calling thread its own tree of the layer in the current keyframe,
+    // to fill without lock. the trees of the threads are merged in the layer by mergePartialLayers (called by save).
+    // the call take a lock, the thread must keep the returned tree for its voxels
+    // the threads are merged in no defined order, so a voxel written by many threads get the value of one of them
+    // a layer must be of the same TTtree in all threads, and with getLayer, else its partial trees are not merged
+    template <typename TTtree>
+    TTtree& getPartialLayer(uint32_t vLayerId, const std::string& vLayerName) {
+        std::lock_guard<std::mutex> lock(m_PartialTreesMutex);
+        auto& tree = m_PartialTrees[m_CurrentKeyFrame][vLayerId][std::this_thread::get_id()];
+        if (tree == nullptr) {
+            tree = std::unique_ptr<TTtree>(new TTtree(vLayerName));
+            tree->setCompression(m_Compression, m_ZipLevel);
+        }
+        return static_cast<TTtree&>(*tree);
+    }
+
+    // merge the partial trees in their layers, once the filling threads are done
+    Writer& mergePartialLayers() {
+        std::lock_guard<std::mutex> lock(m_PartialTreesMutex);
+        for (auto& key : m_PartialTrees) {
+            mergePartialTrees(key.first, key.second);
+        }
+        m_PartialTrees.clear();
+        return *this;
+    }
+
+    // same for one keyframe, the partial trees of the others are kept
+    Writer& mergePartialLayers(KeyFrame vKeyFrame) {
+        std::lock_guard<std::mutex> lock(m_PartialTreesMutex);
+        auto it = m_PartialTrees.find(vKeyFrame);
+        if (it != m_PartialTrees.end()) {
+            mergePartialTrees(it->first, it->second);
+            m_PartialTrees.erase(it);
+        }
+        return *this;
+    }
+
+    // compression of the layers created after this call, see ATree::setCompression
+    Writer& setCompression(uint32_t vFlags, int32_t vZipLevel = 6) {
+        m_Compression = vFlags;
+        m_ZipLevel = vZipLevel;
+        return *this;
+    }
+
+    // when streaming, a change of keyframe finish the current one
     Writer& setKeyFrame(uint32_t vKeyFrame) {
+        if (m_Streaming && vKeyFrame != m_CurrentKeyFrame) {
+            finishKeyFrame();
+        }
         m_CurrentKeyFrame = vKeyFrame;
         return *this;
     }
 
+    // the keyframes are written in the order of their values
     Writer& save(const std::string& vFilePathName) {
+        stopStreaming();
+        mergePartialLayers();
         if (!vFilePathName.empty()) {
             auto dot_p = vFilePathName.find_last_of('.');
             if (dot_p != std::string::npos) {
                 auto base_file_path_name = vFilePathName.substr(0, dot_p);
+                std::vector<KeyFrame> keyFrames;
+                for (const auto& vdb : m_Trees) {
+                    keyFrames.push_back(vdb.first);
+                }
+                std::sort(keyFrames.begin(), keyFrames.end());
                 size_t idx = 1;
-                for (auto& vdb : m_Trees) {
+                for (const auto& keyFrame : keyFrames) {
                     std::stringstream str;
                     if (m_Trees.size() > 1) {
                         str << base_file_path_name << "_" << std::setfill('0') << std::setw(4) << idx++ << ".vdb";  // many frames
@@ -437,7 +746,7 @@ public:
                         str << base_file_path_name << ".vdb";
                     }
                     if (openFileForWriting(str.str())) {
-                        writeVdb(m_file, vdb.second);
+                        writeVdb(m_file, m_Trees.at(keyFrame));
                         closeFile();
                     } else {
                         std::cout << "Error, cant write to the file " << str.str() << std::endl;
@@ -448,6 +757,99 @@ public:
         return *this;
     }
 
+    // streaming of an animation : each finished keyframe is written in <base>_NNNN.vdb, NNNN from 1 by finished keyframe,
+    // then its trees are freed. so the keyframes must be filled one after the other.
+    // a keyframe is finished by finishKeyFrame, by setKeyFrame to another keyframe, or by stopStreaming.
+    // with vAsync the files are written by a background thread during the filling of the next keyframe,
+    // so two keyframes at max are in memory
+    bool startStreaming(const std::string& vFilePathName, bool vAsync = false) {
+        if (m_Streaming || vFilePathName.empty()) {
+            return false;
+        }
+        m_StreamBasePathName = vFilePathName.substr(0, vFilePathName.find_last_of('.'));
+        m_StreamedFramesCount = 0U;
+        m_Streaming = true;
+        if (vAsync) {
+            m_StreamRunning = true;
+            m_StreamThread = std::thread(&Writer::streamLoop, this);
+        }
+        return true;
+    }
+
+    // write the current keyframe and free it. the filling threads of its partial layers must be done,
+    // the partial layers of the other keyframes are not merged, so their threads can go on
+    Writer& finishKeyFrame() {
+        if (!m_Streaming) {
+            return *this;
+        }
+        mergePartialLayers(m_CurrentKeyFrame);
+        auto it = m_Trees.find(m_CurrentKeyFrame);
+        if (it == m_Trees.end()) {
+            return *this;
+        }
+        LayerContainer layers = std::move(it->second);
+        m_Trees.erase(it);
+        std::stringstream str;
+        str << m_StreamBasePathName << "_" << std::setfill('0') << std::setw(4) << ++m_StreamedFramesCount << ".vdb";
+        if (m_StreamThread.joinable()) {
+            // wait the end of the previous write
+            std::unique_lock<std::mutex> lock(m_StreamMutex);
+            m_StreamWake.wait(lock, [this]() { return !m_StreamHasPending; });
+            if (m_StreamError != 0) {
+                m_LastError = m_StreamError;
+                m_StreamError = 0;
+            }
+            m_StreamPending = std::move(layers);
+            m_StreamPendingFilePathName = str.str();
+            m_StreamHasPending = true;
+            m_StreamWake.notify_all();
+        } else {
+            const int32_t error = writeVdbFile(str.str(), layers);
+            if (error != 0) {
+                m_LastError = error;
+            }
+        }
+        return *this;
+    }
+
+    // finish the current keyframe and wait the end of the writes
+    // a failed write of the background writer is reported by getLastError after this call
+    Writer& stopStreaming() {
+        if (!m_Streaming) {
+            return *this;
+        }
+        finishKeyFrame();
+        if (m_StreamThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_StreamMutex);
+                m_StreamRunning = false;
+            }
+            m_StreamWake.notify_all();
+            m_StreamThread.join();
+            if (m_StreamError != 0) {
+                m_LastError = m_StreamError;
+                m_StreamError = 0;
+            }
+        }
+        m_Streaming = false;
+        return *this;
+    }
+
+    bool isStreaming() const {
+        return m_Streaming;
+    }
+
+    // errno of the last error, 0 if none. set by the open of a file, the merge of the partial layers,
+    // and the writes of the streamed keyframes (the background ones are reported by finishKeyFrame and stopStreaming)
+    int32_t getLastError() const {
+        return m_LastError;
+    }
+
+    // count of keyframes written (or given to the background writer) since startStreaming
+    size_t getStreamedFramesCount() const {
+        return m_StreamedFramesCount;
+    }
+
     // common grid types
     VdbFloatGrid& getFloatLayer(uint32_t vLayerId, const std::string& vLayerName) {
         return getLayer<VdbFloatGrid>(vLayerId, vLayerName);
@@ -484,6 +886,64 @@ private:
         }
     }
 
+    // m_PartialTreesMutex must be locked
+    void mergePartialTrees(KeyFrame vKeyFrame, std::unordered_map<LayerId, PartialContainer>& vPartials) {
+        auto& layers = m_Trees[vKeyFrame];
+        for (auto& partials : vPartials) {
+            for (auto& partial : partials.second) {
+                auto it = layers.find(partials.first);
+                if (it == layers.end()) {
+                    layers[partials.first] = std::move(partial.second);
+                } else if (!it->second->merge(*partial.second)) {
+                    std::cout << "Error, cant merge a partial tree of the layer " << partials.first  //
+                              << " in the keyframe " << vKeyFrame << ", the grid types differ" << std::endl;
+                    m_LastError = EINVAL;
+                }
+            }
+        }
+    }
+
+    // return the errno of the open, 0 if written
+    static int32_t writeVdbFile(const std::string& vFilePathName, const LayerContainer& vTrees) {
+        FILE* fp = nullptr;
+#if _MSC_VER
+        int32_t error = fopen_s(&fp, vFilePathName.c_str(), "wb");
+#else
+        fp = fopen(vFilePathName.c_str(), "wb");
+        int32_t error = fp ? 0 : errno;
+#endif
+        if (fp == nullptr) {
+            std::cout << "Error, cant write to the file " << vFilePathName << std::endl;
+            return error != 0 ? error : EIO;
+        }
+        writeVdb(fp, vTrees);
+        fclose(fp);
+        return 0;
+    }
+
+    // background writer of the streaming, one keyframe at a time
+    void streamLoop() {
+        std::unique_lock<std::mutex> lock(m_StreamMutex);
+        while (true) {
+            m_StreamWake.wait(lock, [this]() { return m_StreamHasPending || !m_StreamRunning; });
+            if (!m_StreamHasPending) {
+                break;
+            }
+            LayerContainer layers = std::move(m_StreamPending);
+            m_StreamPending.clear();
+            const std::string filePathName = m_StreamPendingFilePathName;
+            lock.unlock();
+            const int32_t error = writeVdbFile(filePathName, layers);
+            layers.clear();
+            lock.lock();
+            if (error != 0) {
+                m_StreamError = error;
+            }
+            m_StreamHasPending = false;
+            m_StreamWake.notify_all();
+        }
+    }
+
     bool openFileForWriting(const std::string& vFilePathName) {
 #if _MSC_VER
         m_LastError = fopen_s(&m_file, vFilePathName.c_str(), "wb");
@@ -37,6 +37,7 @@ SOFTWARE.
 #include <sstream>
 #include <iostream>
 #include <functional>
+#include <unordered_map>
 
 #include "ezMath.hpp"
 #include "ezStr.hpp"
@@ -392,6 +393,57 @@ struct VoxCube {
     }
 };
 
+// position of a cube, not packed so any position has its own key
+struct CubeKey {
+    CubeX x = 0;
+    CubeY y = 0;
+    CubeZ z = 0;
+    CubeKey() = default;
+    CubeKey(const CubeX& vX, const CubeY& vY, const CubeZ& vZ) : x(vX), y(vY), z(vZ) {}
+    bool operator==(const CubeKey& vOther) const { return x == vOther.x && y == vOther.y && z == vOther.z; }
+    bool operator!=(const CubeKey& vOther) const { return !(*this == vOther); }
+};
+
+struct CubeKeyHash {
+    size_t operator()(const CubeKey& vKey) const {
+        uint64_t h = (uint64_t)vKey.x * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (uint64_t)vKey.y) * 0xC2B2AE3D27D4EB4FULL;
+        h = (h ^ (uint64_t)vKey.z) * 0x165667B19E3779F9ULL;
+        return (size_t)(h ^ (h >> 32));
+    }
+};
+
+// the voxels added in the cubes for one keyframe, as hashed masks of 8x8x8 voxels
+class VoxelsMask {
+private:
+    std::unordered_map<uint64_t, size_t> m_BricksIds;  // brick key => m_Bricks index
+    std::vector<std::array<uint64_t, 8>> m_Bricks;
+    uint64_t m_LastBrickKey = ~0ULL;  // the successive voxels are often in the same brick
+    size_t m_LastBrickId = 0U;
+
+public:
+    // vX, vY, vZ are the coords in the cube, so lower than 127
+    // return false if the voxel was already added
+    bool insert(const size_t& vCubeId, const uint8_t& vX, const uint8_t& vY, const uint8_t& vZ) {
+        const uint64_t key = ((uint64_t)vCubeId << 12) | ((uint64_t)(vX >> 3) << 8) | ((uint64_t)(vY >> 3) << 4) | (uint64_t)(vZ >> 3);
+        if (key != m_LastBrickKey) {
+            auto it = m_BricksIds.emplace(key, m_Bricks.size());
+            if (it.second) {
+                m_Bricks.push_back({});
+            }
+            m_LastBrickKey = key;
+            m_LastBrickId = it.first->second;
+        }
+        auto& word = m_Bricks[m_LastBrickId][vX & 7];
+        const uint64_t bit = 1ULL << (((vY & 7) << 3) | (vZ & 7));
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        return true;
+    }
+};
+
 class Writer {
 private:
     static const uint32_t GetID(const uint8_t& a, const uint8_t& b, const uint8_t& c, const uint8_t& d) {
@@ -430,8 +482,12 @@ private:
 
     std::vector<VoxCube> cubes;
 
-    std::map<CubeX, std::map<CubeY, std::map<CubeZ, CubeID>>> cubesId;
-    std::map<KeyFrame, std::map<VoxelX, std::map<VoxelY, std::map<VoxelZ, VoxelID>>>> voxelId;
+    std::unordered_map<CubeKey, CubeID, CubeKeyHash> cubesId;
+    std::unordered_map<KeyFrame, VoxelsMask> voxelId;
+    VoxelsMask* m_KeyFrameVoxelId = nullptr;  // voxelId of m_KeyFrame
+    CubeKey m_LastCubeKey;                    // the successive voxels are often in the same cube
+    CubeID m_LastCubeId = 0;
+    bool m_HasLastCube = false;               // m_LastCubeKey is valid
 
     int32_t lastError = 0;
 
@@ -469,6 +525,8 @@ public:
         cubes.clear();
         cubesId.clear();
         voxelId.clear();
+        m_KeyFrameVoxelId = nullptr;
+        m_HasLastCube = false;
         return *this;
     }
 
@@ -514,6 +572,7 @@ public:
                 m_LastKeyFrameTime = now;
             }
             m_KeyFrame = vKeyFrame;
+            m_KeyFrameVoxelId = nullptr;
         }
         return *this;
     }
@@ -527,9 +586,9 @@ public:
 
     Writer& addVoxel(const size_t& vX, const size_t& vY, const size_t& vZ, const uint8_t& vColorIndex) {
         // cube pos
-        size_t ox = (size_t)std::floor((double)vX / (double)m_MaxVoxelPerCubeX);
-        size_t oy = (size_t)std::floor((double)vY / (double)m_MaxVoxelPerCubeY);
-        size_t oz = (size_t)std::floor((double)vZ / (double)m_MaxVoxelPerCubeZ);
+        size_t ox = vX / m_MaxVoxelPerCubeX;
+        size_t oy = vY / m_MaxVoxelPerCubeY;
+        size_t oz = vZ / m_MaxVoxelPerCubeZ;
 
         minCubeX = ez::mini<size_t>(minCubeX, ox);
         minCubeY = ez::mini<size_t>(minCubeX, oy);
@@ -725,18 +784,18 @@ private:
         fseek(m_file, vPos, SEEK_SET);
     }
 
-    const size_t m_GetCubeId(const VoxelX& vX, const VoxelY& vY, const VoxelZ& vZ) {
-        if (cubesId.find(vX) != cubesId.end()) {
-            if (cubesId[vX].find(vY) != cubesId[vX].end()) {
-                if (cubesId[vX][vY].find(vZ) != cubesId[vX][vY].end()) {
-                    return cubesId[vX][vY][vZ];
-                }
+    const size_t m_GetCubeId(const CubeX& vX, const CubeY& vY, const CubeZ& vZ) {
+        const CubeKey key(vX, vY, vZ);
+        if (!m_HasLastCube || key != m_LastCubeKey) {
+            auto it = cubesId.emplace(key, maxCubeId);
+            if (it.second) {
+                ++maxCubeId;
             }
+            m_LastCubeKey = key;
+            m_LastCubeId = it.first->second;
+            m_HasLastCube = true;
         }
-
-        cubesId[vX][vY][vZ] = maxCubeId++;
-
-        return cubesId[vX][vY][vZ];
+        return m_LastCubeId;
     }
 
     // Wrap a position inside a particular cube dimension
@@ -751,29 +810,20 @@ private:
     void m_MergeVoxelInCube(const VoxelX& vX, const VoxelY& vY, const VoxelZ& vZ, const uint8_t& vColorIndex, VoxCube* vCube) {
         maxVolume.Combine(ez::dvec3((double)vX, (double)vY, (double)vZ));
 
-        bool exist = false;
-        if (voxelId.find(m_KeyFrame) != voxelId.end()) {
-            auto& vidk = voxelId.at(m_KeyFrame);
-            if (vidk.find(vX) != vidk.end()) {
-                auto& vidkx = vidk.at(vX);
-                if (vidkx.find(vY) != vidkx.end()) {
-                    auto& vidkxy = vidkx.at(vY);
-                    if (vidkxy.find(vZ) != vidkxy.end()) {
-                        exist = true;
-                    }
-                }
-            }
+        const uint8_t x = Wrap(vX, m_MaxVoxelPerCubeX);
+        const uint8_t y = Wrap(vY, m_MaxVoxelPerCubeY);
+        const uint8_t z = Wrap(vZ, m_MaxVoxelPerCubeZ);
+
+        if (m_KeyFrameVoxelId == nullptr) {
+            m_KeyFrameVoxelId = &voxelId[m_KeyFrame];
         }
 
-        if (!exist) {
+        // the first color added for a voxel is kept
+        if (m_KeyFrameVoxelId->insert((size_t)vCube->id, x, y, z)) {
             auto& xyzi = vCube->xyzis[m_KeyFrame];
-            xyzi.voxels.push_back(Wrap(vX, m_MaxVoxelPerCubeX));  // x
-            xyzi.voxels.push_back(Wrap(vY, m_MaxVoxelPerCubeY));  // y
-            xyzi.voxels.push_back(Wrap(vZ, m_MaxVoxelPerCubeZ));  // z
-
-            // correspond a la loc de la couleur du voxel en question
-            voxelId[m_KeyFrame][vX][vY][vZ] = (int)xyzi.voxels.size();
-
+            xyzi.voxels.push_back(x);            // x
+            xyzi.voxels.push_back(y);            // y
+            xyzi.voxels.push_back(z);            // z
             xyzi.voxels.push_back(vColorIndex);  // color index
         }
     }
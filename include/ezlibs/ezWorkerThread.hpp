@@ -26,21 +26,117 @@ SOFTWARE.
 
 // ezWorkerThread is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
 #include <mutex>
+#include <deque>
 #include <atomic>
 #include <thread>
 #include <string>
 #include <vector>
 #include <chrono>
+#include <algorithm>
 #include <functional>
-#include <chrono>
 #include <memory>
+#include <cstring>
+#include <cstdint>
+#include <exception>
+#include <typeinfo>
 #include <typeindex>
+#include <condition_variable>
 
 namespace ez {
 namespace thread {
 
+class ThreadPool;
+
+// Status of a worker shared with the UI thread without lock (triple buffering) :
+// a producer writes the whole status in the back buffer then swaps it with the middle one,
+// the UI swaps the middle buffer with its front one when a new status was published,
+// so the UI always reads a complete status and never waits for a producer
+class StatusChannel {
+public:
+    struct Status {
+        static size_t constexpr sPHASE_SIZE = 128U;
+        static size_t constexpr sHEADER_SIZE = 128U;
+        static size_t constexpr sMESSAGE_SIZE = 512U;
+        char phase[sPHASE_SIZE];  // texts are truncated to the buffer size
+        char header[sHEADER_SIZE];
+        char message[sMESSAGE_SIZE];
+        uint64_t version;  // count of publications
+    };
+
+private:
+    static uint8_t constexpr sINDEX_MASK = 3U;
+    static uint8_t constexpr sDIRTY = 4U;  // the middle buffer was published and not read yet
+    Status m_buffers[3];
+    Status m_current;  // status of the producers
+    std::atomic_flag m_producerLock = ATOMIC_FLAG_INIT;  // between producers only, the UI never takes it
+    std::atomic<uint8_t> m_middle{1U};
+    uint8_t m_back = 0U;  // producers side
+    uint8_t m_front = 2U;  // UI side
+
+public:
+    StatusChannel() {
+        memset(m_buffers, 0, sizeof(m_buffers));
+        memset(&m_current, 0, sizeof(m_current));
+    }
+
+    StatusChannel(const StatusChannel&) = delete;
+    StatusChannel& operator=(const StatusChannel&) = delete;
+
+    void setPhase(const std::string& vPhase) {
+        m_lock();
+        m_copy(m_current.phase, Status::sPHASE_SIZE, vPhase);
+        m_publish();
+    }
+    void setHeader(const std::string& vHeader) {
+        m_lock();
+        m_copy(m_current.header, Status::sHEADER_SIZE, vHeader);
+        m_publish();
+    }
+    void setMessage(const std::string& vMessage) {
+        m_lock();
+        m_copy(m_current.message, Status::sMESSAGE_SIZE, vMessage);
+        m_publish();
+    }
+    // the three texts are seen together by the UI
+    void set(const std::string& vPhase, const std::string& vHeader, const std::string& vMessage) {
+        m_lock();
+        m_copy(m_current.phase, Status::sPHASE_SIZE, vPhase);
+        m_copy(m_current.header, Status::sHEADER_SIZE, vHeader);
+        m_copy(m_current.message, Status::sMESSAGE_SIZE, vMessage);
+        m_publish();
+    }
+
+    // the last published status, for one reader thread (the UI)
+    // the reference stays valid and unchanged until the next call
+    const Status& read() {
+        if (m_middle.load(std::memory_order_relaxed) & sDIRTY) {
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & sINDEX_MASK;
+        }
+        return m_buffers[m_front];
+    }
+
+private:
+    void m_lock() {
+        while (m_producerLock.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+    void m_publish() {
+        ++m_current.version;
+        memcpy(&m_buffers[m_back], &m_current, sizeof(Status));
+        m_back = m_middle.exchange((uint8_t)(m_back | sDIRTY), std::memory_order_acq_rel) & sINDEX_MASK;
+        m_producerLock.clear(std::memory_order_release);
+    }
+    static void m_copy(char* vDst, const size_t vDstSize, const std::string& vSrc) {
+        const size_t len = (std::min)(vSrc.size(), vDstSize - 1U);
+        memcpy(vDst, vSrc.data(), len);
+        vDst[len] = '\0';
+    }
+};
 
 class Worker {
+    friend class ThreadPool;
+
 public:
     typedef std::atomic<float> AtomicFloat;
     typedef std::atomic<bool> AtomicBool;
@@ -48,7 +144,7 @@ public:
     public:
         WorkerIO(Worker& vSelf, AtomicFloat& vProgress, AtomicBool& vWorking, AtomicFloat& vGenerationTime)
             : m_self(vSelf), m_progress(vProgress), m_working(vWorking), m_generationTime(vGenerationTime) {
-            m_baseTime = std::chrono::high_resolution_clock::now();
+            m_baseTime = now();
         }
 
         // Non copiable (tient des rfrences)
@@ -103,10 +199,16 @@ public:
             m_self.m_setCurrentStepMessage(vMessage);
         }
 
+        // phase, step header and step message seen together by the UI
+        void setCurrentStatus(const std::string& vPhase, const std::string& vHeader, const std::string& vMessage) {  //
+            fixTime();
+            m_self.m_status.set(vPhase, vHeader, vMessage);
+        }
+
         std::mutex& getMutexRef() { return m_self.m_mutex; }
 
     private:
-        static std::chrono::steady_clock::time_point now() { return std::chrono::high_resolution_clock::now(); }
+        static std::chrono::steady_clock::time_point now() { return std::chrono::steady_clock::now(); }
         // fetch_add available only for integral in cpp11 (available for float only in cpp20)
         static void m_atomicAdd(AtomicFloat& target, float value) {  // CAS for cpp11
             float old = target.load(std::memory_order_relaxed);
@@ -169,10 +271,8 @@ private:
     std::shared_ptr<void> m_payload;  // propritaire
     std::type_index m_payloadType{typeid(void)};
 
-    // thread shared data (need a mutex lock)
-    std::string m_currentStepHeader;
-    std::string m_currentStepMessage;
-    std::string m_currentPhase;
+    // thread shared data (lock free, see StatusChannel)
+    StatusChannel m_status;
 
 public:
     Worker() : aProgress(0.0f), aWorking(false), aGenerationTime(0.0f) {}
@@ -186,31 +286,8 @@ public:
         BaseFunctor vFinishFunctor = nullptr,
         BaseFunctor vCancelFunctor = nullptr) {
         if (!stop()) {
-            m_taskTitle = vTaskTitle;
-            m_finishFunc = std::move(vFinishFunctor);
-            m_cancelFunc = std::move(vCancelFunctor);
-            m_workerFunc = std::move(vWorkerFunctor);
-
-            // Possession des datas par le thread
-            m_payload = std::shared_ptr<void>(new T(std::move(vData)), [](void* p) { delete static_cast<T*>(p); });
-            m_payloadType = std::type_index(typeid(T));
-
-            aWorking = true;
-            aProgress = 0.0f;
-            aGenerationTime = 0.0f;
-
-            m_workerThread = std::thread([this]() {
-                const auto t0 = std::chrono::high_resolution_clock::now();
-
-                if (m_workerFunc) {
-                    WorkerIO io{*this, aProgress, aWorking, aGenerationTime};
-                    m_workerFunc(io);
-                }
-
-                const auto t1 = std::chrono::high_resolution_clock::now();
-                aGenerationTime = std::chrono::duration<float>(t1 - t0).count();
-                aWorking = false;
-            });
+            m_setup(vTaskTitle, std::move(vData), std::move(vWorkerFunctor), std::move(vFinishFunctor), std::move(vCancelFunctor));
+            m_workerThread = std::thread([this]() { m_run(); });
         }
     }
 
@@ -265,6 +342,14 @@ public:
 
     std::mutex& getMutexRef() { return m_mutex; }
 
+    float getProgress() const { return aProgress; }
+    float getGenerationTime() const { return aGenerationTime; }
+    bool isWorking() const { return aWorking; }
+    const std::string& getTaskTitle() const { return m_taskTitle; }
+
+    // phase and step of the worker, read by one thread (the UI) without waiting the worker
+    const StatusChannel::Status& readStatus() { return m_status.read(); }
+
 #ifdef IMGUI_API
     void drawDialog(const ImVec2& vPos, const float vItemWidth, const float vItemAlign) {
         if (aWorking) {
@@ -302,6 +387,36 @@ public:
 #endif
 
 private:
+    template <typename T>
+    void m_setup(const std::string& vTaskTitle, T vData, WorkerFunctor vWorkerFunctor, BaseFunctor vFinishFunctor, BaseFunctor vCancelFunctor) {
+        m_taskTitle = vTaskTitle;
+        m_finishFunc = std::move(vFinishFunctor);
+        m_cancelFunc = std::move(vCancelFunctor);
+        m_workerFunc = std::move(vWorkerFunctor);
+
+        // Possession des datas par le thread
+        m_payload = std::shared_ptr<void>(new T(std::move(vData)), [](void* p) { delete static_cast<T*>(p); });
+        m_payloadType = std::type_index(typeid(T));
+
+        aWorking = true;
+        aProgress = 0.0f;
+        aGenerationTime = 0.0f;
+    }
+
+    // run the worker functor on the current thread
+    void m_run() {
+        const auto t0 = std::chrono::steady_clock::now();
+
+        if (m_workerFunc) {
+            WorkerIO io{*this, aProgress, aWorking, aGenerationTime};
+            m_workerFunc(io);
+        }
+
+        const auto t1 = std::chrono::steady_clock::now();
+        aGenerationTime = std::chrono::duration<float>(t1 - t0).count();
+        aWorking = false;
+    }
+
     template <typename T>
     T& m_get() {
         if (!m_payload || m_payloadType != std::type_index(typeid(T))) {
@@ -317,41 +432,32 @@ private:
         }
         return *static_cast<const T*>(m_payload.get());
     }
+    void m_setCurrentStepHeader(const std::string& vHeader) { m_status.setHeader(vHeader); }
+    void m_setCurrentStepMessage(const std::string& vMessage) { m_status.setMessage(vMessage); }
+    void m_setCurrentPhase(const std::string& vPhase) { m_status.setPhase(vPhase); }
 #ifdef IMGUI_API
-    void m_setCurrentStepHeader(const std::string& vHeader) {
-        std::lock_guard<std::mutex> _{m_mutex};
-        m_currentStepHeader = vHeader;
-    }
-    void m_setCurrentStepMessage(const std::string& vMessage) {
-        std::lock_guard<std::mutex> _{m_mutex};
-        m_currentStepMessage = vMessage;
-    }
-    void m_setCurrentPhase(const std::string& vPhase) {
-        std::lock_guard<std::mutex> _{m_mutex};
-        m_currentPhase = vPhase;
-    }
-    void m_drawDialogPhase(const float vItemWidth, const float vItemAlign) const {
-        std::lock_guard<std::mutex> _{m_mutex};
-        if (!m_currentPhase.empty()) {
-            ImGui::DisplayAlignedWidget(vItemWidth, "Phase", vItemAlign, [this]() {  //
-                ImGui::Text("%s", m_currentPhase.c_str());
+    void m_drawDialogPhase(const float vItemWidth, const float vItemAlign) {
+        const auto& status = m_status.read();
+        if (status.phase[0] != '\0') {
+            ImGui::DisplayAlignedWidget(vItemWidth, "Phase", vItemAlign, [&status]() {  //
+                ImGui::Text("%s", status.phase);
             });
         }
-        if (!m_currentStepMessage.empty()) {
-            ImGui::DisplayAlignedWidget(vItemWidth, m_currentStepHeader.c_str(), vItemAlign, [this]() {  //
-                ImGui::TextWrapped("%s", m_currentStepMessage.c_str());
+        if (status.message[0] != '\0') {
+            ImGui::DisplayAlignedWidget(vItemWidth, status.header, vItemAlign, [&status]() {  //
+                ImGui::TextWrapped("%s", status.message);
             });
         }
     }
     void m_drawStatusBarPhase() {
-        std::lock_guard<std::mutex> _{m_mutex};
-        if (!m_currentPhase.empty()) {
+        const auto& status = m_status.read();
+        if (status.phase[0] != '\0') {
             ImGui::Separator();
-            ImGui::Text("Phase %s", m_currentPhase.c_str());
+            ImGui::Text("Phase %s", status.phase);
         }
-        if (!m_currentStepMessage.empty()) {
+        if (status.message[0] != '\0') {
             ImGui::Separator();
-            ImGui::TextWrapped("%s %s", m_currentStepHeader.c_str(), m_currentStepMessage.c_str());
+            ImGui::TextWrapped("%s %s", status.header, status.message);
         }
     }
 
@@ -374,5 +480,308 @@ private:
 #endif
 };
 
+// Pool of threads created once, each thread owns a deque of jobs :
+// a thread pops its own jobs from the back, then takes the jobs posted from outside the pool in order,
+// then steals the oldest jobs of the other threads
+class ThreadPool {
+public:
+    typedef std::function<void()> Job;
+
+    // handle of a job submitted with a payload, reported like a Worker (progress, phase, step message)
+    class Task {
+        friend class ThreadPool;
+
+    public:
+        enum class State { PENDING = 0, RUNNING, DONE };
+
+    private:
+        Worker m_worker;
+        std::atomic<int> m_state{(int)State::PENDING};
+        std::atomic<bool> m_canceled{false};
+        bool m_finished = false;  // finish or cancel functor called
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+
+    public:
+        State getState() const { return (State)m_state.load(); }
+        bool isRunning() const { return getState() != State::DONE; }
+        bool isCanceled() const { return m_canceled; }
+        float getProgress() const { return m_worker.getProgress(); }
+        float getGenerationTime() const { return m_worker.getGenerationTime(); }
+        // for draw the dialog or the status bar
+        Worker& getWorker() { return m_worker; }
+
+        // the payload, to read once the task is done
+        template <typename T>
+        T& get() {
+            return m_worker.m_get<T>();
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lck(m_mutex);
+            m_cv.wait(lck, [this]() { return getState() == State::DONE; });
+        }
+
+        // call the finish functor on the calling thread, once the task is done
+        bool finishIfNeeded() {
+            if (getState() != State::DONE || m_finished) {
+                return false;
+            }
+            m_finished = true;
+            Worker::BaseIO io{m_worker};
+            if (m_canceled) {
+                if (m_worker.m_cancelFunc) {
+                    m_worker.m_cancelFunc(io);
+                }
+            } else if (m_worker.m_finishFunc) {
+                m_worker.m_finishFunc(io);
+            }
+            return true;
+        }
+
+        // ask the worker functor to stop (WorkerIO::isRunning() becomes false), a pending task will not run
+        // wait the end of the task and call the cancel functor on the calling thread
+        bool cancel() {
+            if (m_finished) {
+                return false;
+            }
+            m_canceled = true;
+            m_worker.aWorking = false;
+            int pending = (int)State::PENDING;
+            if (m_state.compare_exchange_strong(pending, (int)State::DONE)) {
+                m_cv.notify_all();  // not started, will never run
+            } else {
+                wait();
+            }
+            return finishIfNeeded();
+        }
+    };
+    typedef std::shared_ptr<Task> TaskPtr;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    Queue m_injectQueue;  // jobs posted from outside the pool
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_running{true};
+    std::atomic<size_t> m_pendingJobs{0U};
+    std::atomic<size_t> m_sleepers{0U};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+
+public:
+    // vThreadsCount 0 means one thread per hardware thread
+    explicit ThreadPool(size_t vThreadsCount = 0U) {
+        if (!vThreadsCount) {
+            vThreadsCount = std::thread::hardware_concurrency();
+        }
+        if (!vThreadsCount) {
+            vThreadsCount = 1U;
+        }
+        for (size_t i = 0; i < vThreadsCount; ++i) {
+            m_queues.emplace_back(new Queue());
+        }
+        for (size_t i = 0; i < vThreadsCount; ++i) {
+            m_threads.emplace_back([this, i]() { m_threadLoop(i); });
+        }
+    }
+
+    // the pending jobs are done before the threads are joined
+    ~ThreadPool() {
+        m_running = false;
+        {
+            std::lock_guard<std::mutex> lck(m_sleepMutex);
+            m_sleepCv.notify_all();
+        }
+        for (auto& th : m_threads) {
+            th.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadsCount() const { return m_threads.size(); }
+
+    // push a job, in the queue of the current thread if called from a thread of the pool
+    void post(Job vJob) {
+        auto& queue = (m_currentPool() == this) ? *m_queues[m_currentIndex()] : m_injectQueue;
+        {
+            std::lock_guard<std::mutex> lck(queue.mutex);
+            queue.jobs.push_back(std::move(vJob));
+        }
+        ++m_pendingJobs;
+        if (m_sleepers.load() > 0U) {
+            std::lock_guard<std::mutex> lck(m_sleepMutex);
+            m_sleepCv.notify_one();
+        }
+    }
+
+    // same parameters as Worker::start, but run on a thread of the pool
+    template <typename T>
+    TaskPtr submit(
+        const std::string& vTaskTitle,
+        T vData,
+        Worker::WorkerFunctor vWorkerFunctor,
+        Worker::BaseFunctor vFinishFunctor = nullptr,
+        Worker::BaseFunctor vCancelFunctor = nullptr) {
+        auto task = std::make_shared<Task>();
+        task->m_worker.m_setup(vTaskTitle, std::move(vData), std::move(vWorkerFunctor), std::move(vFinishFunctor), std::move(vCancelFunctor));
+        post([task]() { m_runTask(*task); });
+        return task;
+    }
+
+    // run one pending job on the calling thread, return false if there was none
+    bool runPendingJob() {
+        Job job;
+        if (m_popJob((m_currentPool() == this) ? (int)m_currentIndex() : -1, job)) {
+            job();
+            return true;
+        }
+        return false;
+    }
+
+    // call vFunctor(from, to) on chunks of [vBegin:vEnd) of vGrainSize indexs, and wait for all of them
+    // the calling thread runs chunks too, so it can be called from a job of the pool
+    // vGrainSize 0 means 4 chunks per thread
+    // if chunks throw, all the chunks are waited for, then the first exception is rethrown on the calling thread
+    template <typename T>
+    void parallelForRange(const size_t vBegin, const size_t vEnd, const T& vFunctor, size_t vGrainSize = 0U) {
+        if (vEnd <= vBegin) {
+            return;
+        }
+        const size_t count = vEnd - vBegin;
+        if (!vGrainSize) {
+            vGrainSize = count / (m_threads.size() * 4U);
+            if (!vGrainSize) {
+                vGrainSize = 1U;
+            }
+        }
+        const size_t chunksCount = (count + vGrainSize - 1U) / vGrainSize;
+        std::atomic<size_t> remaining{chunksCount - 1U};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        // the chunks must not unwind, the pending ones use vFunctor and remaining on the stack of this call
+        auto runChunk = [&vFunctor, &errorMutex, &error](const size_t vFrom, const size_t vTo) {
+            try {
+                vFunctor(vFrom, vTo);
+            } catch (...) {
+                std::lock_guard<std::mutex> lck(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        for (size_t c = 1U; c < chunksCount; ++c) {
+            post([&runChunk, &remaining, vBegin, vEnd, vGrainSize, c]() {
+                const size_t from = vBegin + c * vGrainSize;
+                const size_t to = (std::min)(from + vGrainSize, vEnd);
+                runChunk(from, to);
+                --remaining;
+            });
+        }
+        runChunk(vBegin, (std::min)(vBegin + vGrainSize, vEnd));
+        while (remaining.load() > 0U) {
+            if (!runPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // call vFunctor(i) for each i of [vBegin:vEnd)
+    // same exception handling as parallelForRange, a throwing index ends its chunk
+    template <typename T>
+    void parallelFor(const size_t vBegin, const size_t vEnd, const T& vFunctor, const size_t vGrainSize = 0U) {
+        parallelForRange(
+            vBegin,
+            vEnd,
+            [&vFunctor](const size_t vFrom, const size_t vTo) {
+                for (size_t i = vFrom; i < vTo; ++i) {
+                    vFunctor(i);
+                }
+            },
+            vGrainSize);
+    }
+
+private:
+    static ThreadPool*& m_currentPool() {
+        static thread_local ThreadPool* s_pool = nullptr;
+        return s_pool;
+    }
+    static size_t& m_currentIndex() {
+        static thread_local size_t s_index = 0U;
+        return s_index;
+    }
+
+    static void m_runTask(Task& vTask) {
+        int pending = (int)Task::State::PENDING;
+        if (!vTask.m_state.compare_exchange_strong(pending, (int)Task::State::RUNNING)) {
+            return;  // canceled before start
+        }
+        vTask.m_worker.m_run();
+        vTask.m_worker.aWorking = false;
+        {
+            std::lock_guard<std::mutex> lck(vTask.m_mutex);
+            vTask.m_state = (int)Task::State::DONE;
+        }
+        vTask.m_cv.notify_all();
+    }
+
+    static bool m_popJobFromQueue(Queue& vQueue, const bool vBack, Job& vOutJob) {
+        std::lock_guard<std::mutex> lck(vQueue.mutex);
+        if (vQueue.jobs.empty()) {
+            return false;
+        }
+        if (vBack) {
+            vOutJob = std::move(vQueue.jobs.back());
+            vQueue.jobs.pop_back();
+        } else {
+            vOutJob = std::move(vQueue.jobs.front());
+            vQueue.jobs.pop_front();
+        }
+        return true;
+    }
+
+    // own queue first (newest job, still hot in cache), then the jobs posted from outside, then steal the oldest job of the others
+    // vIdx is -1 for a thread outside the pool
+    bool m_popJob(const int vIdx, Job& vOutJob) {
+        bool found = (vIdx >= 0 && m_popJobFromQueue(*m_queues[(size_t)vIdx], true, vOutJob)) || m_popJobFromQueue(m_injectQueue, false, vOutJob);
+        const size_t start = (vIdx >= 0) ? (size_t)vIdx : 0U;
+        for (size_t i = 1U; !found && i <= m_queues.size(); ++i) {
+            found = m_popJobFromQueue(*m_queues[(start + i) % m_queues.size()], false, vOutJob);
+        }
+        if (found) {
+            --m_pendingJobs;
+        }
+        return found;
+    }
+
+    void m_threadLoop(const size_t vIdx) {
+        m_currentPool() = this;
+        m_currentIndex() = vIdx;
+        Job job;
+        for (;;) {
+            if (m_popJob((int)vIdx, job)) {
+                job();
+                job = nullptr;
+                continue;
+            }
+            if (!m_running) {
+                break;
+            }
+            std::unique_lock<std::mutex> lck(m_sleepMutex);
+            ++m_sleepers;
+            m_sleepCv.wait(lck, [this]() { return !m_running || m_pendingJobs.load() > 0U; });
+            --m_sleepers;
+        }
+    }
+};
+
 }  // namespace thread
 }  // namespace ez
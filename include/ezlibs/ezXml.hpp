@@ -28,6 +28,12 @@ SOFTWARE.
 // ezXml is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
 
 #include <map>
+#include <new>
+#include <memory>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
 #include <stack>
 #include <string>
 #include <vector>
@@ -48,6 +54,8 @@ namespace ez {
 
         class Node {
             friend class ez::Xml;
+            friend class Element;
+            friend class Writer;
 
         public:
             enum class Type {
@@ -326,6 +334,983 @@ namespace ez {
         }
 #endif
 
+        // serializer writing in one growable buffer, flushed by blocks when writing in a stream.
+        // the indented output is the same as Node::dump(), the compact one have no indentation and no line ends
+        class Writer {
+        private:
+            std::string m_buffer;
+            std::ostream *m_stream = nullptr;
+            size_t m_flushSize = 0;
+            bool m_compact = false;
+
+        public:
+            explicit Writer(bool vCompact = false) : m_compact(vCompact) {}
+
+            Writer(std::ostream &vStream, bool vCompact = false, size_t vFlushSize = 64 * 1024)
+                : m_stream(&vStream), m_flushSize(vFlushSize), m_compact(vCompact) {
+                m_buffer.reserve(vFlushSize);
+            }
+
+            Writer(const Writer &) = delete;
+            Writer &operator=(const Writer &) = delete;
+
+            ~Writer() {
+                flush();
+            }
+
+            static std::string toString(const Node &vNode, bool vCompact = false) {
+                Writer writer(vCompact);
+                writer.write(vNode);
+                return writer.m_buffer;
+            }
+
+            Writer &write(const Node &vNode) {
+                m_writeNode(vNode, 0U);
+                flush();
+                return *this;
+            }
+
+            // the written text, when not writing in a stream
+            const std::string &str() const {
+                return m_buffer;
+            }
+
+            void clear() {
+                m_buffer.clear();
+            }
+
+            void flush() {
+                if (m_stream != nullptr && !m_buffer.empty()) {
+                    m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                    m_buffer.clear();
+                }
+            }
+
+            // one pass escaping of vDatas at the end of vOut.
+            // if vKeepEntities, the known entities of vDatas are kept as is, like escapeXml(unEscapeXml(vDatas))
+            static void appendEscaped(std::string &vOut, const std::string &vDatas, bool vKeepEntities = false) {
+                const char *p = vDatas.data();
+                const char *end = p + vDatas.size();
+                const char *run = p;  // start of the chars to copy as is
+                for (; p < end; ++p) {
+                    const char *rep = nullptr;
+                    size_t repLen = 0;
+                    switch (*p) {
+                        case '&': {
+                            if (vKeepEntities) {
+                                repLen = m_entityLength(p, end);
+                                if (repLen > 0U) {
+                                    p += repLen - 1U;
+                                    continue;
+                                }
+                            }
+                            rep = "&amp;";
+                            repLen = 5U;
+                        } break;
+                        case '<': rep = "&lt;"; repLen = 4U; break;
+                        case '>': rep = "&gt;"; repLen = 4U; break;
+                        case '"': rep = "&quot;"; repLen = 6U; break;
+                        case '\'': rep = "&apos;"; repLen = 6U; break;
+                        default: continue;
+                    }
+                    vOut.append(run, static_cast<size_t>(p - run));
+                    vOut.append(rep, repLen);
+                    run = p + 1;
+                }
+                vOut.append(run, static_cast<size_t>(end - run));
+            }
+
+        private:
+            // length of the entity decoded by Node::unEscapeXml at vPos, 0 if none
+            static size_t m_entityLength(const char *vPos, const char *vEnd) {
+                static const char *entities[] = {"&lt;", "&gt;", "&amp;", "&quot;", "&apos;"};
+                for (const auto *entity : entities) {
+                    const size_t len = std::strlen(entity);
+                    if (static_cast<size_t>(vEnd - vPos) >= len && std::memcmp(vPos, entity, len) == 0) {
+                        return len;
+                    }
+                }
+                return 0U;
+            }
+
+            void m_newLine() {
+                if (!m_compact) {
+                    m_buffer += '\n';
+                }
+                if (m_stream != nullptr && m_buffer.size() >= m_flushSize) {
+                    flush();
+                }
+            }
+
+            void m_indent(uint32_t vLevel) {
+                if (!m_compact) {
+                    m_buffer.append(vLevel * 2U, ' ');
+                }
+            }
+
+            void m_writeNode(const Node &vNode, uint32_t vLevel) {
+                const bool isComment = (vNode.m_getType() == Node::Type::Comment);
+                m_indent(vLevel);
+                if (isComment) {
+                    m_buffer += "<!-- ";
+                } else {
+                    m_buffer += '<';
+                    m_buffer += vNode.m_name;
+                    for (const auto &attr : vNode.m_attributes) {
+                        m_buffer += ' ';
+                        m_buffer += attr.first;
+                        m_buffer += "=\"";
+                        appendEscaped(m_buffer, attr.second.getValue());
+                        m_buffer += '"';
+                    }
+                }
+                const auto &children = vNode.m_children;
+                if (vNode.m_content.empty() && children.empty()) {
+                    m_buffer += "/>";
+                    m_newLine();
+                    return;
+                }
+                if (!isComment) {
+                    m_buffer += '>';
+                }
+                appendEscaped(m_buffer, vNode.m_content, true);
+                if (isComment) {
+                    m_buffer += " -->";
+                    m_newLine();
+                }
+                if (!children.empty()) {
+                    m_newLine();
+                    for (const auto &child : children) {
+                        m_writeNode(child, vLevel + 1U);
+                    }
+                    m_indent(vLevel);
+                }
+                if (!isComment) {
+                    m_buffer += "</";
+                    m_buffer += vNode.m_name;
+                    m_buffer += '>';
+                    m_newLine();
+                }
+            }
+        };
+
+        // non-owning view on a string of a parsed buffer (names, values, contents)
+        class StringRef {
+        private:
+            const char *m_data = "";
+            size_t m_size = 0;
+
+        public:
+            StringRef() = default;
+            StringRef(const char *vData, size_t vSize) : m_data(vData), m_size(vSize) {}
+
+            const char *data() const { return m_data; }
+            size_t size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+            std::string str() const { return std::string(m_data, m_size); }
+
+            bool operator==(const char *vStr) const {
+                return std::strlen(vStr) == m_size && std::memcmp(m_data, vStr, m_size) == 0;
+            }
+            bool operator==(const std::string &vStr) const {
+                return vStr.size() == m_size && std::memcmp(m_data, vStr.data(), m_size) == 0;
+            }
+            bool operator==(const StringRef &vStr) const {
+                return vStr.m_size == m_size && std::memcmp(m_data, vStr.m_data, m_size) == 0;
+            }
+            template <typename T>
+            bool operator!=(const T &vStr) const {
+                return !(*this == vStr);
+            }
+
+            friend std::ostream &operator<<(std::ostream &os, const StringRef &vStr) {
+                return os.write(vStr.m_data, static_cast<std::streamsize>(vStr.m_size));
+            }
+        };
+
+        // bump allocator by blocks, for trivially destructible objects freed all at once by clear()
+        class Arena {
+        private:
+            std::vector<std::unique_ptr<char[]>> m_blocks;
+            size_t m_blockSize;
+            size_t m_used;
+
+        public:
+            explicit Arena(size_t vBlockSize = 64 * 1024) : m_blockSize(vBlockSize), m_used(vBlockSize) {}
+
+            template <typename T>
+            T *create() {
+                static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+                return new (m_allocate(sizeof(T), alignof(T))) T();
+            }
+
+            // keep the first block for the next use
+            void clear() {
+                if (m_blocks.size() > 1U) {
+                    m_blocks.resize(1U);
+                }
+                m_used = m_blocks.empty() ? m_blockSize : 0U;
+            }
+
+        private:
+            void *m_allocate(size_t vSize, size_t vAlign) {
+                size_t offset = (m_used + vAlign - 1U) & ~(vAlign - 1U);
+                if (m_blocks.empty() || offset + vSize > m_blockSize) {
+                    m_blocks.emplace_back(new char[m_blockSize]);
+                    offset = 0U;
+                }
+                m_used = offset + vSize;
+                return m_blocks.back().get() + offset;
+            }
+        };
+
+        struct ElementAttribute {
+            StringRef name;
+            StringRef value;  // unescaped
+            const ElementAttribute *next = nullptr;
+        };
+
+        // element of a Document, allocated in its arena
+        // names, contents and attributes are views on the parsed buffer
+        class Element {
+            friend class Document;
+
+        private:
+            StringRef m_name;
+            StringRef m_content;  // unescaped
+            Node::Type m_type = Node::Type::Token;
+            const Element *m_parent = nullptr;
+            const Element *m_firstChild = nullptr;
+            Element *m_lastChild = nullptr;
+            const Element *m_nextSibling = nullptr;
+            const ElementAttribute *m_firstAttribute = nullptr;
+            ElementAttribute *m_lastAttribute = nullptr;
+            size_t m_childrenCount = 0;
+
+        public:
+            const StringRef &getName() const { return m_name; }
+            const StringRef &getContent() const { return m_content; }
+            Node::Type getType() const { return m_type; }
+            const Element *getParent() const { return m_parent; }
+            const Element *getFirstChild() const { return m_firstChild; }
+            const Element *getNextSibling() const { return m_nextSibling; }
+            size_t getChildrenCount() const { return m_childrenCount; }
+            const ElementAttribute *getFirstAttribute() const { return m_firstAttribute; }
+
+            const Element *getChild(const char *vName) const {
+                for (auto child = m_firstChild; child != nullptr; child = child->m_nextSibling) {
+                    if (child->m_name == vName) {
+                        return child;
+                    }
+                }
+                return nullptr;
+            }
+
+            const ElementAttribute *findAttribute(const char *vKey) const {
+                for (auto attr = m_firstAttribute; attr != nullptr; attr = attr->next) {
+                    if (attr->name == vKey) {
+                        return attr;
+                    }
+                }
+                return nullptr;
+            }
+
+            bool isAttributeExist(const char *vKey) const {
+                return findAttribute(vKey) != nullptr;
+            }
+
+            // empty if not found
+            StringRef getAttribute(const char *vKey) const {
+                auto attr = findAttribute(vKey);
+                return attr != nullptr ? attr->value : StringRef();
+            }
+
+            // copy of this element and its children as a xml::Node tree
+            Node toNode() const {
+                Node node(m_name.str());
+                m_fillNode(node);
+                return node;
+            }
+
+        private:
+            void m_fillNode(Node &vNode) const {
+                vNode.m_setType(m_type);
+                for (auto attr = m_firstAttribute; attr != nullptr; attr = attr->next) {
+                    vNode.m_setAttribute(attr->name.str(), attr->value.str());
+                }
+                if (!m_content.empty()) {
+                    vNode.setContent(m_content.str());
+                }
+                for (auto child = m_firstChild; child != nullptr; child = child->m_nextSibling) {
+                    child->m_fillNode(vNode.addChild(child->m_name.str()));
+                }
+            }
+        };
+
+        // scanning helpers of the in-situ parsers
+        namespace detail {
+
+            inline bool isSpace(char c) {
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+
+            inline char *skipSpaces(char *p, char *end) {
+                while (p < end && isSpace(*p)) {
+                    ++p;
+                }
+                return p;
+            }
+
+            inline char *findPattern(char *p, char *end, const char *vPattern) {
+                const size_t len = std::strlen(vPattern);
+                while (p + len <= end) {
+                    p = static_cast<char *>(std::memchr(p, vPattern[0], static_cast<size_t>(end - p)));
+                    if (p == nullptr || p + len > end) {
+                        return nullptr;
+                    }
+                    if (std::memcmp(p, vPattern, len) == 0) {
+                        return p;
+                    }
+                    ++p;
+                }
+                return nullptr;
+            }
+
+            inline char *endOfName(char *p, char *end) {
+                while (p < end && !isSpace(*p) && *p != '/' && *p != '>' && *p != '=') {
+                    ++p;
+                }
+                return p;
+            }
+
+            inline char *writeUtf8(uint32_t vCode, char *w) {
+                if (vCode < 0x80U) {
+                    *w++ = static_cast<char>(vCode);
+                } else if (vCode < 0x800U) {
+                    *w++ = static_cast<char>(0xC0U | (vCode >> 6));
+                    *w++ = static_cast<char>(0x80U | (vCode & 0x3FU));
+                } else if (vCode < 0x10000U) {
+                    *w++ = static_cast<char>(0xE0U | (vCode >> 12));
+                    *w++ = static_cast<char>(0x80U | ((vCode >> 6) & 0x3FU));
+                    *w++ = static_cast<char>(0x80U | (vCode & 0x3FU));
+                } else {
+                    *w++ = static_cast<char>(0xF0U | (vCode >> 18));
+                    *w++ = static_cast<char>(0x80U | ((vCode >> 12) & 0x3FU));
+                    *w++ = static_cast<char>(0x80U | ((vCode >> 6) & 0x3FU));
+                    *w++ = static_cast<char>(0x80U | (vCode & 0x3FU));
+                }
+                return w;
+            }
+
+            // decode entities and \r\n in place, the decoded text is never longer
+            inline StringRef unescapeInSitu(char *vBegin, char *vEnd) {
+                char *w = vBegin;
+                for (char *r = vBegin; r < vEnd;) {
+                    if (*r == '&') {
+                        char *semi = static_cast<char *>(std::memchr(r, ';', static_cast<size_t>(std::min<ptrdiff_t>(vEnd - r, 12))));
+                        if (semi != nullptr) {
+                            const StringRef entity(r + 1, static_cast<size_t>(semi - r - 1));
+                            char c = 0;
+                            if (entity == "lt") {
+                                c = '<';
+                            } else if (entity == "gt") {
+                                c = '>';
+                            } else if (entity == "amp") {
+                                c = '&';
+                            } else if (entity == "quot") {
+                                c = '"';
+                            } else if (entity == "apos") {
+                                c = '\'';
+                            } else if (entity.size() > 1U && entity.data()[0] == '#') {
+                                const bool hex = (entity.data()[1] == 'x' || entity.data()[1] == 'X');
+                                char *numEnd = nullptr;
+                                const unsigned long code = std::strtoul(entity.data() + (hex ? 2 : 1), &numEnd, hex ? 16 : 10);
+                                if (numEnd == semi && code <= 0x10FFFFUL) {
+                                    w = writeUtf8(static_cast<uint32_t>(code), w);
+                                    r = semi + 1;
+                                    continue;
+                                }
+                            }
+                            if (c != 0) {
+                                *w++ = c;
+                                r = semi + 1;
+                                continue;
+                            }
+                        }
+                    } else if (*r == '\r') {
+                        // \r\n and \r become \n
+                        *w++ = '\n';
+                        r += (r + 1 < vEnd && r[1] == '\n') ? 2 : 1;
+                        continue;
+                    }
+                    *w++ = *r++;
+                }
+                return StringRef(vBegin, static_cast<size_t>(w - vBegin));
+            }
+
+        }  // namespace detail
+
+        // single pass xml parser working in place on its buffer :
+        // no tokens, no string copies, entities and line endings are decoded in the buffer itself
+        // and elements/attributes are allocated in an arena
+        class Document {
+        private:
+            std::vector<char> m_buffer;  // parsed text, when owned
+            Arena m_arena;
+            Element m_root;
+            std::string m_error;
+            const char *m_bufferBegin = nullptr;  // for error offsets
+
+        public:
+            Document() {
+                clear();
+            }
+
+            Document(const Document &) = delete;
+            Document &operator=(const Document &) = delete;
+
+            void clear() {
+                m_buffer.clear();
+                m_arena.clear();
+                m_root = Element();
+                m_root.m_name = StringRef("root", 4U);
+                m_error.clear();
+            }
+
+            // the virtual root, parent of the top level elements
+            const Element &getRoot() const {
+                return m_root;
+            }
+
+            // reason of the last parsing failure
+            const std::string &getError() const {
+                return m_error;
+            }
+
+            bool parseString(const std::string &vDoc) {
+                clear();
+                m_buffer.assign(vDoc.begin(), vDoc.end());
+                return m_parse(m_buffer.data(), m_buffer.data() + m_buffer.size());
+            }
+
+            // no copy : vBuffer is modified and must outlive the document
+            bool parseInSitu(char *vBuffer, size_t vSize) {
+                clear();
+                return m_parse(vBuffer, vBuffer + vSize);
+            }
+
+            bool parseFile(const std::string &vFilePathName) {
+                clear();
+                std::ifstream docFile(vFilePathName, std::ios::in | std::ios::binary);
+                if (!docFile.is_open()) {
+                    m_error = "cant open file " + vFilePathName;
+                    return false;
+                }
+                docFile.seekg(0, std::ios::end);
+                m_buffer.resize(static_cast<size_t>(docFile.tellg()));
+                docFile.seekg(0, std::ios::beg);
+                docFile.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                return m_parse(m_buffer.data(), m_buffer.data() + m_buffer.size());
+            }
+
+        private:
+            bool m_setError(const std::string &vError, const char *vPos) {
+                m_error = vError + " at offset " + std::to_string(vPos - m_bufferBegin);
+                return false;
+            }
+
+            Element *m_addElement(Element *vParent) {
+                auto elem = m_arena.create<Element>();
+                elem->m_parent = vParent;
+                if (vParent->m_lastChild == nullptr) {
+                    vParent->m_firstChild = elem;
+                } else {
+                    vParent->m_lastChild->m_nextSibling = elem;
+                }
+                vParent->m_lastChild = elem;
+                ++vParent->m_childrenCount;
+                return elem;
+            }
+
+            bool m_parse(char *p, char *end) {
+                m_bufferBegin = p;
+                Element *current = &m_root;
+                while (p < end) {
+                    if (*p != '<') {
+                        // text, kept if not blank
+                        char *lt = static_cast<char *>(std::memchr(p, '<', static_cast<size_t>(end - p)));
+                        if (lt == nullptr) {
+                            lt = end;
+                        }
+                        if (detail::skipSpaces(p, lt) != lt) {
+                            current->m_content = detail::unescapeInSitu(p, lt);
+                        }
+                        p = lt;
+                        continue;
+                    }
+                    if (p + 1 >= end) {
+                        return m_setError("unexpected end", p);
+                    }
+                    if (p[1] == '/') {
+                        // closing tag
+                        char *nameBegin = detail::skipSpaces(p + 2, end);
+                        char *nameEnd = detail::endOfName(nameBegin, end);
+                        char *gt = detail::skipSpaces(nameEnd, end);
+                        if (gt >= end || *gt != '>') {
+                            return m_setError("unterminated closing tag", p);
+                        }
+                        if (current == &m_root || current->m_name != StringRef(nameBegin, static_cast<size_t>(nameEnd - nameBegin))) {
+                            return m_setError("unexpected closing tag </" + std::string(nameBegin, nameEnd) + ">", p);
+                        }
+                        current = const_cast<Element *>(current->m_parent);
+                        p = gt + 1;
+                    } else if (p[1] == '!') {
+                        if (end - p >= 4 && std::memcmp(p, "<!--", 4) == 0) {
+                            char *commentEnd = detail::findPattern(p + 4, end, "-->");
+                            if (commentEnd == nullptr) {
+                                return m_setError("unterminated comment", p);
+                            }
+                            auto comment = m_addElement(current);
+                            comment->m_type = Node::Type::Comment;
+                            commentEnd += 3;
+                            comment->m_content = StringRef(p, static_cast<size_t>(commentEnd - p));  // like xml::Node, the whole comment
+                            p = commentEnd;
+                        } else if (end - p >= 9 && std::memcmp(p, "<![CDATA[", 9) == 0) {
+                            char *cdataEnd = detail::findPattern(p + 9, end, "]]>");
+                            if (cdataEnd == nullptr) {
+                                return m_setError("unterminated CDATA", p);
+                            }
+                            current->m_content = StringRef(p + 9, static_cast<size_t>(cdataEnd - p - 9));
+                            p = cdataEnd + 3;
+                        } else {
+                            // DOCTYPE and co, skipped
+                            char *gt = static_cast<char *>(std::memchr(p, '>', static_cast<size_t>(end - p)));
+                            if (gt == nullptr) {
+                                return m_setError("unterminated declaration", p);
+                            }
+                            p = gt + 1;
+                        }
+                    } else if (p[1] == '?') {
+                        // processing instruction, skipped
+                        char *piEnd = detail::findPattern(p + 2, end, "?>");
+                        if (piEnd == nullptr) {
+                            return m_setError("unterminated processing instruction", p);
+                        }
+                        p = piEnd + 2;
+                    } else {
+                        // opening tag
+                        char *nameBegin = detail::skipSpaces(p + 1, end);
+                        char *nameEnd = detail::endOfName(nameBegin, end);
+                        if (nameEnd == nameBegin) {
+                            return m_setError("empty tag name", p);
+                        }
+                        auto elem = m_addElement(current);
+                        elem->m_name = StringRef(nameBegin, static_cast<size_t>(nameEnd - nameBegin));
+                        p = nameEnd;
+                        bool selfClosed = false;
+                        while (true) {
+                            p = detail::skipSpaces(p, end);
+                            if (p >= end) {
+                                return m_setError("unterminated tag <" + elem->m_name.str() + ">", nameBegin);
+                            }
+                            if (*p == '>') {
+                                ++p;
+                                break;
+                            }
+                            if (*p == '/') {
+                                if (p + 1 >= end || p[1] != '>') {
+                                    return m_setError("unexpected '/' in tag <" + elem->m_name.str() + ">", p);
+                                }
+                                selfClosed = true;
+                                p += 2;
+                                break;
+                            }
+                            // attribute
+                            char *keyBegin = p;
+                            char *keyEnd = detail::endOfName(p, end);
+                            p = detail::skipSpaces(keyEnd, end);
+                            if (keyEnd == keyBegin || p >= end || *p != '=') {
+                                return m_setError("invalid attribute in tag <" + elem->m_name.str() + ">", keyBegin);
+                            }
+                            p = detail::skipSpaces(p + 1, end);
+                            if (p >= end || (*p != '"' && *p != '\'')) {
+                                return m_setError("the attribute '" + std::string(keyBegin, keyEnd) + "' have invalid value", keyBegin);
+                            }
+                            char *valueEnd = static_cast<char *>(std::memchr(p + 1, *p, static_cast<size_t>(end - p - 1)));
+                            if (valueEnd == nullptr) {
+                                return m_setError("the attribute '" + std::string(keyBegin, keyEnd) + "' have invalid value", keyBegin);
+                            }
+                            auto attr = m_arena.create<ElementAttribute>();
+                            attr->name = StringRef(keyBegin, static_cast<size_t>(keyEnd - keyBegin));
+                            attr->value = detail::unescapeInSitu(p + 1, valueEnd);
+                            if (elem->m_lastAttribute == nullptr) {
+                                elem->m_firstAttribute = attr;
+                            } else {
+                                elem->m_lastAttribute->next = attr;
+                            }
+                            elem->m_lastAttribute = attr;
+                            p = valueEnd + 1;
+                        }
+                        if (!selfClosed) {
+                            current = elem;
+                        }
+                    }
+                }
+                if (current != &m_root) {
+                    return m_setError("unclosed tag <" + current->m_name.str() + ">", end);
+                }
+                return true;
+            }
+        };
+
+        // pull reader for documents too big to be loaded :
+        // the stream is read by chunks of fixed size, and each call to next() gives one event.
+        // names and values are views on the internal buffer, valid until the next call to next()
+        class Reader {
+        public:
+            enum class EventType {
+                None = 0,
+                StartElement,  // getName()
+                Attribute,     // getName(), getValue(), after the StartElement of its element
+                Text,          // getValue(), unescaped, blank texts are skipped
+                Comment,       // getValue(), the whole comment like xml::Node
+                EndElement,    // getName(), also sent for self closed elements
+                Count
+            };
+
+        private:
+            std::ifstream m_file;
+            std::istream *m_stream = nullptr;
+            std::vector<char> m_buffer;
+            size_t m_begin = 0;  // start of the unconsumed datas in m_buffer
+            size_t m_end = 0;    // end of the valid datas in m_buffer
+            size_t m_streamOffset = 0;  // offset in the stream of m_buffer[0], for errors
+            bool m_eof = true;
+
+            // current tag, when its attributes are iterated
+            char *m_tagPos = nullptr;
+            char *m_tagEnd = nullptr;
+            bool m_inTag = false;
+
+            std::vector<std::string> m_openedElements;
+            size_t m_depth = 0;
+
+            EventType m_eventType = EventType::None;
+            StringRef m_name;
+            StringRef m_value;
+            std::string m_error;
+
+        public:
+            Reader() = default;
+            Reader(const Reader &) = delete;
+            Reader &operator=(const Reader &) = delete;
+
+            bool openFile(const std::string &vFilePathName, size_t vChunkSize = 64 * 1024) {
+                close();
+                m_file.open(vFilePathName, std::ios::in | std::ios::binary);
+                if (!m_file.is_open()) {
+                    m_error = "cant open file " + vFilePathName;
+                    return false;
+                }
+                return openStream(m_file, vChunkSize);
+            }
+
+            // vStream must outlive the reading
+            bool openStream(std::istream &vStream, size_t vChunkSize = 64 * 1024) {
+                m_reset();
+                m_stream = &vStream;
+                m_buffer.resize(std::max<size_t>(vChunkSize, 16U));
+                m_eof = false;
+                return true;
+            }
+
+            void close() {
+                if (m_file.is_open()) {
+                    m_file.close();
+                }
+                m_reset();
+            }
+
+            // false at the end of the document, or on error (getError() is not empty)
+            bool next() {
+                m_eventType = EventType::None;
+                m_name = StringRef();
+                m_value = StringRef();
+                if (!m_error.empty()) {
+                    return false;
+                }
+                if (m_inTag) {
+                    return m_nextInTag();
+                }
+                while (true) {
+                    if (m_begin == m_end && !m_fill()) {
+                        if (m_depth > 0U) {
+                            return m_setError("unclosed tag <" + m_openedElements[m_depth - 1U] + ">", m_end);
+                        }
+                        return false;
+                    }
+                    char *p = m_buffer.data() + m_begin;
+                    if (*p != '<') {
+                        size_t textEnd = 0;
+                        if (!m_findLowerThan(textEnd)) {
+                            textEnd = m_end;  // text up to the end of the stream
+                        }
+                        p = m_buffer.data() + m_begin;
+                        char *end = m_buffer.data() + textEnd;
+                        m_begin = textEnd;
+                        if (detail::skipSpaces(p, end) != end) {
+                            m_value = detail::unescapeInSitu(p, end);
+                            return m_setEvent(EventType::Text);
+                        }
+                        continue;
+                    }
+                    // the whole construct must be in the buffer
+                    if (!m_ensure(9U) && m_end - m_begin < 2U) {
+                        return m_setError("unexpected end", m_begin);
+                    }
+                    p = m_buffer.data() + m_begin;
+                    const size_t avail = m_end - m_begin;
+                    if (avail >= 4U && std::memcmp(p, "<!--", 4) == 0) {
+                        size_t commentEnd = 0;
+                        if (!m_findPattern(4U, "-->", commentEnd)) {
+                            return m_setError("unterminated comment", m_begin);
+                        }
+                        m_value = StringRef(m_buffer.data() + m_begin, commentEnd + 3U - m_begin);
+                        m_begin = commentEnd + 3U;
+                        return m_setEvent(EventType::Comment);
+                    } else if (avail >= 9U && std::memcmp(p, "<![CDATA[", 9) == 0) {
+                        size_t cdataEnd = 0;
+                        if (!m_findPattern(9U, "]]>", cdataEnd)) {
+                            return m_setError("unterminated CDATA", m_begin);
+                        }
+                        m_value = StringRef(m_buffer.data() + m_begin + 9U, cdataEnd - m_begin - 9U);
+                        m_begin = cdataEnd + 3U;
+                        return m_setEvent(EventType::Text);
+                    } else if (p[1] == '?') {
+                        // processing instruction, skipped
+                        size_t piEnd = 0;
+                        if (!m_findPattern(2U, "?>", piEnd)) {
+                            return m_setError("unterminated processing instruction", m_begin);
+                        }
+                        m_begin = piEnd + 2U;
+                        continue;
+                    }
+                    size_t tagEnd = 0;
+                    if (!m_findTagEnd(tagEnd)) {
+                        return m_setError("unterminated tag", m_begin);
+                    }
+                    p = m_buffer.data() + m_begin;
+                    char *end = m_buffer.data() + tagEnd;  // on '>'
+                    const size_t tagBegin = m_begin;
+                    m_begin = tagEnd + 1U;
+                    if (p[1] == '!') {
+                        continue;  // DOCTYPE and co, skipped
+                    }
+                    if (p[1] == '/') {
+                        char *nameBegin = detail::skipSpaces(p + 2, end);
+                        char *nameEnd = detail::endOfName(nameBegin, end);
+                        m_name = StringRef(nameBegin, static_cast<size_t>(nameEnd - nameBegin));
+                        if (detail::skipSpaces(nameEnd, end) != end) {
+                            return m_setError("invalid closing tag", tagBegin);
+                        }
+                        if (m_depth == 0U || m_name != m_openedElements[m_depth - 1U]) {
+                            return m_setError("unexpected closing tag </" + m_name.str() + ">", tagBegin);
+                        }
+                        --m_depth;
+                        return m_setEvent(EventType::EndElement);
+                    }
+                    char *nameBegin = detail::skipSpaces(p + 1, end);
+                    char *nameEnd = detail::endOfName(nameBegin, end);
+                    if (nameEnd == nameBegin) {
+                        return m_setError("empty tag name", tagBegin);
+                    }
+                    m_name = StringRef(nameBegin, static_cast<size_t>(nameEnd - nameBegin));
+                    if (m_openedElements.size() <= m_depth) {
+                        m_openedElements.resize(m_depth + 1U);
+                    }
+                    m_openedElements[m_depth++].assign(nameBegin, nameEnd);
+                    m_tagPos = nameEnd;
+                    m_tagEnd = end;
+                    m_inTag = true;
+                    return m_setEvent(EventType::StartElement);
+                }
+            }
+
+            EventType getEventType() const {
+                return m_eventType;
+            }
+
+            const StringRef &getName() const {
+                return m_name;
+            }
+
+            const StringRef &getValue() const {
+                return m_value;
+            }
+
+            // count of opened elements, the document element is at depth 1
+            size_t getDepth() const {
+                return m_depth;
+            }
+
+            const std::string &getError() const {
+                return m_error;
+            }
+
+        private:
+            void m_reset() {
+                m_stream = nullptr;
+                m_begin = m_end = m_streamOffset = 0U;
+                m_eof = true;
+                m_inTag = false;
+                m_tagPos = m_tagEnd = nullptr;
+                m_depth = 0U;
+                m_eventType = EventType::None;
+                m_name = m_value = StringRef();
+                m_error.clear();
+            }
+
+            bool m_setEvent(EventType vType) {
+                m_eventType = vType;
+                return true;
+            }
+
+            bool m_setError(const std::string &vError, size_t vPos) {
+                m_eventType = EventType::None;
+                m_error = vError + " at offset " + std::to_string(m_streamOffset + vPos);
+                return false;
+            }
+
+            // attributes of the current tag, then the end of a self closed element
+            bool m_nextInTag() {
+                char *p = detail::skipSpaces(m_tagPos, m_tagEnd);
+                if (p == m_tagEnd) {
+                    m_inTag = false;
+                    return next();
+                }
+                if (*p == '/') {
+                    if (detail::skipSpaces(p + 1, m_tagEnd) != m_tagEnd) {
+                        return m_setError("unexpected '/' in tag <" + m_openedElements[m_depth - 1U] + ">", m_begin);
+                    }
+                    m_inTag = false;
+                    --m_depth;
+                    m_name = StringRef(m_openedElements[m_depth].data(), m_openedElements[m_depth].size());
+                    return m_setEvent(EventType::EndElement);
+                }
+                char *keyEnd = detail::endOfName(p, m_tagEnd);
+                char *eq = detail::skipSpaces(keyEnd, m_tagEnd);
+                if (keyEnd == p || eq == m_tagEnd || *eq != '=') {
+                    return m_setError("invalid attribute in tag <" + m_openedElements[m_depth - 1U] + ">", m_begin);
+                }
+                char *quote = detail::skipSpaces(eq + 1, m_tagEnd);
+                char *valueEnd = nullptr;
+                if (quote != m_tagEnd && (*quote == '"' || *quote == '\'')) {
+                    valueEnd = static_cast<char *>(std::memchr(quote + 1, *quote, static_cast<size_t>(m_tagEnd - quote - 1)));
+                }
+                if (valueEnd == nullptr) {
+                    return m_setError("the attribute '" + std::string(p, keyEnd) + "' have invalid value", m_begin);
+                }
+                m_name = StringRef(p, static_cast<size_t>(keyEnd - p));
+                m_value = detail::unescapeInSitu(quote + 1, valueEnd);
+                m_tagPos = valueEnd + 1;
+                return m_setEvent(EventType::Attribute);
+            }
+
+            // move the unconsumed datas at the start of the buffer, grow it if full, and read the next chunk
+            bool m_fill() {
+                if (m_eof) {
+                    return false;
+                }
+                if (m_begin > 0U) {
+                    std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+                    m_streamOffset += m_begin;
+                    m_end -= m_begin;
+                    m_begin = 0U;
+                }
+                if (m_end == m_buffer.size()) {
+                    m_buffer.resize(m_buffer.size() * 2U);
+                }
+                m_stream->read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+                const size_t readCount = static_cast<size_t>(m_stream->gcount());
+                m_end += readCount;
+                if (readCount == 0U) {
+                    m_eof = true;
+                }
+                return readCount > 0U;
+            }
+
+            // at least vCount bytes unconsumed, if the stream have them
+            bool m_ensure(size_t vCount) {
+                while (m_end - m_begin < vCount) {
+                    if (!m_fill()) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // search from m_begin + vOffset, reading more chunks if needed. vPos is absolute in m_buffer
+            bool m_findPattern(size_t vOffset, const char *vPattern, size_t &vPos) {
+                const size_t len = std::strlen(vPattern);
+                size_t from = vOffset;
+                while (true) {
+                    char *base = m_buffer.data() + m_begin;
+                    char *found = detail::findPattern(base + from, m_buffer.data() + m_end, vPattern);
+                    if (found != nullptr) {
+                        vPos = static_cast<size_t>(found - m_buffer.data());
+                        return true;
+                    }
+                    const size_t avail = m_end - m_begin;
+                    from = std::max(from, avail >= len ? avail - len + 1U : 0U);
+                    if (!m_fill()) {
+                        return false;
+                    }
+                }
+            }
+
+            bool m_findLowerThan(size_t &vPos) {
+                size_t from = 0U;
+                while (true) {
+                    char *base = m_buffer.data() + m_begin;
+                    auto found = static_cast<char *>(std::memchr(base + from, '<', m_end - m_begin - from));
+                    if (found != nullptr) {
+                        vPos = static_cast<size_t>(found - m_buffer.data());
+                        return true;
+                    }
+                    from = m_end - m_begin;
+                    if (!m_fill()) {
+                        return false;
+                    }
+                }
+            }
+
+            // the '>' closing the tag at m_begin, ignoring the ones in attribute values
+            bool m_findTagEnd(size_t &vPos) {
+                size_t from = 1U;
+                char quote = 0;
+                while (true) {
+                    const char *base = m_buffer.data() + m_begin;
+                    const size_t avail = m_end - m_begin;
+                    for (; from < avail; ++from) {
+                        const char c = base[from];
+                        if (quote != 0) {
+                            if (c == quote) {
+                                quote = 0;
+                            }
+                        } else if (c == '"' || c == '\'') {
+                            quote = c;
+                        } else if (c == '>') {
+                            vPos = m_begin + from;
+                            return true;
+                        }
+                    }
+                    if (!m_fill()) {
+                        return false;
+                    }
+                }
+            }
+        };
+
     }  // namespace xml
 
     class Xml {
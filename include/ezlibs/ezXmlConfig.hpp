@@ -95,6 +95,97 @@ public:
         return res;
     }
 
+    // streamed loading for big files : the file is read by chunks and the whole dom is never built.
+    // root and the document element are given to setFromXmlNodes without their childs,
+    // then each child of the document element is built, given to RecursParsingConfig and released.
+    // unlike LoadConfigFile, a parsing error can occur after some nodes were already given
+    bool LoadConfigFileStreamed(const std::string& vFilePathName, const std::string& vUserDatas, size_t vChunkSize = 64 * 1024) {
+        bool res = true;  // if not file found its ok
+        ez::xml::Reader reader;
+        if (reader.openFile(vFilePathName, vChunkSize)) {
+            res = parseConfigReader(reader, vUserDatas);
+            if (!res) {
+                LogVarError("Config.xml file parsing failed : %s", reader.getError().c_str());
+            }
+        }
+        return res;
+    }
+
+    bool parseConfigStream(std::istream& vStream, const std::string& vUserDatas, size_t vChunkSize = 64 * 1024) {
+        ez::xml::Reader reader;
+        reader.openStream(vStream, vChunkSize);
+        return parseConfigReader(reader, vUserDatas);
+    }
+
+    bool parseConfigReader(ez::xml::Reader& vReader, const std::string& vUserDatas) {
+        Node parent("root");
+        Node root("root");
+        std::vector<Node*> nodes(1U, &root);  // opened nodes, by depth
+        bool called[2] = {false, false};      // setFromXmlNodes done for root and the document element
+        bool explore[2] = {true, true};
+        bool skipDocumentElementChilds = false;
+        // setFromXmlNodes of root or of the document element, before the first child
+        auto exploreStreamed = [&](size_t vDepth) {
+            if (!called[vDepth]) {
+                called[vDepth] = true;
+                explore[vDepth] = setFromXmlNodes(*nodes[vDepth], vDepth == 0U ? parent : root, vUserDatas);
+            }
+            return explore[vDepth];
+        };
+        while (vReader.next()) {
+            const auto type = vReader.getEventType();
+            const size_t depth = vReader.getDepth();  // the new element is counted, the closed one is not
+            if (skipDocumentElementChilds && !(type == Reader::EventType::EndElement && depth == 0U)) {
+                continue;
+            }
+            if (type == Reader::EventType::StartElement || type == Reader::EventType::Comment) {
+                const size_t parentDepth = (type == Reader::EventType::Comment) ? depth : depth - 1U;
+                if (parentDepth <= 1U && !exploreStreamed(parentDepth)) {
+                    if (parentDepth == 0U) {
+                        return true;  // nothing more to read
+                    }
+                    skipDocumentElementChilds = true;
+                    continue;
+                }
+                if (type == Reader::EventType::Comment) {
+                    nodes.back()->addComment(vReader.getValue().str());
+                    if (depth <= 1U) {
+                        RecursParsingConfig(nodes.back()->getChildren().back(), *nodes.back(), vUserDatas);
+                        nodes.back()->getChildren().clear();
+                    }
+                } else {
+                    nodes.push_back(&nodes.back()->addChild(vReader.getName().str()));
+                    if (depth <= 1U) {
+                        called[depth] = false;
+                        explore[depth] = true;
+                    }
+                }
+            } else if (type == Reader::EventType::Attribute) {
+                nodes.back()->addAttribute(vReader.getName().str(), vReader.getValue().str());
+            } else if (type == Reader::EventType::Text) {
+                nodes.back()->setContent(vReader.getValue().str());
+            } else if (type == Reader::EventType::EndElement) {
+                if (depth == 0U && !skipDocumentElementChilds) {
+                    exploreStreamed(1U);  // document element without childs
+                }
+                nodes.pop_back();
+                if (depth == 1U) {
+                    // a child of the document element is complete
+                    RecursParsingConfig(nodes.back()->getChildren().back(), *nodes.back(), vUserDatas);
+                    nodes.back()->getChildren().clear();
+                } else if (depth == 0U) {
+                    skipDocumentElementChilds = false;
+                    root.getChildren().clear();
+                }
+            }
+        }
+        if (!vReader.getError().empty()) {
+            return false;
+        }
+        exploreStreamed(0U);
+        return true;
+    }
+
     void RecursParsingConfig(const Node& vNode, const Node& vParent, const std::string& vUserDatas) {
         if (setFromXmlNodes(vNode, vParent, vUserDatas)) {
             RecursParsingConfigChilds(vNode, vUserDatas);
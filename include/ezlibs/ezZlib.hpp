@@ -0,0 +1,783 @@
+#pragma once
+
+/*
+MIT License
+
+Copyright (c) 2014-2024 Stephane Cuillerdier (aka aiekick)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// ezZlib is part of the ezLibs project : https://github.com/aiekick/ezLibs.git
+// zlib streams (RFC 1950) of deflate blocks (RFC 1951), without dependency.
+// the compressor do a LZ77 on hash chains and choose for each block the smallest of stored, fixed or dynamic huffman.
+// the streams are readable by zlib (inflate, uncompress) and the ones of zlib by ez::zlib::uncompress
+// checked in both ways against the zlib of python, for the levels 0 to 9 on empty, random, repetitive and text datas
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace ez {
+namespace zlib {
+
+inline uint32_t adler32(const void* vDatas, size_t vSize, uint32_t vAdler = 1U) {
+    const uint8_t* ptr = static_cast<const uint8_t*>(vDatas);
+    uint32_t a = vAdler & 0xFFFFU;
+    uint32_t b = vAdler >> 16;
+    while (vSize > 0U) {
+        // 5552 is the max count of bytes before a overflow of b
+        const size_t count = std::min<size_t>(vSize, 5552U);
+        vSize -= count;
+        for (size_t i = 0; i < count; ++i) {
+            a += ptr[i];
+            b += a;
+        }
+        ptr += count;
+        a %= 65521U;
+        b %= 65521U;
+    }
+    return (b << 16) | a;
+}
+
+namespace detail {
+
+static constexpr uint32_t LENGTH_BASES[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static constexpr uint32_t LENGTH_EXTRAS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static constexpr uint32_t DIST_BASES[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static constexpr uint32_t DIST_EXTRAS[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static constexpr uint32_t CODE_LENGTHS_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static constexpr size_t LITLEN_CODES{286U};
+static constexpr size_t DIST_CODES{30U};
+static constexpr size_t CODE_LENGTH_CODES{19U};
+static constexpr size_t MAX_SYMBOLS{288U};
+
+// huffman code lengths of the vCount (MAX_SYMBOLS at max) symbols from their frequencies, limited to vMaxBits.
+// at least two symbols have a code, so the code is complete for any inflater
+inline void buildCodeLengths(const uint32_t* vFreqs, size_t vCount, uint32_t vMaxBits, uint8_t* vLengths) {
+    std::array<std::pair<uint32_t, uint32_t>, MAX_SYMBOLS> leafs;  // freq, symbol
+    size_t leafsCount = 0U;
+    for (size_t i = 0; i < vCount; ++i) {
+        vLengths[i] = 0U;
+        if (vFreqs[i] > 0U) {
+            leafs[leafsCount++] = std::make_pair(vFreqs[i], static_cast<uint32_t>(i));
+        }
+    }
+    for (uint32_t i = 0; leafsCount < 2U; ++i) {
+        if (vFreqs[i] == 0U) {
+            leafs[leafsCount++] = std::make_pair(1U, i);
+        }
+    }
+    std::sort(leafs.begin(), leafs.begin() + leafsCount);
+
+    // huffman tree by the two queues method, the nodes are the leafs then the internal nodes
+    std::array<uint64_t, MAX_SYMBOLS * 2U> weights;
+    std::array<uint32_t, MAX_SYMBOLS * 2U> parents;
+    for (size_t i = 0; i < leafsCount; ++i) {
+        weights[i] = leafs[i].first;
+    }
+    size_t nextLeaf = 0U;
+    size_t nextNode = leafsCount;
+    size_t nodesCount = leafsCount;
+    auto popMin = [&]() {
+        if (nextLeaf < leafsCount && (nextNode >= nodesCount || weights[nextLeaf] <= weights[nextNode])) {
+            return nextLeaf++;
+        }
+        return nextNode++;
+    };
+    while (nodesCount < leafsCount * 2U - 1U) {
+        const size_t a = popMin();
+        const size_t b = popMin();
+        weights[nodesCount] = weights[a] + weights[b];
+        parents[a] = parents[b] = static_cast<uint32_t>(nodesCount);
+        ++nodesCount;
+    }
+
+    // depths of the leafs, the root is the last node
+    std::array<uint32_t, MAX_SYMBOLS * 2U> depths;
+    std::array<uint32_t, 64> lengthsCount{};
+    depths[nodesCount - 1U] = 0U;
+    for (size_t i = nodesCount - 1U; i-- > 0U;) {
+        depths[i] = depths[parents[i]] + 1U;
+    }
+    for (size_t i = 0; i < leafsCount; ++i) {
+        ++lengthsCount[std::min<uint32_t>(depths[i], 63U)];
+    }
+
+    // too long codes are moved to vMaxBits, then the kraft sum is fixed by lengthening shorter codes
+    for (uint32_t len = vMaxBits + 1U; len < 64U; ++len) {
+        lengthsCount[vMaxBits] += lengthsCount[len];
+        lengthsCount[len] = 0U;
+    }
+    uint64_t total = 0U;
+    for (uint32_t len = vMaxBits; len > 0U; --len) {
+        total += static_cast<uint64_t>(lengthsCount[len]) << (vMaxBits - len);
+    }
+    while (total > (1ULL << vMaxBits)) {
+        --lengthsCount[vMaxBits];
+        for (uint32_t len = vMaxBits - 1U; len > 0U; --len) {
+            if (lengthsCount[len] > 0U) {
+                --lengthsCount[len];
+                lengthsCount[len + 1U] += 2U;
+                break;
+            }
+        }
+        --total;
+    }
+
+    // the less frequent symbols get the longest codes
+    size_t leafIdx = 0U;
+    for (uint32_t len = vMaxBits; len > 0U; --len) {
+        for (uint32_t i = 0; i < lengthsCount[len]; ++i) {
+            vLengths[leafs[leafIdx++].second] = static_cast<uint8_t>(len);
+        }
+    }
+}
+
+// canonical codes of the lengths, bits reversed since deflate write the codes from the msb
+inline void buildCodes(const uint8_t* vLengths, size_t vCount, uint16_t* vCodes) {
+    std::array<uint32_t, 16> lengthsCount{};
+    for (size_t i = 0; i < vCount; ++i) {
+        ++lengthsCount[vLengths[i]];
+    }
+    lengthsCount[0] = 0U;
+    std::array<uint32_t, 16> nextCode{};
+    uint32_t code = 0U;
+    for (size_t len = 1; len < 16U; ++len) {
+        code = (code + lengthsCount[len - 1U]) << 1;
+        nextCode[len] = code;
+    }
+    for (size_t i = 0; i < vCount; ++i) {
+        const uint32_t len = vLengths[i];
+        uint32_t rev = 0U;
+        if (len > 0U) {
+            const uint32_t c = nextCode[len]++;
+            for (uint32_t b = 0; b < len; ++b) {
+                rev |= ((c >> b) & 1U) << (len - 1U - b);
+            }
+        }
+        vCodes[i] = static_cast<uint16_t>(rev);
+    }
+}
+
+// lsb first bits writer
+class BitWriter {
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_bits{};
+    uint32_t m_count{};
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& vOut) : m_out(vOut) {}
+
+    void put(uint32_t vBits, uint32_t vCount) {
+        m_bits |= static_cast<uint64_t>(vBits) << m_count;
+        m_count += vCount;
+        while (m_count >= 8U) {
+            m_out.push_back(static_cast<uint8_t>(m_bits));
+            m_bits >>= 8;
+            m_count -= 8U;
+        }
+    }
+
+    void alignToByte() {
+        if (m_count > 0U) {
+            put(0U, 8U - m_count);
+        }
+    }
+};
+
+}  // namespace detail
+
+// deflate compressor in zlib streams. keep it for many compressions, its tables are reused
+class Compressor {
+private:
+    static constexpr uint32_t WINDOW_SIZE{32768U};
+    static constexpr uint32_t WINDOW_MASK{WINDOW_SIZE - 1U};
+    static constexpr uint32_t HASH_BITS{15U};
+    static constexpr uint32_t MIN_MATCH{3U};
+    static constexpr uint32_t MAX_MATCH{258U};
+    static constexpr size_t MAX_BLOCK_SYMBOLS{16384U};
+
+    struct Symbol {
+        uint16_t litLen;  // literal byte, or match length
+        uint16_t dist;    // 0 for a literal
+    };
+
+    // positions are stored with an offset growing at each compression, so the old ones are out of window without clear
+    std::vector<uint32_t> m_head;
+    std::vector<uint32_t> m_prev;
+    uint32_t m_base{};
+    uint32_t m_nextBase{1U};
+    std::vector<Symbol> m_symbols;
+    std::vector<uint8_t> m_allLengths;               // code lengths of the two trees of a dynamic block
+    std::vector<std::pair<uint8_t, uint8_t>> m_rle;  // their run length encoding : code, extra bits value
+    std::array<uint8_t, 259> m_lengthCodes{};
+    std::array<uint8_t, 512> m_distCodes{};
+
+public:
+    Compressor() : m_head(static_cast<size_t>(1U) << HASH_BITS, 0U), m_prev(WINDOW_SIZE, 0U) {
+        m_symbols.reserve(MAX_BLOCK_SYMBOLS);
+        for (uint32_t code = 0; code < 29U; ++code) {
+            const uint32_t count = 1U << detail::LENGTH_EXTRAS[code];
+            for (uint32_t i = 0; i < count && detail::LENGTH_BASES[code] + i <= MAX_MATCH; ++i) {
+                m_lengthCodes[detail::LENGTH_BASES[code] + i] = static_cast<uint8_t>(code);
+            }
+        }
+        // like zlib, distances - 1 under 256 are direct, the others by 128 steps
+        for (uint32_t code = 0; code < 30U; ++code) {
+            const uint32_t count = 1U << detail::DIST_EXTRAS[code];
+            for (uint32_t i = 0; i < count; ++i) {
+                const uint32_t d = detail::DIST_BASES[code] - 1U + i;
+                if (d < 256U) {
+                    m_distCodes[d] = static_cast<uint8_t>(code);
+                } else {
+                    m_distCodes[256U + (d >> 7)] = static_cast<uint8_t>(code);
+                }
+            }
+        }
+    }
+
+    // append to vOut the zlib stream of vDatas.
+    // vLevel is 0 (stored only) to 9 (longest search), 6 is a good balance
+    void compress(const void* vDatas, size_t vSize, std::vector<uint8_t>& vOut, int32_t vLevel = 6) {
+        const uint8_t* datas = static_cast<const uint8_t*>(vDatas);
+        const uint32_t level = static_cast<uint32_t>(std::min<int32_t>(std::max<int32_t>(vLevel, 0), 9));
+        // zlib header : deflate, 32K window, level hint, check bits
+        const uint32_t cmf = 0x78U;
+        const uint32_t levelHint = (level < 2U) ? 0U : ((level < 6U) ? 1U : ((level == 6U) ? 2U : 3U));
+        uint32_t flg = levelHint << 6;
+        flg += 31U - ((cmf << 8) + flg) % 31U;
+        vOut.push_back(static_cast<uint8_t>(cmf));
+        vOut.push_back(static_cast<uint8_t>(flg));
+
+        detail::BitWriter bits(vOut);
+        if (vSize == 0U) {
+            bits.put(3U, 3U);  // last fixed block with only the end of block
+            bits.put(0U, 7U);
+        } else if (level == 0U) {
+            m_writeStored(bits, datas, vSize, true);
+        } else {
+            m_deflate(bits, datas, vSize, level);
+        }
+        bits.alignToByte();
+        const uint32_t adler = adler32(datas, vSize);
+        for (int32_t i = 3; i >= 0; --i) {
+            vOut.push_back(static_cast<uint8_t>(adler >> (i * 8)));
+        }
+    }
+
+private:
+    static uint32_t m_hash(const uint8_t* p) {
+        const uint32_t v = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16);
+        return (v * 2654435761U) >> (32U - HASH_BITS);
+    }
+
+    void m_insert(const uint8_t* vDatas, uint32_t vPos) {
+        const uint32_t h = m_hash(vDatas + vPos);
+        m_prev[vPos & WINDOW_MASK] = m_head[h];
+        m_head[h] = m_base + vPos;
+    }
+
+    // longest match at vPos in the window, 0 if less than MIN_MATCH
+    // the search stop at vMaxChain candidates or at a match of vNiceLen, and want better than vPrevLen
+    uint32_t m_findMatch(const uint8_t* vDatas, size_t vSize, uint32_t vPos, uint32_t vMaxChain, uint32_t vNiceLen, uint32_t vPrevLen, uint32_t& vOutDist) const {
+        const uint32_t maxLen = static_cast<uint32_t>(std::min<size_t>(MAX_MATCH, vSize - vPos));
+        uint32_t bestLen = std::max(vPrevLen, MIN_MATCH - 1U);
+        if (maxLen <= bestLen) {
+            return 0U;
+        }
+        const uint32_t minPos = (vPos > WINDOW_SIZE) ? (vPos - WINDOW_SIZE) : 0U;
+        uint32_t candidate = m_head[m_hash(vDatas + vPos)];
+        uint32_t ret = 0U;
+        for (uint32_t chain = vMaxChain; chain > 0U && candidate >= m_base + minPos && candidate < m_base + vPos; --chain) {
+            const uint32_t pos = candidate - m_base;
+            const uint8_t* a = vDatas + pos;
+            const uint8_t* b = vDatas + vPos;
+            if (a[bestLen] == b[bestLen] && a[0] == b[0] && a[1] == b[1]) {
+                uint32_t len = 2U;
+                while (len < maxLen && a[len] == b[len]) {
+                    ++len;
+                }
+                if (len > bestLen) {
+                    bestLen = len;
+                    ret = len;
+                    vOutDist = vPos - pos;
+                    if (len >= vNiceLen || len == maxLen) {
+                        break;
+                    }
+                }
+            }
+            const uint32_t next = m_prev[pos & WINDOW_MASK];
+            if (next >= candidate) {
+                break;
+            }
+            candidate = next;
+        }
+        return ret;
+    }
+
+    void m_deflate(detail::BitWriter& vBits, const uint8_t* vDatas, size_t vSize, uint32_t vLevel) {
+        // good, lazy, nice and chain lengths of zlib by level
+        static const uint32_t s_configs[10][4] = {
+            {0, 0, 0, 0},
+            {4, 0, 8, 4},
+            {4, 0, 16, 8},
+            {4, 0, 32, 32},
+            {4, 4, 16, 16},
+            {8, 16, 32, 32},
+            {8, 16, 128, 128},
+            {8, 32, 128, 256},
+            {32, 128, 258, 1024},
+            {32, 258, 258, 4096},
+        };
+        const uint32_t goodLen = s_configs[vLevel][0];
+        const uint32_t lazyLen = s_configs[vLevel][1];
+        const uint32_t niceLen = s_configs[vLevel][2];
+        const uint32_t maxChain = s_configs[vLevel][3];
+        if (static_cast<uint64_t>(m_nextBase) + vSize >= 0xFFFFFFFFULL) {
+            std::fill(m_head.begin(), m_head.end(), 0U);
+            std::fill(m_prev.begin(), m_prev.end(), 0U);
+            m_nextBase = 1U;
+        }
+        m_base = m_nextBase;  // the entries of the previous compressions are now before the base
+        m_nextBase = m_base + static_cast<uint32_t>(vSize);
+
+        m_symbols.clear();
+        size_t blockStart = 0U;
+        uint32_t pos = 0U;
+        uint32_t nextLen = 0U;
+        uint32_t nextDist = 0U;
+        while (pos < vSize) {
+            uint32_t dist = 0U;
+            uint32_t len = 0U;
+            if (pos + MIN_MATCH <= vSize) {
+                if (nextLen > 0U) {
+                    len = nextLen;
+                    dist = nextDist;
+                    nextLen = 0U;
+                } else {
+                    len = m_findMatch(vDatas, vSize, pos, maxChain, niceLen, 0U, dist);
+                }
+                m_insert(vDatas, pos);
+                if (len > 0U && len < lazyLen && pos + 1U + MIN_MATCH <= vSize) {
+                    // a longer match at the next byte is better, the current byte become a literal
+                    const uint32_t chain = (len >= goodLen) ? (maxChain >> 2) : maxChain;
+                    nextLen = m_findMatch(vDatas, vSize, pos + 1U, chain, niceLen, len, nextDist);
+                    if (nextLen > 0U) {
+                        len = 0U;
+                    }
+                }
+            }
+            if (len >= MIN_MATCH) {
+                m_symbols.push_back({static_cast<uint16_t>(len), static_cast<uint16_t>(dist)});
+                const uint32_t end = pos + len;
+                for (++pos; pos < end; ++pos) {
+                    if (pos + MIN_MATCH <= vSize) {
+                        m_insert(vDatas, pos);
+                    }
+                }
+            } else {
+                m_symbols.push_back({vDatas[pos], 0U});
+                ++pos;
+            }
+            if (m_symbols.size() >= MAX_BLOCK_SYMBOLS) {
+                m_writeBlock(vBits, vDatas + blockStart, pos - blockStart, pos == vSize);
+                blockStart = pos;
+            }
+        }
+        if (!m_symbols.empty()) {
+            m_writeBlock(vBits, vDatas + blockStart, pos - blockStart, true);
+        }
+    }
+
+    uint32_t m_distCode(uint32_t vDist) const {
+        const uint32_t d = vDist - 1U;
+        return (d < 256U) ? m_distCodes[d] : m_distCodes[256U + (d >> 7)];
+    }
+
+    static void m_writeStored(detail::BitWriter& vBits, const uint8_t* vDatas, size_t vSize, bool vLast) {
+        do {
+            const size_t count = std::min<size_t>(vSize, 65535U);
+            vSize -= count;
+            vBits.put((vLast && vSize == 0U) ? 1U : 0U, 1U);
+            vBits.put(0U, 2U);
+            vBits.alignToByte();
+            vBits.put(static_cast<uint32_t>(count), 16U);
+            vBits.put(static_cast<uint32_t>(~count) & 0xFFFFU, 16U);
+            for (size_t i = 0; i < count; ++i) {
+                vBits.put(vDatas[i], 8U);
+            }
+            vDatas += count;
+        } while (vSize > 0U);
+    }
+
+    // write the symbols in the smallest block type
+    void m_writeBlock(detail::BitWriter& vBits, const uint8_t* vDatas, size_t vSize, bool vLast) {
+        using namespace detail;
+        std::array<uint32_t, LITLEN_CODES> litLenFreqs{};
+        std::array<uint32_t, DIST_CODES> distFreqs{};
+        for (const auto& sym : m_symbols) {
+            if (sym.dist == 0U) {
+                ++litLenFreqs[sym.litLen];
+            } else {
+                ++litLenFreqs[257U + m_lengthCodes[sym.litLen]];
+                ++distFreqs[m_distCode(sym.dist)];
+            }
+        }
+        litLenFreqs[256] = 1U;  // end of block
+
+        // dynamic trees
+        std::array<uint8_t, LITLEN_CODES + DIST_CODES> lengths{};
+        buildCodeLengths(litLenFreqs.data(), LITLEN_CODES, 15U, lengths.data());
+        buildCodeLengths(distFreqs.data(), DIST_CODES, 15U, lengths.data() + LITLEN_CODES);
+        size_t litLenCount = LITLEN_CODES;
+        while (litLenCount > 257U && lengths[litLenCount - 1U] == 0U) {
+            --litLenCount;
+        }
+        size_t distCount = DIST_CODES;
+        while (distCount > 1U && lengths[LITLEN_CODES + distCount - 1U] == 0U) {
+            --distCount;
+        }
+        // run length encoding of the code lengths of the two trees
+        auto& allLengths = m_allLengths;
+        allLengths.assign(lengths.begin(), lengths.begin() + litLenCount);
+        allLengths.insert(allLengths.end(), lengths.begin() + LITLEN_CODES, lengths.begin() + LITLEN_CODES + distCount);
+        auto& rle = m_rle;
+        rle.clear();
+        std::array<uint32_t, CODE_LENGTH_CODES> clFreqs{};
+        for (size_t i = 0; i < allLengths.size();) {
+            const uint8_t len = allLengths[i];
+            size_t run = 1U;
+            while (i + run < allLengths.size() && allLengths[i + run] == len) {
+                ++run;
+            }
+            size_t done = 0U;
+            if (len == 0U) {
+                while (run - done >= 11U) {
+                    const size_t count = std::min<size_t>(run - done, 138U);
+                    rle.emplace_back(18U, static_cast<uint8_t>(count - 11U));
+                    done += count;
+                }
+                if (run - done >= 3U) {
+                    rle.emplace_back(17U, static_cast<uint8_t>(run - done - 3U));
+                    done = run;
+                }
+            } else if (run >= 4U) {
+                rle.emplace_back(len, 0U);
+                ++done;
+                while (run - done >= 3U) {
+                    const size_t count = std::min<size_t>(run - done, 6U);
+                    rle.emplace_back(16U, static_cast<uint8_t>(count - 3U));
+                    done += count;
+                }
+            }
+            for (; done < run; ++done) {
+                rle.emplace_back(len, 0U);
+            }
+            i += run;
+        }
+        for (const auto& r : rle) {
+            ++clFreqs[r.first];
+        }
+        std::array<uint8_t, CODE_LENGTH_CODES> clLengths{};
+        buildCodeLengths(clFreqs.data(), CODE_LENGTH_CODES, 7U, clLengths.data());
+        size_t clCount = CODE_LENGTH_CODES;
+        while (clCount > 4U && clLengths[CODE_LENGTHS_ORDER[clCount - 1U]] == 0U) {
+            --clCount;
+        }
+
+        // sizes in bits of the block types
+        uint64_t dynamicBits = 3U + 5U + 5U + 4U + clCount * 3U;
+        for (const auto& r : rle) {
+            dynamicBits += clLengths[r.first] + ((r.first == 16U) ? 2U : ((r.first == 17U) ? 3U : ((r.first == 18U) ? 7U : 0U)));
+        }
+        uint64_t fixedBits = 3U;
+        for (size_t i = 0; i < LITLEN_CODES; ++i) {
+            const uint64_t extra = (i >= 257U) ? LENGTH_EXTRAS[i - 257U] : 0U;
+            dynamicBits += litLenFreqs[i] * (lengths[i] + extra);
+            fixedBits += litLenFreqs[i] * (m_fixedLength(static_cast<uint32_t>(i)) + extra);
+        }
+        for (size_t i = 0; i < DIST_CODES; ++i) {
+            dynamicBits += distFreqs[i] * (lengths[LITLEN_CODES + i] + DIST_EXTRAS[i]);
+            fixedBits += distFreqs[i] * (5U + DIST_EXTRAS[i]);
+        }
+        const uint64_t storedBits = 3U + 7U + 32U + vSize * 8U + (vSize / 65535U) * 40U;
+
+        if (storedBits <= fixedBits && storedBits <= dynamicBits) {
+            m_writeStored(vBits, vDatas, vSize, vLast);
+        } else if (fixedBits <= dynamicBits) {
+            std::array<uint8_t, 288> fixedLengths{};
+            for (uint32_t i = 0; i < 288U; ++i) {
+                fixedLengths[i] = static_cast<uint8_t>(m_fixedLength(i));
+            }
+            std::array<uint8_t, DIST_CODES> fixedDistLengths{};
+            fixedDistLengths.fill(5U);
+            vBits.put(vLast ? 1U : 0U, 1U);
+            vBits.put(1U, 2U);
+            m_writeSymbols(vBits, fixedLengths.data(), fixedLengths.size(), fixedDistLengths.data());
+        } else {
+            vBits.put(vLast ? 1U : 0U, 1U);
+            vBits.put(2U, 2U);
+            vBits.put(static_cast<uint32_t>(litLenCount - 257U), 5U);
+            vBits.put(static_cast<uint32_t>(distCount - 1U), 5U);
+            vBits.put(static_cast<uint32_t>(clCount - 4U), 4U);
+            for (size_t i = 0; i < clCount; ++i) {
+                vBits.put(clLengths[CODE_LENGTHS_ORDER[i]], 3U);
+            }
+            std::array<uint16_t, CODE_LENGTH_CODES> clCodes{};
+            buildCodes(clLengths.data(), CODE_LENGTH_CODES, clCodes.data());
+            for (const auto& r : rle) {
+                vBits.put(clCodes[r.first], clLengths[r.first]);
+                if (r.first == 16U) {
+                    vBits.put(r.second, 2U);
+                } else if (r.first == 17U) {
+                    vBits.put(r.second, 3U);
+                } else if (r.first == 18U) {
+                    vBits.put(r.second, 7U);
+                }
+            }
+            m_writeSymbols(vBits, lengths.data(), LITLEN_CODES, lengths.data() + LITLEN_CODES);
+        }
+        m_symbols.clear();
+    }
+
+    static uint32_t m_fixedLength(uint32_t vSymbol) {
+        return (vSymbol < 144U) ? 8U : ((vSymbol < 256U) ? 9U : ((vSymbol < 280U) ? 7U : 8U));
+    }
+
+    // vLitLenCount is 288 for the fixed code, its codes depend on the two unused symbols
+    void m_writeSymbols(detail::BitWriter& vBits, const uint8_t* vLitLenLengths, size_t vLitLenCount, const uint8_t* vDistLengths) const {
+        using namespace detail;
+        std::array<uint16_t, 288> litLenCodes{};
+        std::array<uint16_t, DIST_CODES> distCodes{};
+        buildCodes(vLitLenLengths, vLitLenCount, litLenCodes.data());
+        buildCodes(vDistLengths, DIST_CODES, distCodes.data());
+        for (const auto& sym : m_symbols) {
+            if (sym.dist == 0U) {
+                vBits.put(litLenCodes[sym.litLen], vLitLenLengths[sym.litLen]);
+            } else {
+                const uint32_t lenCode = m_lengthCodes[sym.litLen];
+                vBits.put(litLenCodes[257U + lenCode], vLitLenLengths[257U + lenCode]);
+                vBits.put(sym.litLen - LENGTH_BASES[lenCode], LENGTH_EXTRAS[lenCode]);
+                const uint32_t distCode = m_distCode(sym.dist);
+                vBits.put(distCodes[distCode], vDistLengths[distCode]);
+                vBits.put(sym.dist - DIST_BASES[distCode], DIST_EXTRAS[distCode]);
+            }
+        }
+        vBits.put(litLenCodes[256], vLitLenLengths[256]);
+    }
+};
+
+// zlib stream of vDatas
+inline std::vector<uint8_t> compress(const void* vDatas, size_t vSize, int32_t vLevel = 6) {
+    std::vector<uint8_t> ret;
+    Compressor().compress(vDatas, vSize, ret, vLevel);
+    return ret;
+}
+
+// append to vOut the datas of a zlib stream, false if the stream is not valid
+inline bool uncompress(const void* vDatas, size_t vSize, std::vector<uint8_t>& vOut) {
+    using namespace detail;
+    const uint8_t* datas = static_cast<const uint8_t*>(vDatas);
+    if (vSize < 6U || (datas[0] & 0x0FU) != 8U || ((datas[0] << 8) | datas[1]) % 31U != 0U || (datas[1] & 0x20U) != 0U) {
+        return false;  // not deflate, bad check, or preset dictionary
+    }
+    const size_t outStart = vOut.size();
+    size_t pos = 2U;
+    uint32_t bitBuf = 0U;
+    uint32_t bitCount = 0U;
+    bool error = false;
+    auto getBits = [&](uint32_t vCount) -> uint32_t {
+        while (bitCount < vCount) {
+            if (pos >= vSize) {
+                error = true;
+                return 0U;
+            }
+            bitBuf |= static_cast<uint32_t>(datas[pos++]) << bitCount;
+            bitCount += 8U;
+        }
+        const uint32_t ret = bitBuf & ((1U << vCount) - 1U);
+        bitBuf >>= vCount;
+        bitCount -= vCount;
+        return ret;
+    };
+
+    // canonical huffman decoding, like the puff of zlib
+    struct Huffman {
+        std::array<uint16_t, 16> counts{};
+        std::array<uint16_t, 288> symbols{};
+    };
+    auto buildHuffman = [](Huffman& vHuff, const uint8_t* vLengths, size_t vCount) {
+        vHuff.counts.fill(0U);
+        for (size_t i = 0; i < vCount; ++i) {
+            ++vHuff.counts[vLengths[i]];
+        }
+        std::array<uint16_t, 16> offsets{};
+        for (size_t len = 1; len < 15U; ++len) {
+            offsets[len + 1U] = static_cast<uint16_t>(offsets[len] + vHuff.counts[len]);
+        }
+        for (size_t i = 0; i < vCount; ++i) {
+            if (vLengths[i] != 0U) {
+                vHuff.symbols[offsets[vLengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+    };
+    auto decode = [&](const Huffman& vHuff) -> int32_t {
+        int32_t code = 0;
+        int32_t first = 0;
+        int32_t index = 0;
+        for (size_t len = 1; len < 16U; ++len) {
+            code |= static_cast<int32_t>(getBits(1U));
+            const int32_t count = vHuff.counts[len];
+            if (code - count < first) {
+                return vHuff.symbols[static_cast<size_t>(index + (code - first))];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        error = true;
+        return -1;
+    };
+
+    Huffman litLenHuff;
+    Huffman distHuff;
+    bool last = false;
+    while (!last && !error) {
+        last = (getBits(1U) != 0U);
+        const uint32_t type = getBits(2U);
+        if (type == 0U) {
+            bitBuf = 0U;
+            bitCount = 0U;
+            if (pos + 4U > vSize) {
+                return false;
+            }
+            const size_t len = datas[pos] | (datas[pos + 1U] << 8);
+            const size_t nlen = datas[pos + 2U] | (datas[pos + 3U] << 8);
+            pos += 4U;
+            if (len != (~nlen & 0xFFFFU) || pos + len > vSize) {
+                return false;
+            }
+            vOut.insert(vOut.end(), datas + pos, datas + pos + len);
+            pos += len;
+            continue;
+        }
+        std::array<uint8_t, LITLEN_CODES + 2U + DIST_CODES> lengths{};
+        size_t litLenCount = 288U;
+        size_t distCount = DIST_CODES;
+        if (type == 1U) {
+            for (uint32_t i = 0; i < 288U; ++i) {
+                lengths[i] = static_cast<uint8_t>((i < 144U) ? 8U : ((i < 256U) ? 9U : ((i < 280U) ? 7U : 8U)));
+            }
+            buildHuffman(litLenHuff, lengths.data(), 288U);
+            std::array<uint8_t, DIST_CODES> distLengths{};
+            distLengths.fill(5U);
+            buildHuffman(distHuff, distLengths.data(), DIST_CODES);
+        } else if (type == 2U) {
+            litLenCount = getBits(5U) + 257U;
+            distCount = getBits(5U) + 1U;
+            const size_t clCount = getBits(4U) + 4U;
+            if (litLenCount > LITLEN_CODES || distCount > DIST_CODES) {
+                return false;
+            }
+            std::array<uint8_t, CODE_LENGTH_CODES> clLengths{};
+            for (size_t i = 0; i < clCount; ++i) {
+                clLengths[CODE_LENGTHS_ORDER[i]] = static_cast<uint8_t>(getBits(3U));
+            }
+            Huffman clHuff;
+            buildHuffman(clHuff, clLengths.data(), CODE_LENGTH_CODES);
+            for (size_t i = 0; i < litLenCount + distCount && !error;) {
+                const int32_t sym = decode(clHuff);
+                if (sym < 0) {
+                    return false;
+                }
+                if (sym < 16) {
+                    lengths[i++] = static_cast<uint8_t>(sym);
+                    continue;
+                }
+                uint8_t len = 0U;
+                size_t repeat = 0U;
+                if (sym == 16) {
+                    if (i == 0U) {
+                        return false;
+                    }
+                    len = lengths[i - 1U];
+                    repeat = 3U + getBits(2U);
+                } else if (sym == 17) {
+                    repeat = 3U + getBits(3U);
+                } else {
+                    repeat = 11U + getBits(7U);
+                }
+                if (i + repeat > litLenCount + distCount) {
+                    return false;
+                }
+                for (; repeat > 0U; --repeat) {
+                    lengths[i++] = len;
+                }
+            }
+            buildHuffman(litLenHuff, lengths.data(), litLenCount);
+            buildHuffman(distHuff, lengths.data() + litLenCount, distCount);
+        } else {
+            return false;
+        }
+        while (!error) {
+            const int32_t sym = decode(litLenHuff);
+            if (sym < 256) {
+                if (sym < 0) {
+                    return false;
+                }
+                vOut.push_back(static_cast<uint8_t>(sym));
+            } else if (sym == 256) {
+                break;
+            } else {
+                const size_t lenCode = static_cast<size_t>(sym - 257);
+                if (lenCode >= 29U) {
+                    return false;
+                }
+                const size_t len = LENGTH_BASES[lenCode] + getBits(LENGTH_EXTRAS[lenCode]);
+                const int32_t distCode = decode(distHuff);
+                if (distCode < 0 || distCode >= 30) {
+                    return false;
+                }
+                const size_t dist = DIST_BASES[distCode] + getBits(DIST_EXTRAS[distCode]);
+                if (dist > vOut.size() - outStart) {
+                    return false;
+                }
+                const size_t from = vOut.size() - dist;
+                for (size_t i = 0; i < len; ++i) {
+                    vOut.push_back(vOut[from + i]);
+                }
+            }
+        }
+    }
+    if (error || pos + 4U > vSize) {
+        return false;
+    }
+    const uint32_t adler = (static_cast<uint32_t>(datas[pos]) << 24) | (static_cast<uint32_t>(datas[pos + 1U]) << 16) |  //
+        (static_cast<uint32_t>(datas[pos + 2U]) << 8) | datas[pos + 3U];
+    return adler == adler32(vOut.data() + outStart, vOut.size() - outStart);
+}
+
+}  // namespace zlib
+}  // namespace ez